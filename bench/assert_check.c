@@ -0,0 +1,70 @@
+/******************************************************************************
+ * @file:    assert_check.c
+ * @purpose: Check that LPCLIB_ASSERT=off accessors compile to the same code
+ *           as the bare register accesses (see "make assert-check")
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Built twice: once at the off level, and once (ASSERT_CHECK_RAW) with
+ * lpclib_assert() stripped out of the accessors entirely, leaving just their
+ * register accesses.  The two disassemblies must match; any difference means
+ * a check is leaking code into "off" builds.  Parameters come in as
+ * arguments so the compiler can't fold the checks away.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpclib_assert.h"
+
+#if (LPCLIB_ASSERT_LEVEL != LPCLIB_ASSERT_OFF)
+# error "assert_check.c must be built with LPCLIB_ASSERT_LEVEL=0"
+#endif
+
+/* Accessors pick this up as they're expanded below */
+#ifdef ASSERT_CHECK_RAW
+# undef lpclib_assert
+# define lpclib_assert(x)
+#endif
+
+#include "lpc11xx.h"
+#include "lpc11xx/gpio.h"
+#include "lpc11xx/uart.h"
+#include "lpc11xx/adc.h"
+#include "lpc11xx/iap.h"
+
+
+/* Functions ----------------------------------------------------------------*/
+
+void check_gpio_write_pins(uint32_t mask, uint32_t values)
+{
+    GPIO_WritePins(GPIO0, mask, values);
+}
+
+uint32_t check_gpio_read_pins(uint32_t mask)
+{
+    return GPIO_ReadPins(GPIO0, mask);
+}
+
+void check_gpio_set_pins_high(uint32_t mask)
+{
+    GPIO_SetPinsHigh(GPIO0, mask);
+}
+
+void check_uart_enable_interrupts(uint32_t it_mask)
+{
+    UART_EnableInterrupts(UART0, it_mask);
+}
+
+void check_adc_set_burst_resolution(ADC_BurstResolution_Type resolution)
+{
+    ADC_SetBurstResolution(ADC0, resolution);
+}
+
+int check_iap_copy_ram_to_flash(uint32_t dest_addr, uint32_t src_addr,
+                                IAP_ByteCountType nbytes)
+{
+    return IAP_CopyRamToFlash(dest_addr, src_addr, nbytes);
+}
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * @file:    bench.c
+ * @purpose: Cycle-count benchmarks for the driver hot paths, run under
+ *           lpc11xx-sim (see bench/Makefile)
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Results are reported through semihosting, so this only runs under the
+ * simulator or a debugger that handles BKPT 0xAB.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx/gpio.h"
+#include "lpc11xx/iocon.h"
+#include "lpc11xx/uart.h"
+#include "lpc11xx/ssp.h"
+#include "system_lpc11xx.h"
+
+#include "bench.h"
+
+
+/* Defines ------------------------------------------------------------------*/
+
+/* Semihosting operations */
+#define BENCH_SYS_WRITE0      (0x04)
+#define BENCH_SYS_EXIT        (0x18)
+#define BENCH_ADP_APP_EXIT    (0x20026UL)
+
+/* Bytes moved by the UART / SSP burst benchmarks (one FIFO's worth) */
+#define BENCH_UART_BURST      (16)
+#define BENCH_SSP_BURST       (8)
+
+
+/* File Local Variables -----------------------------------------------------*/
+
+/* Results land here so the compiler can't drop the reads */
+volatile uint32_t bench_sink;
+
+static uint8_t bench_ssp_buffer[BENCH_SSP_BURST];
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Write a string to the simulator's stdout.
+  */
+static void bench_puts(const char *s)
+{
+    register uint32_t r0 __asm__("r0") = BENCH_SYS_WRITE0;
+    register const char *r1 __asm__("r1") = s;
+
+
+    __asm__ volatile ("bkpt 0xab" : "+r" (r0) : "r" (r1) : "memory");
+}
+
+/** @brief Stop the simulator with a successful exit status.
+  */
+static void bench_exit(void)
+{
+    register uint32_t r0 __asm__("r0") = BENCH_SYS_EXIT;
+    register uint32_t r1 __asm__("r1") = BENCH_ADP_APP_EXIT;
+
+
+    __asm__ volatile ("bkpt 0xab" : "+r" (r0) : "r" (r1) : "memory");
+
+    while (1);
+}
+
+/** @brief Wait for the UART transmitter (& with loopback, receiver) to idle.
+  */
+static void bench_uart_drain(void)
+{
+    while ((UART_GetLineStatus(UART0) & UART_LineStatus_TxEmpty) == 0);
+}
+
+/** @brief Bring up UART0 (fastest baud rate, so setup waits stay short) &
+  *        SSP0 (loopback).
+  */
+static void bench_init(void)
+{
+    SYSCON_EnableAHBClockLines(SYSCON_AHBClockLine_GPIO | SYSCON_AHBClockLine_IOCON
+                               | SYSCON_AHBClockLine_UART0 | SYSCON_AHBClockLine_SSP0);
+
+    IOCON_SetPinConfig(IOCON_PinConfig_1_7_TXD0, IOCON_Mode_Normal);
+    IOCON_SetPinConfig(IOCON_PinConfig_1_6_RXD0, IOCON_Mode_Normal);
+    SYSCON_SetUART0ClockDivider(1);
+
+    UART_SetDivisor(UART0, 1);
+    UART_SetWordLength(UART0, UART_WordLength_8b);
+    UART_SetStopBits(UART0, UART_StopBits_1);
+    UART_SetParity(UART0, UART_Parity_None);
+    UART_EnableFifos(UART0);
+    UART_FlushFifos(UART0);
+    UART_EnableTx(UART0);
+
+    SYSCON_DeassertPeripheralResets(SYSCON_PeripheralReset_SSP0);
+    SYSCON_SetSSP0ClockDivider(1);
+
+    SSP_SetWordLength(SSP0, SSP_WordLength_8);
+    SSP_SetFrameFormat(SSP0, SSP_FrameFormat_SPI);
+    SSP_SetMode(SSP0, SSP_Mode_Master);
+    SSP_SetClockPrescaler(SSP0, 2);
+    SSP_SetPrescalerTicksPerBit(SSP0, 1);
+    SSP_EnableLoopback(SSP0);
+    SSP_Enable(SSP0);
+
+    GPIO_SetPinDirections(GPIO0, GPIO_Pin_3 | GPIO_Pin_5, GPIO_Direction_Out);
+}
+
+/** @brief Run one benchmark BENCH_ITERATIONS times & report its mapping.
+  */
+static void bench_run(const Bench_Type *bench)
+{
+    unsigned int i;
+
+
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        if (bench->Setup) {
+            bench->Setup();
+        }
+
+        bench->Run();
+    }
+
+    bench_puts(bench->Map);
+}
+
+
+/* Benchmarks ---------------------------------------------------------------*/
+
+BENCH_FUNCTION void bench_gpio_write_pins(void)
+{
+    GPIO_WritePins(GPIO0, GPIO_Pin_3 | GPIO_Pin_5, GPIO_Pin_5);
+}
+
+BENCH_FUNCTION void bench_gpio_read_pins(void)
+{
+    bench_sink = GPIO_ReadPins(GPIO0, GPIO_Pin_3 | GPIO_Pin_5);
+}
+
+BENCH_FUNCTION void bench_gpio_set_pins_high(void)
+{
+    GPIO_SetPinsHigh(GPIO0, GPIO_Pin_3);
+}
+
+static void bench_uart_send_setup(void)
+{
+    UART_DisableLoopback(UART0);
+    bench_uart_drain();
+}
+
+/* Fill the (empty) TX FIFO, checking for space like a polled driver would */
+BENCH_FUNCTION void bench_uart_send_burst(void)
+{
+    unsigned int i;
+
+
+    for (i = 0; i < BENCH_UART_BURST; i++) {
+        while ((UART_GetLineStatus(UART0) & UART_LineStatus_TxReady) == 0);
+        UART_Send(UART0, (uint8_t)i);
+    }
+}
+
+static void bench_uart_recv_setup(void)
+{
+    unsigned int i;
+
+
+    UART_FlushRxFifo(UART0);
+    UART_EnableLoopback(UART0);
+
+    for (i = 0; i < BENCH_UART_BURST; i++) {
+        UART_Send(UART0, (uint8_t)i);
+    }
+
+    bench_uart_drain();
+}
+
+/* Empty a full RX FIFO, checking for data like a polled driver would */
+BENCH_FUNCTION void bench_uart_recv_burst(void)
+{
+    uint32_t sum = 0;
+
+
+    while (UART_GetLineStatus(UART0) & UART_LineStatus_RxData) {
+        sum += UART_Recv(UART0);
+    }
+
+    bench_sink = sum;
+}
+
+BENCH_FUNCTION void bench_ssp_xfer_burst(void)
+{
+    unsigned int i;
+
+
+    for (i = 0; i < BENCH_SSP_BURST; i++) {
+        bench_ssp_buffer[i] = SSP_Xfer(SSP0, bench_ssp_buffer[i]);
+    }
+}
+
+/* Cached clock lookup, as a driver would do before computing a divisor */
+BENCH_FUNCTION void bench_clock_get_uart0(void)
+{
+    bench_sink = CLOCK_GetFrequency(CLOCK_UART0);
+}
+
+static const Bench_Type Bench_Drivers[] = {
+    BENCH(gpio_write_pins,    0,                     bench_gpio_write_pins,    bench_gpio_write_pins),
+    BENCH(gpio_read_pins,     0,                     bench_gpio_read_pins,     bench_gpio_read_pins),
+    BENCH(gpio_set_pins_high, 0,                     bench_gpio_set_pins_high, bench_gpio_set_pins_high),
+    BENCH(uart_send_burst,    bench_uart_send_setup, bench_uart_send_burst,    bench_uart_send_burst),
+    BENCH(uart_recv_burst,    bench_uart_recv_setup, bench_uart_recv_burst,    bench_uart_recv_burst),
+    BENCH(ssp_xfer_burst,     0,                     bench_ssp_xfer_burst,     bench_ssp_xfer_burst),
+    BENCH(core_clock_update,  0,                     SystemCoreClockUpdate,    SystemCoreClockUpdate),
+    BENCH(clock_get_uart0,    0,                     bench_clock_get_uart0,    bench_clock_get_uart0),
+};
+
+
+/* Functions ----------------------------------------------------------------*/
+
+int main(void)
+{
+    unsigned int i;
+
+
+    bench_init();
+
+    for (i = 0; i < sizeof(Bench_Drivers) / sizeof(Bench_Drivers[0]); i++) {
+        bench_run(&Bench_Drivers[i]);
+    }
+
+    for (i = 0; i < Bench_UARTIRQCount; i++) {
+        bench_run(&Bench_UARTIRQ[i]);
+    }
+
+    /* Last: these leave the clock wherever the final case put it */
+    for (i = 0; i < Bench_PowerCount; i++) {
+        bench_run(&Bench_Power[i]);
+    }
+
+    bench_exit();
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+/******************************************************************************
+ * @file:    bench.h
+ * @purpose: Declarations shared by the lpc11xx-sim benchmark suite
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Each benchmark is a setup function (not timed) & a run function (timed).
+ * The run function is called through a pointer so that it stays a separate
+ * function the simulator's profile can find; its cycles per call, plus the
+ * code size & stack frame of the function under test, become one row of
+ * bench.tsv.
+ *****************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+
+/* Defines ------------------------------------------------------------------*/
+
+/*! Times each benchmark is run (cycles are reported per run) */
+#define BENCH_ITERATIONS  (16)
+
+/*! Keep a run function out of line & out of the optimizer's reach */
+#define BENCH_FUNCTION    __attribute__((noinline, used))
+
+/*! Describe a benchmark: cycles are those of run, code & stack bytes those
+ *  of subject (the same function, unless run is a wrapper around it).
+ */
+#define BENCH(name, setup, run, subject) { #name "\t" #run "\t" #subject "\n", setup, run }
+
+
+/* Types --------------------------------------------------------------------*/
+
+/*! @brief One benchmark */
+typedef struct {
+    const char  *Map;           /*!< "name\trun\tsubject\n" for bench.tsv */
+    void       (*Setup)(void);  /*!< Untimed preparation before each run, or 0 */
+    void       (*Run)(void);    /*!< The timed function                        */
+} Bench_Type;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/* bench_uart_irq.c */
+extern const Bench_Type Bench_UARTIRQ[];
+extern const unsigned int Bench_UARTIRQCount;
+
+/* bench_power.c */
+extern const Bench_Type Bench_Power[];
+extern const unsigned int Bench_PowerCount;
+
+#endif /* #ifndef BENCH_H_ */
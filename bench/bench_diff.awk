@@ -0,0 +1,78 @@
+# bench_diff.awk : compare bench.tsv against the checked-in baseline.
+#
+# Usage: awk -f bench_diff.awk baseline.tsv bench.tsv
+#
+# Prints every benchmark with its change from the baseline & exits with
+# status 1 if any cycle count, code size or stack size went up, or if a
+# benchmark was added without re-taking the baseline ("make bench-baseline").
+# A baseline with no figures at all (none recorded yet) only gets a warning.
+#
+# Author: Tymm Twillman <tymm@gmail.com>
+# Date:   February 2012
+
+function delta(old, new)
+{
+    if ((old == "") || (old == "?") || (new == "?")) {
+        return new
+    }
+
+    if (new + 0 > old + 0) {
+        worse = 1
+    }
+
+    return (new == old) ? new : sprintf("%s (%+d)", new, new - old)
+}
+
+BEGIN {
+    FS = "\t"
+    worse = 0
+    missing = 0
+    nbase = 0
+
+    printf "%-20s %-18s %-18s %-18s\n", "benchmark", "cycles", "code_bytes", "stack_bytes"
+}
+
+/^#/ || ($1 == "benchmark") {
+    next
+}
+
+FILENAME == ARGV[1] {
+    base[$1] = 1
+    nbase++
+    cycles[$1] = $2
+    code[$1] = $3
+    stack[$1] = $4
+    next
+}
+
+{
+    seen[$1] = 1
+
+    if (!($1 in base)) {
+        missing = 1
+    }
+
+    printf "%-20s %-18s %-18s %-18s%s\n", $1, delta(cycles[$1], $2),
+           delta(code[$1], $3), delta(stack[$1], $4), ($1 in base) ? "" : "  (new)"
+}
+
+END {
+    for (name in base) {
+        if (!(name in seen)) {
+            printf "%-20s (removed)\n", name
+        }
+    }
+
+    if (worse) {
+        print "bench: regression against baseline"
+    }
+
+    if (nbase == 0) {
+        print "bench: no baseline figures recorded; nothing compared (make bench-baseline)"
+        missing = 0
+    } else if (missing) {
+        print "bench: benchmarks missing from baseline; run make bench-baseline"
+    }
+
+    exit worse || missing
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * @file:    bench_power.c
+ * @purpose: Benchmarks of the ROM Power Profile modes at several PLL
+ *           operating points
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Each case sets the clock with PowerAPI_SetPLLFreq() & the mode with
+ * PowerAPI_SetPowerMode() (untimed), then times the same flash-bound
+ * workload.  Under lpc11xx-sim the modes differ only in the flash access
+ * time the ROM picks; the regulator settings, and so the current drawn,
+ * only show on hardware.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx/power_api.h"
+
+#include "bench.h"
+
+
+/* Defines ------------------------------------------------------------------*/
+
+/* Words summed by the workload (fetched from flash) */
+#define BENCH_POWER_WORDS     (32)
+
+/* PLL lock polls allowed */
+#define BENCH_POWER_LOCK_TRIES (1000)
+
+/*! Declare a case: setup for clock hz / mode, & its own run function */
+#define BENCH_POWER(name, hz, mode)                                         \
+    static void bench_power_##name##_setup(void)                            \
+    {                                                                       \
+        bench_power_setup(hz, PowerAPI_PowerMode_##mode);                   \
+    }                                                                       \
+                                                                            \
+    BENCH_FUNCTION static void bench_power_##name(void)                     \
+    {                                                                       \
+        bench_power_workload();                                             \
+    }
+
+#define BENCH_POWER_ENTRY(name) \
+    BENCH(power_##name, bench_power_##name##_setup, bench_power_##name, bench_power_workload)
+
+
+/* File Local Variables -----------------------------------------------------*/
+
+/* Contents don't matter; they're only there to be read from flash */
+static const uint32_t bench_power_data[BENCH_POWER_WORDS] = { 0x5a5a5a5aUL, 1, 2, 3 };
+
+static volatile uint32_t bench_power_sink;
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Move to an operating point through the ROM.
+  */
+static void bench_power_setup(uint32_t hz, PowerAPI_PowerMode_Type mode)
+{
+    PowerAPI_SetPLLFreq(hz, PowerAPI_PLLMode_Equal, BENCH_POWER_LOCK_TRIES);
+    PowerAPI_SetPowerMode(mode);
+}
+
+/* Flash-bound loop: code & data both come from flash */
+BENCH_FUNCTION void bench_power_workload(void)
+{
+    uint32_t sum = 0;
+    unsigned int i;
+
+
+    for (i = 0; i < BENCH_POWER_WORDS; i++) {
+        sum += bench_power_data[i] ^ i;
+    }
+
+    bench_power_sink = sum;
+}
+
+BENCH_POWER(12m_perf,  12000000, Performance)
+BENCH_POWER(12m_eff,   12000000, Efficiency)
+BENCH_POWER(12m_low,   12000000, LowCurrent)
+BENCH_POWER(24m_perf,  24000000, Performance)
+BENCH_POWER(24m_eff,   24000000, Efficiency)
+BENCH_POWER(24m_low,   24000000, LowCurrent)
+BENCH_POWER(48m_perf,  48000000, Performance)
+BENCH_POWER(48m_eff,   48000000, Efficiency)
+BENCH_POWER(48m_low,   48000000, LowCurrent)
+
+
+/* Global Variables ---------------------------------------------------------*/
+
+const Bench_Type Bench_Power[] = {
+    BENCH_POWER_ENTRY(12m_perf),
+    BENCH_POWER_ENTRY(12m_eff),
+    BENCH_POWER_ENTRY(12m_low),
+    BENCH_POWER_ENTRY(24m_perf),
+    BENCH_POWER_ENTRY(24m_eff),
+    BENCH_POWER_ENTRY(24m_low),
+    BENCH_POWER_ENTRY(48m_perf),
+    BENCH_POWER_ENTRY(48m_eff),
+    BENCH_POWER_ENTRY(48m_low),
+};
+
+const unsigned int Bench_PowerCount = sizeof(Bench_Power) / sizeof(Bench_Power[0]);
@@ -0,0 +1,109 @@
+# bench_table.awk : merge lpc11xx-sim output, symbol sizes & stack usage
+#                   into bench.tsv (one row per benchmark).
+#
+# Usage: awk -f bench_table.awk -v map=M -v prof=P -v boot=B -v syms=S \
+#            M P B S [*.su ...]
+#
+#   M      benchmark map: "name <tab> run <tab> subject[+subject...]" lines
+#          (printed by the benchmark image; "boot" is added by the Makefile)
+#   P      lpc11xx-sim -t profile of the whole benchmark run
+#   B      lpc11xx-sim -t profile of the run up to main() (boot cycles)
+#   S      nm -S output for the benchmark image
+#   *.su   gcc -fstack-usage output
+#
+# Cycles are per call of the run function; code bytes are summed & stack
+# bytes maxed over the subjects.  Stack is the function's own frame only
+# (callees aren't added in).
+#
+# Author: Tymm Twillman <tymm@gmail.com>
+# Date:   February 2012
+
+function hex(s,    i, v)
+{
+    v = 0
+    s = tolower(s)
+    for (i = 1; i <= length(s); i++) {
+        v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+    }
+    return v
+}
+
+BEGIN {
+    FS = "\t"
+    n = 0
+}
+
+FILENAME == map {
+    if (NF == 3) {
+        order[n++] = $1
+        run[$1] = $2
+        subject[$1] = $3
+    }
+    next
+}
+
+FILENAME == prof {
+    if (($0 !~ /^#/) && ($1 != "function")) {
+        calls[$1] = $2
+        inclusive[$1] = $4
+    }
+    next
+}
+
+FILENAME == boot {
+    if ($1 == "# cycles") {
+        boot_cycles = $2
+    }
+    next
+}
+
+FILENAME == syms {
+    if ((split($0, f, " ") == 4) && (f[3] ~ /^[TtWw]$/)) {
+        size[f[4]] = hex(f[2])
+    }
+    next
+}
+
+# gcc -fstack-usage: "file:line:col:function <tab> bytes <tab> qualifiers"
+{
+    fn = $1
+    sub(/.*:/, "", fn)
+    if (!(fn in stack) || ($2 + 0 > stack[fn])) {
+        stack[fn] = $2 + 0
+    }
+}
+
+END {
+    printf "benchmark\tcycles\tcode_bytes\tstack_bytes\n"
+
+    for (i = 0; i < n; i++) {
+        name = order[i]
+
+        if (name == "boot") {
+            cycles = (boot_cycles != "") ? boot_cycles : "?"
+        } else if (calls[run[name]] > 0) {
+            cycles = int(inclusive[run[name]] / calls[run[name]] + 0.5)
+        } else {
+            cycles = "?"
+        }
+
+        code = 0
+        frame = 0
+        count = split(subject[name], s, "+")
+        for (j = 1; j <= count; j++) {
+            if (!(s[j] in size)) {
+                code = "?"
+            } else if (code != "?") {
+                code += size[s[j]]
+            }
+
+            if (!(s[j] in stack)) {
+                frame = "?"
+            } else if ((frame != "?") && (stack[s[j]] > frame)) {
+                frame = stack[s[j]]
+            }
+        }
+
+        printf "%s\t%s\t%s\t%s\n", name, cycles, code, frame
+    }
+}
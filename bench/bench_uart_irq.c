@@ -0,0 +1,106 @@
+/******************************************************************************
+ * @file:    bench_uart_irq.c
+ * @purpose: Benchmarks for SERIAL_IRQHandler, the interrupt-driven UART0
+ *           driver used by example/uart/uart_echo_irq.c
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * The handler is called directly with NVIC delivery disabled; exception
+ * entry / exit (32 cycles at zero wait states) isn't included.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx/uart.h"
+#include "lpc11xx/serial.h"
+
+#include "bench.h"
+
+
+/* Defines ------------------------------------------------------------------*/
+
+/* Characters queued for the TX-empty benchmark */
+#define BENCH_TX_QUEUED       (8)
+
+#define BENCH_UART_BAUD       (115200)
+
+
+/* File Local Variables -----------------------------------------------------*/
+
+/* Same ring sizes as the echo example */
+static uint8_t bench_rx_buffer[64];
+static uint8_t bench_tx_buffer[128];
+
+static const SERIAL_Config_Type bench_serial_config = {
+    .Baud      = BENCH_UART_BAUD,
+    .RxTrigger = UART_RxFifoTrigger_1,
+    .RxBuffer  = bench_rx_buffer,
+    .RxSize    = sizeof(bench_rx_buffer),
+    .TxBuffer  = bench_tx_buffer,
+    .TxSize    = sizeof(bench_tx_buffer),
+};
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Shared UART0 setup: driver (re)started with empty rings,
+  *        interrupts off at the NVIC.
+  */
+static void bench_uart_irq_reset(void)
+{
+    while ((UART_GetLineStatus(UART0) & UART_LineStatus_TxEmpty) == 0);
+
+    SERIAL_Init(&bench_serial_config);
+    NVIC_DisableIRQ(UART0_IRQn);
+}
+
+/* One received character waiting */
+static void bench_uart_isr_rx_setup(void)
+{
+    bench_uart_irq_reset();
+
+    UART_EnableLoopback(UART0);
+    UART_Send(UART0, 'x');
+
+    while ((UART_GetLineStatus(UART0) & UART_LineStatus_RxData) == 0);
+}
+
+/* Transmitter empty with BENCH_TX_QUEUED characters in the ring */
+static void bench_uart_isr_tx_setup(void)
+{
+    static const uint8_t data[BENCH_TX_QUEUED] = {
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'
+    };
+
+
+    bench_uart_irq_reset();
+
+    UART_DisableLoopback(UART0);
+
+    SERIAL_Write(data, sizeof(data));
+}
+
+/* Separate run functions so the two cases are timed apart */
+BENCH_FUNCTION static void bench_uart0_isr_rx(void)
+{
+    SERIAL_IRQHandler();
+}
+
+BENCH_FUNCTION static void bench_uart0_isr_tx(void)
+{
+    SERIAL_IRQHandler();
+}
+
+
+/* Global Variables ---------------------------------------------------------*/
+
+const Bench_Type Bench_UARTIRQ[] = {
+    BENCH(uart0_isr_rx, bench_uart_isr_rx_setup, bench_uart0_isr_rx, SERIAL_IRQHandler),
+    BENCH(uart0_isr_tx, bench_uart_isr_tx_setup, bench_uart0_isr_tx, SERIAL_IRQHandler),
+};
+
+const unsigned int Bench_UARTIRQCount = sizeof(Bench_UARTIRQ) / sizeof(Bench_UARTIRQ[0]);
@@ -41,22 +41,30 @@
 #include <stdint.h>
 
 #include "lpc11xx.h"
+#include "lpc11xx/clock.h"
 #include "lpc11xx/adc.h"
 /*#include "lpc11xx/canopen_api.h"*/
 #include "lpc11xx/crp.h"
 #include "lpc11xx/ct16b.h"
 #include "lpc11xx/ct32b.h"
 #include "lpc11xx/flash.h"
+#include "lpc11xx/gate.h"
 #include "lpc11xx/gpio.h"
 #include "lpc11xx/i2c.h"
 #include "lpc11xx/iap.h"
+#include "lpc11xx/idle.h"
 #include "lpc11xx/iocon.h"
+#include "lpc11xx/irccal.h"
 #include "lpc11xx/isr_vector.h"
 #include "lpc11xx/pmu.h"
-/*#include "lpc11xx/power_api.h"*/
+#include "lpc11xx/power_api.h"
+#include "lpc11xx/retain.h"
+#include "lpc11xx/rs485.h"
+#include "lpc11xx/serial.h"
 #include "lpc11xx/ssp.h"
 #include "lpc11xx/syscon.h"
 #include "lpc11xx/uart.h"
+#include "lpc11xx/wake.h"
 #include "lpc11xx/wdt.h"
 #include "system_lpc11xx.h"
 
@@ -156,9 +164,6 @@ void init_uart(UART_Type *uart, uint32_t baud)
     uint32_t uart_divisor;
 
 
-    /* Determine the UART divisor for the given baud rate. */
-    uart_divisor = ((SystemAHBClock / 16) + (baud / 2)) / baud;
-
     /* This should always be true -- currently only support a single UART...
      */
     if (uart == UART0) {
@@ -176,6 +181,9 @@ void init_uart(UART_Type *uart, uint32_t baud)
         SYSCON_SetUART0ClockDivider(1);
     }
 
+    /* Determine the UART divisor for the given baud rate, from UART PCLK */
+    uart_divisor = ((CLOCK_GetFrequency(CLOCK_UART0) / 16) + (baud / 2)) / baud;
+
     /* Set the UART baud rate generator divisor to the value calculated */
     UART_SetDivisor(uart, uart_divisor);
 
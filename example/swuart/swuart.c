@@ -181,9 +181,9 @@ static inline void swuart_tx_load(void)
   *
   * Tries to get the next byte from the transmit buffer; if it's empty
   * then this will disable the timer match interrupts for software uart
-  * transmit.
+  * transmit.  Runs from RAM to keep bit timing jitter down.
   */
-void CT16B0_IRQHandler(void)
+LPC11XX_RAMFUNC void CT16B0_IRQHandler(void)
 {
     uint16_t it;
 
@@ -44,6 +44,8 @@
 #include <stdint.h>
 
 #include "lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/gate.h"
 #include "lpc11xx/syscon.h"
 #include "lpc11xx/gpio.h"
 #include "lpc11xx/iocon.h"
@@ -146,9 +148,6 @@ void init_uart(UART_Type *uart, uint32_t baud)
     uint32_t uart_divisor;
 
 
-    /* Determine the UART divisor for the given baud rate. */
-    uart_divisor = ((SystemAHBClock / 16) + (baud / 2)) / baud;
-
     /* This should always be true -- currently only support a single UART...
      */
     if (uart == UART0) {
@@ -159,13 +158,16 @@ void init_uart(UART_Type *uart, uint32_t baud)
         IOCON_SetPinConfig(IOCON_PinConfig_1_7_TXD0, IOCON_Mode_Normal);
         IOCON_SetPinConfig(IOCON_PinConfig_1_6_RXD0, IOCON_Mode_Normal);
 
-        /* Enable the clock line to the UART */
-        SYSCON_EnableAHBClockLines(SYSCON_AHBClockLine_UART0);
+        /* Turn the UART on (GATE_Release() turns it back off) */
+        GATE_Acquire(GATE_UART0);
 
         /* Set the UART input clock to run at AHB bus speed */
         SYSCON_SetUART0ClockDivider(1);
     }
 
+    /* Determine the UART divisor for the given baud rate, from UART PCLK */
+    uart_divisor = ((CLOCK_GetFrequency(CLOCK_UART0) / 16) + (baud / 2)) / baud;
+
     /* Set the UART baud rate generator divisor to the value calculated */
     UART_SetDivisor(uart, uart_divisor);
 
@@ -0,0 +1,329 @@
+/**************************************************************************//**
+ * @file     core_cm0.h
+ * @brief    Host-Side Stand-In for the CMSIS Cortex-M0 Core Peripheral Header
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * This file takes the place of the ARM CMSIS core_cm0.h when the library is
+ * built for the host (liblpc11xx-host.a).  It provides the same types,
+ * register maps and intrinsic functions that the library headers depend on,
+ * but the core registers (NVIC, SCB, SysTick) live in the simulated register
+ * file provided by lpc11xx_host.c, and the core intrinsics (interrupt masking,
+ * WFI, etc.) are routed to the host interrupt model.
+ *
+ * Only the subset of CMSIS used by the library and its examples is provided.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef HOST_CORE_CM0_H_
+#define HOST_CORE_CM0_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+
+/**
+  * @defgroup HOST_Core_CM0 Host Cortex-M0 Core Stand-In
+  * @ingroup  HOST_SimulationLayer
+  * @{
+  */
+
+/* Defines ------------------------------------------------------------------*/
+
+#define __CM0_CMSIS_VERSION_MAIN  (0x02)         /*!< CMSIS API version this stands in for */
+#define __CM0_CMSIS_VERSION_SUB   (0x10)
+#define __CORTEX_M                (0x00)         /*!< Cortex-M Core                        */
+
+#ifdef __cplusplus
+# define __I    volatile                         /*!< Defines 'read only' permissions      */
+#else
+# define __I    volatile const                   /*!< Defines 'read only' permissions      */
+#endif
+#define __O     volatile                         /*!< Defines 'write only' permissions     */
+#define __IO    volatile                         /*!< Defines 'read / write' permissions   */
+
+#define __ASM     __asm__                        /*!< asm keyword for GNU Compiler         */
+#define __INLINE  inline                         /*!< inline keyword for GNU Compiler      */
+
+/*! @brief Marker so code can tell it is being built against the host model */
+#define LPC11XX_HOST              (1)
+
+
+/* Core Register Maps -------------------------------------------------------*/
+
+/*! @brief Nested Vectored Interrupt Controller Register Map */
+typedef struct {
+    __IO    uint32_t    ISER[1];       /*!< Offset: 0x000  Interrupt Set Enable Register         */
+            uint32_t      RESERVED0[31];
+    __IO    uint32_t    ICER[1];       /*!< Offset: 0x080  Interrupt Clear Enable Register       */
+            uint32_t      RSERVED1[31];
+    __IO    uint32_t    ISPR[1];       /*!< Offset: 0x100  Interrupt Set Pending Register        */
+            uint32_t      RESERVED2[31];
+    __IO    uint32_t    ICPR[1];       /*!< Offset: 0x180  Interrupt Clear Pending Register      */
+            uint32_t      RESERVED3[31];
+            uint32_t      RESERVED4[64];
+    __IO    uint32_t    IP[8];         /*!< Offset: 0x300  Interrupt Priority Register           */
+} NVIC_Type;
+
+/*! @brief System Control Block Register Map */
+typedef struct {
+    __I     uint32_t    CPUID;         /*!< Offset: 0x000  CPU ID Base Register                  */
+    __IO    uint32_t    ICSR;          /*!< Offset: 0x004  Interrupt Control State Register      */
+            uint32_t      RESERVED0;
+    __IO    uint32_t    AIRCR;         /*!< Offset: 0x00C  App. Interrupt / Reset Control Reg.   */
+    __IO    uint32_t    SCR;           /*!< Offset: 0x010  System Control Register               */
+    __IO    uint32_t    CCR;           /*!< Offset: 0x014  Configuration Control Register        */
+            uint32_t      RESERVED1;
+    __IO    uint32_t    SHP[2];        /*!< Offset: 0x01C  System Handlers Priority Registers    */
+    __IO    uint32_t    SHCSR;         /*!< Offset: 0x024  System Handler Control and State Reg. */
+} SCB_Type;
+
+/*! @brief SysTick Timer Register Map */
+typedef struct {
+    __IO    uint32_t    CTRL;          /*!< Offset: 0x000  SysTick Control and Status Register   */
+    __IO    uint32_t    LOAD;          /*!< Offset: 0x004  SysTick Reload Value Register         */
+    __IO    uint32_t    VAL;           /*!< Offset: 0x008  SysTick Current Value Register        */
+    __I     uint32_t    CALIB;         /*!< Offset: 0x00C  SysTick Calibration Register          */
+} SysTick_Type;
+
+#define SCB_ICSR_PENDSVSET_Msk         (1UL << 28)         /*!< Set PendSV Pending               */
+#define SCB_ICSR_PENDSVCLR_Msk         (1UL << 27)         /*!< Clear PendSV Pending             */
+#define SCB_ICSR_PENDSTSET_Msk         (1UL << 26)         /*!< Set SysTick Pending              */
+#define SCB_ICSR_PENDSTCLR_Msk         (1UL << 25)         /*!< Clear SysTick Pending            */
+
+#define SCB_AIRCR_VECTKEY_Pos          16                  /*!< AIRCR Register Key Position      */
+#define SCB_AIRCR_VECTKEY_Msk          (0xffffUL << 16)    /*!< AIRCR Register Key Mask          */
+#define SCB_AIRCR_SYSRESETREQ_Msk      (1UL << 2)          /*!< System Reset Request             */
+
+#define SCB_SCR_SEVONPEND_Msk          (1UL << 4)          /*!< Send Event on Pending IRQ        */
+#define SCB_SCR_SLEEPDEEP_Msk          (1UL << 2)          /*!< Deep Sleep on WFI / WFE          */
+#define SCB_SCR_SLEEPONEXIT_Msk        (1UL << 1)          /*!< Sleep on Exit from ISR           */
+
+#define SysTick_CTRL_COUNTFLAG_Msk     (1UL << 16)         /*!< Counted to 0 since last read     */
+#define SysTick_CTRL_CLKSOURCE_Msk     (1UL << 2)          /*!< Clock Source (1 = core clock)    */
+#define SysTick_CTRL_TICKINT_Msk       (1UL << 1)          /*!< Interrupt on count to 0          */
+#define SysTick_CTRL_ENABLE_Msk        (1UL << 0)          /*!< Counter Enable                   */
+#define SysTick_LOAD_RELOAD_Msk        (0x00ffffffUL)      /*!< Usable bits in LOAD              */
+
+#define SCS_BASE            (0xe000e000UL)                 /*!< System Control Space Base        */
+#define SysTick_BASE        (SCS_BASE +  0x0010UL)         /*!< SysTick Base Address             */
+#define NVIC_BASE           (SCS_BASE +  0x0100UL)         /*!< NVIC Base Address                */
+#define SCB_BASE            (SCS_BASE +  0x0d00UL)         /*!< System Control Block Base        */
+
+#define SCB                 ((SCB_Type *)SCB_BASE)         /*!< SCB configuration struct         */
+#define SysTick             ((SysTick_Type *)SysTick_BASE) /*!< SysTick configuration struct     */
+#define NVIC                ((NVIC_Type *)NVIC_BASE)       /*!< NVIC configuration struct        */
+
+
+/* Host Interrupt Model Hooks -----------------------------------------------*/
+
+/* Implemented in lpc11xx_host.c; see lpc11xx_host.h for the harness side. */
+extern uint32_t HOST_GetPRIMASK(void);
+extern void     HOST_SetPRIMASK(uint32_t primask);
+extern void     HOST_WaitForInterrupt(void);
+
+/* Every translation unit that touches a peripheral pulls in the register
+ *  file (and its constructor) so the *_BASE addresses are always mapped.
+ */
+extern const int HOST_RegisterFilePresent;
+static const int * const HOST_RegisterFileRef __attribute__((used)) =
+    &HOST_RegisterFilePresent;
+
+
+/* Core Intrinsics ----------------------------------------------------------*/
+
+/** @brief Enable IRQ interrupts (clear PRIMASK); pending interrupts are taken.
+  */
+__INLINE static void __enable_irq(void)           { HOST_SetPRIMASK(0); }
+
+/** @brief Disable IRQ interrupts (set PRIMASK).
+  */
+__INLINE static void __disable_irq(void)          { HOST_SetPRIMASK(1); }
+
+/** @brief Get the current PRIMASK value.
+  * @return                  1 if interrupts are masked, else 0.
+  */
+__INLINE static uint32_t __get_PRIMASK(void)      { return HOST_GetPRIMASK(); }
+
+/** @brief Set PRIMASK; interrupts pending when unmasked are taken.
+  * @param[in]  priMask      New PRIMASK value.
+  */
+__INLINE static void __set_PRIMASK(uint32_t priMask) { HOST_SetPRIMASK(priMask); }
+
+/** @brief Wait for interrupt; services pending interrupts in the model.
+  */
+__INLINE static void __WFI(void)                  { HOST_WaitForInterrupt(); }
+
+/** @brief Wait for event; treated as WFI by the model.
+  */
+__INLINE static void __WFE(void)                  { HOST_WaitForInterrupt(); }
+
+__INLINE static void __NOP(void)                  { __asm__ __volatile__ ("nop"); }
+__INLINE static void __SEV(void)                  { }
+__INLINE static void __ISB(void)                  { __asm__ __volatile__ ("" ::: "memory"); }
+__INLINE static void __DSB(void)                  { __asm__ __volatile__ ("" ::: "memory"); }
+__INLINE static void __DMB(void)                  { __asm__ __volatile__ ("" ::: "memory"); }
+
+__INLINE static uint32_t __REV(uint32_t value)    { return __builtin_bswap32(value); }
+
+__INLINE static uint32_t __REV16(uint32_t value)
+{
+    return ((value & 0xff00ff00UL) >> 8) | ((value & 0x00ff00ffUL) << 8);
+}
+
+__INLINE static int32_t __REVSH(int32_t value)
+{
+    return (int16_t)(((value & 0xff00) >> 8) | ((value & 0x00ff) << 8));
+}
+
+
+/* NVIC / SysTick Functions -------------------------------------------------*/
+
+/* Byte index / shift of an interrupt's priority in IP[] / SHP[] */
+#define _BIT_SHIFT(IRQn)         ((((uint32_t)(IRQn)) & 0x03) * 8)
+#define _SHP_IDX(IRQn)           ((((uint32_t)(IRQn) & 0x0f) - 8) >> 2)
+#define _IP_IDX(IRQn)            ((uint32_t)(IRQn) >> 2)
+
+/** @brief Enable an external interrupt.
+  * @param[in]  IRQn         Interrupt number.
+  */
+__INLINE static void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISER[0] = (1UL << ((uint32_t)(IRQn) & 0x1f));
+}
+
+/** @brief Disable an external interrupt.
+  * @param[in]  IRQn         Interrupt number.
+  */
+__INLINE static void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    NVIC->ICER[0] = (1UL << ((uint32_t)(IRQn) & 0x1f));
+}
+
+/** @brief Get the pending state of an external interrupt.
+  * @param[in]  IRQn         Interrupt number.
+  * @return                  1 if pending, else 0.
+  */
+__INLINE static uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    return (NVIC->ISPR[0] & (1UL << ((uint32_t)(IRQn) & 0x1f))) ? 1 : 0;
+}
+
+/** @brief Set an external interrupt pending.
+  * @param[in]  IRQn         Interrupt number.
+  */
+__INLINE static void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISPR[0] = (1UL << ((uint32_t)(IRQn) & 0x1f));
+}
+
+/** @brief Clear the pending state of an external interrupt.
+  * @param[in]  IRQn         Interrupt number.
+  */
+__INLINE static void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    NVIC->ICPR[0] = (1UL << ((uint32_t)(IRQn) & 0x1f));
+}
+
+/** @brief Set the priority of an interrupt.
+  * @param[in]  IRQn         Interrupt number.
+  * @param[in]  priority     Priority (0 = highest).
+  */
+__INLINE static void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    if ((int32_t)IRQn < 0) {
+        SCB->SHP[_SHP_IDX(IRQn)] = (SCB->SHP[_SHP_IDX(IRQn)] & ~(0xffUL << _BIT_SHIFT(IRQn)))
+            | (((priority << (8 - __NVIC_PRIO_BITS)) & 0xff) << _BIT_SHIFT(IRQn));
+    } else {
+        NVIC->IP[_IP_IDX(IRQn)] = (NVIC->IP[_IP_IDX(IRQn)] & ~(0xffUL << _BIT_SHIFT(IRQn)))
+            | (((priority << (8 - __NVIC_PRIO_BITS)) & 0xff) << _BIT_SHIFT(IRQn));
+    }
+}
+
+/** @brief Get the priority of an interrupt.
+  * @param[in]  IRQn         Interrupt number.
+  * @return                  Priority (0 = highest).
+  */
+__INLINE static uint32_t NVIC_GetPriority(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn < 0) {
+        return ((SCB->SHP[_SHP_IDX(IRQn)] >> _BIT_SHIFT(IRQn)) & 0xff) >> (8 - __NVIC_PRIO_BITS);
+    } else {
+        return ((NVIC->IP[_IP_IDX(IRQn)] >> _BIT_SHIFT(IRQn)) & 0xff) >> (8 - __NVIC_PRIO_BITS);
+    }
+}
+
+/** @brief Request a system reset.
+  */
+__INLINE static void NVIC_SystemReset(void)
+{
+    SCB->AIRCR = (0x5faUL << SCB_AIRCR_VECTKEY_Pos) | SCB_AIRCR_SYSRESETREQ_Msk;
+}
+
+/** @brief Configure SysTick for a periodic interrupt.
+  * @param[in]  ticks        Number of core clocks between interrupts.
+  * @return                  0 on success, 1 if ticks is out of range.
+  */
+__INLINE static uint32_t SysTick_Config(uint32_t ticks)
+{
+    if (ticks - 1 > SysTick_LOAD_RELOAD_Msk) {
+        return 1;
+    }
+
+    SysTick->LOAD = (ticks & SysTick_LOAD_RELOAD_Msk) - 1;
+    NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk
+                    | SysTick_CTRL_ENABLE_Msk;
+
+    return 0;
+}
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef HOST_CORE_CM0_H_ */
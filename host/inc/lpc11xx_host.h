@@ -0,0 +1,416 @@
+/**************************************************************************//**
+ * @file     lpc11xx_host.h
+ * @brief    Host-Side Simulated Peripheral Register File for the LPC11xx
+ *           Device Library.
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * liblpc11xx-host.a lets the library headers & sources (and code built on
+ * them) run as a normal Linux process.  The LPC11xx peripheral address ranges
+ * (APB at 0x40000000, AHB GPIO at 0x50000000 and the Cortex-M0 System Control
+ * Space at 0xe000e000) are mapped into the process at their real addresses,
+ * so the *_BASE definitions in lpc11xx.h resolve unchanged.
+ *
+ * Registers without side effects (SYSCON, IOCON, PMU, FLASH, ...) are plain
+ * memory, initialized to their reset values.  Peripherals whose registers do
+ * have side effects are backed by models:
+ *
+ * - UART0: 16-byte RX/TX FIFOs behind RBR/THR, DLAB, IIR priority encoding,
+ *   LSR, RX trigger levels, character time-out and auto RTS/CTS.
+ * - GPIO0-3: SELDATA address masking, DIR, edge/level interrupt detection and
+ *   write-1-to-clear IC.
+ * - WDT: MOD set-only bits, the 0xAA/0x55 FEED sequence (including feed
+ *   errors) and time-out reset / interrupt.
+ * - SSP0/1: 8-frame FIFOs, loopback or harness slave device, RIS/MIS/ICR.
+ * - CT16B0/1 & CT32B0/1: prescaler, match interrupt/reset/stop, capture and
+ *   write-1-to-clear IR.
+ * - NVIC, SCB & SysTick: enable/pending set/clear registers, priorities,
+ *   SysTick reload/COUNTFLAG and reset requests.
+ *
+ * Modelled register pages are kept inaccessible; each access faults into the
+ * model, which supplies (or consumes) the value for that one instruction.
+ * This is currently implemented for x86 / x86-64 Linux hosts.  On other
+ * hosts all registers are plain memory (HOST_TrapsAvailable() returns 0).
+ * A model can also be switched off with HOST_EnableModel(base, 0) when raw
+ * memory speed matters more than side effects.
+ *
+ * The models are exercised through the library accessors by the unit tests
+ * in host/test; "make check" builds & runs them.
+ *
+ * Interrupts are taken synchronously: when a register access, a harness call
+ * or __enable_irq() leaves an enabled interrupt pending above the current
+ * execution priority, the corresponding handler (UART0_IRQHandler, etc.) is
+ * called before control returns.  Handlers not defined by the application
+ * default to a stub that reports the interrupt and disables it.
+ *
+ * @note
+ * The trap mechanism uses SIGSEGV / SIGTRAP, so debugging a host build under
+ * gdb needs "handle SIGSEGV nostop noprint" and "handle SIGTRAP nostop".
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef LPC11XX_HOST_H_
+#define LPC11XX_HOST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+
+
+/**
+  * @defgroup HOST_SimulationLayer Host Simulation Layer
+  * @{
+  */
+
+/* Types & Type-Related Definitions -----------------------------------------*/
+
+/** @defgroup HOST_Types Host Simulation Types and Type-Related Definitions
+  * @{
+  */
+
+/*! @brief Exit status used when a reset is requested & no reset hook is set */
+#define HOST_RESET_EXIT_STATUS   (75)
+
+/*! @brief HOST_GetActiveInterrupt() value when no handler is executing */
+#define HOST_THREAD_MODE         (-16)
+
+/*! @brief Reset sources reported to the reset hook (match SYSRESSTAT bits) */
+typedef enum {
+    HOST_ResetSource_WDT       = (1 << 2),   /*!< Watchdog time-out / feed error */
+    HOST_ResetSource_System    = (1 << 4),   /*!< SYSRESETREQ written to AIRCR   */
+} HOST_ResetSource_Type;
+
+/*! @brief Peripheral model descriptor.
+  *
+  * Offsets passed to the access functions are byte offsets from Base, always
+  * word aligned.  Read may have side effects (e.g. popping the RX FIFO);
+  * Peek must not.
+  */
+typedef struct HOST_Model {
+    const char  *Name;                                   /*!< Peripheral name      */
+    uint32_t     Base;                                   /*!< Register block base  */
+    uint32_t     Size;                                   /*!< Register block size  */
+    void        *State;                                  /*!< Model private state  */
+    void       (*Reset)(struct HOST_Model *model);       /*!< Return to reset state */
+    uint32_t   (*Read)(struct HOST_Model *model, uint32_t offset);
+    uint32_t   (*Peek)(struct HOST_Model *model, uint32_t offset);
+    void       (*Write)(struct HOST_Model *model, uint32_t offset, uint32_t value);
+    void       (*Advance)(struct HOST_Model *model, uint32_t clocks);
+    int          Enabled;                                /*!< Accesses are trapped */
+} HOST_Model_Type;
+
+/** @} */
+
+
+/* Exported Variables -------------------------------------------------------*/
+
+/** @defgroup HOST_Variables Host Simulation Variables
+  * @{
+  */
+
+/*! @brief NULL-terminated list of all peripheral models */
+extern HOST_Model_Type * const HOST_Models[];
+
+/** @} */
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @defgroup HOST_Functions Host Simulation Functions
+  * @{
+  */
+
+/** @brief Map the register file & install the access traps.
+  *
+  * Called automatically before main(); safe to call more than once.
+  */
+extern void HOST_Init(void);
+
+/** @brief Return every register & model (and the interrupt state) to reset.
+  */
+extern void HOST_Reset(void);
+
+/** @brief Test whether modelled registers are trapped on this host.
+  * @return                  1 if register side effects are modelled, else 0.
+  */
+extern int HOST_TrapsAvailable(void);
+
+/** @brief Enable or disable the model for a peripheral.
+  * @param[in]  base         Base address of the peripheral (e.g. UART0_BASE).
+  * @param[in]  enable       0 to make the registers plain memory, else 1.
+  */
+extern void HOST_EnableModel(uint32_t base, int enable);
+
+/** @brief Find the model covering an address.
+  * @param[in]  addr         Address in the peripheral space.
+  * @return                  The model, or (null) if the address is plain.
+  */
+extern HOST_Model_Type *HOST_FindModel(uint32_t addr);
+
+/** @brief Read from the peripheral space as a bus master would.
+  * @param[in]  addr         Address to read.
+  * @param[in]  size         Access size in bytes (1, 2 or 4).
+  * @return                  The value read (with any read side effects).
+  *
+  * For use by simulators that do not execute accesses natively.
+  */
+extern uint32_t HOST_BusRead(uint32_t addr, unsigned int size);
+
+/** @brief Write to the peripheral space as a bus master would.
+  * @param[in]  addr         Address to write.
+  * @param[in]  value        Value to write.
+  * @param[in]  size         Access size in bytes (1, 2 or 4).
+  */
+extern void HOST_BusWrite(uint32_t addr, uint32_t value, unsigned int size);
+
+/** @brief Advance simulated time for timers, SysTick and the watchdog.
+  * @param[in]  clocks       Number of system clocks to advance.
+  *
+  * Peripheral clocks are assumed to run at the system clock rate.
+  * Interrupts are serviced once, at the end of the interval, so events
+  * recurring within one call coalesce into a single pending interrupt (as
+  * they would on a CPU busy with interrupts masked).  Advance in steps no
+  * longer than the shortest period of interest to see every event.
+  */
+extern void HOST_AdvanceClock(uint32_t clocks);
+
+/** @brief Take any pending, enabled interrupts that are above the current
+  *        execution priority.
+  */
+extern void HOST_ServiceInterrupts(void);
+
+/** @brief Drive the (level) interrupt request line of a peripheral.
+  * @param[in]  irq          Interrupt number (SysTick_IRQn ... GPIO0_IRQn).
+  * @param[in]  asserted     1 if the peripheral is requesting service.
+  */
+extern void HOST_SetIRQLine(IRQn_Type irq, int asserted);
+
+/** @brief Set the handler called for an interrupt.
+  * @param[in]  irq          Interrupt number (SVC_IRQn ... GPIO0_IRQn).
+  * @param[in]  handler      Handler to call, or (null) to restore the default.
+  */
+extern void HOST_SetVector(IRQn_Type irq, void (*handler)(void));
+
+/** @brief Get the number of times an interrupt handler has been entered.
+  * @param[in]  irq          Interrupt number (SVC_IRQn ... GPIO0_IRQn).
+  * @return                  The number of handler entries since HOST_Reset().
+  */
+extern uint32_t HOST_GetInterruptCount(IRQn_Type irq);
+
+/** @brief Get the interrupt whose handler is currently executing.
+  * @return                  The active interrupt number, or HOST_THREAD_MODE.
+  */
+extern int HOST_GetActiveInterrupt(void);
+
+/** @brief Set the function called when WFI / WFE finds nothing pending.
+  * @param[in]  hook         The idle hook (e.g. to feed simulated input), or (null).
+  *
+  * Without a hook WFI just returns.
+  */
+extern void HOST_SetIdleHook(void (*hook)(void));
+
+/** @brief Set the function called on a system or watchdog reset.
+  * @param[in]  hook         The reset hook, or (null) to exit the process.
+  *
+  * The hook is called in signal context; it may siglongjmp() back into the
+  * harness.  If it returns, execution continues after the resetting access.
+  */
+extern void HOST_SetResetHook(void (*hook)(HOST_ResetSource_Type source));
+
+
+/* External CPU (instruction set simulator) interface -----------------------*/
+
+/** @brief Hand exception entry over to an external CPU model.
+  * @param[in]  external     1 if an external CPU takes exceptions, 0 to call
+  *                          the host handlers directly (default).
+  *
+  * With an external CPU, interrupts are never dispatched to host handlers;
+  * the CPU model polls HOST_PendingException() instead.
+  */
+extern void HOST_SetExternalCPU(int external);
+
+/** @brief Get the exception that would preempt execution now.
+  * @param[in]  ignore_primask  1 to ignore PRIMASK (the WFI wake-up condition).
+  * @return                  The exception's IRQ number, or HOST_THREAD_MODE.
+  */
+extern int HOST_PendingException(int ignore_primask);
+
+/** @brief Test whether any interrupt source could ever become pending.
+  * @return                  0 if nothing is enabled (waiting would deadlock).
+  */
+extern int HOST_InterruptsEnabled(void);
+
+/** @brief Mark an exception as entered (clears pending, raises priority).
+  * @param[in]  irq          Exception being entered (HardFault_IRQn ... GPIO0_IRQn).
+  */
+extern void HOST_EnterException(int irq);
+
+/** @brief Return the execution priority to that of a preempted exception.
+  * @param[in]  irq          Exception returned to, or HOST_THREAD_MODE.
+  */
+extern void HOST_ExitException(int irq);
+
+/* UART0 harness ------------------------------------------------------------*/
+
+/** @brief Deliver characters to a UART's receiver.
+  * @param[in]  uart         The UART (UART0).
+  * @param[in]  data         Characters to receive.
+  * @param[in]  len          Number of characters.
+  * @return                  Characters accepted before the RX FIFO overran.
+  */
+extern unsigned int HOST_UARTReceive(UART_Type *uart, const uint8_t *data, unsigned int len);
+
+/** @brief Signal that the receive line has been idle for the time-out period.
+  * @param[in]  uart         The UART (UART0).
+  *
+  * Raises a character time-out interrupt if data remains in the RX FIFO.
+  */
+extern void HOST_UARTRxIdle(UART_Type *uart);
+
+/** @brief Collect characters the UART has put on the wire.
+  * @param[in]  uart         The UART (UART0).
+  * @param[out] buf          Buffer to fill.
+  * @param[in]  max          Size of buf.
+  * @return                  The number of characters copied.
+  */
+extern unsigned int HOST_UARTTransmitted(UART_Type *uart, uint8_t *buf, unsigned int max);
+
+/** @brief Choose whether the transmitter drains instantly or on demand.
+  * @param[in]  uart         The UART (UART0).
+  * @param[in]  hold         0: characters leave the TX FIFO immediately;
+  *                          1: they leave only via HOST_UARTShiftOut().
+  */
+extern void HOST_UARTSetTxHold(UART_Type *uart, int hold);
+
+/** @brief Shift characters out of a held transmitter.
+  * @param[in]  uart         The UART (UART0).
+  * @param[in]  count        Maximum number of character times to advance.
+  * @return                  The number of characters that left the TX FIFO.
+  */
+extern unsigned int HOST_UARTShiftOut(UART_Type *uart, unsigned int count);
+
+/** @brief Set the level of the (active-low) CTS input.
+  * @param[in]  uart         The UART (UART0).
+  * @param[in]  asserted     1 if the peer is ready to receive.
+  */
+extern void HOST_UARTSetCTS(UART_Type *uart, int asserted);
+
+/** @brief Get the level of the (active-low) RTS output.
+  * @param[in]  uart         The UART (UART0).
+  * @return                  1 if RTS is asserted (we are ready to receive).
+  */
+extern int HOST_UARTGetRTS(UART_Type *uart);
+
+/** @brief Get the number of characters lost to RX FIFO overrun.
+  * @param[in]  uart         The UART (UART0).
+  * @return                  The number of characters lost since reset.
+  */
+extern uint32_t HOST_UARTGetOverruns(UART_Type *uart);
+
+
+/* GPIO harness -------------------------------------------------------------*/
+
+/** @brief Drive external levels onto GPIO pins.
+  * @param[in]  gpio         The GPIO port (GPIO0 - GPIO3).
+  * @param[in]  mask         Pins to drive.
+  * @param[in]  levels       New levels for the pins in mask.
+  *
+  * Only pins configured as inputs see the new level; edges are detected
+  * according to IS / IBE / IEV.
+  */
+extern void HOST_GPIOSetInputs(GPIO_Type *gpio, uint32_t mask, uint32_t levels);
+
+/** @brief Get the levels on a GPIO port's pins.
+  * @param[in]  gpio         The GPIO port (GPIO0 - GPIO3).
+  * @return                  Output latch for output pins, external level for inputs.
+  */
+extern uint32_t HOST_GPIOGetPins(GPIO_Type *gpio);
+
+
+/* WDT harness --------------------------------------------------------------*/
+
+/** @brief Get the number of feed sequence errors seen by the watchdog.
+  * @return                  The number of feed errors since reset.
+  */
+extern uint32_t HOST_WDTGetFeedErrors(void);
+
+/** @brief Get the number of valid feeds seen by the watchdog.
+  * @return                  The number of completed feed sequences since reset.
+  */
+extern uint32_t HOST_WDTGetFeeds(void);
+
+
+/* SSP harness --------------------------------------------------------------*/
+
+/** @brief Attach a simulated slave device to an SSP.
+  * @param[in]  ssp          The SSP (SSP0 or SSP1).
+  * @param[in]  xfer         Called per frame with MOSI data; returns MISO data.
+  *                          (null) returns all-ones frames (idle MISO).
+  */
+extern void HOST_SSPSetSlave(SSP_Type *ssp, uint16_t (*xfer)(uint16_t mosi));
+
+/** @brief Get the number of frames an SSP has shifted.
+  * @param[in]  ssp          The SSP (SSP0 or SSP1).
+  * @return                  The number of frames since reset.
+  */
+extern uint32_t HOST_SSPGetFrameCount(SSP_Type *ssp);
+
+
+/* Counter / Timer harness --------------------------------------------------*/
+
+/** @brief Present an edge on a timer's capture input.
+  * @param[in]  timer        The timer (CT16B0, CT16B1, CT32B0 or CT32B1).
+  * @param[in]  rising       1 for a rising edge, 0 for falling.
+  */
+extern void HOST_CTCaptureEdge(void *timer, int rising);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef LPC11XX_HOST_H_ */
@@ -0,0 +1,985 @@
+/******************************************************************************
+ * @file:    lpc11xx_host.c
+ * @purpose: Simulated LPC11xx register file, access traps & interrupt model
+ *           for host (non-target) builds of the device library.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_host_priv.h"
+#include "lpc11xx/isr_vector.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Trapping relies on the x86 single-step flag & page-fault error code */
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+# define HOST_HAVE_TRAPS 1
+# define HOST_REG_ERR    REG_ERR
+# define HOST_REG_FLAGS  REG_EFL
+# define HOST_X86_TF     (1 << 8)
+# define HOST_PF_WRITE   (1 << 1)
+#else
+# define HOST_HAVE_TRAPS 0
+#endif
+
+/* Nested trapped accesses (ISRs taken from the trap handler) */
+#define HOST_MAX_PENDING    (32)
+
+/* Handler entries in a single HOST_ServiceInterrupts() call before the
+ *  interrupt is considered stuck (a handler not clearing its source).
+ */
+#define HOST_MAX_ISR_LOOPS  (1000000UL)
+
+/* Exception numbers (index into vector table) */
+#define HOST_NUM_VECTORS    (48)
+#define HOST_VECTOR(irq)    ((int)(irq) + 16)
+
+/* Execution priority when no handler is running */
+#define HOST_THREAD_PRIORITY (0x100)
+
+
+/*! @brief Address ranges making up the register file */
+typedef struct {
+    uint32_t Base;
+    uint32_t Size;
+} HOST_Region_Type;
+
+static const HOST_Region_Type HostRegions[] = {
+    { 0x40000000UL, 0x00080000UL },   /* APB peripherals         */
+    { 0x50000000UL, 0x00040000UL },   /* AHB GPIO                */
+    { 0xe000e000UL, 0x00001000UL },   /* Cortex-M0 SCS           */
+};
+
+/*! @brief Reset values for registers that are not zero out of reset */
+typedef struct {
+    uint32_t Addr;
+    uint32_t Value;
+} HOST_ResetValue_Type;
+
+static const HOST_ResetValue_Type HostResetValues[] = {
+    { SYSCON_BASE + 0x000, 0x00000002UL },   /* SYSMEMREMAP (flash)        */
+    { SYSCON_BASE + 0x00c, 0x00000001UL },   /* SYSPLLSTAT (locks at once) */
+    { SYSCON_BASE + 0x024, 0x000000a0UL },   /* WDTOSCCTRL                 */
+    { SYSCON_BASE + 0x028, 0x00000080UL },   /* IRCCTRL                    */
+    { SYSCON_BASE + 0x030, 0x00000001UL },   /* SYSRESSTAT (power-on)      */
+    { SYSCON_BASE + 0x078, 0x00000001UL },   /* SYSAHBCLKDIV               */
+    { SYSCON_BASE + 0x080, 0x0000085fUL },   /* SYSAHBCLKCTRL              */
+    { SYSCON_BASE + 0x154, 0x00000004UL },   /* SYSTCKCAL                  */
+    { SYSCON_BASE + 0x234, 0x0000edf0UL },   /* PDAWAKECFG                 */
+    { SYSCON_BASE + 0x238, 0x0000edf0UL },   /* PDRUNCFG                   */
+    { SYSCON_BASE + 0x3f4, 0x0444102bUL },   /* DEVICE_ID (LPC1114/301)    */
+    { FLASH_BASE  + 0x010, 0x00000002UL },   /* FLASHCFG                   */
+    { FLASH_BASE  + 0xfe0, 0x00000004UL },   /* FMSTAT (signature done)    */
+};
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* Set up once the register file has been mapped */
+static int HostInitialized;
+
+/* One entry per trapped access whose instruction hasn't completed yet */
+static struct {
+    HOST_Model_Type *Model;
+    uint32_t         Offset;
+    uint8_t          Write;
+    uint8_t          First;
+} HostPending[HOST_MAX_PENDING];
+static volatile int HostPendingCount;
+
+/* Depth of trap handler nesting (ISRs are not taken while inside a model) */
+static volatile int HostInModel;
+
+/* Exceptions are taken by an external CPU model, not host handlers */
+static int HostExternalCPU;
+
+/* Interrupt state */
+static uint32_t HostPRIMASK;
+static uint32_t HostISER;
+static uint32_t HostISPR;
+static uint32_t HostIRQLines;
+static uint32_t HostIP[8];
+static uint32_t HostSHP[2];
+static uint32_t HostSysPending;      /* PendSV / SysTick pending bits */
+static uint32_t HostSCR;
+static int      HostActive = HOST_THREAD_MODE;
+static int      HostActivePriority = HOST_THREAD_PRIORITY;
+static uint32_t HostInterruptCounts[HOST_NUM_VECTORS];
+
+/* SysTick state */
+static uint32_t HostSysTickCTRL;
+static uint32_t HostSysTickLOAD;
+static uint32_t HostSysTickVAL;
+
+static void (*HostVectors[HOST_NUM_VECTORS])(void);
+static void (*HostIdleHook)(void);
+static void (*HostResetHook)(HOST_ResetSource_Type source);
+
+
+/* Global Variables ---------------------------------------------------------*/
+
+/*! @brief Referenced from core_cm0.h so this object is always linked in */
+const int HOST_RegisterFilePresent = 1;
+
+/*! @brief All peripheral models */
+HOST_Model_Type * const HOST_Models[] = {
+    &HOST_SCSModel,
+    &HOST_UART0Model,
+    &HOST_WDTModel,
+    &HOST_SSP0Model,
+    &HOST_SSP1Model,
+    &HOST_CT16B0Model,
+    &HOST_CT16B1Model,
+    &HOST_CT32B0Model,
+    &HOST_CT32B1Model,
+    &HOST_GPIO0Model,
+    &HOST_GPIO1Model,
+    &HOST_GPIO2Model,
+    &HOST_GPIO3Model,
+    0
+};
+
+
+/* Default Handlers ---------------------------------------------------------*/
+
+/** @brief Handler for interrupts the application does not handle.
+  *
+  * Reports the interrupt & disables it so it can't livelock the harness.
+  */
+static void HOST_DefaultHandler(void)
+{
+    fprintf(stderr, "lpc11xx-host: unhandled exception %d, disabling\n", HostActive);
+
+    if (HostActive >= 0) {
+        HostISER &= ~(1UL << HostActive);
+    } else if (HostActive == SysTick_IRQn) {
+        HostSysTickCTRL &= ~SysTick_CTRL_TICKINT_Msk;
+    }
+}
+
+#define HOST_WEAK_HANDLER(name) \
+    void name(void) __attribute__((weak, alias("HOST_DefaultHandler")))
+
+HOST_WEAK_HANDLER(HardFault_Handler);
+HOST_WEAK_HANDLER(SVC_Handler);
+HOST_WEAK_HANDLER(PendSV_Handler);
+HOST_WEAK_HANDLER(SysTick_Handler);
+HOST_WEAK_HANDLER(WAKEUP0_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP1_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP2_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP3_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP4_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP5_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP6_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP7_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP8_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP9_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP10_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP11_IRQHandler);
+HOST_WEAK_HANDLER(WAKEUP12_IRQHandler);
+HOST_WEAK_HANDLER(SSP1_IRQHandler);
+HOST_WEAK_HANDLER(I2C0_IRQHandler);
+HOST_WEAK_HANDLER(CT16B0_IRQHandler);
+HOST_WEAK_HANDLER(CT16B1_IRQHandler);
+HOST_WEAK_HANDLER(CT32B0_IRQHandler);
+HOST_WEAK_HANDLER(CT32B1_IRQHandler);
+HOST_WEAK_HANDLER(SSP0_IRQHandler);
+HOST_WEAK_HANDLER(UART0_IRQHandler);
+HOST_WEAK_HANDLER(ADC0_IRQHandler);
+HOST_WEAK_HANDLER(WDT_IRQHandler);
+HOST_WEAK_HANDLER(BOD_IRQHandler);
+HOST_WEAK_HANDLER(GPIO3_IRQHandler);
+HOST_WEAK_HANDLER(GPIO2_IRQHandler);
+HOST_WEAK_HANDLER(GPIO1_IRQHandler);
+HOST_WEAK_HANDLER(GPIO0_IRQHandler);
+
+/*! @brief Vector table used when no runtime vector has been set */
+static void (* const HostDefaultVectors[HOST_NUM_VECTORS])(void) = {
+    [HOST_VECTOR(HardFault_IRQn)] = HardFault_Handler,
+    [HOST_VECTOR(SVC_IRQn)]       = SVC_Handler,
+    [HOST_VECTOR(PendSV_IRQn)]    = PendSV_Handler,
+    [HOST_VECTOR(SysTick_IRQn)]   = SysTick_Handler,
+    [HOST_VECTOR(WAKEUP0_IRQn)]   = WAKEUP0_IRQHandler,
+    [HOST_VECTOR(WAKEUP1_IRQn)]   = WAKEUP1_IRQHandler,
+    [HOST_VECTOR(WAKEUP2_IRQn)]   = WAKEUP2_IRQHandler,
+    [HOST_VECTOR(WAKEUP3_IRQn)]   = WAKEUP3_IRQHandler,
+    [HOST_VECTOR(WAKEUP4_IRQn)]   = WAKEUP4_IRQHandler,
+    [HOST_VECTOR(WAKEUP5_IRQn)]   = WAKEUP5_IRQHandler,
+    [HOST_VECTOR(WAKEUP6_IRQn)]   = WAKEUP6_IRQHandler,
+    [HOST_VECTOR(WAKEUP7_IRQn)]   = WAKEUP7_IRQHandler,
+    [HOST_VECTOR(WAKEUP8_IRQn)]   = WAKEUP8_IRQHandler,
+    [HOST_VECTOR(WAKEUP9_IRQn)]   = WAKEUP9_IRQHandler,
+    [HOST_VECTOR(WAKEUP10_IRQn)]  = WAKEUP10_IRQHandler,
+    [HOST_VECTOR(WAKEUP11_IRQn)]  = WAKEUP11_IRQHandler,
+    [HOST_VECTOR(WAKEUP12_IRQn)]  = WAKEUP12_IRQHandler,
+    [HOST_VECTOR(SSP1_IRQn)]      = SSP1_IRQHandler,
+    [HOST_VECTOR(I2C0_IRQn)]      = I2C0_IRQHandler,
+    [HOST_VECTOR(CT16B0_IRQn)]    = CT16B0_IRQHandler,
+    [HOST_VECTOR(CT16B1_IRQn)]    = CT16B1_IRQHandler,
+    [HOST_VECTOR(CT32B0_IRQn)]    = CT32B0_IRQHandler,
+    [HOST_VECTOR(CT32B1_IRQn)]    = CT32B1_IRQHandler,
+    [HOST_VECTOR(SSP0_IRQn)]      = SSP0_IRQHandler,
+    [HOST_VECTOR(UART0_IRQn)]     = UART0_IRQHandler,
+    [HOST_VECTOR(ADC0_IRQn)]      = ADC0_IRQHandler,
+    [HOST_VECTOR(WDT_IRQn)]       = WDT_IRQHandler,
+    [HOST_VECTOR(BOD_IRQn)]       = BOD_IRQHandler,
+    [HOST_VECTOR(GPIO3_IRQn)]     = GPIO3_IRQHandler,
+    [HOST_VECTOR(GPIO2_IRQn)]     = GPIO2_IRQHandler,
+    [HOST_VECTOR(GPIO1_IRQn)]     = GPIO1_IRQHandler,
+    [HOST_VECTOR(GPIO0_IRQn)]     = GPIO0_IRQHandler,
+};
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Make a model's register pages trap (or not).
+  */
+static void host_protect(HOST_Model_Type *model, int trap)
+{
+#if HOST_HAVE_TRAPS
+    long     page = sysconf(_SC_PAGESIZE);
+    uint32_t size = (model->Size + page - 1) & ~(page - 1);
+
+
+    mprotect((void *)(uintptr_t)model->Base, size,
+             trap ? PROT_NONE : (PROT_READ | PROT_WRITE));
+#else
+    (void)model;
+    (void)trap;
+#endif
+}
+
+/** @brief Priority (0-255, lower is more urgent) of an exception.
+  */
+static int host_priority(int irq)
+{
+    if (irq == HardFault_IRQn) {
+        return -1;
+    } else if (irq == SVC_IRQn) {
+        return (HostSHP[0] >> 24) & 0xff;
+    } else if (irq == PendSV_IRQn) {
+        return (HostSHP[1] >> 16) & 0xff;
+    } else if (irq == SysTick_IRQn) {
+        return (HostSHP[1] >> 24) & 0xff;
+    }
+
+    return (HostIP[irq >> 2] >> ((irq & 3) * 8)) & 0xff;
+}
+
+/** @brief Find the most urgent pending exception able to preempt.
+  * @return The exception's IRQ number, or HOST_THREAD_MODE if none.
+  */
+static int host_next_exception(uint32_t primask)
+{
+    uint32_t pending;
+    int best = HOST_THREAD_MODE;
+    int best_prio = HostActivePriority;
+    int irq;
+
+
+    if (primask) {
+        return HOST_THREAD_MODE;
+    }
+
+    /* Lower exception numbers win ties, so check system exceptions first */
+    if ((HostSysPending & (1 << 1)) && (host_priority(PendSV_IRQn) < best_prio)) {
+        best = PendSV_IRQn;
+        best_prio = host_priority(PendSV_IRQn);
+    }
+
+    if ((HostSysPending & (1 << 0)) && (host_priority(SysTick_IRQn) < best_prio)) {
+        best = SysTick_IRQn;
+        best_prio = host_priority(SysTick_IRQn);
+    }
+
+    pending = (HostISPR | HostIRQLines) & HostISER;
+
+    for (irq = 0; pending; irq++, pending >>= 1) {
+        if ((pending & 1) && (host_priority(irq) < best_prio)) {
+            best = irq;
+            best_prio = host_priority(irq);
+        }
+    }
+
+    return best;
+}
+
+/** @brief Enter & run the handler for one exception.
+  */
+static void host_take_exception(int irq)
+{
+    int saved_active = HostActive;
+    int saved_priority = HostActivePriority;
+    void (*handler)(void);
+
+
+    HOST_EnterException(irq);
+
+    handler = HostVectors[HOST_VECTOR(irq)];
+    if (handler == 0) {
+        handler = HostDefaultVectors[HOST_VECTOR(irq)];
+    }
+
+    handler();
+
+    HostActive = saved_active;
+    HostActivePriority = saved_priority;
+}
+
+
+/* Access Traps -------------------------------------------------------------*/
+
+#if HOST_HAVE_TRAPS
+
+/** @brief Page fault on a modelled register page.
+  *
+  * Opens up the model's pages, fills in the word being accessed (for reads
+  * and read-modify-writes) and single-steps the faulting instruction.
+  */
+static void host_segv(int sig, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = context;
+    uint32_t addr = (uint32_t)(uintptr_t)info->si_addr;
+    HOST_Model_Type *model;
+    volatile uint32_t *reg;
+    uint32_t offset;
+    int write;
+    int n;
+
+
+    (void)sig;
+
+    model = (((uintptr_t)info->si_addr >> 32) == 0) ? HOST_FindModel(addr) : 0;
+
+    if ((model == 0) || !model->Enabled || (HostPendingCount >= HOST_MAX_PENDING)) {
+        /* Not ours; let the fault happen for real */
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    write  = (uc->uc_mcontext.gregs[HOST_REG_ERR] & HOST_PF_WRITE) ? 1 : 0;
+    offset = (addr - model->Base) & ~3UL;
+    reg    = (volatile uint32_t *)(uintptr_t)(model->Base + offset);
+
+    HostInModel++;
+
+    host_protect(model, 0);
+
+    *reg = write ? model->Peek(model, offset) : model->Read(model, offset);
+
+    n = HostPendingCount++;
+    HostPending[n].Model  = model;
+    HostPending[n].Offset = offset;
+    HostPending[n].Write  = write;
+    HostPending[n].First  = (uc->uc_mcontext.gregs[HOST_REG_FLAGS] & HOST_X86_TF) ? 0 : 1;
+
+    HostInModel--;
+
+    uc->uc_mcontext.gregs[HOST_REG_FLAGS] |= HOST_X86_TF;
+}
+
+/** @brief Single-step completion of a trapped access.
+  *
+  * Hands written values to the model, closes the model's pages again and
+  * takes any interrupt the access raised.
+  */
+static void host_trap(int sig, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = context;
+    HOST_Model_Type *model;
+    volatile uint32_t *reg;
+    int first;
+
+
+    (void)sig;
+    (void)info;
+
+    if (HostPendingCount == 0) {
+        signal(SIGTRAP, SIG_DFL);
+        raise(SIGTRAP);
+        return;
+    }
+
+    uc->uc_mcontext.gregs[HOST_REG_FLAGS] &= ~HOST_X86_TF;
+
+    HostInModel++;
+
+    do {
+        HostPendingCount--;
+        model = HostPending[HostPendingCount].Model;
+        first = HostPending[HostPendingCount].First;
+        reg   = (volatile uint32_t *)(uintptr_t)(model->Base + HostPending[HostPendingCount].Offset);
+
+        if (HostPending[HostPendingCount].Write) {
+            model->Write(model, HostPending[HostPendingCount].Offset, *reg);
+        }
+
+        if (model->Enabled) {
+            host_protect(model, 1);
+        }
+    } while (!first && HostPendingCount);
+
+    HostInModel--;
+
+    HOST_ServiceInterrupts();
+}
+
+#endif /* #if HOST_HAVE_TRAPS */
+
+
+/* SCS (NVIC / SCB / SysTick) Model -----------------------------------------*/
+
+static void host_scs_reset(HOST_Model_Type *model)
+{
+    (void)model;
+
+    HostISER = 0;
+    HostISPR = 0;
+    HostIRQLines = 0;
+    memset(HostIP, 0, sizeof(HostIP));
+    memset(HostSHP, 0, sizeof(HostSHP));
+    HostSysPending = 0;
+    HostSCR = 0;
+    HostSysTickCTRL = 0;
+    HostSysTickLOAD = 0;
+    HostSysTickVAL = 0;
+}
+
+static uint32_t host_scs_peek(HOST_Model_Type *model, uint32_t offset)
+{
+    (void)model;
+
+    switch (offset) {
+    case 0x010: return HostSysTickCTRL;
+    case 0x014: return HostSysTickLOAD;
+    case 0x018: return HostSysTickVAL;
+    case 0x01c: return 0x80000000UL | (SYSCON->SYSTCKCAL & 0x00ffffffUL);
+    case 0x100:
+    case 0x180: return HostISER;
+    case 0x200:
+    case 0x280: return HostISPR | HostIRQLines;
+    case 0xd00: return 0x410cc200UL;                   /* Cortex-M0 r0p0 */
+    case 0xd04:
+        return ((HostSysPending & (1 << 1)) ? SCB_ICSR_PENDSVSET_Msk : 0)
+             | ((HostSysPending & (1 << 0)) ? SCB_ICSR_PENDSTSET_Msk : 0)
+             | ((HostActive == HOST_THREAD_MODE) ? 0 : (uint32_t)HOST_VECTOR(HostActive));
+    case 0xd0c: return 0xfa050000UL;
+    case 0xd10: return HostSCR;
+    case 0xd14: return 0x00000208UL;
+    case 0xd1c: return HostSHP[0];
+    case 0xd20: return HostSHP[1];
+    default:
+        break;
+    }
+
+    if ((offset >= 0x400) && (offset < 0x420)) {
+        return HostIP[(offset - 0x400) >> 2];
+    }
+
+    return 0;
+}
+
+static uint32_t host_scs_read(HOST_Model_Type *model, uint32_t offset)
+{
+    uint32_t value = host_scs_peek(model, offset);
+
+
+    /* COUNTFLAG clears on read */
+    if (offset == 0x010) {
+        HostSysTickCTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+    }
+
+    return value;
+}
+
+static void host_scs_write(HOST_Model_Type *model, uint32_t offset, uint32_t value)
+{
+    (void)model;
+
+    switch (offset) {
+    case 0x010:
+        HostSysTickCTRL = (HostSysTickCTRL & SysTick_CTRL_COUNTFLAG_Msk) | (value & 0x07);
+        return;
+    case 0x014: HostSysTickLOAD = value & SysTick_LOAD_RELOAD_Msk; return;
+    case 0x018:
+        HostSysTickVAL = 0;
+        HostSysTickCTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+        return;
+    case 0x100: HostISER |= value; return;
+    case 0x180: HostISER &= ~value; return;
+    case 0x200: HostISPR |= value; return;
+    case 0x280: HostISPR &= ~value; return;
+    case 0xd04:
+        if (value & SCB_ICSR_PENDSVSET_Msk) HostSysPending |= (1 << 1);
+        if (value & SCB_ICSR_PENDSVCLR_Msk) HostSysPending &= ~(1 << 1);
+        if (value & SCB_ICSR_PENDSTSET_Msk) HostSysPending |= (1 << 0);
+        if (value & SCB_ICSR_PENDSTCLR_Msk) HostSysPending &= ~(1 << 0);
+        return;
+    case 0xd0c:
+        if (((value & SCB_AIRCR_VECTKEY_Msk) == (0x5faUL << SCB_AIRCR_VECTKEY_Pos))
+            && (value & SCB_AIRCR_SYSRESETREQ_Msk))
+        {
+            host_request_reset(HOST_ResetSource_System);
+        }
+        return;
+    case 0xd10: HostSCR = value & 0x16; return;
+    case 0xd1c: HostSHP[0] = value & 0xff000000UL; return;
+    case 0xd20: HostSHP[1] = value & 0xffff0000UL; return;
+    default:
+        break;
+    }
+
+    /* Only the top __NVIC_PRIO_BITS of each priority byte are implemented */
+    if ((offset >= 0x400) && (offset < 0x420)) {
+        HostIP[(offset - 0x400) >> 2] = value
+            & (0x01010101UL * ((0xff << (8 - __NVIC_PRIO_BITS)) & 0xff));
+    }
+}
+
+static void host_scs_advance(HOST_Model_Type *model, uint32_t clocks)
+{
+    uint64_t period;
+
+
+    (void)model;
+
+    /* A zero reload value stops the counter */
+    if (!(HostSysTickCTRL & SysTick_CTRL_ENABLE_Msk) || (HostSysTickLOAD == 0)) {
+        return;
+    }
+
+    period = (uint64_t)HostSysTickLOAD + 1;
+
+    while (clocks) {
+        if (HostSysTickVAL == 0) {
+            /* Reload happens on the clock after reaching 0 */
+            HostSysTickVAL = HostSysTickLOAD;
+            clocks--;
+            continue;
+        }
+
+        if (clocks < HostSysTickVAL) {
+            HostSysTickVAL -= clocks;
+            break;
+        }
+
+        clocks -= HostSysTickVAL;
+        HostSysTickVAL = 0;
+        HostSysTickCTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+
+        if (HostSysTickCTRL & SysTick_CTRL_TICKINT_Msk) {
+            host_pend_systick();
+        }
+
+        /* Skip whole periods in one go */
+        if (HostSysTickLOAD && (clocks > period)) {
+            clocks -= (uint32_t)(((clocks - 1) / period) * period);
+        }
+    }
+}
+
+HOST_Model_Type HOST_SCSModel = {
+    .Name    = "SCS",
+    .Base    = 0xe000e000UL,
+    .Size    = 0x1000,
+    .Reset   = host_scs_reset,
+    .Read    = host_scs_read,
+    .Peek    = host_scs_peek,
+    .Write   = host_scs_write,
+    .Advance = host_scs_advance,
+    .Enabled = 1,
+};
+
+
+/* Internal Functions -------------------------------------------------------*/
+
+void host_request_reset(HOST_ResetSource_Type source)
+{
+    SYSCON->SYSRESSTAT |= source;
+
+    if (HostResetHook) {
+        HostResetHook(source);
+        return;
+    }
+
+    fprintf(stderr, "lpc11xx-host: %s reset requested\n",
+            (source == HOST_ResetSource_WDT) ? "watchdog" : "system");
+    exit(HOST_RESET_EXIT_STATUS);
+}
+
+void host_pend_systick(void)
+{
+    HostSysPending |= (1 << 0);
+}
+
+void host_harness_done(void)
+{
+    HOST_ServiceInterrupts();
+}
+
+
+/* Core Intrinsic Hooks (see core_cm0.h) ------------------------------------*/
+
+uint32_t HOST_GetPRIMASK(void)
+{
+    return HostPRIMASK;
+}
+
+void HOST_SetPRIMASK(uint32_t primask)
+{
+    HostPRIMASK = primask & 1;
+
+    if (!HostPRIMASK) {
+        HOST_ServiceInterrupts();
+    }
+}
+
+void HOST_WaitForInterrupt(void)
+{
+    if ((host_next_exception(0) == HOST_THREAD_MODE) && HostIdleHook) {
+        HostIdleHook();
+    }
+
+    /* WFI wakes on pending interrupts even with PRIMASK set, but only takes
+     *  them once unmasked
+     */
+    HOST_ServiceInterrupts();
+}
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Map the register file & install the access traps.
+  */
+void HOST_Init(void)
+{
+    unsigned int i;
+    void *p;
+#if HOST_HAVE_TRAPS
+    struct sigaction sa;
+#endif
+
+
+    if (HostInitialized) {
+        return;
+    }
+
+    for (i = 0; i < sizeof(HostRegions) / sizeof(HostRegions[0]); i++) {
+        p = mmap((void *)(uintptr_t)HostRegions[i].Base, HostRegions[i].Size,
+                 PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+                 -1, 0);
+
+        if (p != (void *)(uintptr_t)HostRegions[i].Base) {
+            fprintf(stderr, "lpc11xx-host: can't map register file at 0x%08lx\n",
+                    (unsigned long)HostRegions[i].Base);
+            abort();
+        }
+    }
+
+#if HOST_HAVE_TRAPS
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+
+    sa.sa_sigaction = host_segv;
+    sigaction(SIGSEGV, &sa, 0);
+
+    sa.sa_sigaction = host_trap;
+    sigaction(SIGTRAP, &sa, 0);
+#endif
+
+    HostInitialized = 1;
+
+    HOST_Reset();
+}
+
+/* Map the register file before any constructors or main() run */
+static void host_init_early(void) __attribute__((constructor(101)));
+static void host_init_early(void)
+{
+    HOST_Init();
+}
+
+/** @brief Return every register & model (and the interrupt state) to reset.
+  */
+void HOST_Reset(void)
+{
+    HOST_Model_Type * const *m;
+    unsigned int i;
+
+
+    for (m = HOST_Models; *m; m++) {
+        host_protect(*m, 0);
+    }
+
+    for (i = 0; i < sizeof(HostRegions) / sizeof(HostRegions[0]); i++) {
+        memset((void *)(uintptr_t)HostRegions[i].Base, 0, HostRegions[i].Size);
+    }
+
+    for (i = 0; i < sizeof(HostResetValues) / sizeof(HostResetValues[0]); i++) {
+        *(volatile uint32_t *)(uintptr_t)HostResetValues[i].Addr = HostResetValues[i].Value;
+    }
+
+    HostPRIMASK = 0;
+    HostActive = HOST_THREAD_MODE;
+    HostActivePriority = HOST_THREAD_PRIORITY;
+    memset(HostInterruptCounts, 0, sizeof(HostInterruptCounts));
+
+    for (m = HOST_Models; *m; m++) {
+        (*m)->Reset(*m);
+        (*m)->Enabled = HOST_HAVE_TRAPS;
+        host_protect(*m, (*m)->Enabled);
+    }
+}
+
+/** @brief Test whether modelled registers are trapped on this host.
+  */
+int HOST_TrapsAvailable(void)
+{
+    return HOST_HAVE_TRAPS;
+}
+
+/** @brief Enable or disable the model for a peripheral.
+  */
+void HOST_EnableModel(uint32_t base, int enable)
+{
+    HOST_Model_Type *model = HOST_FindModel(base);
+
+
+    if (model) {
+        model->Enabled = enable && HOST_HAVE_TRAPS;
+        host_protect(model, model->Enabled);
+    }
+}
+
+/** @brief Find the model covering an address.
+  */
+HOST_Model_Type *HOST_FindModel(uint32_t addr)
+{
+    HOST_Model_Type * const *m;
+    long page = sysconf(_SC_PAGESIZE);
+
+
+    for (m = HOST_Models; *m; m++) {
+        if ((addr >= (*m)->Base)
+            && (addr - (*m)->Base < (((*m)->Size + page - 1) & ~(page - 1))))
+        {
+            return *m;
+        }
+    }
+
+    return 0;
+}
+
+/** @brief Read from the peripheral space as a bus master would.
+  */
+uint32_t HOST_BusRead(uint32_t addr, unsigned int size)
+{
+    HOST_Model_Type *model = HOST_FindModel(addr);
+    uint32_t word;
+    unsigned int shift = (addr & 3) * 8;
+
+
+    if (model) {
+        word = model->Read(model, (addr - model->Base) & ~3UL);
+    } else {
+        word = *(volatile uint32_t *)(uintptr_t)(addr & ~3UL);
+    }
+
+    if (size == 4) {
+        return word;
+    }
+
+    return (word >> shift) & ((size == 2) ? 0xffff : 0xff);
+}
+
+/** @brief Write to the peripheral space as a bus master would.
+  */
+void HOST_BusWrite(uint32_t addr, uint32_t value, unsigned int size)
+{
+    HOST_Model_Type *model = HOST_FindModel(addr);
+    uint32_t offset;
+    uint32_t word;
+    uint32_t mask;
+    unsigned int shift = (addr & 3) * 8;
+
+
+    if (size != 4) {
+        mask = ((size == 2) ? 0xffffUL : 0xffUL) << shift;
+
+        if (model) {
+            word = model->Peek(model, (addr - model->Base) & ~3UL);
+        } else {
+            word = *(volatile uint32_t *)(uintptr_t)(addr & ~3UL);
+        }
+
+        value = (word & ~mask) | ((value << shift) & mask);
+    }
+
+    if (model) {
+        offset = (addr - model->Base) & ~3UL;
+        model->Write(model, offset, value);
+    } else {
+        *(volatile uint32_t *)(uintptr_t)(addr & ~3UL) = value;
+    }
+}
+
+/** @brief Advance simulated time for timers, SysTick and the watchdog.
+  */
+void HOST_AdvanceClock(uint32_t clocks)
+{
+    HOST_Model_Type * const *m;
+
+
+    for (m = HOST_Models; *m; m++) {
+        if ((*m)->Advance) {
+            (*m)->Advance(*m, clocks);
+        }
+    }
+
+    host_harness_done();
+}
+
+/** @brief Take pending, enabled interrupts above the current priority.
+  */
+void HOST_ServiceInterrupts(void)
+{
+    unsigned long loops = 0;
+    int irq;
+
+
+    if (!HostInitialized || HostInModel || HostExternalCPU) {
+        return;
+    }
+
+    while ((irq = host_next_exception(HostPRIMASK)) != HOST_THREAD_MODE) {
+        if (++loops > HOST_MAX_ISR_LOOPS) {
+            fprintf(stderr, "lpc11xx-host: exception %d is stuck pending\n", irq);
+            abort();
+        }
+
+        host_take_exception(irq);
+    }
+}
+
+/** @brief Drive the interrupt request line of a peripheral.
+  */
+void HOST_SetIRQLine(IRQn_Type irq, int asserted)
+{
+    if ((int)irq == SysTick_IRQn) {
+        if (asserted) {
+            host_pend_systick();
+        }
+        return;
+    }
+
+    if ((int)irq < 0) {
+        return;
+    }
+
+    if (asserted) {
+        HostIRQLines |= (1UL << irq);
+    } else {
+        HostIRQLines &= ~(1UL << irq);
+    }
+}
+
+/** @brief Set the handler called for an interrupt.
+  */
+void HOST_SetVector(IRQn_Type irq, void (*handler)(void))
+{
+    HostVectors[HOST_VECTOR(irq)] = handler;
+}
+
+/** @brief Get the number of times an interrupt handler has been entered.
+  */
+uint32_t HOST_GetInterruptCount(IRQn_Type irq)
+{
+    return HostInterruptCounts[HOST_VECTOR(irq)];
+}
+
+/** @brief Get the interrupt whose handler is currently executing.
+  */
+int HOST_GetActiveInterrupt(void)
+{
+    return HostActive;
+}
+
+/** @brief Set the function called when WFI / WFE finds nothing pending.
+  */
+void HOST_SetIdleHook(void (*hook)(void))
+{
+    HostIdleHook = hook;
+}
+
+/** @brief Set the function called on a system or watchdog reset.
+  */
+void HOST_SetResetHook(void (*hook)(HOST_ResetSource_Type source))
+{
+    HostResetHook = hook;
+}
+
+/** @brief Hand exception entry over to an external CPU model.
+  */
+void HOST_SetExternalCPU(int external)
+{
+    HostExternalCPU = external;
+}
+
+/** @brief Get the exception that would preempt execution now.
+  */
+int HOST_PendingException(int ignore_primask)
+{
+    return host_next_exception(ignore_primask ? 0 : HostPRIMASK);
+}
+
+/** @brief Test whether any interrupt source could ever become pending.
+  */
+int HOST_InterruptsEnabled(void)
+{
+    return (HostISER != 0) || (HostSysPending != 0)
+           || ((HostSysTickCTRL & (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk))
+               == (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk));
+}
+
+/** @brief Mark an exception as entered (clears pending, raises priority).
+  */
+void HOST_EnterException(int irq)
+{
+    if (irq >= 0) {
+        HostISPR &= ~(1UL << irq);
+    } else if (irq == PendSV_IRQn) {
+        HostSysPending &= ~(1 << 1);
+    } else if (irq == SysTick_IRQn) {
+        HostSysPending &= ~(1 << 0);
+    }
+
+    HostActive = irq;
+    HostActivePriority = host_priority(irq);
+    HostInterruptCounts[HOST_VECTOR(irq)]++;
+}
+
+/** @brief Return the execution priority to that of a preempted exception.
+  */
+void HOST_ExitException(int irq)
+{
+    HostActive = irq;
+    HostActivePriority = (irq == HOST_THREAD_MODE) ? HOST_THREAD_PRIORITY : host_priority(irq);
+}
@@ -0,0 +1,291 @@
+/******************************************************************************
+ * @file:    lpc11xx_host_ct.c
+ * @purpose: Host model of the LPC11xx 16-bit & 32-bit counter / timers
+ *           (prescaler, match actions, capture, interrupt flags).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_host_priv.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* TCR bits */
+#define CT_CE             (1 << 0)
+#define CT_CR             (1 << 1)
+
+/* IR bit for capture channel 0 */
+#define CT_IR_CR0         (1 << 4)
+
+/* Per-channel MCR bits */
+#define CT_MRI(n)         (1 << ((n) * 3))
+#define CT_MRR(n)         (1 << ((n) * 3 + 1))
+#define CT_MRS(n)         (1 << ((n) * 3 + 2))
+
+/* CCR bits */
+#define CT_CAP0RE         (1 << 0)
+#define CT_CAP0FE         (1 << 1)
+#define CT_CAP0I          (1 << 2)
+
+
+/* Types --------------------------------------------------------------------*/
+
+typedef struct {
+    IRQn_Type IRQn;
+    uint32_t  Mask;           /* 0xffff for CT16B, 0xffffffff for CT32B */
+    uint32_t  IR;
+    uint32_t  TCR;
+    uint32_t  TC;
+    uint32_t  PR;
+    uint32_t  PC;
+    uint32_t  MCR;
+    uint32_t  MR[4];
+    uint32_t  CCR;
+    uint32_t  CR0;
+    uint32_t  EMR;
+    uint32_t  CTCR;
+    uint32_t  PWMC;
+    int       ResetPending;   /* Next tick takes TC to 0 (match reset) */
+} CT_State_Type;
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static CT_State_Type CtState[4] = {
+    { .IRQn = CT16B0_IRQn, .Mask = 0x0000ffffUL },
+    { .IRQn = CT16B1_IRQn, .Mask = 0x0000ffffUL },
+    { .IRQn = CT32B0_IRQn, .Mask = 0xffffffffUL },
+    { .IRQn = CT32B1_IRQn, .Mask = 0xffffffffUL },
+};
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+static void ct_update_irq(CT_State_Type *t)
+{
+    HOST_SetIRQLine(t->IRQn, t->IR != 0);
+}
+
+/** @brief Apply the match actions for every match register equal to TC.
+  */
+static void ct_match(CT_State_Type *t)
+{
+    int n;
+
+
+    for (n = 0; n < 4; n++) {
+        if (t->MR[n] != t->TC) {
+            continue;
+        }
+
+        if (t->MCR & CT_MRI(n)) {
+            t->IR |= (1 << n);
+        }
+        if (t->MCR & CT_MRR(n)) {
+            t->ResetPending = 1;
+        }
+        if (t->MCR & CT_MRS(n)) {
+            t->TCR &= ~CT_CE;
+            t->PC = 0;
+        }
+    }
+}
+
+/** @brief Number of TC increments until the next match with an action.
+  */
+static uint64_t ct_next_event(CT_State_Type *t)
+{
+    uint64_t best = (uint64_t)t->Mask + 1;
+    uint64_t d;
+    int n;
+
+
+    for (n = 0; n < 4; n++) {
+        if (!(t->MCR & (CT_MRI(n) | CT_MRR(n) | CT_MRS(n)))) {
+            continue;
+        }
+
+        d = (t->MR[n] - t->TC) & t->Mask;
+        if (d == 0) {
+            d = (uint64_t)t->Mask + 1;
+        }
+        if (d < best) {
+            best = d;
+        }
+    }
+
+    return best;
+}
+
+static void ct_reset(HOST_Model_Type *model)
+{
+    CT_State_Type *t = model->State;
+    IRQn_Type irq = t->IRQn;
+    uint32_t mask = t->Mask;
+
+
+    memset(t, 0, sizeof(*t));
+    t->IRQn = irq;
+    t->Mask = mask;
+}
+
+static uint32_t ct_peek(HOST_Model_Type *model, uint32_t offset)
+{
+    CT_State_Type *t = model->State;
+
+
+    switch (offset) {
+    case 0x00: return t->IR;
+    case 0x04: return t->TCR;
+    case 0x08: return t->TC;
+    case 0x0c: return t->PR;
+    case 0x10: return t->PC;
+    case 0x14: return t->MCR;
+    case 0x18: return t->MR[0];
+    case 0x1c: return t->MR[1];
+    case 0x20: return t->MR[2];
+    case 0x24: return t->MR[3];
+    case 0x28: return t->CCR;
+    case 0x2c: return t->CR0;
+    case 0x3c: return t->EMR;
+    case 0x70: return t->CTCR;
+    case 0x74: return t->PWMC;
+    default:   return 0;
+    }
+}
+
+static uint32_t ct_read(HOST_Model_Type *model, uint32_t offset)
+{
+    return ct_peek(model, offset);
+}
+
+static void ct_write(HOST_Model_Type *model, uint32_t offset, uint32_t value)
+{
+    CT_State_Type *t = model->State;
+
+
+    switch (offset) {
+    case 0x00: t->IR &= ~(value & 0x1f); break;           /* write-1-to-clear */
+    case 0x04:
+        t->TCR = value & (CT_CE | CT_CR);
+        if (t->TCR & CT_CR) {
+            t->TC = 0;
+            t->PC = 0;
+            t->ResetPending = 0;
+        }
+        break;
+    case 0x08: t->TC = value & t->Mask; t->ResetPending = 0; break;
+    case 0x0c: t->PR = value & t->Mask; break;
+    case 0x10: t->PC = value & t->Mask; break;
+    case 0x14: t->MCR = value & 0x0fff; break;
+    case 0x18: t->MR[0] = value & t->Mask; break;
+    case 0x1c: t->MR[1] = value & t->Mask; break;
+    case 0x20: t->MR[2] = value & t->Mask; break;
+    case 0x24: t->MR[3] = value & t->Mask; break;
+    case 0x28: t->CCR = value & 0x07; break;
+    case 0x3c: t->EMR = value & 0x0fff; break;
+    case 0x70: t->CTCR = value & 0x0f; break;
+    case 0x74: t->PWMC = value & 0x0f; break;
+    default:
+        break;
+    }
+
+    ct_update_irq(t);
+}
+
+static void ct_advance(HOST_Model_Type *model, uint32_t clocks)
+{
+    CT_State_Type *t = model->State;
+    uint64_t period = (uint64_t)t->PR + 1;
+    uint64_t ticks;
+    uint64_t d;
+
+
+    if (((t->TCR & (CT_CE | CT_CR)) != CT_CE) || (t->CTCR & 0x03)) {
+        return;
+    }
+
+    /* Whole timer ticks in this interval; the rest stays in PC */
+    ticks = ((uint64_t)t->PC + clocks) / period;
+    t->PC = (uint32_t)(((uint64_t)t->PC + clocks) % period);
+
+    while (ticks && (t->TCR & CT_CE)) {
+        if (t->ResetPending) {
+            t->ResetPending = 0;
+            t->TC = 0;
+            ticks--;
+            ct_match(t);
+            continue;
+        }
+
+        d = ct_next_event(t);
+
+        if (d > ticks) {
+            t->TC = (uint32_t)((t->TC + ticks) & t->Mask);
+            break;
+        }
+
+        t->TC = (uint32_t)((t->TC + d) & t->Mask);
+        ticks -= d;
+        ct_match(t);
+    }
+
+    ct_update_irq(t);
+}
+
+#define CT_MODEL(name, n)                                           \
+HOST_Model_Type HOST_##name##Model = {                              \
+    .Name    = #name,                                               \
+    .Base    = name##_BASE,                                         \
+    .Size    = sizeof(CT32B_Type),                                  \
+    .State   = &CtState[n],                                         \
+    .Reset   = ct_reset,                                            \
+    .Read    = ct_read,                                             \
+    .Peek    = ct_peek,                                             \
+    .Write   = ct_write,                                            \
+    .Advance = ct_advance,                                          \
+    .Enabled = 1,                                                   \
+}
+
+CT_MODEL(CT16B0, 0);
+CT_MODEL(CT16B1, 1);
+CT_MODEL(CT32B0, 2);
+CT_MODEL(CT32B1, 3);
+
+
+/* Harness Functions --------------------------------------------------------*/
+
+/** @brief Present an edge on a timer's capture input.
+  */
+void HOST_CTCaptureEdge(void *timer, int rising)
+{
+    HOST_Model_Type *model = HOST_FindModel((uint32_t)(uintptr_t)timer);
+    CT_State_Type *t;
+
+
+    if ((model == 0) || (model->Advance != ct_advance)) {
+        return;
+    }
+
+    t = model->State;
+
+    if ((rising && (t->CCR & CT_CAP0RE)) || (!rising && (t->CCR & CT_CAP0FE))) {
+        t->CR0 = t->TC;
+
+        if (t->CCR & CT_CAP0I) {
+            t->IR |= CT_IR_CR0;
+        }
+    }
+
+    ct_update_irq(t);
+    host_harness_done();
+}
@@ -0,0 +1,213 @@
+/******************************************************************************
+ * @file:    lpc11xx_host_gpio.c
+ * @purpose: Host model of the LPC11xx GPIO ports (masked data access, pin
+ *           interrupts).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_host_priv.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Register offsets past the masked data window */
+#define GPIO_DIR          (0x8000)
+#define GPIO_IS           (0x8004)
+#define GPIO_IBE          (0x8008)
+#define GPIO_IEV          (0x800c)
+#define GPIO_IE           (0x8010)
+#define GPIO_RIS          (0x8014)
+#define GPIO_MIS          (0x8018)
+#define GPIO_IC           (0x801c)
+
+
+/* Types --------------------------------------------------------------------*/
+
+typedef struct {
+    IRQn_Type IRQn;
+    uint32_t  Out;            /* Output latch                    */
+    uint32_t  In;             /* Level driven by the outside     */
+    uint32_t  Pins;           /* Resulting pin levels            */
+    uint32_t  DIR;
+    uint32_t  IS;
+    uint32_t  IBE;
+    uint32_t  IEV;
+    uint32_t  IE;
+    uint32_t  Edges;          /* Latched edge interrupts         */
+} GPIO_State_Type;
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static GPIO_State_Type GpioState[4] = {
+    { .IRQn = GPIO0_IRQn },
+    { .IRQn = GPIO1_IRQn },
+    { .IRQn = GPIO2_IRQn },
+    { .IRQn = GPIO3_IRQn },
+};
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Raw interrupt status: latched edges plus active levels.
+  */
+static uint32_t gpio_ris(GPIO_State_Type *g)
+{
+    uint32_t level_active = ~(g->Pins ^ g->IEV) & g->IS;
+
+
+    return (g->Edges & ~g->IS) | level_active;
+}
+
+/** @brief Recompute pin levels & detect interrupt edges.
+  */
+static void gpio_update(GPIO_State_Type *g)
+{
+    uint32_t old = g->Pins;
+    uint32_t changed;
+    uint32_t rising;
+    uint32_t falling;
+
+
+    g->Pins = ((g->Out & g->DIR) | (g->In & ~g->DIR)) & GPIO_DATA_Mask;
+
+    changed = old ^ g->Pins;
+    rising  = changed & g->Pins;
+    falling = changed & ~g->Pins;
+
+    g->Edges |= changed & ~g->IS & g->IBE;
+    g->Edges |= rising  & ~g->IS & ~g->IBE & g->IEV;
+    g->Edges |= falling & ~g->IS & ~g->IBE & ~g->IEV;
+
+    HOST_SetIRQLine(g->IRQn, (gpio_ris(g) & g->IE) != 0);
+}
+
+static void gpio_reset(HOST_Model_Type *model)
+{
+    GPIO_State_Type *g = model->State;
+    IRQn_Type irq = g->IRQn;
+
+
+    memset(g, 0, sizeof(*g));
+    g->IRQn = irq;
+}
+
+static uint32_t gpio_peek(HOST_Model_Type *model, uint32_t offset)
+{
+    GPIO_State_Type *g = model->State;
+
+
+    /* Address bits [13:2] select which pins take part in the access */
+    if (offset < GPIO_DIR) {
+        if (offset >= 0x4000) {
+            return 0;
+        }
+        return g->Pins & (offset >> 2) & GPIO_DATA_Mask;
+    }
+
+    switch (offset) {
+    case GPIO_DIR: return g->DIR;
+    case GPIO_IS:  return g->IS;
+    case GPIO_IBE: return g->IBE;
+    case GPIO_IEV: return g->IEV;
+    case GPIO_IE:  return g->IE;
+    case GPIO_RIS: return gpio_ris(g);
+    case GPIO_MIS: return gpio_ris(g) & g->IE;
+    default:       return 0;
+    }
+}
+
+static uint32_t gpio_read(HOST_Model_Type *model, uint32_t offset)
+{
+    return gpio_peek(model, offset);
+}
+
+static void gpio_write(HOST_Model_Type *model, uint32_t offset, uint32_t value)
+{
+    GPIO_State_Type *g = model->State;
+    uint32_t mask;
+
+
+    value &= GPIO_DATA_Mask;
+
+    if (offset < GPIO_DIR) {
+        if (offset < 0x4000) {
+            mask = (offset >> 2) & GPIO_DATA_Mask;
+            g->Out = (g->Out & ~mask) | (value & mask);
+        }
+    } else {
+        switch (offset) {
+        case GPIO_DIR: g->DIR = value; break;
+        case GPIO_IS:  g->IS  = value; break;
+        case GPIO_IBE: g->IBE = value; break;
+        case GPIO_IEV: g->IEV = value; break;
+        case GPIO_IE:  g->IE  = value; break;
+        case GPIO_IC:  g->Edges &= ~value; break;
+        default:
+            break;
+        }
+    }
+
+    gpio_update(g);
+}
+
+#define GPIO_MODEL(n)                                               \
+HOST_Model_Type HOST_GPIO##n##Model = {                             \
+    .Name    = "GPIO" #n,                                           \
+    .Base    = GPIO##n##_BASE,                                      \
+    .Size    = sizeof(GPIO_Type),                                   \
+    .State   = &GpioState[n],                                       \
+    .Reset   = gpio_reset,                                          \
+    .Read    = gpio_read,                                           \
+    .Peek    = gpio_peek,                                           \
+    .Write   = gpio_write,                                          \
+    .Enabled = 1,                                                   \
+}
+
+GPIO_MODEL(0);
+GPIO_MODEL(1);
+GPIO_MODEL(2);
+GPIO_MODEL(3);
+
+
+/** @brief Get the model state for a GPIO port.
+  */
+static GPIO_State_Type *gpio_state(GPIO_Type *gpio)
+{
+    HOST_Model_Type *model = HOST_FindModel((uint32_t)(uintptr_t)gpio);
+
+
+    return model ? model->State : &GpioState[0];
+}
+
+
+/* Harness Functions --------------------------------------------------------*/
+
+/** @brief Drive external levels onto GPIO pins.
+  */
+void HOST_GPIOSetInputs(GPIO_Type *gpio, uint32_t mask, uint32_t levels)
+{
+    GPIO_State_Type *g = gpio_state(gpio);
+
+
+    g->In = (g->In & ~mask) | (levels & mask);
+    gpio_update(g);
+
+    host_harness_done();
+}
+
+/** @brief Get the levels on a GPIO port's pins.
+  */
+uint32_t HOST_GPIOGetPins(GPIO_Type *gpio)
+{
+    return gpio_state(gpio)->Pins;
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * @file:    lpc11xx_host_priv.h
+ * @purpose: Internal interfaces shared by the host peripheral models.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+#ifndef LPC11XX_HOST_PRIV_H_
+#define LPC11XX_HOST_PRIV_H_
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+
+
+/* Defines ------------------------------------------------------------------*/
+
+/* Generic FIFO used by the UART & SSP models */
+#define HOST_FIFO_MAX  (16)
+
+typedef struct {
+    uint16_t Data[HOST_FIFO_MAX];
+    uint8_t  Head;
+    uint8_t  Count;
+    uint8_t  Depth;
+} HOST_FIFO_Type;
+
+
+/* Inline Functions ---------------------------------------------------------*/
+
+static inline void host_fifo_init(HOST_FIFO_Type *fifo, unsigned int depth)
+{
+    fifo->Head  = 0;
+    fifo->Count = 0;
+    fifo->Depth = depth;
+}
+
+static inline int host_fifo_push(HOST_FIFO_Type *fifo, uint16_t value)
+{
+    if (fifo->Count >= fifo->Depth) {
+        return 0;
+    }
+
+    fifo->Data[(fifo->Head + fifo->Count) % fifo->Depth] = value;
+    fifo->Count++;
+
+    return 1;
+}
+
+static inline uint16_t host_fifo_pop(HOST_FIFO_Type *fifo)
+{
+    uint16_t value;
+
+
+    if (fifo->Count == 0) {
+        return 0;
+    }
+
+    value = fifo->Data[fifo->Head];
+    fifo->Head = (fifo->Head + 1) % fifo->Depth;
+    fifo->Count--;
+
+    return value;
+}
+
+static inline uint16_t host_fifo_peek(const HOST_FIFO_Type *fifo)
+{
+    return fifo->Count ? fifo->Data[fifo->Head] : 0;
+}
+
+
+/* Model Descriptors --------------------------------------------------------*/
+
+extern HOST_Model_Type HOST_SCSModel;
+extern HOST_Model_Type HOST_UART0Model;
+extern HOST_Model_Type HOST_WDTModel;
+extern HOST_Model_Type HOST_SSP0Model;
+extern HOST_Model_Type HOST_SSP1Model;
+extern HOST_Model_Type HOST_CT16B0Model;
+extern HOST_Model_Type HOST_CT16B1Model;
+extern HOST_Model_Type HOST_CT32B0Model;
+extern HOST_Model_Type HOST_CT32B1Model;
+extern HOST_Model_Type HOST_GPIO0Model;
+extern HOST_Model_Type HOST_GPIO1Model;
+extern HOST_Model_Type HOST_GPIO2Model;
+extern HOST_Model_Type HOST_GPIO3Model;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/* Request a reset from a model (lpc11xx_host.c) */
+extern void host_request_reset(HOST_ResetSource_Type source);
+
+/* Pend the SysTick exception (lpc11xx_host.c) */
+extern void host_pend_systick(void);
+
+/* Called at the end of every harness entry point to take interrupts that the
+ *  call may have raised (lpc11xx_host.c)
+ */
+extern void host_harness_done(void);
+
+#endif /* #ifndef LPC11XX_HOST_PRIV_H_ */
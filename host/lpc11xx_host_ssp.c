@@ -0,0 +1,211 @@
+/******************************************************************************
+ * @file:    lpc11xx_host_ssp.c
+ * @purpose: Host model of the LPC11xx SSP controllers (FIFOs, loopback,
+ *           harness slave device, interrupt status).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_host_priv.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+#define SSP_FIFO_DEPTH    (8)
+
+/* RIS / IMSC / MIS bit positions (hardware layout) */
+#define SSP_INT_ROR       (1 << 0)
+#define SSP_INT_RT        (1 << 1)
+#define SSP_INT_RX        (1 << 2)
+#define SSP_INT_TX        (1 << 3)
+
+
+/* Types --------------------------------------------------------------------*/
+
+typedef struct {
+    IRQn_Type      IRQn;
+    HOST_FIFO_Type Rx;
+    HOST_FIFO_Type Tx;
+    uint32_t       CR0;
+    uint32_t       CR1;
+    uint32_t       CPSR;
+    uint32_t       IMSC;
+    uint32_t       Sticky;      /* ROR / RT until cleared via ICR */
+    uint32_t       Frames;
+    uint16_t     (*Slave)(uint16_t mosi);
+} SSP_State_Type;
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static SSP_State_Type SspState[2] = {
+    { .IRQn = SSP0_IRQn },
+    { .IRQn = SSP1_IRQn },
+};
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+static uint32_t ssp_ris(SSP_State_Type *s)
+{
+    return s->Sticky
+           | ((s->Rx.Count >= SSP_FIFO_DEPTH / 2) ? SSP_INT_RX : 0)
+           | ((s->Tx.Count <= SSP_FIFO_DEPTH / 2) ? SSP_INT_TX : 0);
+}
+
+static void ssp_update_irq(SSP_State_Type *s)
+{
+    HOST_SetIRQLine(s->IRQn, (ssp_ris(s) & s->IMSC) != 0);
+}
+
+/** @brief Shift out queued frames while the SSP is an enabled master.
+  */
+static void ssp_shift(SSP_State_Type *s)
+{
+    uint16_t mask = (2 << (s->CR0 & SSP_DSS_Mask)) - 1;
+    uint16_t mosi;
+    uint16_t miso;
+
+
+    if (!(s->CR1 & SSP_SSE) || (s->CR1 & SSP_MS)) {
+        return;
+    }
+
+    while (s->Tx.Count) {
+        mosi = host_fifo_pop(&s->Tx) & mask;
+
+        if (s->CR1 & SSP_LBM) {
+            miso = mosi;
+        } else if (s->Slave) {
+            miso = s->Slave(mosi);
+        } else {
+            miso = 0xffff;
+        }
+
+        if (!host_fifo_push(&s->Rx, miso & mask)) {
+            s->Sticky |= SSP_INT_ROR;
+        }
+
+        s->Frames++;
+    }
+}
+
+static void ssp_reset(HOST_Model_Type *model)
+{
+    SSP_State_Type *s = model->State;
+    IRQn_Type irq = s->IRQn;
+    uint16_t (*slave)(uint16_t) = s->Slave;
+
+
+    memset(s, 0, sizeof(*s));
+    s->IRQn = irq;
+    s->Slave = slave;
+    host_fifo_init(&s->Rx, SSP_FIFO_DEPTH);
+    host_fifo_init(&s->Tx, SSP_FIFO_DEPTH);
+}
+
+static uint32_t ssp_peek(HOST_Model_Type *model, uint32_t offset)
+{
+    SSP_State_Type *s = model->State;
+
+
+    switch (offset) {
+    case 0x00: return s->CR0;
+    case 0x04: return s->CR1;
+    case 0x08: return host_fifo_peek(&s->Rx);
+    case 0x0c:
+        return ((s->Tx.Count == 0) ? SSP_TFE : 0)
+             | ((s->Tx.Count < SSP_FIFO_DEPTH) ? SSP_TNF : 0)
+             | (s->Rx.Count ? SSP_RNE : 0)
+             | ((s->Rx.Count == SSP_FIFO_DEPTH) ? SSP_RFF : 0);
+    case 0x10: return s->CPSR;
+    case 0x14: return s->IMSC;
+    case 0x18: return ssp_ris(s);
+    case 0x1c: return ssp_ris(s) & s->IMSC;
+    default:   return 0;
+    }
+}
+
+static uint32_t ssp_read(HOST_Model_Type *model, uint32_t offset)
+{
+    SSP_State_Type *s = model->State;
+    uint32_t value = ssp_peek(model, offset);
+
+
+    if (offset == 0x08) {
+        host_fifo_pop(&s->Rx);
+        s->Sticky &= ~SSP_INT_RT;
+        ssp_update_irq(s);
+    }
+
+    return value;
+}
+
+static void ssp_write(HOST_Model_Type *model, uint32_t offset, uint32_t value)
+{
+    SSP_State_Type *s = model->State;
+
+
+    switch (offset) {
+    case 0x00: s->CR0 = value & SSP_CR0_Mask; break;
+    case 0x04: s->CR1 = value & SSP_CR1_Mask; break;
+    case 0x08: host_fifo_push(&s->Tx, value & 0xffff); break;
+    case 0x10: s->CPSR = value & 0xfe; break;
+    case 0x14: s->IMSC = value & SSP_IMSC_Mask; break;
+    case 0x20: s->Sticky &= ~(value & (SSP_INT_ROR | SSP_INT_RT)); break;
+    default:
+        break;
+    }
+
+    ssp_shift(s);
+    ssp_update_irq(s);
+}
+
+#define SSP_MODEL(n)                                                \
+HOST_Model_Type HOST_SSP##n##Model = {                              \
+    .Name    = "SSP" #n,                                            \
+    .Base    = SSP##n##_BASE,                                       \
+    .Size    = sizeof(SSP_Type),                                    \
+    .State   = &SspState[n],                                        \
+    .Reset   = ssp_reset,                                           \
+    .Read    = ssp_read,                                            \
+    .Peek    = ssp_peek,                                            \
+    .Write   = ssp_write,                                           \
+    .Enabled = 1,                                                   \
+}
+
+SSP_MODEL(0);
+SSP_MODEL(1);
+
+
+/** @brief Get the model state for an SSP.
+  */
+static SSP_State_Type *ssp_state(SSP_Type *ssp)
+{
+    return (ssp == SSP1) ? &SspState[1] : &SspState[0];
+}
+
+
+/* Harness Functions --------------------------------------------------------*/
+
+/** @brief Attach a simulated slave device to an SSP.
+  */
+void HOST_SSPSetSlave(SSP_Type *ssp, uint16_t (*xfer)(uint16_t mosi))
+{
+    ssp_state(ssp)->Slave = xfer;
+}
+
+/** @brief Get the number of frames an SSP has shifted.
+  */
+uint32_t HOST_SSPGetFrameCount(SSP_Type *ssp)
+{
+    return ssp_state(ssp)->Frames;
+}
@@ -0,0 +1,446 @@
+/******************************************************************************
+ * @file:    lpc11xx_host_uart.c
+ * @purpose: Host model of the LPC11xx UART (FIFOs, interrupt ID, flow control).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_host_priv.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+#define UART_FIFO_DEPTH   (16)
+
+/* Characters the harness can collect from the transmit wire */
+#define UART_WIRE_SIZE    (4096)
+
+/* IER bits (not all have names in lpc11xx.h) */
+#define UART_IER_RBR      (1 << 0)
+#define UART_IER_THRE     (1 << 1)
+#define UART_IER_RLS      (1 << 2)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static struct {
+    HOST_FIFO_Type Rx;
+    HOST_FIFO_Type Tx;
+    uint8_t  Wire[UART_WIRE_SIZE];
+    unsigned WireHead;
+    unsigned WireCount;
+    uint32_t IER;
+    uint32_t LCR;
+    uint32_t MCR;
+    uint32_t SCR;
+    uint32_t ACR;
+    uint32_t FDR;
+    uint32_t TER;
+    uint32_t DLL;
+    uint32_t DLM;
+    uint32_t FCR;
+    uint32_t RS485CTRL;
+    uint32_t ADRMATCH;
+    uint32_t RS485DLY;
+    uint32_t LSRErrors;       /* Sticky OE/PE/FE/BI until LSR is read */
+    uint32_t MSRDelta;        /* Sticky DCTS until MSR is read        */
+    int      THREPending;     /* THRE interrupt raised & not cleared  */
+    int      CTIPending;      /* Character time-out raised            */
+    int      TxHold;
+    int      CTS;
+    uint32_t Overruns;
+} Uart0;
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief RX trigger level (in characters) selected by FCR.
+  */
+static unsigned int uart_rx_trigger(void)
+{
+    static const uint8_t levels[] = { 1, 4, 8, 14 };
+
+
+    return levels[(Uart0.FCR & UART_RXTRIGLVL_Mask) >> UART_RXTRIGLVL_Shift];
+}
+
+/** @brief Current (active) state of the RTS output.
+  */
+static int uart_rts(void)
+{
+    if (Uart0.MCR & UART_RTSENA) {
+        return Uart0.Rx.Count < uart_rx_trigger();
+    }
+
+    return (Uart0.MCR & UART_RTS) ? 1 : 0;
+}
+
+/** @brief Highest priority pending interrupt ID (IIR[3:0]).
+  */
+static uint32_t uart_intid(void)
+{
+    if ((Uart0.IER & UART_IER_RLS) && (Uart0.LSRErrors & (UART_OE | UART_PE | UART_FE | UART_BI))) {
+        return UART_INTID_RLS;
+    }
+
+    if ((Uart0.IER & UART_IER_RBR) && (Uart0.Rx.Count >= uart_rx_trigger())) {
+        return UART_INTID_RDA;
+    }
+
+    if ((Uart0.IER & UART_IER_RBR) && Uart0.CTIPending && Uart0.Rx.Count) {
+        return UART_INTID_CTI;
+    }
+
+    if ((Uart0.IER & UART_IER_THRE) && Uart0.THREPending) {
+        return UART_INTID_THRE;
+    }
+
+    return UART_INTID_NONE;
+}
+
+static void uart_update_irq(void)
+{
+    HOST_SetIRQLine(UART0_IRQn, uart_intid() != UART_INTID_NONE);
+}
+
+/** @brief Deliver one character to the receiver (wire or loopback).
+  */
+static int uart_rx_char(uint8_t c)
+{
+    if (!host_fifo_push(&Uart0.Rx, c)) {
+        Uart0.LSRErrors |= UART_OE;
+        Uart0.Overruns++;
+        return 0;
+    }
+
+    Uart0.CTIPending = 0;
+
+    return 1;
+}
+
+/** @brief Move characters from the TX FIFO onto the wire.
+  * @param  max  Maximum number of characters to move.
+  * @return Number of characters moved.
+  */
+static unsigned int uart_shift_out(unsigned int max)
+{
+    unsigned int n = 0;
+    uint8_t c;
+
+
+    while ((n < max) && Uart0.Tx.Count && (Uart0.TER & UART_TXEN)
+           && (!(Uart0.MCR & UART_CTSENA) || Uart0.CTS))
+    {
+        c = host_fifo_pop(&Uart0.Tx);
+
+        if (Uart0.MCR & UART_LOOPBACK) {
+            uart_rx_char(c);
+        } else {
+            Uart0.Wire[(Uart0.WireHead + Uart0.WireCount) % UART_WIRE_SIZE] = c;
+
+            if (Uart0.WireCount < UART_WIRE_SIZE) {
+                Uart0.WireCount++;
+            } else {
+                Uart0.WireHead = (Uart0.WireHead + 1) % UART_WIRE_SIZE;
+            }
+        }
+
+        n++;
+
+        if (Uart0.Tx.Count == 0) {
+            Uart0.THREPending = 1;
+        }
+    }
+
+    return n;
+}
+
+static void uart_reset(HOST_Model_Type *model)
+{
+    (void)model;
+
+    memset(&Uart0, 0, sizeof(Uart0));
+    host_fifo_init(&Uart0.Rx, UART_FIFO_DEPTH);
+    host_fifo_init(&Uart0.Tx, UART_FIFO_DEPTH);
+
+    Uart0.DLL = 1;
+    Uart0.FDR = 0x10;
+    Uart0.TER = UART_TXEN;
+    Uart0.CTS = 1;
+}
+
+static uint32_t uart_peek(HOST_Model_Type *model, uint32_t offset)
+{
+    (void)model;
+
+    switch (offset) {
+    case 0x00:
+        return (Uart0.LCR & UART_DLAB) ? Uart0.DLL : host_fifo_peek(&Uart0.Rx);
+    case 0x04:
+        return (Uart0.LCR & UART_DLAB) ? Uart0.DLM : Uart0.IER;
+    case 0x08:
+        return uart_intid() | ((Uart0.FCR & UART_FIFOEN) ? UART_FIFO_Mask : 0);
+    case 0x0c:
+        return Uart0.LCR;
+    case 0x10:
+        return Uart0.MCR;
+    case 0x14:
+        return Uart0.LSRErrors
+               | (Uart0.Rx.Count ? UART_RDR : 0)
+               | (Uart0.Tx.Count ? 0 : (UART_THRE | UART_TEMT));
+    case 0x18:
+        return Uart0.MSRDelta | (Uart0.CTS ? UART_CTS : 0);
+    case 0x1c: return Uart0.SCR;
+    case 0x20: return Uart0.ACR;
+    case 0x28: return Uart0.FDR;
+    case 0x30: return Uart0.TER;
+    case 0x4c: return Uart0.RS485CTRL;
+    case 0x50: return Uart0.ADRMATCH;
+    case 0x54: return Uart0.RS485DLY;
+    case 0x58: return Uart0.Rx.Count | (Uart0.Tx.Count << 8);
+    default:   return 0;
+    }
+}
+
+static uint32_t uart_read(HOST_Model_Type *model, uint32_t offset)
+{
+    uint32_t value = uart_peek(model, offset);
+
+
+    switch (offset) {
+    case 0x00:
+        if (!(Uart0.LCR & UART_DLAB)) {
+            host_fifo_pop(&Uart0.Rx);
+            Uart0.CTIPending = 0;
+        }
+        break;
+    case 0x08:
+        /* Reading IIR clears a THRE interrupt if that's what it reports */
+        if ((value & UART_INTID_Mask) == UART_INTID_THRE) {
+            Uart0.THREPending = 0;
+        }
+        break;
+    case 0x14:
+        Uart0.LSRErrors = 0;
+        break;
+    case 0x18:
+        Uart0.MSRDelta = 0;
+        break;
+    default:
+        break;
+    }
+
+    uart_update_irq();
+
+    return value;
+}
+
+static void uart_write(HOST_Model_Type *model, uint32_t offset, uint32_t value)
+{
+    (void)model;
+
+    switch (offset) {
+    case 0x00:
+        if (Uart0.LCR & UART_DLAB) {
+            Uart0.DLL = value & UART_DLLSB_Mask;
+        } else {
+            host_fifo_push(&Uart0.Tx, value & 0xff);
+            Uart0.THREPending = 0;
+
+            if (!Uart0.TxHold) {
+                uart_shift_out(UART_FIFO_DEPTH);
+            }
+        }
+        break;
+    case 0x04:
+        if (Uart0.LCR & UART_DLAB) {
+            Uart0.DLM = value & UART_DLMSB_Mask;
+        } else {
+            /* Enabling THRE with an empty transmitter raises it at once */
+            if ((value & UART_IER_THRE) && !(Uart0.IER & UART_IER_THRE) && (Uart0.Tx.Count == 0)) {
+                Uart0.THREPending = 1;
+            }
+            Uart0.IER = value & UART_IER_Mask;
+        }
+        break;
+    case 0x08:
+        if (value & UART_FIFO_RX_RESET) {
+            host_fifo_init(&Uart0.Rx, UART_FIFO_DEPTH);
+            Uart0.CTIPending = 0;
+        }
+        if (value & UART_FIFO_TX_RESET) {
+            host_fifo_init(&Uart0.Tx, UART_FIFO_DEPTH);
+        }
+        Uart0.FCR = value & (UART_FIFOEN | UART_RXTRIGLVL_Mask);
+        break;
+    case 0x0c: Uart0.LCR = value & UART_LCR_Mask; break;
+    case 0x10:
+        Uart0.MCR = value & UART_MCR_Mask;
+        if (!Uart0.TxHold) {
+            uart_shift_out(UART_FIFO_DEPTH);
+        }
+        break;
+    case 0x1c: Uart0.SCR = value & 0xff; break;
+    case 0x20: Uart0.ACR = value & 0x07; break;
+    case 0x28: Uart0.FDR = value & UART_FDR_Mask; break;
+    case 0x30:
+        Uart0.TER = value & UART_TXEN;
+        if (!Uart0.TxHold) {
+            uart_shift_out(UART_FIFO_DEPTH);
+        }
+        break;
+    case 0x4c: Uart0.RS485CTRL = value & UART_RS485CTRL_Mask; break;
+    case 0x50: Uart0.ADRMATCH = value & UART_RS485ADRMATCH_Mask; break;
+    case 0x54: Uart0.RS485DLY = value & UART_RS485DLY_Mask; break;
+    default:
+        break;
+    }
+
+    uart_update_irq();
+}
+
+HOST_Model_Type HOST_UART0Model = {
+    .Name    = "UART0",
+    .Base    = UART0_BASE,
+    .Size    = sizeof(UART_Type),
+    .Reset   = uart_reset,
+    .Read    = uart_read,
+    .Peek    = uart_peek,
+    .Write   = uart_write,
+    .Enabled = 1,
+};
+
+
+/* Harness Functions --------------------------------------------------------*/
+
+/** @brief Deliver characters to a UART's receiver.
+  */
+unsigned int HOST_UARTReceive(UART_Type *uart, const uint8_t *data, unsigned int len)
+{
+    unsigned int n = 0;
+
+
+    (void)uart;
+
+    while (n < len) {
+        if (!uart_rx_char(data[n])) {
+            break;
+        }
+        n++;
+    }
+
+    uart_update_irq();
+    host_harness_done();
+
+    return n;
+}
+
+/** @brief Signal that the receive line has been idle for the time-out period.
+  */
+void HOST_UARTRxIdle(UART_Type *uart)
+{
+    (void)uart;
+
+    if (Uart0.Rx.Count) {
+        Uart0.CTIPending = 1;
+    }
+
+    uart_update_irq();
+    host_harness_done();
+}
+
+/** @brief Collect characters the UART has put on the wire.
+  */
+unsigned int HOST_UARTTransmitted(UART_Type *uart, uint8_t *buf, unsigned int max)
+{
+    unsigned int n = 0;
+
+
+    (void)uart;
+
+    while ((n < max) && Uart0.WireCount) {
+        buf[n++] = Uart0.Wire[Uart0.WireHead];
+        Uart0.WireHead = (Uart0.WireHead + 1) % UART_WIRE_SIZE;
+        Uart0.WireCount--;
+    }
+
+    return n;
+}
+
+/** @brief Choose whether the transmitter drains instantly or on demand.
+  */
+void HOST_UARTSetTxHold(UART_Type *uart, int hold)
+{
+    (void)uart;
+
+    Uart0.TxHold = hold;
+
+    if (!hold) {
+        uart_shift_out(UART_FIFO_DEPTH);
+        uart_update_irq();
+        host_harness_done();
+    }
+}
+
+/** @brief Shift characters out of a held transmitter.
+  */
+unsigned int HOST_UARTShiftOut(UART_Type *uart, unsigned int count)
+{
+    unsigned int n;
+
+
+    (void)uart;
+
+    n = uart_shift_out(count);
+
+    uart_update_irq();
+    host_harness_done();
+
+    return n;
+}
+
+/** @brief Set the level of the (active-low) CTS input.
+  */
+void HOST_UARTSetCTS(UART_Type *uart, int asserted)
+{
+    (void)uart;
+
+    if ((asserted ? 1 : 0) != Uart0.CTS) {
+        Uart0.MSRDelta |= UART_DCTS;
+    }
+
+    Uart0.CTS = asserted ? 1 : 0;
+
+    if (!Uart0.TxHold) {
+        uart_shift_out(UART_FIFO_DEPTH);
+    }
+
+    uart_update_irq();
+    host_harness_done();
+}
+
+/** @brief Get the level of the (active-low) RTS output.
+  */
+int HOST_UARTGetRTS(UART_Type *uart)
+{
+    (void)uart;
+
+    return uart_rts();
+}
+
+/** @brief Get the number of characters lost to RX FIFO overrun.
+  */
+uint32_t HOST_UARTGetOverruns(UART_Type *uart)
+{
+    (void)uart;
+
+    return Uart0.Overruns;
+}
@@ -0,0 +1,214 @@
+/******************************************************************************
+ * @file:    lpc11xx_host_wdt.c
+ * @purpose: Host model of the LPC11xx watchdog timer (feed sequence,
+ *           time-out reset / interrupt).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx/wdt.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_host_priv.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* The WDT counter is clocked at wdt_clk / 4 */
+#define WDT_PRESCALE      (4)
+
+/* Smallest time-out the hardware allows */
+#define WDT_TC_Min        (0xff)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static struct {
+    uint32_t MOD;
+    uint32_t TC;
+    uint32_t TV;
+    uint32_t Prescale;        /* wdt_clk cycles towards the next TV tick */
+    int      GotAA;           /* First half of feed sequence seen        */
+    int      Running;         /* Enabled & fed at least once             */
+    uint32_t Feeds;
+    uint32_t FeedErrors;
+} Wdt;
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+static void wdt_update_irq(void)
+{
+    HOST_SetIRQLine(WDT_IRQn, (Wdt.MOD & WDT_WDINT) && !(Wdt.MOD & WDT_WDRESET));
+}
+
+/** @brief Watchdog time-out (or feed error): flag, then reset or interrupt.
+  */
+static void wdt_timeout(void)
+{
+    Wdt.MOD |= WDT_WDTOF | WDT_WDINT;
+
+    if (Wdt.MOD & WDT_WDRESET) {
+        Wdt.Running = 0;
+        host_request_reset(HOST_ResetSource_WDT);
+    }
+
+    wdt_update_irq();
+}
+
+/** @brief Any access other than the second half of a feed breaks the sequence.
+  */
+static void wdt_check_sequence(uint32_t offset, int write, uint32_t value)
+{
+    if (!Wdt.GotAA) {
+        return;
+    }
+
+    Wdt.GotAA = 0;
+
+    if ((offset == 0x08) && write && (value == WDT_Feed_B)) {
+        Wdt.TV = Wdt.TC;
+        Wdt.Prescale = 0;
+        Wdt.Feeds++;
+
+        if (Wdt.MOD & WDT_WDEN) {
+            Wdt.Running = 1;
+        }
+        return;
+    }
+
+    if (Wdt.Running) {
+        Wdt.FeedErrors++;
+        wdt_timeout();
+    }
+}
+
+static void wdt_reset(HOST_Model_Type *model)
+{
+    (void)model;
+
+    memset(&Wdt, 0, sizeof(Wdt));
+    Wdt.TC = WDT_TC_Min;
+    Wdt.TV = WDT_TC_Min;
+}
+
+static uint32_t wdt_peek(HOST_Model_Type *model, uint32_t offset)
+{
+    (void)model;
+
+    switch (offset) {
+    case 0x00: return Wdt.MOD;
+    case 0x04: return Wdt.TC;
+    case 0x0c: return Wdt.TV;
+    default:   return 0;
+    }
+}
+
+static uint32_t wdt_read(HOST_Model_Type *model, uint32_t offset)
+{
+    wdt_check_sequence(offset, 0, 0);
+
+    return wdt_peek(model, offset);
+}
+
+static void wdt_write(HOST_Model_Type *model, uint32_t offset, uint32_t value)
+{
+    (void)model;
+
+    if (Wdt.GotAA) {
+        wdt_check_sequence(offset, 1, value);
+        return;
+    }
+
+    switch (offset) {
+    case 0x00:
+        /* WDEN & WDRESET can only be set; WDTOF only cleared; WDINT by
+         *  writing 1 (L-series behavior, harmless on others)
+         */
+        Wdt.MOD |= value & (WDT_WDEN | WDT_WDRESET);
+        if (!(value & WDT_WDTOF)) {
+            Wdt.MOD &= ~WDT_WDTOF;
+        }
+        if (value & WDT_WDINT) {
+            Wdt.MOD &= ~WDT_WDINT;
+        }
+        break;
+    case 0x04:
+        Wdt.TC = value & WDT_TC_Mask;
+        if (Wdt.TC < WDT_TC_Min) {
+            Wdt.TC = WDT_TC_Min;
+        }
+        break;
+    case 0x08:
+        if (value == WDT_Feed_A) {
+            Wdt.GotAA = 1;
+        } else if (Wdt.Running) {
+            Wdt.FeedErrors++;
+            wdt_timeout();
+        }
+        break;
+    default:
+        break;
+    }
+
+    wdt_update_irq();
+}
+
+static void wdt_advance(HOST_Model_Type *model, uint32_t clocks)
+{
+    uint32_t ticks;
+
+
+    (void)model;
+
+    if (!Wdt.Running) {
+        return;
+    }
+
+    Wdt.Prescale += clocks % WDT_PRESCALE;
+    ticks = clocks / WDT_PRESCALE + Wdt.Prescale / WDT_PRESCALE;
+    Wdt.Prescale %= WDT_PRESCALE;
+
+    if (ticks < Wdt.TV) {
+        Wdt.TV -= ticks;
+        return;
+    }
+
+    Wdt.TV = 0;
+    wdt_timeout();
+}
+
+HOST_Model_Type HOST_WDTModel = {
+    .Name    = "WDT",
+    .Base    = WDT_BASE,
+    .Size    = sizeof(WDT_Type),
+    .Reset   = wdt_reset,
+    .Read    = wdt_read,
+    .Peek    = wdt_peek,
+    .Write   = wdt_write,
+    .Advance = wdt_advance,
+    .Enabled = 1,
+};
+
+
+/* Harness Functions --------------------------------------------------------*/
+
+/** @brief Get the number of feed sequence errors seen by the watchdog.
+  */
+uint32_t HOST_WDTGetFeedErrors(void)
+{
+    return Wdt.FeedErrors;
+}
+
+/** @brief Get the number of valid feeds seen by the watchdog.
+  */
+uint32_t HOST_WDTGetFeeds(void)
+{
+    return Wdt.Feeds;
+}
@@ -0,0 +1,243 @@
+/******************************************************************************
+ * @file:    lpc11xx_pack.c
+ * @purpose: lpc11xx-pack: compress a .data load image for _start to unpack
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Usage: lpc11xx-pack [-o out.s] data.bin
+ *
+ * Reads the raw .data contents (objcopy -O binary -j .data) & writes an
+ * assembler file putting the packed image in the .data_lz section, headed by
+ * the address of _meminit_unpack (src/lpc11xx_unpack.s, which describes the
+ * format).  Sizes go to stderr.  See LPC11XX_DATA_LZ in lpc11xx.mk for how
+ * it fits into a build.
+ *
+ * The search is brute force (greedy longest match); .data is at most a few
+ * KB, so this is quick enough & keeps the format trivial to unpack.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+#define PACK_MAX_INPUT      (65536)
+
+#define PACK_MAX_LITERALS   (128)           /* control 0x00-0x7f          */
+#define PACK_MIN_MATCH      (4)             /* control 0x80-0xff          */
+#define PACK_MAX_MATCH      (PACK_MIN_MATCH + 127)
+#define PACK_MAX_OFFSET     (65535)
+
+/* Bytes ahead of the packed data (unpacker address) */
+#define PACK_HEADER_SIZE    (4)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static uint8_t PackIn[PACK_MAX_INPUT];
+static uint8_t PackOut[PACK_MAX_INPUT + PACK_MAX_INPUT / PACK_MAX_LITERALS + 1];
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+static void pack_usage(void)
+{
+    fprintf(stderr, "usage: lpc11xx-pack [-o out.s] data.bin\n");
+    exit(1);
+}
+
+/** @brief Find the longest earlier match for the input at pos.
+  * @return The match length (0 if under PACK_MIN_MATCH); *offset is set.
+  */
+static size_t pack_match(size_t pos, size_t len, size_t *offset)
+{
+    size_t best = 0;
+    size_t start = (pos > PACK_MAX_OFFSET) ? pos - PACK_MAX_OFFSET : 0;
+    size_t limit = len - pos;
+    size_t i;
+    size_t n;
+
+
+    if (limit > PACK_MAX_MATCH) {
+        limit = PACK_MAX_MATCH;
+    }
+
+    for (i = start; i < pos; i++) {
+        /* May run past pos: the unpacker copies byte by byte */
+        for (n = 0; (n < limit) && (PackIn[i + n] == PackIn[pos + n]); n++);
+
+        /* Prefer the nearest of equal matches */
+        if (n >= best) {
+            best = n;
+            *offset = pos - i;
+        }
+    }
+
+    return (best >= PACK_MIN_MATCH) ? best : 0;
+}
+
+/** @brief Compress PackIn into PackOut.
+  * @return The packed size.
+  */
+static size_t pack(size_t len)
+{
+    size_t in = 0;
+    size_t out = 0;
+    size_t literals = 0;
+    size_t match;
+    size_t offset = 0;
+
+
+    while (in < len) {
+        match = pack_match(in, len, &offset);
+
+        if (match == 0) {
+            literals++;
+            in++;
+        }
+
+        /* Flush literals before a match, when full, or at the end */
+        if (literals && (match || (literals == PACK_MAX_LITERALS) || (in == len))) {
+            PackOut[out++] = literals - 1;
+            memcpy(&PackOut[out], &PackIn[in - literals], literals);
+            out += literals;
+            literals = 0;
+        }
+
+        if (match) {
+            PackOut[out++] = 0x80 + (match - PACK_MIN_MATCH);
+            PackOut[out++] = offset & 0xff;
+            PackOut[out++] = offset >> 8;
+            in += match;
+        }
+    }
+
+    return out;
+}
+
+/** @brief Check the packed data against the input (same algorithm as the
+  *        unpacker).
+  */
+static int pack_check(size_t len, size_t packed)
+{
+    static uint8_t check[PACK_MAX_INPUT];
+    size_t in = 0;
+    size_t out = 0;
+    size_t n;
+    size_t offset;
+
+
+    while (out < len) {
+        if (in >= packed) {
+            return -1;
+        }
+
+        if (PackOut[in] < 0x80) {
+            n = PackOut[in++] + 1;
+            if ((out + n > len) || (in + n > packed)) {
+                return -1;
+            }
+            memcpy(&check[out], &PackOut[in], n);
+            in += n;
+            out += n;
+        } else {
+            n = PackOut[in] - 0x80 + PACK_MIN_MATCH;
+            offset = PackOut[in + 1] | (PackOut[in + 2] << 8);
+            in += 3;
+            if ((offset == 0) || (offset > out) || (out + n > len)) {
+                return -1;
+            }
+            for (; n; n--, out++) {
+                check[out] = check[out - offset];
+            }
+        }
+    }
+
+    return ((in == packed) && (memcmp(check, PackIn, len) == 0)) ? 0 : -1;
+}
+
+
+/* Functions ----------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    const char *output = 0;
+    FILE *in;
+    FILE *out = stdout;
+    size_t len;
+    size_t packed;
+    size_t i;
+    int opt;
+
+
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        switch (opt) {
+        case 'o':
+            output = optarg;
+            break;
+
+        default:
+            pack_usage();
+        }
+    }
+
+    if (optind != argc - 1) {
+        pack_usage();
+    }
+
+    in = fopen(argv[optind], "rb");
+    if (in == 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    len = fread(PackIn, 1, sizeof(PackIn), in);
+    if (!feof(in) || ferror(in)) {
+        fprintf(stderr, "lpc11xx-pack: %s: too big or unreadable\n", argv[optind]);
+        return 1;
+    }
+    fclose(in);
+
+    packed = pack(len);
+
+    if (pack_check(len, packed) < 0) {
+        fprintf(stderr, "lpc11xx-pack: internal error: packed data doesn't unpack\n");
+        return 1;
+    }
+
+    if (output) {
+        out = fopen(output, "w");
+        if (out == 0) {
+            perror(output);
+            return 1;
+        }
+    }
+
+    fprintf(out, "/* Packed .data image from %s (lpc11xx-pack): %lu -> %lu bytes */\n\n",
+            argv[optind], (unsigned long)len, (unsigned long)packed);
+    fprintf(out, "    .syntax unified\n    .cpu    cortex-m0\n    .thumb\n\n");
+    fprintf(out, "    .section .data_lz, \"a\", %%progbits\n    .align  2\n\n");
+    fprintf(out, "    .word   _meminit_unpack\n");
+
+    for (i = 0; i < packed; i++) {
+        fprintf(out, "%s0x%02x", (i % 16) ? ", " : "\n    .byte   ", PackOut[i]);
+    }
+    fprintf(out, "\n");
+
+    if (output) {
+        fclose(out);
+    }
+
+    fprintf(stderr, "lpc11xx-pack: .data %lu bytes, packed %lu (+%d header)%s\n",
+            (unsigned long)len, (unsigned long)packed, PACK_HEADER_SIZE,
+            (packed + PACK_HEADER_SIZE >= len) ? "; no smaller, not worth packing" : "");
+
+    return 0;
+}
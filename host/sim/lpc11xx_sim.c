@@ -0,0 +1,179 @@
+/******************************************************************************
+ * @file:    lpc11xx_sim.c
+ * @purpose: lpc11xx-sim: run an LPC11xx ELF image on a simulated Cortex-M0
+ *           & report cycle counts per function.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Usage: lpc11xx-sim [options] image.elf
+ *
+ *   -c cycles    Stop after this many core clocks (default 1000000000,
+ *                0 for no limit)
+ *   -u where     Stop on reaching a symbol or address (e.g. -u main to time
+ *                startup code)
+ *   -m cycles    MULS cost: 1 (fast multiplier, default) or 32
+ *   -o file      Write the report to a file instead of stderr
+ *   -t           Tab-separated report (for scripts)
+ *   -q           No report; just the program's exit status
+ *
+ * The image is linked with the usual link_scripts/ *-rom.ld scripts and runs
+ * from its reset vector, so all of lpc11xx_crt0.c is counted.  Semihosting
+ * output goes to stdout; the exit status is the program's SYS_EXIT code, 0
+ * on reaching the -u address, or 2 if it stopped for any other reason.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_sim.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+#define SIM_DEFAULT_MAX_CYCLES  (1000000000ULL)
+
+/* Exit status when the program didn't exit by itself */
+#define SIM_EXIT_STOPPED        (2)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static SIM_CPU_Type SimCPU;
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Reset requested by the program (SYSRESETREQ / watchdog): stop.
+  */
+static void sim_reset_hook(HOST_ResetSource_Type source)
+{
+    (void)source;
+
+    SimCPU.Stop = SIM_Stop_Reset;
+}
+
+static void sim_usage(void)
+{
+    fprintf(stderr, "usage: lpc11xx-sim [-c cycles] [-u symbol|address] [-m 1|32]"
+                    " [-o file] [-t] [-q] image.elf\n");
+    exit(SIM_EXIT_STOPPED);
+}
+
+
+/* Functions ----------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    const char *until = 0;
+    const char *report = 0;
+    char *end;
+    FILE *out = stderr;
+    int quiet = 0;
+    int tsv = 0;
+    int opt;
+
+
+    SimCPU.MaxCycles = SIM_DEFAULT_MAX_CYCLES;
+    SimCPU.MulCycles = 1;
+    SimCPU.Until = 1;
+
+    while ((opt = getopt(argc, argv, "c:u:m:o:tq")) != -1) {
+        switch (opt) {
+        case 'c':
+            SimCPU.MaxCycles = strtoull(optarg, &end, 0);
+            if (*end) {
+                sim_usage();
+            }
+            break;
+
+        case 'u':
+            until = optarg;
+            break;
+
+        case 'm':
+            SimCPU.MulCycles = strtoul(optarg, &end, 0);
+            if (*end || ((SimCPU.MulCycles != 1) && (SimCPU.MulCycles != 32))) {
+                sim_usage();
+            }
+            break;
+
+        case 'o':
+            report = optarg;
+            break;
+
+        case 't':
+            tsv = 1;
+            break;
+
+        case 'q':
+            quiet = 1;
+            break;
+
+        default:
+            sim_usage();
+        }
+    }
+
+    if (optind != argc - 1) {
+        sim_usage();
+    }
+
+    /* Unprogrammed flash reads as ones */
+    memset(SimCPU.Flash, 0xff, sizeof(SimCPU.Flash));
+
+    if (SIM_LoadELF(&SimCPU, argv[optind]) < 0) {
+        return SIM_EXIT_STOPPED;
+    }
+
+    SIM_RomInit(&SimCPU);
+
+    if (until) {
+        if (SIM_LookupSymbol(until, &SimCPU.Until) < 0) {
+            SimCPU.Until = strtoul(until, &end, 0) & ~1UL;
+            if (*end) {
+                fprintf(stderr, "lpc11xx-sim: unknown symbol '%s'\n", until);
+                return SIM_EXIT_STOPPED;
+            }
+        }
+    }
+
+    HOST_Init();
+    HOST_SetExternalCPU(1);
+    HOST_SetResetHook(sim_reset_hook);
+
+    SIM_Reset(&SimCPU);
+    SIM_Run(&SimCPU);
+    SIM_ProfFinish(&SimCPU);
+
+    fflush(stdout);
+
+    if (!quiet) {
+        if (report) {
+            out = fopen(report, "w");
+            if (out == 0) {
+                perror(report);
+                return SIM_EXIT_STOPPED;
+            }
+        }
+
+        SIM_ProfReport(&SimCPU, out, tsv);
+
+        if (report) {
+            fclose(out);
+        }
+    }
+
+    switch (SimCPU.Stop) {
+    case SIM_Stop_Exit:  return SimCPU.ExitCode;
+    case SIM_Stop_Until: return 0;
+    default:             return SIM_EXIT_STOPPED;
+    }
+}
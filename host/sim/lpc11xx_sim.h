@@ -0,0 +1,124 @@
+/******************************************************************************
+ * @file:    lpc11xx_sim.h
+ * @purpose: Internal interfaces of the Cortex-M0 instruction set simulator
+ *           (lpc11xx-sim).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+#ifndef LPC11XX_SIM_H_
+#define LPC11XX_SIM_H_
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+
+
+/* Defines ------------------------------------------------------------------*/
+
+/* Memory map (largest LPC11xx parts; smaller parts simply don't use it all) */
+#define SIM_FLASH_BASE    (0x00000000UL)
+#define SIM_FLASH_SIZE    (64 * 1024)
+#define SIM_RAM_BASE      (0x10000000UL)
+#define SIM_RAM_SIZE      (8 * 1024)
+#define SIM_ROM_BASE      (0x1fff0000UL)
+#define SIM_ROM_SIZE      (16 * 1024)
+
+/* Addresses below this are remapped by SYSCON->SYSMEMREMAP */
+#define SIM_REMAP_SIZE    (0x200)
+
+/* Exception number of the first external interrupt */
+#define SIM_EXC_IRQ0      (16)
+
+/* Cortex-M0 exception entry / return with zero wait state memory */
+#define SIM_EXC_ENTRY_CYCLES  (16)
+#define SIM_EXC_RETURN_CYCLES (16)
+
+/* Cycles spent per step while asleep in WFI waiting for an interrupt */
+#define SIM_SLEEP_STEP    (16)
+
+
+/* Types --------------------------------------------------------------------*/
+
+/*! @brief Why the simulation stopped */
+typedef enum {
+    SIM_Stop_None = 0,          /*!< Still running                          */
+    SIM_Stop_Exit,              /*!< Semihosting SYS_EXIT                   */
+    SIM_Stop_Breakpoint,        /*!< BKPT instruction                       */
+    SIM_Stop_Until,             /*!< Reached the -u address                 */
+    SIM_Stop_CycleLimit,        /*!< Reached the -c cycle limit             */
+    SIM_Stop_Idle,              /*!< Waiting with no interrupt able to fire */
+    SIM_Stop_Lockup,            /*!< Fault inside the HardFault handler     */
+    SIM_Stop_Reset,             /*!< System / watchdog reset requested      */
+} SIM_Stop_Type;
+
+/*! @brief Processor & memory state */
+typedef struct {
+    uint32_t      R[16];        /*!< R0-R12, SP (current), LR, PC           */
+    uint32_t      N, Z, C, V;   /*!< APSR condition flags (0 or 1)          */
+    uint32_t      OtherSP;      /*!< Whichever of MSP / PSP isn't in R[13]  */
+    uint32_t      CONTROL;      /*!< CONTROL.SPSEL (bit 1)                  */
+    int           Exception;    /*!< Active exception number, 0 in Thread   */
+
+    uint64_t      Cycles;       /*!< Total core clocks                      */
+    uint64_t      Instructions; /*!< Instructions retired                   */
+    uint64_t      WaitCycles;   /*!< Of Cycles, spent in flash wait states  */
+    uint64_t      SleepCycles;  /*!< Of Cycles, spent asleep in WFI         */
+    uint64_t      ExceptionCount;
+
+    uint32_t      FetchWord;    /*!< Address of the flash word last fetched */
+    unsigned int  MulCycles;    /*!< MULS cost (1 or 32 depending on part)  */
+    uint64_t      MaxCycles;    /*!< Stop after this many cycles (0: never) */
+    uint32_t      Until;        /*!< Stop on reaching this address, else 1  */
+
+    SIM_Stop_Type Stop;
+    int           ExitCode;
+
+    uint8_t       Flash[SIM_FLASH_SIZE];
+    uint8_t       Ram[SIM_RAM_SIZE];
+    uint8_t       Rom[SIM_ROM_SIZE];
+} SIM_CPU_Type;
+
+/*! @brief A function symbol & its profile */
+typedef struct {
+    const char   *Name;
+    uint32_t      Addr;
+    uint32_t      Size;
+    uint64_t      Calls;
+    uint64_t      Self;         /*!< Cycles spent in the function itself    */
+    uint64_t      Inclusive;    /*!< Cycles including callees & preemption  */
+    unsigned int  Depth;        /*!< Activations currently on the stack     */
+} SIM_Symbol_Type;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/* lpc11xx_sim_cpu.c */
+extern void SIM_Reset(SIM_CPU_Type *cpu);
+extern void SIM_Run(SIM_CPU_Type *cpu);
+extern uint32_t SIM_Read(SIM_CPU_Type *cpu, uint32_t addr, unsigned int size);
+extern void SIM_Write(SIM_CPU_Type *cpu, uint32_t addr, uint32_t value, unsigned int size);
+extern uint8_t *SIM_Memory(SIM_CPU_Type *cpu, uint32_t addr, uint32_t len);
+
+/* lpc11xx_sim_elf.c */
+extern int SIM_LoadELF(SIM_CPU_Type *cpu, const char *path);
+extern SIM_Symbol_Type *SIM_Symbols;
+extern unsigned int SIM_SymbolCount;
+extern int SIM_LookupSymbol(const char *name, uint32_t *addr);
+
+/* lpc11xx_sim_rom.c */
+extern int SIM_RomCall(SIM_CPU_Type *cpu, uint32_t pc);
+extern void SIM_RomInit(SIM_CPU_Type *cpu);
+
+/* lpc11xx_sim_prof.c */
+extern void SIM_ProfCall(SIM_CPU_Type *cpu, uint32_t target, uint32_t ret);
+extern void SIM_ProfReturn(SIM_CPU_Type *cpu, uint32_t pc);
+extern void SIM_ProfException(SIM_CPU_Type *cpu, uint32_t handler, uint32_t exc_return);
+extern void SIM_ProfExceptionReturn(SIM_CPU_Type *cpu);
+extern void SIM_ProfAccount(SIM_CPU_Type *cpu, uint32_t pc, unsigned int cycles);
+extern void SIM_ProfFinish(SIM_CPU_Type *cpu);
+extern void SIM_ProfReport(SIM_CPU_Type *cpu, FILE *out, int tsv);
+
+#endif /* #ifndef LPC11XX_SIM_H_ */
@@ -0,0 +1,1208 @@
+/******************************************************************************
+ * @file:    lpc11xx_sim_cpu.c
+ * @purpose: ARMv6-M (Cortex-M0) instruction set simulator core: decode,
+ *           execute, exceptions, memory map & cycle accounting.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx_sim.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* xPSR bits */
+#define SIM_XPSR_T            (1UL << 24)
+#define SIM_XPSR_ALIGN        (1UL << 9)
+
+/* CONTROL.SPSEL: Thread mode runs on the process stack */
+#define SIM_CONTROL_SPSEL     (1UL << 1)
+
+/* Exception numbers */
+#define SIM_EXC_HARDFAULT     (3)
+#define SIM_EXC_SVC           (11)
+
+/* Semihosting */
+#define SIM_SEMIHOST_BKPT     (0xab)
+#define SIM_SYS_WRITEC        (0x03)
+#define SIM_SYS_WRITE0        (0x04)
+#define SIM_SYS_WRITE         (0x05)
+#define SIM_SYS_EXIT          (0x18)
+#define SIM_ADP_APP_EXIT      (0x20026UL)
+
+/* Invalid address for the flash fetch buffer */
+#define SIM_NO_FETCH          (0xffffffffUL)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* Wait states picked up by the instruction being executed */
+static unsigned int SimExtra;
+
+/* Set by a memory access that faulted during the current instruction */
+static int         SimFault;
+static uint32_t    SimFaultAddr;
+static const char *SimFaultWhy;
+
+/* WFE event register */
+static int         SimEvent;
+
+
+/* Memory -------------------------------------------------------------------*/
+
+/** @brief Flash wait states currently configured (FLASHCFG.FLASHTIM).
+  */
+static unsigned int sim_flash_waits(void)
+{
+    return FLASH->FLASHCFG & FLASH_FLASHTIM_Mask;
+}
+
+/** @brief Test for an address in the (modelled) peripheral space.
+  */
+static int sim_is_peripheral(uint32_t addr)
+{
+    return ((addr - 0x40000000UL) < 0x00080000UL)
+        || ((addr - 0x50000000UL) < 0x00040000UL)
+        || ((addr - 0xe000e000UL) < 0x00001000UL);
+}
+
+/** @brief Note a bus fault; the current instruction ends in HardFault.
+  */
+static void sim_fault(uint32_t addr, const char *why)
+{
+    if (!SimFault) {
+        SimFault = 1;
+        SimFaultAddr = addr;
+        SimFaultWhy = why;
+    }
+}
+
+/** @brief Backing store for an address, after SYSMEMREMAP.
+  * @param[out] flash        Set to 1 if the access goes to flash.
+  */
+static uint8_t *sim_map(SIM_CPU_Type *cpu, uint32_t addr, int *flash)
+{
+    *flash = 0;
+
+    if (addr < SIM_REMAP_SIZE) {
+        switch (SYSCON->SYSMEMREMAP & SYSCON_SYSMEMREMAP_MAP_Mask) {
+        case SYSCON_SYSMEMREMAP_MAP_BOOTLOADER:
+            return &cpu->Rom[addr];
+        case SYSCON_SYSMEMREMAP_MAP_RAM:
+            return &cpu->Ram[addr];
+        default:
+            break;
+        }
+    }
+
+    if (addr - SIM_FLASH_BASE < SIM_FLASH_SIZE) {
+        *flash = 1;
+        return &cpu->Flash[addr - SIM_FLASH_BASE];
+    } else if (addr - SIM_RAM_BASE < SIM_RAM_SIZE) {
+        return &cpu->Ram[addr - SIM_RAM_BASE];
+    } else if (addr - SIM_ROM_BASE < SIM_ROM_SIZE) {
+        return &cpu->Rom[addr - SIM_ROM_BASE];
+    }
+
+    return 0;
+}
+
+/** @brief Get the backing store for a range of flash, RAM or ROM.
+  * @param[in]  cpu          The simulated CPU.
+  * @param[in]  addr         Start of the range (not remapped).
+  * @param[in]  len          Length of the range in bytes.
+  * @return                  Host pointer to the range, or (null) if the range
+  *                          isn't entirely inside one memory.
+  */
+uint8_t *SIM_Memory(SIM_CPU_Type *cpu, uint32_t addr, uint32_t len)
+{
+    if ((addr - SIM_FLASH_BASE < SIM_FLASH_SIZE) && (len <= SIM_FLASH_SIZE - (addr - SIM_FLASH_BASE))) {
+        return &cpu->Flash[addr - SIM_FLASH_BASE];
+    } else if ((addr - SIM_RAM_BASE < SIM_RAM_SIZE) && (len <= SIM_RAM_SIZE - (addr - SIM_RAM_BASE))) {
+        return &cpu->Ram[addr - SIM_RAM_BASE];
+    } else if ((addr - SIM_ROM_BASE < SIM_ROM_SIZE) && (len <= SIM_ROM_SIZE - (addr - SIM_ROM_BASE))) {
+        return &cpu->Rom[addr - SIM_ROM_BASE];
+    }
+
+    return 0;
+}
+
+/** @brief Data read as the core would perform it.
+  * @param[in]  cpu          The simulated CPU.
+  * @param[in]  addr         Address to read (must be aligned to size).
+  * @param[in]  size         1, 2 or 4 bytes.
+  * @return                  The value read (zero-extended).
+  */
+uint32_t SIM_Read(SIM_CPU_Type *cpu, uint32_t addr, unsigned int size)
+{
+    uint32_t value = 0;
+    uint8_t *p;
+    int flash;
+
+
+    if (addr & (size - 1)) {
+        sim_fault(addr, "unaligned read");
+        return 0;
+    }
+
+    p = sim_map(cpu, addr, &flash);
+
+    if (p) {
+        memcpy(&value, p, size);
+        if (flash) {
+            SimExtra += sim_flash_waits();
+        }
+        return value;
+    }
+
+    if (sim_is_peripheral(addr)) {
+        return HOST_BusRead(addr, size);
+    }
+
+    sim_fault(addr, "read from unmapped address");
+    return 0;
+}
+
+/** @brief Data write as the core would perform it.
+  * @param[in]  cpu          The simulated CPU.
+  * @param[in]  addr         Address to write (must be aligned to size).
+  * @param[in]  value        Value to write.
+  * @param[in]  size         1, 2 or 4 bytes.
+  */
+void SIM_Write(SIM_CPU_Type *cpu, uint32_t addr, uint32_t value, unsigned int size)
+{
+    uint8_t *p;
+    int flash;
+
+
+    if (addr & (size - 1)) {
+        sim_fault(addr, "unaligned write");
+        return;
+    }
+
+    p = sim_map(cpu, addr, &flash);
+
+    if (p && (p >= cpu->Ram) && (p < cpu->Ram + SIM_RAM_SIZE)) {
+        memcpy(p, &value, size);
+        return;
+    }
+
+    if (!p && sim_is_peripheral(addr)) {
+        HOST_BusWrite(addr, value, size);
+        return;
+    }
+
+    sim_fault(addr, p ? "write to read-only memory" : "write to unmapped address");
+}
+
+/** @brief Fetch one halfword of an instruction.
+  *
+  * The core fetches 32 bits at a time; flash wait states are charged once
+  * per word fetched (the LPC11xx flash interface buffers the last word).
+  */
+static uint16_t sim_fetch(SIM_CPU_Type *cpu, uint32_t addr)
+{
+    uint8_t *p;
+    int flash;
+
+
+    p = sim_map(cpu, addr, &flash);
+
+    if (p == 0) {
+        sim_fault(addr, "instruction fetch from unmapped address");
+        return 0;
+    }
+
+    if (flash && ((addr & ~3UL) != cpu->FetchWord)) {
+        cpu->FetchWord = addr & ~3UL;
+        SimExtra += sim_flash_waits();
+    }
+
+    return p[0] | (p[1] << 8);
+}
+
+
+/* Registers & Flags --------------------------------------------------------*/
+
+static uint32_t sim_apsr(SIM_CPU_Type *cpu)
+{
+    return (cpu->N << 31) | (cpu->Z << 30) | (cpu->C << 29) | (cpu->V << 28);
+}
+
+static void sim_set_apsr(SIM_CPU_Type *cpu, uint32_t apsr)
+{
+    cpu->N = (apsr >> 31) & 1;
+    cpu->Z = (apsr >> 30) & 1;
+    cpu->C = (apsr >> 29) & 1;
+    cpu->V = (apsr >> 28) & 1;
+}
+
+static void sim_nz(SIM_CPU_Type *cpu, uint32_t result)
+{
+    cpu->N = result >> 31;
+    cpu->Z = (result == 0);
+}
+
+/** @brief AddWithCarry(), optionally setting NZCV.
+  */
+static uint32_t sim_adc(SIM_CPU_Type *cpu, uint32_t a, uint32_t b, uint32_t carry, int setflags)
+{
+    uint64_t sum = (uint64_t)a + b + carry;
+    uint32_t result = (uint32_t)sum;
+
+
+    if (setflags) {
+        sim_nz(cpu, result);
+        cpu->C = (uint32_t)(sum >> 32);
+        cpu->V = ((~(a ^ b) & (a ^ result)) >> 31) & 1;
+    }
+
+    return result;
+}
+
+/** @brief Shift / rotate by a register or immediate amount, setting N, Z & C.
+  * @param[in]  type         0 LSL, 1 LSR, 2 ASR, 3 ROR.
+  */
+static uint32_t sim_shift(SIM_CPU_Type *cpu, unsigned int type, uint32_t value, uint32_t amount)
+{
+    uint32_t result = value;
+
+
+    if (amount != 0) {
+        switch (type) {
+        case 0:
+            if (amount < 32) {
+                cpu->C = (value >> (32 - amount)) & 1;
+                result = value << amount;
+            } else {
+                cpu->C = (amount == 32) ? (value & 1) : 0;
+                result = 0;
+            }
+            break;
+        case 1:
+            if (amount < 32) {
+                cpu->C = (value >> (amount - 1)) & 1;
+                result = value >> amount;
+            } else {
+                cpu->C = (amount == 32) ? (value >> 31) : 0;
+                result = 0;
+            }
+            break;
+        case 2:
+            if (amount < 32) {
+                cpu->C = (value >> (amount - 1)) & 1;
+                result = (uint32_t)((int32_t)value >> amount);
+            } else {
+                cpu->C = value >> 31;
+                result = (value >> 31) ? 0xffffffffUL : 0;
+            }
+            break;
+        default:
+            amount &= 31;
+            if (amount) {
+                result = (value >> amount) | (value << (32 - amount));
+            }
+            cpu->C = result >> 31;
+            break;
+        }
+    }
+
+    sim_nz(cpu, result);
+
+    return result;
+}
+
+static int sim_condition(SIM_CPU_Type *cpu, unsigned int cond)
+{
+    switch (cond) {
+    case 0x0: return cpu->Z;
+    case 0x1: return !cpu->Z;
+    case 0x2: return cpu->C;
+    case 0x3: return !cpu->C;
+    case 0x4: return cpu->N;
+    case 0x5: return !cpu->N;
+    case 0x6: return cpu->V;
+    case 0x7: return !cpu->V;
+    case 0x8: return cpu->C && !cpu->Z;
+    case 0x9: return !cpu->C || cpu->Z;
+    case 0xa: return cpu->N == cpu->V;
+    case 0xb: return cpu->N != cpu->V;
+    case 0xc: return !cpu->Z && (cpu->N == cpu->V);
+    case 0xd: return cpu->Z || (cpu->N != cpu->V);
+    default:  return 1;
+    }
+}
+
+/** @brief Test whether Thread mode is running on the process stack.
+  */
+static int sim_on_psp(SIM_CPU_Type *cpu)
+{
+    return (cpu->Exception == 0) && (cpu->CONTROL & SIM_CONTROL_SPSEL);
+}
+
+
+/* Exceptions ---------------------------------------------------------------*/
+
+/** @brief Stack a frame & enter an exception handler.
+  * @param[in]  exc          Exception number (3 = HardFault ... 47).
+  * @param[in]  ret          Return address to stack.
+  * @return                  Cycles taken.
+  */
+static unsigned int sim_exception(SIM_CPU_Type *cpu, int exc, uint32_t ret)
+{
+    uint32_t sp = cpu->R[13];
+    uint32_t xpsr = sim_apsr(cpu) | SIM_XPSR_T | (uint32_t)cpu->Exception;
+    uint32_t exc_return;
+    uint32_t vector;
+    uint32_t frame;
+
+
+    if (sp & 4) {
+        sp -= 4;
+        xpsr |= SIM_XPSR_ALIGN;
+    }
+
+    frame = sp - 32;
+
+    SIM_Write(cpu, frame +  0, cpu->R[0], 4);
+    SIM_Write(cpu, frame +  4, cpu->R[1], 4);
+    SIM_Write(cpu, frame +  8, cpu->R[2], 4);
+    SIM_Write(cpu, frame + 12, cpu->R[3], 4);
+    SIM_Write(cpu, frame + 16, cpu->R[12], 4);
+    SIM_Write(cpu, frame + 20, cpu->R[14], 4);
+    SIM_Write(cpu, frame + 24, ret & ~1UL, 4);
+    SIM_Write(cpu, frame + 28, xpsr, 4);
+
+    if (sim_on_psp(cpu)) {
+        cpu->R[13] = cpu->OtherSP;
+        cpu->OtherSP = frame;
+        exc_return = 0xfffffffdUL;
+    } else {
+        cpu->R[13] = frame;
+        exc_return = cpu->Exception ? 0xfffffff1UL : 0xfffffff9UL;
+    }
+
+    cpu->R[14] = exc_return;
+    cpu->Exception = exc;
+    cpu->ExceptionCount++;
+    SimEvent = 1;
+
+    HOST_EnterException(exc - SIM_EXC_IRQ0);
+
+    vector = SIM_Read(cpu, (uint32_t)exc * 4, 4);
+
+    cpu->R[15] = vector & ~1UL;
+    cpu->FetchWord = SIM_NO_FETCH;
+
+    SIM_ProfException(cpu, cpu->R[15], exc_return);
+
+    if (SimFault || !(vector & 1)) {
+        sim_fault(vector, "bad vector / stacking fault during exception entry");
+    }
+
+    return SIM_EXC_ENTRY_CYCLES;
+}
+
+/** @brief Unstack a frame on exception return.
+  * @param[in]  exc_return   The EXC_RETURN value branched to.
+  */
+static void sim_exception_return(SIM_CPU_Type *cpu, uint32_t exc_return)
+{
+    uint32_t frame;
+    uint32_t xpsr;
+    int to_psp = 0;
+
+
+    switch (exc_return & 0x0f) {
+    case 0x1:
+        break;
+    case 0x9:
+        cpu->CONTROL &= ~SIM_CONTROL_SPSEL;
+        break;
+    case 0xd:
+        to_psp = 1;
+        cpu->CONTROL |= SIM_CONTROL_SPSEL;
+        break;
+    default:
+        sim_fault(exc_return, "invalid EXC_RETURN");
+        return;
+    }
+
+    frame = to_psp ? cpu->OtherSP : cpu->R[13];
+
+    cpu->R[0]  = SIM_Read(cpu, frame +  0, 4);
+    cpu->R[1]  = SIM_Read(cpu, frame +  4, 4);
+    cpu->R[2]  = SIM_Read(cpu, frame +  8, 4);
+    cpu->R[3]  = SIM_Read(cpu, frame + 12, 4);
+    cpu->R[12] = SIM_Read(cpu, frame + 16, 4);
+    cpu->R[14] = SIM_Read(cpu, frame + 20, 4);
+    cpu->R[15] = SIM_Read(cpu, frame + 24, 4) & ~1UL;
+    xpsr       = SIM_Read(cpu, frame + 28, 4);
+
+    frame += 32 + ((xpsr & SIM_XPSR_ALIGN) ? 4 : 0);
+
+    if (to_psp) {
+        cpu->OtherSP = cpu->R[13];
+    }
+    cpu->R[13] = frame;
+
+    sim_set_apsr(cpu, xpsr);
+    cpu->Exception = ((exc_return & 0x0f) == 0x1) ? (int)(xpsr & 0x3f) : 0;
+    cpu->FetchWord = SIM_NO_FETCH;
+
+    HOST_ExitException(cpu->Exception ? cpu->Exception - SIM_EXC_IRQ0 : HOST_THREAD_MODE);
+}
+
+/** @brief Write the PC from a BX / POP / BLX (interworking branch).
+  * @return                  1 if this was an exception return.
+  */
+static int sim_bx_write_pc(SIM_CPU_Type *cpu, uint32_t target)
+{
+    if (cpu->Exception && ((target & 0xf0000000UL) == 0xf0000000UL)) {
+        sim_exception_return(cpu, target);
+        return 1;
+    }
+
+    if (!(target & 1)) {
+        sim_fault(target, "branch to ARM state (bit 0 clear)");
+    }
+
+    cpu->R[15] = target & ~1UL;
+    cpu->FetchWord = SIM_NO_FETCH;
+
+    return 0;
+}
+
+
+/* Semihosting --------------------------------------------------------------*/
+
+static void sim_semihost(SIM_CPU_Type *cpu)
+{
+    uint32_t op = cpu->R[0];
+    uint32_t arg = cpu->R[1];
+    uint32_t buf;
+    uint32_t len;
+    int c;
+
+
+    switch (op) {
+    case SIM_SYS_WRITEC:
+        putchar((int)SIM_Read(cpu, arg, 1));
+        break;
+    case SIM_SYS_WRITE0:
+        while ((c = (int)SIM_Read(cpu, arg++, 1)) != 0 && !SimFault) {
+            putchar(c);
+        }
+        break;
+    case SIM_SYS_WRITE:
+        buf = SIM_Read(cpu, arg + 4, 4);
+        len = SIM_Read(cpu, arg + 8, 4);
+        while (len-- && !SimFault) {
+            putchar((int)SIM_Read(cpu, buf++, 1));
+        }
+        cpu->R[0] = 0;
+        return;
+    case SIM_SYS_EXIT:
+        cpu->Stop = SIM_Stop_Exit;
+        cpu->ExitCode = (arg == SIM_ADP_APP_EXIT) ? 0 : 1;
+        return;
+    default:
+        cpu->R[0] = 0xffffffffUL;
+        return;
+    }
+
+    fflush(stdout);
+}
+
+
+/* Execution ----------------------------------------------------------------*/
+
+/** @brief Sleep (WFI / WFE) until an interrupt could be taken.
+  * @return                  Cycles slept (already applied to the peripherals).
+  */
+static unsigned int sim_sleep(SIM_CPU_Type *cpu)
+{
+    unsigned int slept = 0;
+
+
+    while (HOST_PendingException(1) == HOST_THREAD_MODE) {
+        if (!HOST_InterruptsEnabled()) {
+            cpu->Stop = SIM_Stop_Idle;
+            break;
+        }
+
+        if ((cpu->MaxCycles && (cpu->Cycles + slept >= cpu->MaxCycles))
+            || (slept > 0x7fffffffUL))
+        {
+            break;
+        }
+
+        HOST_AdvanceClock(SIM_SLEEP_STEP);
+        slept += SIM_SLEEP_STEP;
+
+        if (cpu->Stop != SIM_Stop_None) {
+            break;
+        }
+    }
+
+    cpu->SleepCycles += slept;
+
+    return slept;
+}
+
+/** @brief MRS: read a special register.
+  */
+static uint32_t sim_mrs(SIM_CPU_Type *cpu, unsigned int sysm)
+{
+    uint32_t value = 0;
+
+
+    if (sysm < 8) {
+        if (!(sysm & 4)) {
+            value |= sim_apsr(cpu);
+        }
+        if (sysm & 1) {
+            value |= (uint32_t)cpu->Exception;
+        }
+        return value;
+    }
+
+    switch (sysm) {
+    case 8:  return sim_on_psp(cpu) ? cpu->OtherSP : cpu->R[13];
+    case 9:  return sim_on_psp(cpu) ? cpu->R[13] : cpu->OtherSP;
+    case 16: return HOST_GetPRIMASK();
+    case 20: return cpu->CONTROL;
+    default: return 0;
+    }
+}
+
+/** @brief MSR: write a special register.
+  */
+static void sim_msr(SIM_CPU_Type *cpu, unsigned int sysm, uint32_t value)
+{
+    uint32_t sp;
+
+
+    if (sysm < 8) {
+        if (!(sysm & 4)) {
+            sim_set_apsr(cpu, value);
+        }
+        return;
+    }
+
+    switch (sysm) {
+    case 8:
+        if (sim_on_psp(cpu)) {
+            cpu->OtherSP = value & ~3UL;
+        } else {
+            cpu->R[13] = value & ~3UL;
+        }
+        break;
+    case 9:
+        if (sim_on_psp(cpu)) {
+            cpu->R[13] = value & ~3UL;
+        } else {
+            cpu->OtherSP = value & ~3UL;
+        }
+        break;
+    case 16:
+        HOST_SetPRIMASK(value & 1);
+        break;
+    case 20:
+        /* SPSEL can only be changed in Thread mode */
+        if ((cpu->Exception == 0) && ((value ^ cpu->CONTROL) & SIM_CONTROL_SPSEL)) {
+            sp = cpu->R[13];
+            cpu->R[13] = cpu->OtherSP;
+            cpu->OtherSP = sp;
+            cpu->CONTROL ^= SIM_CONTROL_SPSEL;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/** @brief Execute one 16-bit or 32-bit instruction.
+  *
+  * Cycle counts follow the Cortex-M0 TRM instruction timings; flash wait
+  * states are added per word fetched or data word read from flash.
+  */
+static void sim_step(SIM_CPU_Type *cpu)
+{
+    uint32_t pc = cpu->R[15];
+    uint32_t acct_pc = pc;
+    uint32_t *r = cpu->R;
+    uint32_t addr;
+    uint32_t value;
+    uint32_t result;
+    uint32_t op2;
+    unsigned int cycles = 1;
+    unsigned int advanced = 0;
+    unsigned int count;
+    unsigned int i;
+    unsigned int rd, rn, rm;
+    int call = 0;           /* BL / BLX: profiler call                */
+    int ret = 0;            /* Possible function return               */
+    int exc_ret = 0;        /* Exception return                       */
+    int branched = 0;
+    uint16_t op;
+    int irq;
+
+
+    SimExtra = 0;
+    SimFault = 0;
+
+    /* Take a pending interrupt at the instruction boundary */
+    irq = HOST_PendingException(0);
+    if (irq != HOST_THREAD_MODE) {
+        cycles = sim_exception(cpu, irq + SIM_EXC_IRQ0, pc);
+        acct_pc = r[15];
+        goto account;
+    }
+
+    /* Calls into the boot ROM (IAP, ...) are emulated */
+    if (pc - SIM_ROM_BASE < SIM_ROM_SIZE) {
+        if (SIM_RomCall(cpu, pc)) {
+            cycles = 3;
+            ret = 1;
+            goto account;
+        }
+        sim_fault(pc, "execution in boot ROM (no ROM image)");
+        goto account;
+    }
+
+    op = sim_fetch(cpu, pc);
+    r[15] = pc + 4;                 /* PC as read by the instruction */
+
+    switch (op >> 11) {
+    case 0x00:                      /* LSLS Rd, Rm, #imm5 */
+    case 0x01:                      /* LSRS Rd, Rm, #imm5 */
+    case 0x02:                      /* ASRS Rd, Rm, #imm5 */
+        rd = op & 7;
+        rm = (op >> 3) & 7;
+        value = (op >> 6) & 0x1f;
+        if ((value == 0) && ((op >> 11) != 0)) {
+            value = 32;
+        }
+        r[rd] = sim_shift(cpu, op >> 11, r[rm], value);
+        break;
+
+    case 0x03:                      /* ADDS / SUBS Rd, Rn, Rm / #imm3 */
+        rd = op & 7;
+        rn = (op >> 3) & 7;
+        value = (op & (1 << 10)) ? ((op >> 6) & 7) : r[(op >> 6) & 7];
+        if (op & (1 << 9)) {
+            r[rd] = sim_adc(cpu, r[rn], ~value, 1, 1);
+        } else {
+            r[rd] = sim_adc(cpu, r[rn], value, 0, 1);
+        }
+        break;
+
+    case 0x04:                      /* MOVS Rd, #imm8 */
+        rd = (op >> 8) & 7;
+        r[rd] = op & 0xff;
+        sim_nz(cpu, r[rd]);
+        break;
+
+    case 0x05:                      /* CMP Rn, #imm8 */
+        sim_adc(cpu, r[(op >> 8) & 7], ~(uint32_t)(op & 0xff), 1, 1);
+        break;
+
+    case 0x06:                      /* ADDS Rdn, #imm8 */
+        rd = (op >> 8) & 7;
+        r[rd] = sim_adc(cpu, r[rd], op & 0xff, 0, 1);
+        break;
+
+    case 0x07:                      /* SUBS Rdn, #imm8 */
+        rd = (op >> 8) & 7;
+        r[rd] = sim_adc(cpu, r[rd], ~(uint32_t)(op & 0xff), 1, 1);
+        break;
+
+    case 0x08:
+        if ((op & 0xfc00) == 0x4000) {
+            /* Data processing (register) */
+            rd = op & 7;
+            rm = (op >> 3) & 7;
+
+            switch ((op >> 6) & 0xf) {
+            case 0x0: r[rd] &= r[rm]; sim_nz(cpu, r[rd]); break;                       /* ANDS */
+            case 0x1: r[rd] ^= r[rm]; sim_nz(cpu, r[rd]); break;                       /* EORS */
+            case 0x2: r[rd] = sim_shift(cpu, 0, r[rd], r[rm] & 0xff); break;           /* LSLS */
+            case 0x3: r[rd] = sim_shift(cpu, 1, r[rd], r[rm] & 0xff); break;           /* LSRS */
+            case 0x4: r[rd] = sim_shift(cpu, 2, r[rd], r[rm] & 0xff); break;           /* ASRS */
+            case 0x5: r[rd] = sim_adc(cpu, r[rd], r[rm], cpu->C, 1); break;            /* ADCS */
+            case 0x6: r[rd] = sim_adc(cpu, r[rd], ~r[rm], cpu->C, 1); break;           /* SBCS */
+            case 0x7: r[rd] = sim_shift(cpu, 3, r[rd], r[rm] & 0xff); break;           /* RORS */
+            case 0x8: sim_nz(cpu, r[rd] & r[rm]); break;                               /* TST  */
+            case 0x9: r[rd] = sim_adc(cpu, ~r[rm], 0, 1, 1); break;                    /* RSBS */
+            case 0xa: sim_adc(cpu, r[rd], ~r[rm], 1, 1); break;                        /* CMP  */
+            case 0xb: sim_adc(cpu, r[rd], r[rm], 0, 1); break;                         /* CMN  */
+            case 0xc: r[rd] |= r[rm]; sim_nz(cpu, r[rd]); break;                       /* ORRS */
+            case 0xd:                                                                  /* MULS */
+                r[rd] *= r[rm];
+                sim_nz(cpu, r[rd]);
+                cycles = cpu->MulCycles;
+                break;
+            case 0xe: r[rd] &= ~r[rm]; sim_nz(cpu, r[rd]); break;                      /* BICS */
+            default:  r[rd] = ~r[rm]; sim_nz(cpu, r[rd]); break;                       /* MVNS */
+            }
+        } else if ((op & 0xfc00) == 0x4400) {
+            /* Special data processing & branch exchange */
+            rd = (op & 7) | ((op >> 4) & 8);
+            rm = (op >> 3) & 0xf;
+
+            switch ((op >> 8) & 3) {
+            case 0:                                                                    /* ADD  */
+                result = r[rd] + r[rm];
+                if (rd == 15) {
+                    r[15] = result & ~1UL;
+                    cpu->FetchWord = SIM_NO_FETCH;
+                    branched = ret = 1;
+                    cycles = 3;
+                } else {
+                    r[rd] = result;
+                }
+                break;
+            case 1:                                                                    /* CMP  */
+                sim_adc(cpu, r[rd], ~r[rm], 1, 1);
+                break;
+            case 2:                                                                    /* MOV  */
+                if (rd == 15) {
+                    r[15] = r[rm] & ~1UL;
+                    cpu->FetchWord = SIM_NO_FETCH;
+                    branched = ret = 1;
+                    cycles = 3;
+                } else {
+                    r[rd] = r[rm];
+                }
+                break;
+            default:                                                                   /* BX / BLX */
+                value = r[rm];
+                cycles = 3;
+                branched = 1;
+                if (op & 0x80) {
+                    r[14] = (pc + 2) | 1;
+                    call = 1;
+                } else {
+                    ret = 1;
+                }
+                exc_ret = sim_bx_write_pc(cpu, value);
+                break;
+            }
+        }
+        break;
+
+    case 0x09:                      /* LDR Rt, [PC, #imm8] */
+        addr = (r[15] & ~3UL) + (op & 0xff) * 4;
+        r[(op >> 8) & 7] = SIM_Read(cpu, addr, 4);
+        cycles = 2;
+        break;
+
+    case 0x0a:
+    case 0x0b:                      /* Load / store (register offset) */
+        rd = op & 7;
+        addr = r[(op >> 3) & 7] + r[(op >> 6) & 7];
+        cycles = 2;
+
+        switch ((op >> 9) & 7) {
+        case 0: SIM_Write(cpu, addr, r[rd], 4); break;                                 /* STR   */
+        case 1: SIM_Write(cpu, addr, r[rd] & 0xffff, 2); break;                        /* STRH  */
+        case 2: SIM_Write(cpu, addr, r[rd] & 0xff, 1); break;                          /* STRB  */
+        case 3: r[rd] = (uint32_t)(int8_t)SIM_Read(cpu, addr, 1); break;               /* LDRSB */
+        case 4: r[rd] = SIM_Read(cpu, addr, 4); break;                                 /* LDR   */
+        case 5: r[rd] = SIM_Read(cpu, addr, 2); break;                                 /* LDRH  */
+        case 6: r[rd] = SIM_Read(cpu, addr, 1); break;                                 /* LDRB  */
+        default: r[rd] = (uint32_t)(int16_t)SIM_Read(cpu, addr, 2); break;             /* LDRSH */
+        }
+        break;
+
+    case 0x0c:                      /* STR Rt, [Rn, #imm5 * 4] */
+        SIM_Write(cpu, r[(op >> 3) & 7] + ((op >> 6) & 0x1f) * 4, r[op & 7], 4);
+        cycles = 2;
+        break;
+
+    case 0x0d:                      /* LDR Rt, [Rn, #imm5 * 4] */
+        r[op & 7] = SIM_Read(cpu, r[(op >> 3) & 7] + ((op >> 6) & 0x1f) * 4, 4);
+        cycles = 2;
+        break;
+
+    case 0x0e:                      /* STRB Rt, [Rn, #imm5] */
+        SIM_Write(cpu, r[(op >> 3) & 7] + ((op >> 6) & 0x1f), r[op & 7] & 0xff, 1);
+        cycles = 2;
+        break;
+
+    case 0x0f:                      /* LDRB Rt, [Rn, #imm5] */
+        r[op & 7] = SIM_Read(cpu, r[(op >> 3) & 7] + ((op >> 6) & 0x1f), 1);
+        cycles = 2;
+        break;
+
+    case 0x10:                      /* STRH Rt, [Rn, #imm5 * 2] */
+        SIM_Write(cpu, r[(op >> 3) & 7] + ((op >> 6) & 0x1f) * 2, r[op & 7] & 0xffff, 2);
+        cycles = 2;
+        break;
+
+    case 0x11:                      /* LDRH Rt, [Rn, #imm5 * 2] */
+        r[op & 7] = SIM_Read(cpu, r[(op >> 3) & 7] + ((op >> 6) & 0x1f) * 2, 2);
+        cycles = 2;
+        break;
+
+    case 0x12:                      /* STR Rt, [SP, #imm8 * 4] */
+        SIM_Write(cpu, r[13] + (op & 0xff) * 4, r[(op >> 8) & 7], 4);
+        cycles = 2;
+        break;
+
+    case 0x13:                      /* LDR Rt, [SP, #imm8 * 4] */
+        r[(op >> 8) & 7] = SIM_Read(cpu, r[13] + (op & 0xff) * 4, 4);
+        cycles = 2;
+        break;
+
+    case 0x14:                      /* ADR Rd, label */
+        r[(op >> 8) & 7] = (r[15] & ~3UL) + (op & 0xff) * 4;
+        break;
+
+    case 0x15:                      /* ADD Rd, SP, #imm8 * 4 */
+        r[(op >> 8) & 7] = r[13] + (op & 0xff) * 4;
+        break;
+
+    case 0x16:
+    case 0x17:                      /* Miscellaneous */
+        if ((op & 0xff00) == 0xb000) {
+            /* ADD / SUB SP, SP, #imm7 * 4 */
+            if (op & 0x80) {
+                r[13] -= (op & 0x7f) * 4;
+            } else {
+                r[13] += (op & 0x7f) * 4;
+            }
+        } else if ((op & 0xff00) == 0xb200) {
+            rd = op & 7;
+            rm = (op >> 3) & 7;
+            switch ((op >> 6) & 3) {
+            case 0: r[rd] = (uint32_t)(int16_t)r[rm]; break;                           /* SXTH */
+            case 1: r[rd] = (uint32_t)(int8_t)r[rm]; break;                            /* SXTB */
+            case 2: r[rd] = r[rm] & 0xffff; break;                                     /* UXTH */
+            default: r[rd] = r[rm] & 0xff; break;                                      /* UXTB */
+            }
+        } else if ((op & 0xfe00) == 0xb400) {
+            /* PUSH {reglist[, LR]} */
+            count = __builtin_popcount(op & 0x1ff);
+            addr = r[13] - count * 4;
+            r[13] = addr;
+            for (i = 0; i < 8; i++) {
+                if (op & (1 << i)) {
+                    SIM_Write(cpu, addr, r[i], 4);
+                    addr += 4;
+                }
+            }
+            if (op & 0x100) {
+                SIM_Write(cpu, addr, r[14], 4);
+            }
+            cycles = 1 + count;
+        } else if ((op & 0xffef) == 0xb662) {
+            /* CPSIE i / CPSID i */
+            HOST_SetPRIMASK((op >> 4) & 1);
+        } else if ((op & 0xff00) == 0xba00) {
+            rd = op & 7;
+            value = r[(op >> 3) & 7];
+            switch ((op >> 6) & 3) {
+            case 0:                                                                    /* REV   */
+                r[rd] = __builtin_bswap32(value);
+                break;
+            case 1:                                                                    /* REV16 */
+                r[rd] = ((value & 0x00ff00ffUL) << 8) | ((value >> 8) & 0x00ff00ffUL);
+                break;
+            case 3:                                                                    /* REVSH */
+                r[rd] = (uint32_t)(int16_t)(((value & 0xff) << 8) | ((value >> 8) & 0xff));
+                break;
+            default:
+                sim_fault(pc, "undefined instruction");
+                break;
+            }
+        } else if ((op & 0xfe00) == 0xbc00) {
+            /* POP {reglist[, PC]} */
+            count = __builtin_popcount(op & 0x1ff);
+            addr = r[13];
+            for (i = 0; i < 8; i++) {
+                if (op & (1 << i)) {
+                    r[i] = SIM_Read(cpu, addr, 4);
+                    addr += 4;
+                }
+            }
+            cycles = 1 + count;
+            if (op & 0x100) {
+                value = SIM_Read(cpu, addr, 4);
+                r[13] = addr + 4;
+                cycles += 3;
+                branched = ret = 1;
+                exc_ret = sim_bx_write_pc(cpu, value);
+            } else {
+                r[13] = addr;
+            }
+        } else if ((op & 0xff00) == 0xbe00) {
+            /* BKPT #imm8 */
+            if ((op & 0xff) == SIM_SEMIHOST_BKPT) {
+                sim_semihost(cpu);
+            } else {
+                cpu->Stop = SIM_Stop_Breakpoint;
+                r[15] = pc;
+                branched = 1;
+            }
+        } else if ((op & 0xff0f) == 0xbf00) {
+            /* Hints */
+            switch ((op >> 4) & 0xf) {
+            case 2:                                                                    /* WFE */
+                if (SimEvent) {
+                    SimEvent = 0;
+                    break;
+                }
+                /* Fall through */
+            case 3:                                                                    /* WFI */
+                r[15] = pc + 2;
+                advanced = sim_sleep(cpu);
+                cycles += advanced;
+                SimEvent = 0;
+                break;
+            case 4:                                                                    /* SEV */
+                SimEvent = 1;
+                break;
+            default:                                                                   /* NOP / YIELD */
+                break;
+            }
+        } else {
+            sim_fault(pc, "undefined instruction");
+        }
+        break;
+
+    case 0x18:                      /* STM Rn!, {reglist} */
+        rn = (op >> 8) & 7;
+        addr = r[rn];
+        count = __builtin_popcount(op & 0xff);
+        for (i = 0; i < 8; i++) {
+            if (op & (1 << i)) {
+                SIM_Write(cpu, addr, r[i], 4);
+                addr += 4;
+            }
+        }
+        r[rn] = addr;
+        cycles = 1 + count;
+        break;
+
+    case 0x19:                      /* LDM Rn{!}, {reglist} */
+        rn = (op >> 8) & 7;
+        addr = r[rn];
+        count = __builtin_popcount(op & 0xff);
+        for (i = 0; i < 8; i++) {
+            if (op & (1 << i)) {
+                r[i] = SIM_Read(cpu, addr, 4);
+                addr += 4;
+            }
+        }
+        if (!(op & (1 << rn))) {
+            r[rn] = addr;
+        }
+        cycles = 1 + count;
+        break;
+
+    case 0x1a:
+    case 0x1b:
+        if ((op & 0x0f00) == 0x0f00) {
+            /* SVC #imm8 (escalates to HardFault with PRIMASK set) */
+            r[15] = pc + 2;
+            if (HOST_GetPRIMASK()) {
+                sim_fault(pc, "SVC with interrupts masked");
+            } else {
+                cycles += sim_exception(cpu, SIM_EXC_SVC, pc + 2);
+            }
+            branched = 1;
+        } else if ((op & 0x0f00) == 0x0e00) {
+            sim_fault(pc, "permanently undefined instruction (UDF)");
+        } else if (sim_condition(cpu, (op >> 8) & 0xf)) {
+            /* B<cond> label */
+            r[15] = r[15] + ((uint32_t)(int8_t)(op & 0xff) << 1);
+            cpu->FetchWord = SIM_NO_FETCH;
+            branched = 1;
+            cycles = 3;
+        }
+        break;
+
+    case 0x1c:                      /* B label */
+        value = r[15] + ((uint32_t)((int32_t)((uint32_t)op << 21) >> 20));
+        if ((value == pc) && (HOST_GetPRIMASK() || !HOST_InterruptsEnabled())
+            && (HOST_PendingException(1) == HOST_THREAD_MODE))
+        {
+            /* Branch-to-self that no interrupt can ever leave */
+            cpu->Stop = SIM_Stop_Idle;
+        }
+        r[15] = value;
+        cpu->FetchWord = SIM_NO_FETCH;
+        branched = 1;
+        cycles = 3;
+        break;
+
+    case 0x1e:
+    case 0x1f:                      /* 32-bit instructions */
+        op2 = sim_fetch(cpu, pc + 2);
+
+        if (((op & 0xf800) == 0xf000) && ((op2 & 0xd000) == 0xd000)) {
+            /* BL label */
+            uint32_t s  = (op >> 10) & 1;
+            uint32_t i1 = !(((op2 >> 13) & 1) ^ s);
+            uint32_t i2 = !(((op2 >> 11) & 1) ^ s);
+            uint32_t imm = (s << 24) | (i1 << 23) | (i2 << 22)
+                         | ((uint32_t)(op & 0x3ff) << 12) | ((op2 & 0x7ff) << 1);
+
+            if (s) {
+                imm |= 0xfe000000UL;
+            }
+
+            r[14] = (pc + 4) | 1;
+            r[15] = pc + 4 + imm;
+            cpu->FetchWord = SIM_NO_FETCH;
+            branched = call = 1;
+            cycles = 4;
+        } else if (((op & 0xffe0) == 0xf380) && ((op2 & 0xd000) == 0x8000)) {
+            /* MSR spec_reg, Rn */
+            sim_msr(cpu, op2 & 0xff, r[op & 0xf]);
+            cycles = 4;
+        } else if (((op & 0xffff) == 0xf3ef) && ((op2 & 0xd000) == 0x8000)) {
+            /* MRS Rd, spec_reg */
+            r[(op2 >> 8) & 0xf] = sim_mrs(cpu, op2 & 0xff);
+            cycles = 4;
+        } else if (((op & 0xfff0) == 0xf3b0) && ((op2 & 0xd000) == 0x8000)
+                   && (((op2 >> 4) & 0xf) >= 4) && (((op2 >> 4) & 0xf) <= 6))
+        {
+            /* DSB / DMB / ISB */
+            if (((op2 >> 4) & 0xf) == 6) {
+                cpu->FetchWord = SIM_NO_FETCH;
+            }
+            cycles = 4;
+        } else {
+            sim_fault(pc, "undefined 32-bit instruction");
+        }
+
+        if (!branched) {
+            r[15] = pc + 4;
+            branched = 1;
+        }
+        break;
+
+    default:                        /* 0x1d: 32-bit encodings not in ARMv6-M */
+        sim_fault(pc, "undefined instruction");
+        break;
+    }
+
+    if (!branched) {
+        r[15] = pc + 2;
+    }
+
+    if (exc_ret) {
+        cycles += SIM_EXC_RETURN_CYCLES;
+    }
+
+    cpu->Instructions++;
+
+account:
+    if (SimFault) {
+        if (cpu->Exception == SIM_EXC_HARDFAULT) {
+            fprintf(stderr, "lpc11xx-sim: lockup at 0x%08lx: %s (address 0x%08lx)\n",
+                    (unsigned long)pc, SimFaultWhy, (unsigned long)SimFaultAddr);
+            cpu->Stop = SIM_Stop_Lockup;
+            return;
+        }
+
+        fprintf(stderr, "lpc11xx-sim: HardFault at 0x%08lx: %s (address 0x%08lx)\n",
+                (unsigned long)pc, SimFaultWhy, (unsigned long)SimFaultAddr);
+
+        SimFault = 0;
+        call = ret = exc_ret = 0;
+        cycles += sim_exception(cpu, SIM_EXC_HARDFAULT, pc);
+        acct_pc = r[15];
+
+        if (SimFault) {
+            cpu->Stop = SIM_Stop_Lockup;
+        }
+    }
+
+    cycles += SimExtra;
+    cpu->Cycles += cycles;
+    cpu->WaitCycles += SimExtra;
+
+    SIM_ProfAccount(cpu, acct_pc, cycles);
+
+    if (call) {
+        SIM_ProfCall(cpu, r[15], r[14]);
+    } else if (exc_ret) {
+        SIM_ProfExceptionReturn(cpu);
+    } else if (ret) {
+        SIM_ProfReturn(cpu, r[15]);
+    }
+
+    HOST_AdvanceClock(cycles - advanced);
+}
+
+/** @brief Reset the core: load SP & PC from the vector table.
+  * @param[in]  cpu          The simulated CPU, with its image loaded.
+  *
+  * Peripheral models & interrupt state are reset too.
+  */
+void SIM_Reset(SIM_CPU_Type *cpu)
+{
+    uint32_t pc;
+
+
+    HOST_Reset();
+
+    memset(cpu->R, 0, sizeof(cpu->R));
+    cpu->N = cpu->Z = cpu->C = cpu->V = 0;
+    cpu->CONTROL = 0;
+    cpu->OtherSP = 0;
+    cpu->Exception = 0;
+    cpu->Cycles = 0;
+    cpu->Instructions = 0;
+    cpu->WaitCycles = 0;
+    cpu->SleepCycles = 0;
+    cpu->ExceptionCount = 0;
+    cpu->FetchWord = SIM_NO_FETCH;
+    cpu->Stop = SIM_Stop_None;
+    cpu->ExitCode = 0;
+    SimEvent = 0;
+
+    cpu->R[13] = SIM_Read(cpu, 0, 4) & ~3UL;
+    pc = SIM_Read(cpu, 4, 4);
+    cpu->R[15] = pc & ~1UL;
+
+    if (!(pc & 1)) {
+        fprintf(stderr, "lpc11xx-sim: reset vector 0x%08lx is not a Thumb address\n",
+                (unsigned long)pc);
+        cpu->Stop = SIM_Stop_Lockup;
+    }
+
+    SIM_ProfCall(cpu, cpu->R[15], 0xffffffffUL);
+}
+
+/** @brief Run until a stop condition (see SIM_Stop_Type).
+  */
+void SIM_Run(SIM_CPU_Type *cpu)
+{
+    while (cpu->Stop == SIM_Stop_None) {
+        if (cpu->R[15] == cpu->Until) {
+            cpu->Stop = SIM_Stop_Until;
+            break;
+        }
+
+        if (cpu->MaxCycles && (cpu->Cycles >= cpu->MaxCycles)) {
+            cpu->Stop = SIM_Stop_CycleLimit;
+            break;
+        }
+
+        sim_step(cpu);
+    }
+}
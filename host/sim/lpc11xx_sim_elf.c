@@ -0,0 +1,236 @@
+/******************************************************************************
+ * @file:    lpc11xx_sim_elf.c
+ * @purpose: ELF image loader & function symbol table for lpc11xx-sim.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lpc11xx_sim.h"
+
+
+/* Global Variables ---------------------------------------------------------*/
+
+/*! @brief Function symbols sorted by address, plus a catch-all last entry */
+SIM_Symbol_Type *SIM_Symbols;
+
+/*! @brief Number of entries in SIM_Symbols (including the catch-all) */
+unsigned int SIM_SymbolCount;
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* All ELF symbols (any type) for SIM_LookupSymbol() */
+static struct {
+    const char *Name;
+    uint32_t    Value;
+} *SimAllSymbols;
+static unsigned int SimAllSymbolCount;
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+static int sim_symbol_cmp(const void *a, const void *b)
+{
+    const SIM_Symbol_Type *sa = a;
+    const SIM_Symbol_Type *sb = b;
+
+
+    if (sa->Addr != sb->Addr) {
+        return (sa->Addr < sb->Addr) ? -1 : 1;
+    }
+
+    /* Larger (real) function first where aliases share an address */
+    return (sa->Size > sb->Size) ? -1 : (sa->Size < sb->Size);
+}
+
+/** @brief Build the function table from an ELF symbol table section.
+  */
+static void sim_load_symbols(const uint8_t *image, size_t len, const Elf32_Shdr *symtab,
+                             const Elf32_Shdr *strtab)
+{
+    const Elf32_Sym *sym;
+    const char *strings;
+    unsigned int count;
+    unsigned int i;
+    unsigned int n;
+
+
+    if ((symtab->sh_offset + symtab->sh_size > len) || (strtab->sh_offset + strtab->sh_size > len)) {
+        return;
+    }
+
+    sym = (const Elf32_Sym *)(image + symtab->sh_offset);
+    strings = (const char *)(image + strtab->sh_offset);
+    count = symtab->sh_size / sizeof(Elf32_Sym);
+
+    SIM_Symbols = calloc(count + 1, sizeof(SIM_Symbol_Type));
+    SimAllSymbols = calloc(count, sizeof(*SimAllSymbols));
+
+    for (i = 0, n = 0; i < count; i++) {
+        if ((sym[i].st_name == 0) || (sym[i].st_name >= strtab->sh_size)) {
+            continue;
+        }
+
+        SimAllSymbols[SimAllSymbolCount].Name = strdup(strings + sym[i].st_name);
+        SimAllSymbols[SimAllSymbolCount].Value = sym[i].st_value;
+        SimAllSymbolCount++;
+
+        if ((ELF32_ST_TYPE(sym[i].st_info) != STT_FUNC) || (sym[i].st_shndx == SHN_UNDEF)) {
+            continue;
+        }
+
+        SIM_Symbols[n].Name = SimAllSymbols[SimAllSymbolCount - 1].Name;
+        SIM_Symbols[n].Addr = sym[i].st_value & ~1UL;
+        SIM_Symbols[n].Size = sym[i].st_size;
+        n++;
+    }
+
+    qsort(SIM_Symbols, n, sizeof(SIM_Symbol_Type), sim_symbol_cmp);
+
+    /* Keep one symbol per address */
+    for (i = 0, count = 0; i < n; i++) {
+        if ((count == 0) || (SIM_Symbols[count - 1].Addr != SIM_Symbols[i].Addr)) {
+            SIM_Symbols[count++] = SIM_Symbols[i];
+        }
+    }
+
+    SIM_Symbols[count].Name = "[other]";
+    SIM_SymbolCount = count + 1;
+}
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Load an ELF image (by load address) & its function symbols.
+  * @param[in]  cpu          The simulated CPU.
+  * @param[in]  path         Path to the ELF file.
+  * @return                  0 on success, -1 on error (reported on stderr).
+  */
+int SIM_LoadELF(SIM_CPU_Type *cpu, const char *path)
+{
+    const Elf32_Ehdr *eh;
+    const Elf32_Phdr *ph;
+    const Elf32_Shdr *sh;
+    uint8_t *image;
+    uint8_t *dst;
+    size_t len;
+    long size;
+    FILE *f;
+    int i;
+
+
+    f = fopen(path, "rb");
+    if (f == 0) {
+        perror(path);
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (size < (long)sizeof(Elf32_Ehdr)) {
+        fprintf(stderr, "%s: not an ELF file\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    len = (size_t)size;
+    image = malloc(len);
+
+    if ((image == 0) || (fread(image, 1, len, f) != len)) {
+        fprintf(stderr, "%s: read error\n", path);
+        fclose(f);
+        free(image);
+        return -1;
+    }
+
+    fclose(f);
+
+    eh = (const Elf32_Ehdr *)image;
+
+    if ((memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0) || (eh->e_ident[EI_CLASS] != ELFCLASS32)
+        || (eh->e_ident[EI_DATA] != ELFDATA2LSB) || (eh->e_machine != EM_ARM))
+    {
+        fprintf(stderr, "%s: not a little-endian 32-bit ARM ELF file\n", path);
+        free(image);
+        return -1;
+    }
+
+    if (eh->e_phoff + (size_t)eh->e_phnum * sizeof(Elf32_Phdr) > len) {
+        fprintf(stderr, "%s: truncated program headers\n", path);
+        free(image);
+        return -1;
+    }
+
+    /* Segments go to their load (physical) address; crt0 copies .data */
+    ph = (const Elf32_Phdr *)(image + eh->e_phoff);
+
+    for (i = 0; i < eh->e_phnum; i++) {
+        if ((ph[i].p_type != PT_LOAD) || (ph[i].p_filesz == 0)) {
+            continue;
+        }
+
+        dst = SIM_Memory(cpu, ph[i].p_paddr, ph[i].p_filesz);
+
+        if ((dst == 0) || (ph[i].p_offset + ph[i].p_filesz > len)) {
+            fprintf(stderr, "%s: segment at 0x%08lx (%lu bytes) doesn't fit in flash / RAM\n",
+                    path, (unsigned long)ph[i].p_paddr, (unsigned long)ph[i].p_filesz);
+            free(image);
+            return -1;
+        }
+
+        memcpy(dst, image + ph[i].p_offset, ph[i].p_filesz);
+    }
+
+    /* Symbols are optional (stripped images just profile as "[other]") */
+    if ((eh->e_shoff != 0) && (eh->e_shoff + (size_t)eh->e_shnum * sizeof(Elf32_Shdr) <= len)) {
+        sh = (const Elf32_Shdr *)(image + eh->e_shoff);
+
+        for (i = 0; i < eh->e_shnum; i++) {
+            if ((sh[i].sh_type == SHT_SYMTAB) && (sh[i].sh_link < eh->e_shnum)) {
+                sim_load_symbols(image, len, &sh[i], &sh[sh[i].sh_link]);
+                break;
+            }
+        }
+    }
+
+    if (SIM_Symbols == 0) {
+        SIM_Symbols = calloc(1, sizeof(SIM_Symbol_Type));
+        SIM_Symbols[0].Name = "[other]";
+        SIM_SymbolCount = 1;
+    }
+
+    free(image);
+
+    return 0;
+}
+
+/** @brief Look up a symbol's value by name.
+  * @param[in]  name         Symbol name.
+  * @param[out] addr         The symbol's value (Thumb bit cleared).
+  * @return                  0 if found, -1 if not.
+  */
+int SIM_LookupSymbol(const char *name, uint32_t *addr)
+{
+    unsigned int i;
+
+
+    for (i = 0; i < SimAllSymbolCount; i++) {
+        if (strcmp(SimAllSymbols[i].Name, name) == 0) {
+            *addr = SimAllSymbols[i].Value & ~1UL;
+            return 0;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,288 @@
+/******************************************************************************
+ * @file:    lpc11xx_sim_prof.c
+ * @purpose: Per-function cycle profile (self / inclusive / calls) for
+ *           lpc11xx-sim.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lpc11xx_sim.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Deepest call / exception nesting tracked */
+#define SIM_PROF_MAX_DEPTH    (512)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* Shadow call stack */
+static struct {
+    SIM_Symbol_Type *Sym;
+    uint32_t         Return;      /* Return address, or EXC_RETURN          */
+    uint64_t         Entry;       /* cpu->Cycles on entry                   */
+    int              Exception;   /* Frame is an exception handler          */
+} SimStack[SIM_PROF_MAX_DEPTH];
+static unsigned int SimDepth;
+
+/* Frames not tracked because the shadow stack was full */
+static unsigned int SimLost;
+
+/* Symbol last looked up (code tends to stay in one function) */
+static SIM_Symbol_Type *SimLast;
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Find the function containing an address.
+  */
+static SIM_Symbol_Type *sim_lookup(uint32_t addr)
+{
+    SIM_Symbol_Type *other = &SIM_Symbols[SIM_SymbolCount - 1];
+    unsigned int lo = 0;
+    unsigned int hi = SIM_SymbolCount - 1;
+    unsigned int mid;
+    SIM_Symbol_Type *s;
+
+
+    if (SimLast && (addr - SimLast->Addr < SimLast->Size)) {
+        return SimLast;
+    }
+
+    /* Last symbol with Addr <= addr (the catch-all entry isn't searched) */
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (SIM_Symbols[mid].Addr <= addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0) {
+        return other;
+    }
+
+    s = &SIM_Symbols[lo - 1];
+
+    /* Sizeless symbols (hand-written assembly) run up to the next symbol */
+    if ((s->Size != 0) ? (addr - s->Addr >= s->Size)
+                       : ((lo < SIM_SymbolCount - 1) && (addr >= SIM_Symbols[lo].Addr)))
+    {
+        return other;
+    }
+
+    if (s->Size) {
+        SimLast = s;
+    }
+
+    return s;
+}
+
+static void sim_push(SIM_CPU_Type *cpu, SIM_Symbol_Type *sym, uint32_t ret, int exception)
+{
+    sym->Calls++;
+
+    if (SimDepth == SIM_PROF_MAX_DEPTH) {
+        SimLost++;
+        return;
+    }
+
+    SimStack[SimDepth].Sym = sym;
+    SimStack[SimDepth].Return = ret;
+    SimStack[SimDepth].Entry = cpu->Cycles;
+    SimStack[SimDepth].Exception = exception;
+    SimDepth++;
+
+    sym->Depth++;
+}
+
+static void sim_pop(SIM_CPU_Type *cpu)
+{
+    SIM_Symbol_Type *sym;
+
+
+    SimDepth--;
+    sym = SimStack[SimDepth].Sym;
+
+    /* Recursion: only the outermost activation counts toward inclusive */
+    if (--sym->Depth == 0) {
+        sym->Inclusive += cpu->Cycles - SimStack[SimDepth].Entry;
+    }
+}
+
+static int sim_cmp_inclusive(const void *a, const void *b)
+{
+    const SIM_Symbol_Type *sa = a;
+    const SIM_Symbol_Type *sb = b;
+
+
+    if (sa->Inclusive != sb->Inclusive) {
+        return (sa->Inclusive > sb->Inclusive) ? -1 : 1;
+    }
+
+    return (sa->Self > sb->Self) ? -1 : (sa->Self < sb->Self);
+}
+
+static const char *sim_stop_reason(SIM_Stop_Type stop)
+{
+    switch (stop) {
+    case SIM_Stop_Exit:       return "exit";
+    case SIM_Stop_Breakpoint: return "breakpoint";
+    case SIM_Stop_Until:      return "until";
+    case SIM_Stop_CycleLimit: return "cycle-limit";
+    case SIM_Stop_Idle:       return "idle";
+    case SIM_Stop_Lockup:     return "lockup";
+    case SIM_Stop_Reset:      return "reset";
+    default:                  return "running";
+    }
+}
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Note a call (BL / BLX) to a function.
+  */
+void SIM_ProfCall(SIM_CPU_Type *cpu, uint32_t target, uint32_t ret)
+{
+    sim_push(cpu, sim_lookup(target), ret & ~1UL, 0);
+}
+
+/** @brief Note a possible function return (BX, POP {PC}, MOV / ADD PC).
+  *
+  * Pops back to the frame whose return address was branched to, which also
+  * copes with tail calls & longjmp(); anything else is an ordinary branch.
+  */
+void SIM_ProfReturn(SIM_CPU_Type *cpu, uint32_t pc)
+{
+    unsigned int i;
+
+
+    for (i = SimDepth; i > 0; i--) {
+        if (SimStack[i - 1].Exception) {
+            return;
+        }
+        if (SimStack[i - 1].Return == pc) {
+            break;
+        }
+    }
+
+    if (i == 0) {
+        return;
+    }
+
+    while (SimDepth >= i) {
+        sim_pop(cpu);
+    }
+}
+
+/** @brief Note entry to an exception handler.
+  */
+void SIM_ProfException(SIM_CPU_Type *cpu, uint32_t handler, uint32_t exc_return)
+{
+    sim_push(cpu, sim_lookup(handler), exc_return, 1);
+}
+
+/** @brief Note an exception return: unwind to & including the handler's frame.
+  */
+void SIM_ProfExceptionReturn(SIM_CPU_Type *cpu)
+{
+    while (SimDepth) {
+        if (SimStack[SimDepth - 1].Exception) {
+            sim_pop(cpu);
+            break;
+        }
+        sim_pop(cpu);
+    }
+}
+
+/** @brief Charge the cycles of one instruction to the function executing it.
+  */
+void SIM_ProfAccount(SIM_CPU_Type *cpu, uint32_t pc, unsigned int cycles)
+{
+    (void)cpu;
+
+    sim_lookup(pc)->Self += cycles;
+}
+
+/** @brief Close all open frames (end of simulation).
+  */
+void SIM_ProfFinish(SIM_CPU_Type *cpu)
+{
+    while (SimDepth) {
+        sim_pop(cpu);
+    }
+}
+
+/** @brief Write the run summary & function profile.
+  * @param[in]  cpu          The simulated CPU after SIM_Run().
+  * @param[in]  out          Where to write.
+  * @param[in]  tsv          1 for tab-separated output (for scripts), else a
+  *                          table sorted by inclusive cycles.
+  */
+void SIM_ProfReport(SIM_CPU_Type *cpu, FILE *out, int tsv)
+{
+    SIM_Symbol_Type *sorted;
+    unsigned int i;
+
+
+    sorted = malloc(SIM_SymbolCount * sizeof(SIM_Symbol_Type));
+    if (sorted == 0) {
+        return;
+    }
+
+    for (i = 0; i < SIM_SymbolCount; i++) {
+        sorted[i] = SIM_Symbols[i];
+    }
+
+    qsort(sorted, SIM_SymbolCount, sizeof(SIM_Symbol_Type), sim_cmp_inclusive);
+
+    if (tsv) {
+        fprintf(out, "# stop\t%s\n", sim_stop_reason(cpu->Stop));
+        fprintf(out, "# cycles\t%llu\n", (unsigned long long)cpu->Cycles);
+        fprintf(out, "# instructions\t%llu\n", (unsigned long long)cpu->Instructions);
+        fprintf(out, "# wait_cycles\t%llu\n", (unsigned long long)cpu->WaitCycles);
+        fprintf(out, "# sleep_cycles\t%llu\n", (unsigned long long)cpu->SleepCycles);
+        fprintf(out, "# exceptions\t%llu\n", (unsigned long long)cpu->ExceptionCount);
+        fprintf(out, "function\tcalls\tself\tinclusive\n");
+    } else {
+        fprintf(out, "stopped:      %s\n", sim_stop_reason(cpu->Stop));
+        fprintf(out, "cycles:       %llu\n", (unsigned long long)cpu->Cycles);
+        fprintf(out, "instructions: %llu\n", (unsigned long long)cpu->Instructions);
+        fprintf(out, "flash waits:  %llu cycles\n", (unsigned long long)cpu->WaitCycles);
+        fprintf(out, "asleep:       %llu cycles\n", (unsigned long long)cpu->SleepCycles);
+        fprintf(out, "exceptions:   %llu\n", (unsigned long long)cpu->ExceptionCount);
+        if (SimLost) {
+            fprintf(out, "(call nesting beyond %u levels not profiled)\n", SIM_PROF_MAX_DEPTH);
+        }
+        fprintf(out, "\n%14s %6s %14s %10s  %s\n", "inclusive", "%", "self", "calls", "function");
+    }
+
+    for (i = 0; i < SIM_SymbolCount; i++) {
+        if ((sorted[i].Calls == 0) && (sorted[i].Self == 0)) {
+            continue;
+        }
+
+        if (tsv) {
+            fprintf(out, "%s\t%llu\t%llu\t%llu\n", sorted[i].Name,
+                    (unsigned long long)sorted[i].Calls, (unsigned long long)sorted[i].Self,
+                    (unsigned long long)sorted[i].Inclusive);
+        } else {
+            fprintf(out, "%14llu %6.2f %14llu %10llu  %s\n",
+                    (unsigned long long)sorted[i].Inclusive,
+                    cpu->Cycles ? (100.0 * sorted[i].Inclusive / cpu->Cycles) : 0.0,
+                    (unsigned long long)sorted[i].Self,
+                    (unsigned long long)sorted[i].Calls, sorted[i].Name);
+        }
+    }
+
+    free(sorted);
+}
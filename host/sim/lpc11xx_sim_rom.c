@@ -0,0 +1,381 @@
+/******************************************************************************
+ * @file:    lpc11xx_sim_rom.c
+ * @purpose: Emulation of LPC11xx boot ROM entry points (IAP, Power
+ *           Profile API) for lpc11xx-sim.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/flash.h"
+#include "lpc11xx/iap.h"
+#include "lpc11xx/power_api.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx_sim.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Read UID isn't in IAP_CommandType (not all boot ROM versions have it) */
+#define SIM_IAP_READ_UID      (58)
+
+/* Boot code version reported (major 1, minor 7) */
+#define SIM_BOOT_VERSION      ((1 << 8) | 7)
+
+/* Where the (emulated) ROM driver table & Power API live */
+#define SIM_ROM_DRIVERS       (0x1fff2000UL)
+#define SIM_ROM_PWRD          (0x1fff2010UL)
+#define SIM_ROM_SET_PLL       (0x1fff2020UL)
+#define SIM_ROM_SET_POWER     (0x1fff2024UL)
+
+/* Power API set_pll limits, kHz */
+#define SIM_PLL_MIN_IN        (10000)
+#define SIM_PLL_MAX_IN        (25000)
+#define SIM_PLL_MAX_CLOCK     (CLOCK_MAX_CORE_CLOCK / 1000)
+#define SIM_PLL_MAX_OUT       (CLOCK_MAX_PLL_CLOCK / 1000)
+#define SIM_PLL_MIN_CCO       (CLOCK_MIN_CCO_CLOCK / 1000)
+#define SIM_PLL_MAX_CCO       (CLOCK_MAX_CCO_CLOCK / 1000)
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+/** @brief Get a flash sector range as host memory.
+  */
+static uint8_t *sim_iap_sectors(SIM_CPU_Type *cpu, uint32_t start, uint32_t end, uint32_t *len)
+{
+    if ((start > end) || (end >= SIM_FLASH_SIZE / IAP_SECTOR_SIZE)) {
+        return 0;
+    }
+
+    *len = (end - start + 1) * IAP_SECTOR_SIZE;
+
+    return SIM_Memory(cpu, SIM_FLASH_BASE + start * IAP_SECTOR_SIZE, *len);
+}
+
+/** @brief Run one IAP command.
+  * @param[in]  cmd          Command block (command & parameters).
+  * @param[out] result       Result block (status & results).
+  */
+static void sim_iap(SIM_CPU_Type *cpu, const uint32_t *cmd, uint32_t *result)
+{
+    uint8_t *dst;
+    uint8_t *src;
+    uint32_t len;
+    uint32_t i;
+
+
+    result[0] = IAP_Status_Success;
+
+    switch (cmd[0]) {
+    case IAP_Command_PrepareSectors:
+        if (sim_iap_sectors(cpu, cmd[1], cmd[2], &len) == 0) {
+            result[0] = IAP_Status_InvalidSectorError;
+        }
+        break;
+
+    case IAP_Command_CopyRamToFlash:
+        dst = SIM_Memory(cpu, cmd[1], cmd[3]);
+        src = SIM_Memory(cpu, cmd[2], cmd[3]);
+        if ((dst == 0) || (dst < cpu->Flash) || (dst >= cpu->Flash + SIM_FLASH_SIZE) || (cmd[1] & 0xff)) {
+            result[0] = IAP_Status_DestinationAddressError;
+        } else if ((src == 0) || (src < cpu->Ram) || (src >= cpu->Ram + SIM_RAM_SIZE) || (cmd[2] & 3)) {
+            result[0] = IAP_Status_SourceAddressError;
+        } else if (!IAP_IS_BYTE_COUNT_TYPE(cmd[3])) {
+            result[0] = IAP_Status_CountError;
+        } else {
+            /* Programming can only clear bits */
+            for (i = 0; i < cmd[3]; i++) {
+                dst[i] &= src[i];
+            }
+        }
+        break;
+
+    case IAP_Command_EraseSectors:
+        dst = sim_iap_sectors(cpu, cmd[1], cmd[2], &len);
+        if (dst == 0) {
+            result[0] = IAP_Status_InvalidSectorError;
+        } else {
+            memset(dst, 0xff, len);
+        }
+        break;
+
+    case IAP_Command_BlankCheckSectors:
+        dst = sim_iap_sectors(cpu, cmd[1], cmd[2], &len);
+        if (dst == 0) {
+            result[0] = IAP_Status_InvalidSectorError;
+            break;
+        }
+        for (i = 0; i < len; i += 4) {
+            if ((dst[i] & dst[i + 1] & dst[i + 2] & dst[i + 3]) != 0xff) {
+                result[0] = IAP_Status_SectorNotBlankError;
+                result[1] = cmd[1] * IAP_SECTOR_SIZE + i;
+                memcpy(&result[2], &dst[i], 4);
+                break;
+            }
+        }
+        break;
+
+    case IAP_Command_ReadPartID:
+        result[1] = SYSCON->DEVICE_ID;
+        break;
+
+    case IAP_Command_ReadBootCodeVersion:
+        result[1] = SIM_BOOT_VERSION;
+        break;
+
+    case IAP_Command_Compare:
+        dst = SIM_Memory(cpu, cmd[1], cmd[3]);
+        src = SIM_Memory(cpu, cmd[2], cmd[3]);
+        if ((dst == 0) || (cmd[1] & 3)) {
+            result[0] = IAP_Status_DestinationAddressError;
+        } else if ((src == 0) || (cmd[2] & 3)) {
+            result[0] = IAP_Status_SourceAddressError;
+        } else if (cmd[3] & 3) {
+            result[0] = IAP_Status_CountError;
+        } else {
+            for (i = 0; i < cmd[3]; i++) {
+                if (dst[i] != src[i]) {
+                    result[0] = IAP_Status_CompareError;
+                    result[1] = i & ~3UL;
+                    break;
+                }
+            }
+        }
+        break;
+
+    case SIM_IAP_READ_UID:
+        result[1] = 0x4c504331UL;
+        result[2] = 0x31787830UL;
+        result[3] = 0x73696d00UL;
+        result[4] = 0x00000001UL;
+        break;
+
+    default:
+        /* ReinvokeISP would leave the application; not supported */
+        result[0] = IAP_Status_InvalidCommand;
+        break;
+    }
+}
+
+
+/** @brief Store a word in the ROM image.
+  */
+static void sim_rom_word(SIM_CPU_Type *cpu, uint32_t addr, uint32_t value)
+{
+    memcpy(&cpu->Rom[addr - SIM_ROM_BASE], &value, 4);
+}
+
+/** @brief Get the PLL P (divider) setting putting the CCO in range.
+  * @param[in]  out          PLL output, kHz
+  * @return                  SYSCON_SysPLLPVal_Type value, or -1 if none fits
+  */
+static int sim_pll_p(uint32_t out)
+{
+    int p;
+
+
+    for (p = 0; p < 4; p++) {
+        if ((out * (2UL << p) >= SIM_PLL_MIN_CCO) && (out * (2UL << p) <= SIM_PLL_MAX_CCO)) {
+            return p;
+        }
+    }
+
+    return -1;
+}
+
+/** @brief Power API set_pll: find & program a PLL / AHB divider setting.
+  * @param[in]  cmd          PLL input (kHz), wanted clock (kHz), mode,
+  *                          lock polls.
+  * @param[out] result       Status, clock set (kHz).
+  *
+  * Candidates are the PLL input itself & every legal PLL output, each
+  * divided by every AHB divider; the closest allowed by the mode wins,
+  * ties going to the lowest main clock.
+  */
+static void sim_set_pll(const uint32_t *cmd, uint32_t *result)
+{
+    uint32_t fin = cmd[0];
+    uint32_t want = cmd[1];
+    uint32_t main_clk;
+    uint32_t div;
+    uint32_t tries;
+    uint64_t err;
+    uint64_t best_err = 0;
+    uint32_t best_m = 0;
+    uint32_t best_div = 0;
+    unsigned int m;
+    int p;
+
+
+    if (cmd[2] > PowerAPI_PLLMode_Approximate) {
+        result[0] = PowerAPI_Status_InvalidMode;
+        return;
+    }
+
+    if ((fin < SIM_PLL_MIN_IN) || (fin > SIM_PLL_MAX_IN)
+        || (want == 0) || (want > SIM_PLL_MAX_CLOCK)) {
+        result[0] = PowerAPI_Status_InvalidFrequency;
+        return;
+    }
+
+    /* m == 0: PLL bypassed */
+    for (m = 0; m <= 32; m++) {
+        main_clk = m ? fin * m : fin;
+
+        if (m && ((main_clk > SIM_PLL_MAX_OUT) || (sim_pll_p(main_clk) < 0))) {
+            continue;
+        }
+
+        for (div = 1; div <= 255; div++) {
+            if (main_clk > SIM_PLL_MAX_CLOCK * div) {
+                continue;
+            }
+
+            /* Error scaled by div (clock = main_clk / div) */
+            if (main_clk >= want * div) {
+                err = main_clk - want * div;
+                if (cmd[2] == PowerAPI_PLLMode_LessOrEqual && err) {
+                    continue;
+                }
+            } else {
+                err = want * div - main_clk;
+                if (cmd[2] == PowerAPI_PLLMode_GreaterOrEqual) {
+                    continue;
+                }
+            }
+
+            if ((cmd[2] == PowerAPI_PLLMode_Equal) && err) {
+                continue;
+            }
+
+            if ((best_div == 0) || (err * best_div < best_err * div)) {
+                best_err = err;
+                best_m = m;
+                best_div = div;
+            }
+        }
+    }
+
+    if (best_div == 0) {
+        result[0] = PowerAPI_Status_FreqNotFound;
+        return;
+    }
+
+    /* Run from the PLL input while the PLL is reprogrammed */
+    SYSCON_SetMainClockSource(SYSCON_MainClockSource_SysPLLIn);
+    SYSCON_EnableMainClockSourceUpdate();
+    SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_SysPLL);
+    SYSCON_SetAHBClockDivider(best_div);
+
+    if (best_m) {
+        p = sim_pll_p(fin * best_m);
+        SYSCON_SetSysPLLClockScaler((best_m - 1) | (p << SYSCON_SYSPLLCTRL_PSEL_Shift));
+        SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_SysPLL);
+
+        for (tries = 0; !SYSCON_SysPLLIsLocked(); tries++) {
+            if (tries >= cmd[3]) {
+                result[0] = PowerAPI_Status_PLLNotLocked;
+                return;
+            }
+        }
+
+        SYSCON_SetMainClockSource(SYSCON_MainClockSource_SysPLLOut);
+        SYSCON_EnableMainClockSourceUpdate();
+    }
+
+    result[0] = PowerAPI_Status_Success;
+    result[1] = (best_m ? fin * best_m : fin) / best_div;
+}
+
+/** @brief Power API set_power: tune flash & regulator for a clock / mode.
+  * @param[in]  cmd          New clock (MHz), mode, current clock (MHz).
+  * @param[out] result       Status.
+  *
+  * The regulator isn't modelled; every mode gets the minimum flash access
+  * time for the clock, which is all that shows up in cycle counts.
+  */
+static void sim_set_power(const uint32_t *cmd, uint32_t *result)
+{
+    if ((cmd[0] == 0) || (cmd[0] > SIM_PLL_MAX_CLOCK / 1000)) {
+        result[0] = PowerAPI_Status_InvalidFrequency;
+    } else if (cmd[1] > PowerAPI_PowerMode_LowCurrent) {
+        result[0] = PowerAPI_Status_InvalidMode;
+    } else {
+        FLASH_SetWaitStates(CLOCK_FlashWaitStates(cmd[0] * 1000000UL));
+        result[0] = PowerAPI_Status_Success;
+    }
+}
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Emulate a call to a boot ROM entry point.
+  * @param[in]  cpu          The simulated CPU, with PC at the ROM address.
+  * @param[in]  pc           The ROM address being executed.
+  * @return                  1 if emulated (PC set to the return address),
+  *                          0 if the address isn't a known entry point.
+  *
+  * ROM code itself isn't simulated, so its cycles aren't counted.
+  */
+int SIM_RomCall(SIM_CPU_Type *cpu, uint32_t pc)
+{
+    uint32_t cmd[5];
+    uint32_t result[5];
+    unsigned int results;
+    unsigned int i;
+
+
+    memset(cmd, 0, sizeof(cmd));
+    memset(result, 0, sizeof(result));
+
+    if (pc == (IAP_ENTRY_POINT & ~1UL)) {
+        for (i = 0; i < 5; i++) {
+            cmd[i] = SIM_Read(cpu, cpu->R[0] + i * 4, 4);
+        }
+        sim_iap(cpu, cmd, result);
+        results = 5;
+    } else if (pc == SIM_ROM_SET_PLL) {
+        for (i = 0; i < 4; i++) {
+            cmd[i] = SIM_Read(cpu, cpu->R[0] + i * 4, 4);
+        }
+        sim_set_pll(cmd, result);
+        results = 2;
+    } else if (pc == SIM_ROM_SET_POWER) {
+        for (i = 0; i < 3; i++) {
+            cmd[i] = SIM_Read(cpu, cpu->R[0] + i * 4, 4);
+        }
+        sim_set_power(cmd, result);
+        results = 1;
+    } else {
+        return 0;
+    }
+
+    for (i = 0; i < results; i++) {
+        SIM_Write(cpu, cpu->R[1] + i * 4, result[i], 4);
+    }
+
+    cpu->R[15] = cpu->R[14] & ~1UL;
+    cpu->FetchWord = 0xffffffffUL;
+
+    return 1;
+}
+
+/** @brief Lay out the ROM's driver table (for the Power API) in the image.
+  * @param[in]  cpu          The simulated CPU.
+  *
+  * Only the Power API slot is filled in; the others read as 0.
+  */
+void SIM_RomInit(SIM_CPU_Type *cpu)
+{
+    sim_rom_word(cpu, POWERAPI_ROM_DRIVER_TABLE, SIM_ROM_DRIVERS);
+    sim_rom_word(cpu, SIM_ROM_DRIVERS + POWERAPI_ROM_DRIVER_INDEX * 4, SIM_ROM_PWRD);
+    sim_rom_word(cpu, SIM_ROM_PWRD, SIM_ROM_SET_PLL | 1);
+    sim_rom_word(cpu, SIM_ROM_PWRD + 4, SIM_ROM_SET_POWER | 1);
+}
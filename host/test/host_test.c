@@ -0,0 +1,101 @@
+/******************************************************************************
+ * @file:    host_test.c
+ * @purpose: Check / report helpers shared by the host unit tests.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpclib_assert.h"
+#include "system_lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "host_test.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static unsigned int host_test_checks;
+static unsigned int host_test_failures;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief A library assertion failed; report where & fail the test program.
+  *
+  * Overrides the (looping) default so a failed check can't hang make check.
+  */
+void lpclib_assert_failed(void)
+{
+    const LPCLIB_AssertRecord_Type *record = lpclib_assert_get_record();
+
+
+    fprintf(stderr, "lpclib_assert failed at file ID %lu line %lu\n",
+            (unsigned long)LPCLIB_ASSERT_LOCATION_FILE(record->Location),
+            (unsigned long)LPCLIB_ASSERT_LOCATION_LINE(record->Location));
+    _exit(1);
+}
+
+/** @brief Map the register file, run SystemInit() & reset all models.
+  */
+void host_test_setup(void)
+{
+    HOST_Init();
+    HOST_Reset();
+    SystemInit();
+    CLOCK_InvalidateFrequencies();
+}
+
+/** @brief Count a check, reporting it if it failed.
+  * @param[in]  ok           Nonzero if the check passed.
+  * @param[in]  expr         The checked expression, as text.
+  * @param[in]  file         Source file of the check.
+  * @param[in]  line         Line of the check.
+  */
+void host_test_check(int ok, const char *expr, const char *file, int line)
+{
+    host_test_checks++;
+
+    if (!ok) {
+        host_test_failures++;
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    }
+}
+
+/** @brief Count an equality check, reporting both values if it failed.
+  * @param[in]  a            The value found.
+  * @param[in]  b            The value expected.
+  * @param[in]  expr_a       a, as text.
+  * @param[in]  expr_b       b, as text.
+  * @param[in]  file         Source file of the check.
+  * @param[in]  line         Line of the check.
+  */
+void host_test_equal(int64_t a, int64_t b, const char *expr_a, const char *expr_b,
+                     const char *file, int line)
+{
+    host_test_checks++;
+
+    if (a != b) {
+        host_test_failures++;
+        fprintf(stderr, "%s:%d: check failed: %s == %s (%lld != %lld)\n", file, line,
+                expr_a, expr_b, (long long)a, (long long)b);
+    }
+}
+
+/** @brief Report the test program's result.
+  * @param[in]  name         Name of the test program.
+  * @return                  Exit status for main(): 0 if every check passed.
+  */
+int host_test_done(const char *name)
+{
+    printf("%s: %u checks, %u failed\n", name, host_test_checks, host_test_failures);
+
+    return host_test_failures ? 1 : 0;
+}
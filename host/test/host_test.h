@@ -0,0 +1,47 @@
+/******************************************************************************
+ * @file:    host_test.h
+ * @purpose: Minimal check / report helpers shared by the host unit tests
+ *           (make check).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! Check a condition; a failure is reported & counted, the test goes on */
+#define HOST_TEST_CHECK(x) \
+    host_test_check((x) != 0, #x, __FILE__, __LINE__)
+
+/*! Check that two integer values are equal, reporting both if they aren't */
+#define HOST_TEST_EQUAL(a, b) \
+    host_test_equal((int64_t)(a), (int64_t)(b), #a, #b, __FILE__, __LINE__)
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Map the register file, run SystemInit() & reset all models.
+  *
+  * Call at the start of each test case so state doesn't leak between them.
+  */
+extern void host_test_setup(void);
+
+extern void host_test_check(int ok, const char *expr, const char *file, int line);
+extern void host_test_equal(int64_t a, int64_t b, const char *expr_a, const char *expr_b,
+                            const char *file, int line);
+
+/** @brief Report the test program's result.
+  * @param[in]  name         Name of the test program.
+  * @return                  Exit status for main(): 0 if every check passed.
+  */
+extern int host_test_done(const char *name);
+
+#endif /* #ifndef HOST_TEST_H_ */
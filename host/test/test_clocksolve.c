@@ -0,0 +1,266 @@
+/******************************************************************************
+ * @file:    test_clocksolve.c
+ * @purpose: Host table tests for the clock tree solver (CLOCK_Solve(),
+ *           CLOCK_SolveUARTBaud() & the CLOCK_Nearest() divider search).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * The solver is included directly so its file-local helpers can be tested
+ * on their own; the library's copy isn't linked in.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "../../src/lpc11xx_clocksolve.c"
+#include "host_test.h"
+
+
+/* Types --------------------------------------------------------------------*/
+
+/* CLOCK_Solve(): targets in, selected settings out */
+typedef struct {
+    CLOCK_Targets_Type Targets;
+    int      Result;
+    uint8_t  UsePLL;
+    uint8_t  PLLScaler;
+    uint8_t  AHBDivider;
+    uint32_t MainClock;
+    uint32_t ErrorPPM;
+} SolveCase_Type;
+
+/* CLOCK_SolveUARTBaud(): main clock & baud in, setting out */
+typedef struct {
+    uint32_t MainClock;
+    uint32_t Baud;
+    int      Result;
+    uint8_t  Divider;
+    uint16_t Divisor;
+    uint8_t  DivAddVal;
+    uint8_t  MulVal;
+    uint32_t ActualBaud;
+    uint32_t ErrorPPM;
+} BaudCase_Type;
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+#define PLL_SCALER(m, p)  (((p) << SYSCON_SYSPLLCTRL_PSEL_Shift) | ((m) - 1))
+
+static const SolveCase_Type SolveCases[] = {
+    /* Exact PLL solutions; lowest CCO wins */
+    { { 12000000, 48000000, 0, 0, 0, 0 },
+      0, 1, PLL_SCALER(4, SYSCON_SysPLLPVal_2), 1, 48000000, 0 },
+    { { 12000000, 24000000, 0, 0, 0, 0 },
+      0, 1, PLL_SCALER(2, SYSCON_SysPLLPVal_4), 1, 24000000, 0 },
+
+    /* The input itself, PLL off; then divided by the AHB divider */
+    { { 12000000, 12000000, 0, 0, 0, 0 },
+      0, 0, 0, 1, 12000000, 0 },
+    { { 12000000, 6000000, 0, 0, 0, 0 },
+      0, 0, 0, 2, 12000000, 0 },
+    { { 1000000, 1000000, 0, 0, 0, 0 },
+      0, 0, 0, 1, 1000000, 0 },
+
+    /* Over the core limit: the closest legal clock, with its error */
+    { { 12000000, 50000000, 0, 0, 0, 0 },
+      0, 1, PLL_SCALER(4, SYSCON_SysPLLPVal_2), 1, 48000000, 40000 },
+
+    /* PLL input out of range (under 10MHz): PLL not used */
+    { { 8000000, 48000000, 0, 0, 0, 0 },
+      0, 0, 0, 1, 8000000, 833333 },
+
+    /* SSP0 at the main clock / 6 pulls the main clock to 72MHz */
+    { { 12000000, 36000000, 0, 12000000, 0, 0 },
+      0, 1, PLL_SCALER(6, SYSCON_SysPLLPVal_2), 2, 72000000, 0 },
+
+    /* A PLL clock for an exact 9600 beats the input with 320ppm */
+    { { 12000000, 12000000, 9600, 0, 0, 0 },
+      0, 1, PLL_SCALER(2, SYSCON_SysPLLPVal_4), 2, 24000000, 0 },
+
+    /* Every output at once */
+    { { 12000000, 48000000, 115200, 4000000, 1000000, 0 },
+      0, 1, PLL_SCALER(8, SYSCON_SysPLLPVal_1), 2, 96000000, 229 },
+
+    /* Failures: no UART setting within tolerance at any main clock */
+    { { 12000000, 48000000, 10000000, 0, 0, 0 },
+      -1, 0, 0, 0, 0, 0 },
+    { { 1000000, 1000000, 115200, 0, 0, 0 },
+      -1, 0, 0, 0, 0, 0 },
+};
+
+static const BaudCase_Type BaudCases[] = {
+    /* 48MHz: the fractional divider gets the fast rates within 0.2% */
+    { 48000000, 921600,  0, 1,   3,     1, 12, 923077,  1603 },
+    { 48000000, 460800,  0, 1,   4,     5, 8,  461538,  1603 },
+    { 48000000, 115200,  0, 1,   23,    2, 15, 115090,  959 },
+    { 48000000, 9600,    0, 50,  5,     1, 4,  9600,    0 },
+    { 48000000, 300,     0, 250, 40,    0, 1,  300,     0 },
+    { 48000000, 1,       0, 250, 12000, 0, 1,  1,       0 },
+
+    /* Fastest possible rate (PCLK / 16) & just over it */
+    { 48000000, 3000000, 0, 1,   1,     0, 1,  3000000, 0 },
+    { 48000000, 3000001, -1, 0,   0,     0, 0,  0,       0 },
+
+    /* 12MHz: 460800 is 18.6% off at best; the setting is still reported */
+    { 12000000, 460800,  -1, 2,  1,     0, 1,  375000,  186198 },
+    { 12000000, 115200,  0, 1,   4,     5, 8,  115385,  1603 },
+    { 12000000, 9600,    0, 1,   71,    1, 10, 9603,    320 },
+};
+
+
+/* Functions ----------------------------------------------------------------*/
+
+static void test_solve(void)
+{
+    const SolveCase_Type *c;
+    CLOCK_Config_Type config;
+    unsigned int i;
+
+
+    for (i = 0; i < sizeof(SolveCases) / sizeof(SolveCases[0]); i++) {
+        c = &SolveCases[i];
+
+        HOST_TEST_EQUAL(CLOCK_Solve(&c->Targets, &config), c->Result);
+        if (c->Result < 0) {
+            continue;
+        }
+
+        HOST_TEST_EQUAL(config.UsePLL, c->UsePLL);
+        HOST_TEST_EQUAL(config.PLLScaler, c->PLLScaler);
+        HOST_TEST_EQUAL(config.AHBDivider, c->AHBDivider);
+        HOST_TEST_EQUAL(config.MainClock, c->MainClock);
+        HOST_TEST_EQUAL(config.ErrorPPM, c->ErrorPPM);
+        HOST_TEST_EQUAL(config.ActualCoreClock, c->MainClock / c->AHBDivider);
+        HOST_TEST_CHECK(config.ActualCoreClock <= CLOCK_MAX_CORE_CLOCK);
+    }
+}
+
+static void test_solve_peripherals(void)
+{
+    CLOCK_Targets_Type targets = { 12000000, 48000000, 115200, 4000000, 1000000, 0 };
+    CLOCK_Config_Type config;
+
+
+    HOST_TEST_EQUAL(CLOCK_Solve(&targets, &config), 0);
+
+    /* 96MHz * 14 / (16 * 9 * 3 * 27) */
+    HOST_TEST_EQUAL(config.UART0Divider, 9);
+    HOST_TEST_EQUAL(config.UART0Divisor, 3);
+    HOST_TEST_EQUAL(config.UART0DivAddVal, 13);
+    HOST_TEST_EQUAL(config.UART0MulVal, 14);
+    HOST_TEST_EQUAL(config.ActualUART0Baud, 115226);
+
+    /* Largest SYSCON divider first */
+    HOST_TEST_EQUAL(config.SSP0Divider, 12);
+    HOST_TEST_EQUAL(config.SSP0Prescaler, 2);
+    HOST_TEST_EQUAL(config.SSP0TicksPerBit, 1);
+    HOST_TEST_EQUAL(config.ActualSSP0Clock, 4000000);
+    HOST_TEST_EQUAL(config.SSP1Divider, 48);
+    HOST_TEST_EQUAL(config.ActualSSP1Clock, 1000000);
+
+    /* WDT: 10kHz is out of reach; the IRC / 255 gets nearest.  30MHz needs
+     *  the (96MHz) main clock.
+     */
+    targets = (CLOCK_Targets_Type){ 12000000, 48000000, 0, 0, 0, 10000 };
+    HOST_TEST_EQUAL(CLOCK_Solve(&targets, &config), 0);
+    HOST_TEST_EQUAL(config.WDTClockSource, SYSCON_WDTClockSource_IRC);
+    HOST_TEST_EQUAL(config.WDTDivider, 255);
+    HOST_TEST_EQUAL(config.ActualWDTTick, 11765);
+
+    targets = (CLOCK_Targets_Type){ 12000000, 48000000, 0, 0, 0, 30000000 };
+    HOST_TEST_EQUAL(CLOCK_Solve(&targets, &config), 0);
+    HOST_TEST_EQUAL(config.WDTClockSource, SYSCON_WDTClockSource_MainClock);
+    HOST_TEST_EQUAL(config.WDTDivider, 1);
+    HOST_TEST_EQUAL(config.ActualWDTTick, 24000000);
+}
+
+static void test_uart_baud(void)
+{
+    const BaudCase_Type *c;
+    CLOCK_UARTBaud_Type setting;
+    unsigned int i;
+
+
+    for (i = 0; i < sizeof(BaudCases) / sizeof(BaudCases[0]); i++) {
+        c = &BaudCases[i];
+
+        HOST_TEST_EQUAL(CLOCK_SolveUARTBaud(c->MainClock, c->Baud, &setting), c->Result);
+        if (c->Divider == 0) {
+            continue;
+        }
+
+        HOST_TEST_EQUAL(setting.Divider, c->Divider);
+        HOST_TEST_EQUAL(setting.Divisor, c->Divisor);
+        HOST_TEST_EQUAL(setting.DivAddVal, c->DivAddVal);
+        HOST_TEST_EQUAL(setting.MulVal, c->MulVal);
+        HOST_TEST_EQUAL(setting.ActualBaud, c->ActualBaud);
+        HOST_TEST_EQUAL(setting.ErrorPPM, c->ErrorPPM);
+
+        /* The fractional divider needs a divisor of 3 or more */
+        HOST_TEST_CHECK((setting.DivAddVal == 0) || (setting.Divisor >= 3));
+        HOST_TEST_CHECK(setting.DivAddVal < setting.MulVal);
+    }
+}
+
+static void test_nearest(void)
+{
+    uint16_t parts[3];
+
+
+    /* Exact */
+    HOST_TEST_EQUAL(CLOCK_Nearest(48000000, 1, 12000000, 1, 255, CLOCK_SplitSimple, parts), 0);
+    HOST_TEST_EQUAL(parts[0], 4);
+
+    /* 1200 / 2 & 1200 / 3 are both 20% from 500: ties go to the slower clock */
+    HOST_TEST_EQUAL(CLOCK_Nearest(1200, 1, 500, 1, 255, CLOCK_SplitSimple, parts), 200000);
+    HOST_TEST_EQUAL(parts[0], 3);
+
+    /* Otherwise the nearer side wins */
+    HOST_TEST_EQUAL(CLOCK_Nearest(1200, 1, 590, 1, 255, CLOCK_SplitSimple, parts), 16949);
+    HOST_TEST_EQUAL(parts[0], 2);
+
+    /* Target above the clock: the smallest divider */
+    HOST_TEST_EQUAL(CLOCK_Nearest(48000000, 1, 100000000, 1, 255, CLOCK_SplitSimple, parts),
+                    520000);
+    HOST_TEST_EQUAL(parts[0], 1);
+
+    /* kmin keeps the core under its limit */
+    HOST_TEST_EQUAL(CLOCK_Nearest(96000000, 1, 96000000, 2, 255, CLOCK_SplitSimple, parts),
+                    500000);
+    HOST_TEST_EQUAL(parts[0], 2);
+
+    /* Nothing in range splits */
+    HOST_TEST_EQUAL(CLOCK_Nearest(48000000, 1, 1000, 300, 400, CLOCK_SplitSimple, parts),
+                    UINT32_MAX);
+
+    /* The splits: largest SYSCON divider, then the smallest prescaler */
+    HOST_TEST_EQUAL(CLOCK_Nearest(48000000, CLOCK_UART_SCALE, 300, 1, 255UL * 65535UL,
+                                  CLOCK_SplitUART, parts), 0);
+    HOST_TEST_EQUAL(parts[0], 250);
+    HOST_TEST_EQUAL(parts[1], 40);
+
+    HOST_TEST_EQUAL(CLOCK_Nearest(48000000, CLOCK_SSP_SCALE, 100000, 1, 255UL * 127UL * 256UL,
+                                  CLOCK_SplitSSP, parts), 0);
+    HOST_TEST_EQUAL(parts[0], 240);
+    HOST_TEST_EQUAL(parts[1], 2);
+    HOST_TEST_EQUAL(parts[2], 1);
+
+    /* Fractional splits keep the divisor at 3 or more */
+    HOST_TEST_CHECK(!CLOCK_SplitUARTFrac(2, parts));
+    HOST_TEST_CHECK(CLOCK_SplitUARTFrac(9, parts));
+    HOST_TEST_EQUAL(parts[0], 3);
+    HOST_TEST_EQUAL(parts[1], 3);
+}
+
+int main(void)
+{
+    test_solve();
+    test_solve_peripherals();
+    test_uart_baud();
+    test_nearest();
+
+    return host_test_done("test_clocksolve");
+}
@@ -0,0 +1,173 @@
+/******************************************************************************
+ * @file:    test_ct.c
+ * @purpose: Host unit tests for the CT16B / CT32B accessors against the
+ *           counter / timer model (prescaler, match actions, capture).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx/ct16b.h"
+#include "lpc11xx/ct32b.h"
+#include "host_test.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static volatile unsigned int ct_irqs;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+static void ct_handler(void)
+{
+    ct_irqs++;
+    CT16B_ClearPendingInterruptMask(CT16B0, CT16B_GetPendingInteruptMask(CT16B0));
+}
+
+static void test_prescaler(void)
+{
+    host_test_setup();
+
+    CT16B_SetMode(CT16B0, CT16B_Mode_Timer);
+    CT16B_SetPrescaler(CT16B0, 3);
+    HOST_TEST_EQUAL(CT16B_GetPrescaler(CT16B0), 3);
+
+    /* Disabled: no counting */
+    HOST_AdvanceClock(100);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 0);
+
+    CT16B_Enable(CT16B0);
+    HOST_TEST_CHECK(CT16B_IsEnabled(CT16B0));
+
+    /* One tick per (PR + 1) clocks; the remainder stays in PC */
+    HOST_AdvanceClock(10);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 2);
+    HOST_TEST_EQUAL(CT16B_GetPrescalerCount(CT16B0), 2);
+    HOST_AdvanceClock(2);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 3);
+    HOST_TEST_EQUAL(CT16B_GetPrescalerCount(CT16B0), 0);
+
+    /* Held in reset */
+    CT16B_AssertReset(CT16B0);
+    HOST_AdvanceClock(100);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 0);
+    CT16B_ClearReset(CT16B0);
+    HOST_TEST_CHECK(!CT16B_ResetIsAsserted(CT16B0));
+    HOST_AdvanceClock(4);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 1);
+}
+
+static void test_match(void)
+{
+    unsigned int i;
+
+
+    host_test_setup();
+    HOST_SetVector(CT16B0_IRQn, ct_handler);
+    ct_irqs = 0;
+
+    /* MR0: interrupt & reset every 10 ticks; MR1: interrupt only */
+    CT16B_SetCountForMatchChannel(CT16B0, 0, 9);
+    CT16B_SetConfigForMatchChannel(CT16B0, 0,
+                                   CT16B_MatchConfigMask_Interrupt | CT16B_MatchConfigMask_Reset);
+    CT16B_SetCountForMatchChannel(CT16B0, 1, 5);
+    CT16B_SetConfigForMatchChannel(CT16B0, 1, CT16B_MatchConfigMask_Interrupt);
+    HOST_TEST_EQUAL(CT16B_GetConfigForMatchChannel(CT16B0, 0),
+                    CT16B_MatchConfigMask_Interrupt | CT16B_MatchConfigMask_Reset);
+    HOST_TEST_EQUAL(CT16B_GetCountForMatchChannel(CT16B0, 1), 5);
+
+    CT16B_Enable(CT16B0);
+    HOST_AdvanceClock(5);
+    HOST_TEST_EQUAL(CT16B_GetPendingInteruptMask(CT16B0), CT16B_InterruptMask_MR1);
+    CT16B_ClearPendingInterruptMask(CT16B0, CT16B_InterruptMask_MR1);
+
+    HOST_AdvanceClock(4);
+    HOST_TEST_EQUAL(CT16B_GetPendingInteruptMask(CT16B0), CT16B_InterruptMask_MR0);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 9);
+    CT16B_ClearPendingInterruptMask(CT16B0, CT16B_InterruptMask_MR0);
+
+    /* The reset happens on the tick after the match */
+    HOST_AdvanceClock(1);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 0);
+
+    /* Through the NVIC: two periods, two interrupts per period */
+    NVIC_EnableIRQ(CT16B0_IRQn);
+    for (i = 0; i < 20; i++) {
+        HOST_AdvanceClock(1);
+    }
+    HOST_TEST_EQUAL(ct_irqs, 4);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 0);
+
+    /* Stop on match */
+    CT16B_SetConfigForMatchChannel(CT16B0, 0, CT16B_MatchConfigMask_Stop);
+    HOST_AdvanceClock(50);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B0), 9);
+    HOST_TEST_CHECK(!CT16B_IsEnabled(CT16B0));
+}
+
+static void test_width(void)
+{
+    host_test_setup();
+
+    /* 16-bit timers wrap at 0x10000, 32-bit ones don't */
+    CT16B_SetCount(CT16B1, 0xfffe);
+    CT16B_Enable(CT16B1);
+    HOST_AdvanceClock(3);
+    HOST_TEST_EQUAL(CT16B_GetCount(CT16B1), 1);
+
+    CT32B_SetCount(CT32B0, 0xfffe);
+    CT32B_Enable(CT32B0);
+    HOST_AdvanceClock(3);
+    HOST_TEST_EQUAL(CT32B_GetCount(CT32B0), 0x10001);
+
+    /* Match on a 32-bit value */
+    CT32B_SetChannelMatchValue(CT32B0, 2, 0x10010);
+    CT32B_SetChannelMatchControl(CT32B0, 2, CT32B_MatchControl_Interrupt);
+    HOST_AdvanceClock(0x0f);
+    HOST_TEST_EQUAL(CT32B_GetPendingIT(CT32B0), CT32B_IT_MR2);
+}
+
+static void test_capture(void)
+{
+    host_test_setup();
+
+    CT16B_SetConfigForCaptureChannel(CT16B0, 0, CT16B_CaptureConfigMask_RisingEdges
+                                                | CT16B_CaptureConfigMask_Interrupt);
+    HOST_TEST_EQUAL(CT16B_GetConfigForCaptureChannel(CT16B0, 0),
+                    CT16B_CaptureConfigMask_RisingEdges | CT16B_CaptureConfigMask_Interrupt);
+    CT16B_Enable(CT16B0);
+
+    HOST_AdvanceClock(123);
+    HOST_CTCaptureEdge(CT16B0, 1);
+    HOST_TEST_EQUAL(CT16B_GetCountForCaptureChannel(CT16B0, 0), 123);
+    HOST_TEST_EQUAL(CT16B_GetPendingInteruptMask(CT16B0), CT16B_InterruptMask_CR0);
+
+    /* Falling edges aren't being watched */
+    HOST_AdvanceClock(10);
+    HOST_CTCaptureEdge(CT16B0, 0);
+    HOST_TEST_EQUAL(CT16B_GetCountForCaptureChannel(CT16B0, 0), 123);
+
+    CT32B_SetCaptureControl(CT32B1, 0, CT32B_CaptureControl_FallingEdges);
+    CT32B_Enable(CT32B1);
+    HOST_AdvanceClock(77);
+    HOST_CTCaptureEdge(CT32B1, 0);
+    HOST_TEST_EQUAL(CT32B_GetCaptureValue(CT32B1, 0), 77);
+    HOST_TEST_EQUAL(CT32B_GetPendingIT(CT32B1), 0);
+}
+
+int main(void)
+{
+    test_prescaler();
+    test_match();
+    test_width();
+    test_capture();
+
+    return host_test_done("test_ct");
+}
@@ -0,0 +1,184 @@
+/******************************************************************************
+ * @file:    test_gate.c
+ * @purpose: Host unit tests for peripheral gating: reference counts, the
+ *           clocks / divider behind a line, time accounting, & the drivers'
+ *           references.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx/gate.h"
+#include "lpc11xx/serial.h"
+#include "lpc11xx/idle.h"
+#include "host_test.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static uint32_t gate_time;
+
+static uint8_t serial_rx[64];
+static uint8_t serial_tx[64];
+
+
+/* Functions ----------------------------------------------------------------*/
+
+static uint32_t gate_now(void)
+{
+    return gate_time;
+}
+
+static unsigned int gate_users(GATE_Line_Type line)
+{
+    GATE_Stats_Type stats;
+
+
+    GATE_GetStats(line, &stats);
+
+    return stats.Users;
+}
+
+static int uart0_clocked(void)
+{
+    return (SYSCON->SYSAHBCLKCTRL & SYSCON_AHBClockLine_UART0) != 0;
+}
+
+static void test_refcount(void)
+{
+    host_test_setup();
+
+    /* UART0's divider is kept across a release */
+    SYSCON_SetUART0ClockDivider(3);
+    GATE_Init();
+    HOST_TEST_CHECK(!uart0_clocked());
+    HOST_TEST_EQUAL(SYSCON_GetUART0ClockDivider(), 0);
+    HOST_TEST_CHECK(!GATE_IsEnabled(GATE_UART0));
+
+    GATE_Acquire(GATE_UART0);
+    HOST_TEST_CHECK(uart0_clocked());
+    HOST_TEST_EQUAL(SYSCON_GetUART0ClockDivider(), 3);
+
+    /* Only the last user turns it off */
+    GATE_Acquire(GATE_UART0);
+    HOST_TEST_EQUAL(gate_users(GATE_UART0), 2);
+    GATE_Release(GATE_UART0);
+    HOST_TEST_CHECK(uart0_clocked());
+    HOST_TEST_CHECK(GATE_IsEnabled(GATE_UART0));
+    GATE_Release(GATE_UART0);
+    HOST_TEST_CHECK(!uart0_clocked());
+    HOST_TEST_EQUAL(SYSCON_GetUART0ClockDivider(), 0);
+    HOST_TEST_CHECK(!GATE_IsEnabled(GATE_UART0));
+
+    /* The ADC's analog power goes with it */
+    GATE_Acquire(GATE_ADC0);
+    HOST_TEST_CHECK(!(SYSCON->PDRUNCFG & SYSCON_AnalogPowerLine_ADC0));
+    GATE_Release(GATE_ADC0);
+    HOST_TEST_CHECK(SYSCON->PDRUNCFG & SYSCON_AnalogPowerLine_ADC0);
+}
+
+static void test_accounting(void)
+{
+    GATE_Stats_Type before, stats;
+
+
+    host_test_setup();
+
+    GATE_GetStats(GATE_SSP0, &before);
+
+    gate_time = 100;
+    GATE_SetTimeSource(gate_now);
+
+    GATE_Acquire(GATE_SSP0);
+    gate_time = 150;
+    GATE_Release(GATE_SSP0);
+
+    /* Time off isn't counted */
+    gate_time = 1000;
+    GATE_Acquire(GATE_SSP0);
+    gate_time = 1020;
+
+    /* Time so far is included while on */
+    GATE_GetStats(GATE_SSP0, &stats);
+    HOST_TEST_EQUAL(stats.Enables - before.Enables, 2);
+    HOST_TEST_EQUAL(stats.EnabledTime - before.EnabledTime, 70);
+    HOST_TEST_EQUAL(stats.Users, 1);
+
+    gate_time = 1030;
+    GATE_Release(GATE_SSP0);
+    gate_time = 5000;
+    GATE_GetStats(GATE_SSP0, &stats);
+    HOST_TEST_EQUAL(stats.EnabledTime - before.EnabledTime, 80);
+    HOST_TEST_EQUAL(stats.Users, 0);
+
+    GATE_SetTimeSource(0);
+}
+
+/* A driver holds exactly one reference, whoever else uses the line */
+static void test_drivers(void)
+{
+    SERIAL_Config_Type config = {
+        .Baud      = 115200,
+        .RxTrigger = UART_RxFifoTrigger_1,
+        .RxBuffer  = serial_rx,
+        .RxSize    = sizeof(serial_rx),
+        .TxBuffer  = serial_tx,
+        .TxSize    = sizeof(serial_tx),
+    };
+
+
+    host_test_setup();
+    HOST_SetVector(UART0_IRQn, SERIAL_IRQHandler);
+    HOST_SetVector(CT32B0_IRQn, IDLE_CT32B0_IRQHandler);
+
+    /* Someone else turned UART0 on first */
+    GATE_Acquire(GATE_UART0);
+
+    HOST_TEST_EQUAL(SERIAL_Init(&config), 0);
+    HOST_TEST_EQUAL(gate_users(GATE_UART0), 2);
+    HOST_TEST_EQUAL(SERIAL_Init(&config), 0);
+    HOST_TEST_EQUAL(gate_users(GATE_UART0), 2);
+
+    /* Their release leaves it running for the driver */
+    GATE_Release(GATE_UART0);
+    HOST_TEST_CHECK(uart0_clocked());
+    HOST_TEST_CHECK(SYSCON_GetUART0ClockDivider() != 0);
+
+    SERIAL_Deinit();
+    HOST_TEST_EQUAL(gate_users(GATE_UART0), 0);
+    HOST_TEST_CHECK(!uart0_clocked());
+    HOST_TEST_CHECK(!(NVIC->ISER[0] & (1UL << UART0_IRQn)));
+
+    /* A second deinit doesn't release someone else's reference */
+    GATE_Acquire(GATE_UART0);
+    SERIAL_Deinit();
+    HOST_TEST_EQUAL(gate_users(GATE_UART0), 1);
+    GATE_Release(GATE_UART0);
+
+    IDLE_Init();
+    IDLE_Init();
+    HOST_TEST_EQUAL(gate_users(GATE_CT32B0), 1);
+    IDLE_Deinit();
+    HOST_TEST_EQUAL(gate_users(GATE_CT32B0), 0);
+    HOST_TEST_CHECK(!(SYSCON->SYSAHBCLKCTRL & SYSCON_AHBClockLine_CT32B0));
+    HOST_TEST_CHECK(!(NVIC->ISER[0] & (1UL << CT32B0_IRQn)));
+
+    HOST_SetVector(UART0_IRQn, 0);
+    HOST_SetVector(CT32B0_IRQn, 0);
+}
+
+int main(void)
+{
+    test_refcount();
+    test_accounting();
+    test_drivers();
+
+    return host_test_done("test_gate");
+}
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * @file:    test_gpio.c
+ * @purpose: Host unit tests for the GPIO accessors against the GPIO model
+ *           (masked data access, directions, edge & level interrupts).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx/gpio.h"
+#include "host_test.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static volatile unsigned int gpio_irqs;
+static volatile uint32_t gpio_pending;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/* Edge handler: note & clear what fired */
+static void gpio_edge_handler(void)
+{
+    gpio_irqs++;
+    gpio_pending |= GPIO_GetPendingInterruptsMask(GPIO0);
+    GPIO_ClearPendingInterruptsForPins(GPIO0, GPIO_GetPendingInterruptsMask(GPIO0));
+}
+
+/* Level handler: a level can't be cleared, so mask it off */
+static void gpio_level_handler(void)
+{
+    gpio_irqs++;
+    gpio_pending |= GPIO_GetPendingInterruptsMask(GPIO0);
+    GPIO_DisableInterruptsForPins(GPIO0, GPIO_GetPendingInterruptsMask(GPIO0));
+}
+
+static void test_outputs(void)
+{
+    host_test_setup();
+
+    GPIO_SetPinDirections(GPIO1, 0x00f, GPIO_Direction_Out);
+
+    GPIO_WritePort(GPIO1, 0x005);
+    HOST_TEST_EQUAL(HOST_GPIOGetPins(GPIO1) & 0x00f, 0x005);
+
+    /* Only the masked pins change */
+    GPIO_WritePins(GPIO1, 0x003, 0x002);
+    HOST_TEST_EQUAL(HOST_GPIOGetPins(GPIO1) & 0x00f, 0x006);
+
+    GPIO_SetPinsHigh(GPIO1, 0x009);
+    HOST_TEST_EQUAL(HOST_GPIOGetPins(GPIO1) & 0x00f, 0x00f);
+
+    GPIO_SetPinsLow(GPIO1, 0x003);
+    HOST_TEST_EQUAL(HOST_GPIOGetPins(GPIO1) & 0x00f, 0x00c);
+
+    GPIO_InvertPins(GPIO1, 0x006);
+    HOST_TEST_EQUAL(HOST_GPIOGetPins(GPIO1) & 0x00f, 0x00a);
+
+    /* Masked reads only return the selected pins */
+    HOST_TEST_EQUAL(GPIO_ReadPins(GPIO1, 0x003), 0x002);
+    HOST_TEST_EQUAL(GPIO_ReadPort(GPIO1) & 0x00f, 0x00a);
+
+    /* Other ports are untouched */
+    HOST_TEST_EQUAL(HOST_GPIOGetPins(GPIO2), 0);
+}
+
+static void test_inputs(void)
+{
+    host_test_setup();
+
+    GPIO_SetPinDirections(GPIO0, 0x00f, GPIO_Direction_Out);
+    GPIO_WritePort(GPIO0, 0x000);
+
+    HOST_GPIOSetInputs(GPIO0, 0x0ff, 0x0a5);
+
+    /* Inputs see the driven level; outputs keep their latch */
+    HOST_TEST_EQUAL(GPIO_ReadPins(GPIO0, 0x0f0), 0x0a0);
+    HOST_TEST_EQUAL(GPIO_ReadPins(GPIO0, 0x00f), 0x000);
+
+    /* Turning a pin around shows the outside level */
+    GPIO_SetPinDirections(GPIO0, 0x001, GPIO_Direction_In);
+    HOST_TEST_EQUAL(GPIO_ReadPins(GPIO0, 0x001), 0x001);
+}
+
+static void test_edge_interrupts(void)
+{
+    host_test_setup();
+    HOST_SetVector(GPIO0_IRQn, gpio_edge_handler);
+    gpio_irqs = 0;
+    gpio_pending = 0;
+
+    GPIO_SetPinDirections(GPIO0, 0x030, GPIO_Direction_In);
+    GPIO_SetSenseConfigForPins(GPIO0, 0x010, GPIO_Sense_RisingEdge);
+    GPIO_SetSenseConfigForPins(GPIO0, 0x020, GPIO_Sense_BothEdges);
+    HOST_TEST_EQUAL(GPIO_GetPinSenseConfig(GPIO0, 4), GPIO_Sense_RisingEdge);
+    HOST_TEST_EQUAL(GPIO_GetPinSenseConfig(GPIO0, 5), GPIO_Sense_BothEdges);
+
+    /* Edges latch in RIS even while masked */
+    HOST_GPIOSetInputs(GPIO0, 0x010, 0x010);
+    HOST_TEST_EQUAL(GPIO_GetRawInterruptsMask(GPIO0), 0x010);
+    HOST_TEST_EQUAL(GPIO_GetPendingInterruptsMask(GPIO0), 0);
+    GPIO_ClearPendingInterruptsForPin(GPIO0, 4);
+    HOST_TEST_EQUAL(GPIO_GetRawInterruptsMask(GPIO0), 0);
+
+    GPIO_EnableInterruptsForPins(GPIO0, 0x030);
+    NVIC_EnableIRQ(GPIO0_IRQn);
+
+    /* Falling edge on a rising-edge pin: nothing */
+    HOST_GPIOSetInputs(GPIO0, 0x010, 0x000);
+    HOST_TEST_EQUAL(gpio_irqs, 0);
+
+    HOST_GPIOSetInputs(GPIO0, 0x010, 0x010);
+    HOST_TEST_EQUAL(gpio_irqs, 1);
+    HOST_TEST_EQUAL(gpio_pending, 0x010);
+
+    /* Both edges on pin 5 */
+    gpio_pending = 0;
+    HOST_GPIOSetInputs(GPIO0, 0x020, 0x020);
+    HOST_GPIOSetInputs(GPIO0, 0x020, 0x000);
+    HOST_TEST_EQUAL(gpio_irqs, 3);
+    HOST_TEST_EQUAL(gpio_pending, 0x020);
+    HOST_TEST_EQUAL(GPIO_GetRawInterruptsMask(GPIO0), 0);
+    HOST_TEST_EQUAL(HOST_GetInterruptCount(GPIO0_IRQn), 3);
+}
+
+static void test_level_interrupts(void)
+{
+    host_test_setup();
+    HOST_SetVector(GPIO0_IRQn, gpio_level_handler);
+    gpio_irqs = 0;
+    gpio_pending = 0;
+
+    GPIO_SetPinDirections(GPIO0, 0x040, GPIO_Direction_In);
+    GPIO_SetSenseConfigForPins(GPIO0, 0x040, GPIO_Sense_High);
+    HOST_TEST_EQUAL(GPIO_GetPinSenseConfig(GPIO0, 6), GPIO_Sense_High);
+    GPIO_EnableInterruptsForPins(GPIO0, 0x040);
+    NVIC_EnableIRQ(GPIO0_IRQn);
+
+    HOST_GPIOSetInputs(GPIO0, 0x040, 0x040);
+    HOST_TEST_EQUAL(gpio_irqs, 1);
+    HOST_TEST_EQUAL(gpio_pending, 0x040);
+
+    /* Still active: writing IC doesn't clear a level */
+    GPIO_ClearPendingInterruptsForPin(GPIO0, 6);
+    HOST_TEST_EQUAL(GPIO_GetRawInterruptsMask(GPIO0), 0x040);
+
+    HOST_GPIOSetInputs(GPIO0, 0x040, 0x000);
+    HOST_TEST_EQUAL(GPIO_GetRawInterruptsMask(GPIO0), 0);
+    HOST_TEST_EQUAL(gpio_irqs, 1);
+}
+
+int main(void)
+{
+    test_outputs();
+    test_inputs();
+    test_edge_interrupts();
+    test_level_interrupts();
+
+    return host_test_done("test_gpio");
+}
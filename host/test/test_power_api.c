@@ -0,0 +1,303 @@
+/******************************************************************************
+ * @file:    test_power_api.c
+ * @purpose: Host tests for the Power Profile API wrappers: command / result
+ *           marshalling, every ROM status & clock notifications.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * The ROM driver table is mapped at its real address & points at stand-ins
+ * for set_pll / set_power, which record their commands & then run the
+ * lpc11xx-sim ROM emulation (included here) or return a forced status.
+ * The wrappers & the emulation are included directly; neither is in
+ * liblpc11xx-host.a.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "../../src/lpc11xx_power_api.c"
+#include "../sim/lpc11xx_sim_rom.c"
+#include "host_test.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Page holding the ROM's driver table pointer */
+#define ROM_TABLE_PAGE    (POWERAPI_ROM_DRIVER_TABLE & ~0xfffUL)
+
+/* ROM stand-in status meaning "run the emulation" */
+#define ROM_EMULATE       (-1)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static uint32_t rom_pll_command[4];
+static uint32_t rom_power_command[3];
+static unsigned int rom_pll_calls;
+static unsigned int rom_power_calls;
+static unsigned int rom_flash_waits;
+static int rom_status = ROM_EMULATE;
+
+static unsigned int notify_pre;
+static unsigned int notify_post;
+static uint32_t notify_pre_clock;
+static uint32_t notify_post_clock;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/* The emulation's ISS hooks aren't used here */
+uint32_t SIM_Read(SIM_CPU_Type *cpu, uint32_t addr, unsigned int size)
+{
+    (void)cpu; (void)addr; (void)size;
+    return 0;
+}
+
+void SIM_Write(SIM_CPU_Type *cpu, uint32_t addr, uint32_t value, unsigned int size)
+{
+    (void)cpu; (void)addr; (void)value; (void)size;
+}
+
+uint8_t *SIM_Memory(SIM_CPU_Type *cpu, uint32_t addr, uint32_t len)
+{
+    (void)cpu; (void)addr; (void)len;
+    return 0;
+}
+
+static void rom_set_pll(uint32_t command[], uint32_t result[])
+{
+    memcpy(rom_pll_command, command, sizeof(rom_pll_command));
+    rom_flash_waits = FLASH_GetWaitStates();
+    rom_pll_calls++;
+
+    if (rom_status == ROM_EMULATE) {
+        sim_set_pll(command, result);
+    } else {
+        result[0] = rom_status;
+    }
+}
+
+static void rom_set_power(uint32_t command[], uint32_t result[])
+{
+    memcpy(rom_power_command, command, sizeof(rom_power_command));
+    rom_power_calls++;
+
+    if (rom_status == ROM_EMULATE) {
+        sim_set_power(command, result);
+    } else {
+        result[0] = rom_status;
+    }
+}
+
+static const PowerAPI_ROM_Type rom_power_api = { rom_set_pll, rom_set_power };
+static const PowerAPI_ROM_Type *rom_drivers[POWERAPI_ROM_DRIVER_INDEX + 1];
+
+static void notify(CLOCK_Event_Type event, uint32_t coreClock)
+{
+    if (event == CLOCK_Event_PreChange) {
+        notify_pre++;
+        notify_pre_clock = coreClock;
+    } else {
+        notify_post++;
+        notify_post_clock = coreClock;
+    }
+}
+
+static CLOCK_Notifier_Type notifier = { notify, 0 };
+
+/** @brief Map the ROM driver table & point it at the stand-ins.
+  */
+static void rom_map(void)
+{
+    void *p;
+
+
+    p = mmap((void *)ROM_TABLE_PAGE, 0x1000, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p != (void *)ROM_TABLE_PAGE) {
+        fprintf(stderr, "test_power_api: can't map the ROM driver table\n");
+        exit(1);
+    }
+
+    rom_drivers[POWERAPI_ROM_DRIVER_INDEX] = &rom_power_api;
+    *(const PowerAPI_ROM_Type ***)POWERAPI_ROM_DRIVER_TABLE = rom_drivers;
+}
+
+static void setup(void)
+{
+    host_test_setup();
+
+#ifdef HSE_Val
+    /* Feed the PLL from the IRC so the clocks below hold for any crystal */
+    SYSCON_SetSysPLLClockSource(SYSCON_SysPLLClockSource_IRC);
+    SYSCON_EnableSysPLLClockSourceUpdate();
+#endif
+
+    rom_status = ROM_EMULATE;
+    rom_pll_calls = 0;
+    rom_power_calls = 0;
+    notify_pre = 0;
+    notify_post = 0;
+}
+
+static void test_set_pll(void)
+{
+    setup();
+
+    /* Marshalling: kHz in & out, mode & lock polls passed through */
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 100),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(rom_pll_calls, 1);
+    HOST_TEST_EQUAL(rom_pll_command[0], IRC_Val / 1000);
+    HOST_TEST_EQUAL(rom_pll_command[1], 24000);
+    HOST_TEST_EQUAL(rom_pll_command[2], PowerAPI_PLLMode_Equal);
+    HOST_TEST_EQUAL(rom_pll_command[3], 100);
+
+    /* The registers the ROM wrote are picked up */
+    HOST_TEST_EQUAL(SystemCoreClock, 24000000);
+    HOST_TEST_EQUAL(CLOCK_GetFrequency(CLOCK_Core), 24000000);
+
+    /* Flash is slowed before the ROM speeds the clock up */
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(48000000, PowerAPI_PLLMode_Equal, 100),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(rom_flash_waits, CLOCK_FlashWaitStates(48000000));
+    HOST_TEST_EQUAL(SystemCoreClock, 48000000);
+
+    /* Inexact modes (12MHz * m / div: 42MHz is the best at or below 47MHz) */
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(47000000, PowerAPI_PLLMode_LessOrEqual, 100),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(rom_pll_command[2], PowerAPI_PLLMode_LessOrEqual);
+    HOST_TEST_EQUAL(SystemCoreClock, 42000000);
+
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(47000000, PowerAPI_PLLMode_GreaterOrEqual, 100),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(SystemCoreClock, 48000000);
+
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(47000000, PowerAPI_PLLMode_Approximate, 100),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(rom_pll_command[2], PowerAPI_PLLMode_Approximate);
+    HOST_TEST_EQUAL(SystemCoreClock, 48000000);
+}
+
+static void test_set_pll_errors(void)
+{
+    setup();
+
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 100),
+                    PowerAPI_Status_Success);
+
+    /* From the emulation; the clock is left alone */
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(60000000, PowerAPI_PLLMode_Equal, 100),
+                    PowerAPI_Status_InvalidFrequency);
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(47000000, PowerAPI_PLLMode_Equal, 100),
+                    PowerAPI_Status_FreqNotFound);
+    HOST_TEST_EQUAL(SystemCoreClock, 24000000);
+
+    /* A PLL that never locks leaves the core on the PLL input */
+    *(volatile uint32_t *)&SYSCON->SYSPLLSTAT = 0;
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 10),
+                    PowerAPI_Status_PLLNotLocked);
+    HOST_TEST_EQUAL(SystemCoreClock, IRC_Val);
+    *(volatile uint32_t *)&SYSCON->SYSPLLSTAT = 1;
+
+    /* Every status the ROM can give is passed back */
+    rom_status = PowerAPI_Status_InvalidFrequency;
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 100), rom_status);
+    rom_status = PowerAPI_Status_InvalidMode;
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 100), rom_status);
+    rom_status = PowerAPI_Status_FreqNotFound;
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 100), rom_status);
+    rom_status = PowerAPI_Status_PLLNotLocked;
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 100), rom_status);
+}
+
+#ifdef HSE_Val
+/* With the PLL on the crystal, its frequency is what's passed */
+static void test_set_pll_crystal(void)
+{
+    setup();
+
+    SYSCON_SetSysPLLClockSource(SYSCON_SysPLLClockSource_SysOsc);
+    SYSCON_EnableSysPLLClockSourceUpdate();
+
+    PowerAPI_SetPLLFreq(F_CPU, PowerAPI_PLLMode_Approximate, 100);
+    HOST_TEST_EQUAL(rom_pll_calls, 1);
+    HOST_TEST_EQUAL(rom_pll_command[0], HSE_Val / 1000);
+    HOST_TEST_EQUAL(rom_pll_command[1], F_CPU / 1000);
+}
+#endif
+
+static void test_set_power(void)
+{
+    setup();
+
+    /* Marshalling: the current clock in MHz, twice */
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 100),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(PowerAPI_SetPowerMode(PowerAPI_PowerMode_Efficiency),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(rom_power_calls, 1);
+    HOST_TEST_EQUAL(rom_power_command[0], 24);
+    HOST_TEST_EQUAL(rom_power_command[1], PowerAPI_PowerMode_Efficiency);
+    HOST_TEST_EQUAL(rom_power_command[2], 24);
+    HOST_TEST_EQUAL(FLASH_GetWaitStates(), CLOCK_FlashWaitStates(24000000));
+
+    HOST_TEST_EQUAL(PowerAPI_SetPowerMode(PowerAPI_PowerMode_LowCurrent),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(rom_power_command[1], PowerAPI_PowerMode_LowCurrent);
+
+    rom_status = PowerAPI_Status_InvalidFrequency;
+    HOST_TEST_EQUAL(PowerAPI_SetPowerMode(PowerAPI_PowerMode_Default), rom_status);
+    rom_status = PowerAPI_Status_InvalidMode;
+    HOST_TEST_EQUAL(PowerAPI_SetPowerMode(PowerAPI_PowerMode_Performance), rom_status);
+}
+
+static void test_notify(void)
+{
+    setup();
+    CLOCK_RegisterNotifier(&notifier);
+
+    /* Pre gets the request, post the clock the ROM chose */
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(47000000, PowerAPI_PLLMode_LessOrEqual, 100),
+                    PowerAPI_Status_Success);
+    HOST_TEST_EQUAL(notify_pre, 1);
+    HOST_TEST_EQUAL(notify_pre_clock, 47000000);
+    HOST_TEST_EQUAL(notify_post, 1);
+    HOST_TEST_EQUAL(notify_post_clock, 42000000);
+
+    /* Post comes after a failure too, with the clock left running */
+    *(volatile uint32_t *)&SYSCON->SYSPLLSTAT = 0;
+    HOST_TEST_EQUAL(PowerAPI_SetPLLFreq(24000000, PowerAPI_PLLMode_Equal, 10),
+                    PowerAPI_Status_PLLNotLocked);
+    *(volatile uint32_t *)&SYSCON->SYSPLLSTAT = 1;
+    HOST_TEST_EQUAL(notify_pre, 2);
+    HOST_TEST_EQUAL(notify_post, 2);
+    HOST_TEST_EQUAL(notify_post_clock, IRC_Val);
+
+    /* set_power doesn't change the clock */
+    PowerAPI_SetPowerMode(PowerAPI_PowerMode_Default);
+    HOST_TEST_EQUAL(notify_post, 2);
+
+    CLOCK_UnregisterNotifier(&notifier);
+}
+
+int main(void)
+{
+    rom_map();
+
+    test_set_pll();
+    test_set_pll_errors();
+#ifdef HSE_Val
+    test_set_pll_crystal();
+#endif
+    test_set_power();
+    test_notify();
+
+    return host_test_done("test_power_api");
+}
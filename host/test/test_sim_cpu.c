@@ -0,0 +1,507 @@
+/******************************************************************************
+ * @file:    test_sim_cpu.c
+ * @purpose: Host unit tests for the lpc11xx-sim Cortex-M0 core: hand
+ *           assembled instruction sequences, checked for their architectural
+ *           result & their cycle count.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * The core is included directly (it isn't in liblpc11xx-host.a); the boot
+ * ROM emulation & the profiler are stubbed out.  Each sequence is loaded
+ * behind a minimal vector table & run up to its end address, so the cycle
+ * count covers exactly the instructions under test.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../sim/lpc11xx_sim_cpu.c"
+#include "host_test.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Where sequences are loaded (after the vector table) */
+#define TEST_CODE         (SIM_FLASH_BASE + 0x100)
+#define TEST_RAM_CODE     (SIM_RAM_BASE + 0x100)
+
+/* Scratch data & the initial main stack */
+#define TEST_DATA         (SIM_RAM_BASE + 0x400)
+#define TEST_STACK        (SIM_RAM_BASE + SIM_RAM_SIZE)
+
+/* UART0 handler, for the exception timing test */
+#define TEST_HANDLER      (SIM_FLASH_BASE + 0x180)
+
+/* No sequence here comes anywhere near this */
+#define TEST_MAX_CYCLES   (1000)
+
+/* Instructions used more than once */
+#define OP_NOP            (0xbf00)
+#define OP_BX_LR          (0x4770)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static SIM_CPU_Type Cpu;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/* Stand-ins for the parts of the simulator not under test */
+int SIM_RomCall(SIM_CPU_Type *cpu, uint32_t pc)
+{
+    (void)cpu; (void)pc;
+    return 0;
+}
+
+void SIM_ProfCall(SIM_CPU_Type *cpu, uint32_t target, uint32_t ret)
+{
+    (void)cpu; (void)target; (void)ret;
+}
+
+void SIM_ProfReturn(SIM_CPU_Type *cpu, uint32_t pc)
+{
+    (void)cpu; (void)pc;
+}
+
+void SIM_ProfException(SIM_CPU_Type *cpu, uint32_t handler, uint32_t exc_return)
+{
+    (void)cpu; (void)handler; (void)exc_return;
+}
+
+void SIM_ProfExceptionReturn(SIM_CPU_Type *cpu)
+{
+    (void)cpu;
+}
+
+void SIM_ProfAccount(SIM_CPU_Type *cpu, uint32_t pc, unsigned int cycles)
+{
+    (void)cpu; (void)pc; (void)cycles;
+}
+
+/** @brief Store a word little-endian, as the core reads it.
+  */
+static void test_word(uint8_t *mem, uint32_t value)
+{
+    mem[0] = value & 0xff;
+    mem[1] = (value >> 8) & 0xff;
+    mem[2] = (value >> 16) & 0xff;
+    mem[3] = value >> 24;
+}
+
+/** @brief Store halfwords little-endian, as the core fetches them.
+  */
+static void test_place(uint8_t *mem, const uint16_t *code, unsigned int count)
+{
+    unsigned int i;
+
+
+    for (i = 0; i < count; i++) {
+        mem[i * 2]     = code[i] & 0xff;
+        mem[i * 2 + 1] = code[i] >> 8;
+    }
+}
+
+/** @brief Load a sequence at addr (flash or RAM) & reset the core onto it.
+  *
+  * Runs stop at the end of the sequence; flash has no wait states unless a
+  * test sets them.  Registers may be set up between this & test_run().
+  */
+static void test_load(uint32_t addr, const uint16_t *code, unsigned int count)
+{
+    memset(Cpu.Flash, 0xff, sizeof(Cpu.Flash));
+    memset(Cpu.Ram, 0, sizeof(Cpu.Ram));
+
+    test_word(&Cpu.Flash[0], TEST_STACK);
+    test_word(&Cpu.Flash[4], addr | 1);
+
+    test_place(SIM_Memory(&Cpu, addr, count * 2), code, count);
+
+    Cpu.MulCycles = 1;
+    Cpu.MaxCycles = TEST_MAX_CYCLES;
+    Cpu.Until = addr + count * 2;
+
+    SIM_Reset(&Cpu);
+
+    FLASH->FLASHCFG &= ~FLASH_FLASHTIM_Mask;
+}
+
+/** @brief Run the loaded sequence.
+  * @return                  Cycles taken.
+  */
+static uint64_t test_run(void)
+{
+    SIM_Run(&Cpu);
+    HOST_TEST_EQUAL(Cpu.Stop, SIM_Stop_Until);
+
+    return Cpu.Cycles;
+}
+
+/* Adds, subtracts & compares: results, NZCV & one cycle each */
+static void test_arith(void)
+{
+    static const uint16_t add[] = {
+        0x2080,             /* MOVS  r0, #0x80     */
+        0x0600,             /* LSLS  r0, r0, #24   */
+        0x1801,             /* ADDS  r1, r0, r0    */
+    };
+    static const uint16_t sub[] = {
+        0x2805,             /* CMP   r0, #5        */
+        0x1ec1,             /* SUBS  r1, r0, #3    */
+    };
+    static const uint16_t carry[] = {
+        0x4148,             /* ADCS  r0, r1        */
+        0x4262,             /* RSBS  r2, r4        */
+    };
+
+
+    test_load(TEST_CODE, add, 3);
+    HOST_TEST_EQUAL(test_run(), 3);
+    HOST_TEST_EQUAL(Cpu.Instructions, 3);
+    HOST_TEST_EQUAL(Cpu.R[0], 0x80000000UL);
+    HOST_TEST_EQUAL(Cpu.R[1], 0);
+    HOST_TEST_CHECK(!Cpu.N && Cpu.Z && Cpu.C && Cpu.V);
+
+    test_load(TEST_CODE, sub, 2);
+    Cpu.R[0] = 3;
+    HOST_TEST_EQUAL(test_run(), 2);
+    HOST_TEST_EQUAL(Cpu.R[1], 0);
+    HOST_TEST_CHECK(!Cpu.N && Cpu.Z && Cpu.C && !Cpu.V);
+
+    /* The compare alone: 3 - 5 borrows */
+    test_load(TEST_CODE, sub, 1);
+    Cpu.R[0] = 3;
+    HOST_TEST_EQUAL(test_run(), 1);
+    HOST_TEST_CHECK(Cpu.N && !Cpu.Z && !Cpu.C && !Cpu.V);
+
+    test_load(TEST_CODE, carry, 2);
+    Cpu.R[0] = 1;
+    Cpu.R[1] = 2;
+    Cpu.R[4] = 5;
+    Cpu.C = 1;
+    HOST_TEST_EQUAL(test_run(), 2);
+    HOST_TEST_EQUAL(Cpu.R[0], 4);
+    HOST_TEST_EQUAL(Cpu.R[2], (uint32_t)-5);
+    HOST_TEST_CHECK(Cpu.N && !Cpu.C);
+}
+
+/* Logical operations, extends & byte reversal: one cycle each */
+static void test_logic(void)
+{
+    static const uint16_t code[] = {
+        0x4008,             /* ANDS  r0, r1        */
+        0x4053,             /* EORS  r3, r2        */
+        0x43a6,             /* BICS  r6, r4        */
+        0xb24f,             /* SXTB  r7, r1        */
+        0xb29d,             /* UXTH  r5, r3        */
+        0xba14,             /* REV   r4, r2        */
+        0xbad2,             /* REVSH r2, r2        */
+        0x43c9,             /* MVNS  r1, r1        */
+    };
+
+
+    test_load(TEST_CODE, code, 8);
+    Cpu.R[0] = 0xff00ff00UL;
+    Cpu.R[1] = 0x0ff00f80UL;
+    Cpu.R[2] = 0x12345678UL;
+    Cpu.R[3] = 0xffffffffUL;
+    Cpu.R[4] = 0x0000ffffUL;
+    Cpu.R[6] = 0x12345678UL;
+    HOST_TEST_EQUAL(test_run(), 8);
+    HOST_TEST_EQUAL(Cpu.R[0], 0x0f000f00UL);
+    HOST_TEST_EQUAL(Cpu.R[3], 0xedcba987UL);
+    HOST_TEST_EQUAL(Cpu.R[6], 0x12340000UL);
+    HOST_TEST_EQUAL(Cpu.R[7], 0xffffff80UL);
+    HOST_TEST_EQUAL(Cpu.R[5], 0x0000a987UL);
+    HOST_TEST_EQUAL(Cpu.R[4], 0x78563412UL);
+    HOST_TEST_EQUAL(Cpu.R[2], 0x00007856UL);
+    HOST_TEST_EQUAL(Cpu.R[1], 0xf00ff07fUL);
+    HOST_TEST_CHECK(Cpu.N && !Cpu.Z);
+}
+
+/* Shifts by immediate & register, including the 32 / >32 cases */
+static void test_shift(void)
+{
+    static const uint16_t code[] = {
+        0x0808,             /* LSRS  r0, r1, #32   */
+        0x111a,             /* ASRS  r2, r3, #4    */
+        0x41ec,             /* RORS  r4, r5        */
+        0x40be,             /* LSLS  r6, r7        */
+    };
+
+
+    test_load(TEST_CODE, code, 1);
+    Cpu.R[1] = 0x80000001UL;
+    HOST_TEST_EQUAL(test_run(), 1);
+    HOST_TEST_EQUAL(Cpu.R[0], 0);
+    HOST_TEST_CHECK(Cpu.Z && Cpu.C);
+
+    test_load(TEST_CODE, code, 4);
+    Cpu.R[1] = 1;
+    Cpu.R[3] = 0x80000018UL;
+    Cpu.R[4] = 0x12345678UL;
+    Cpu.R[5] = 8;
+    Cpu.R[6] = 0xffffffffUL;
+    Cpu.R[7] = 33;
+    HOST_TEST_EQUAL(test_run(), 4);
+    HOST_TEST_EQUAL(Cpu.R[2], 0xf8000001UL);
+    HOST_TEST_EQUAL(Cpu.R[4], 0x78123456UL);
+    HOST_TEST_EQUAL(Cpu.R[6], 0);
+    HOST_TEST_CHECK(Cpu.Z && !Cpu.C);
+}
+
+/* MULS takes 1 or 32 cycles depending on the part's multiplier */
+static void test_mul(void)
+{
+    static const uint16_t code[] = {
+        0x4348,             /* MULS  r0, r1, r0    */
+    };
+
+
+    test_load(TEST_CODE, code, 1);
+    Cpu.R[0] = 7;
+    Cpu.R[1] = (uint32_t)-6;
+    HOST_TEST_EQUAL(test_run(), 1);
+    HOST_TEST_EQUAL(Cpu.R[0], (uint32_t)-42);
+    HOST_TEST_CHECK(Cpu.N && !Cpu.Z);
+
+    test_load(TEST_CODE, code, 1);
+    Cpu.MulCycles = 32;
+    Cpu.R[0] = 7;
+    Cpu.R[1] = 6;
+    HOST_TEST_EQUAL(test_run(), 32);
+    HOST_TEST_EQUAL(Cpu.R[0], 42);
+}
+
+/* Single loads & stores: two cycles each, sizes & sign extension */
+static void test_load_store(void)
+{
+    static const uint16_t code[] = {
+        0x6041,             /* STR   r1, [r0, #4]  */
+        0x7902,             /* LDRB  r2, [r0, #4]  */
+        0x5f03,             /* LDRSH r3, [r0, r4]  */
+        0x8101,             /* STRH  r1, [r0, #8]  */
+        0x6885,             /* LDR   r5, [r0, #8]  */
+        0x9601,             /* STR   r6, [sp, #4]  */
+    };
+    static const uint16_t literal[] = {
+        0x4800,             /* LDR   r0, [pc, #0]  */
+        0xe001,             /* B     .+6           */
+        0x5678, 0x1234,     /* .word 0x12345678    */
+    };
+
+
+    test_load(TEST_CODE, code, 6);
+    Cpu.R[0] = TEST_DATA;
+    Cpu.R[1] = 0xdeadbeefUL;
+    Cpu.R[4] = 6;
+    Cpu.R[6] = 0x600dUL;
+    Cpu.R[13] = TEST_STACK - 8;
+    HOST_TEST_EQUAL(test_run(), 12);
+    HOST_TEST_EQUAL(SIM_Read(&Cpu, TEST_DATA + 4, 4), 0xdeadbeefUL);
+    HOST_TEST_EQUAL(Cpu.R[2], 0xef);
+    HOST_TEST_EQUAL(Cpu.R[3], 0xffffdeadUL);
+    HOST_TEST_EQUAL(Cpu.R[5], 0xbeef);
+    HOST_TEST_EQUAL(SIM_Read(&Cpu, TEST_STACK - 4, 4), 0x600d);
+
+    /* Literal load (2) & the branch over the literal (3) */
+    test_load(TEST_CODE, literal, 4);
+    HOST_TEST_EQUAL(test_run(), 5);
+    HOST_TEST_EQUAL(Cpu.R[0], 0x12345678UL);
+    HOST_TEST_EQUAL(Cpu.Instructions, 2);
+}
+
+/* Multiple loads & stores: 1 + N cycles, write-back rules */
+static void test_multiple(void)
+{
+    static const uint16_t stack[] = {
+        0xb503,             /* PUSH  {r0, r1, lr}  */
+        0xbc0c,             /* POP   {r2, r3}      */
+    };
+    static const uint16_t block[] = {
+        0xc006,             /* STM   r0!, {r1, r2} */
+        0xcb30,             /* LDM   r3!, {r4, r5} */
+        0xce41,             /* LDM   r6, {r0, r6}  */
+    };
+
+
+    test_load(TEST_CODE, stack, 2);
+    Cpu.R[0] = 0x11111111UL;
+    Cpu.R[1] = 0x22222222UL;
+    Cpu.R[14] = 0x33333333UL;
+    HOST_TEST_EQUAL(test_run(), 4 + 3);
+    HOST_TEST_EQUAL(Cpu.R[2], 0x11111111UL);
+    HOST_TEST_EQUAL(Cpu.R[3], 0x22222222UL);
+    HOST_TEST_EQUAL(Cpu.R[13], TEST_STACK - 4);
+    HOST_TEST_EQUAL(SIM_Read(&Cpu, TEST_STACK - 4, 4), 0x33333333UL);
+
+    test_load(TEST_CODE, block, 3);
+    Cpu.R[0] = TEST_DATA;
+    Cpu.R[1] = 0xaaaaaaaaUL;
+    Cpu.R[2] = 0xbbbbbbbbUL;
+    Cpu.R[3] = TEST_DATA;
+    Cpu.R[6] = TEST_DATA;
+    HOST_TEST_EQUAL(test_run(), 3 + 3 + 3);
+    HOST_TEST_EQUAL(Cpu.R[4], 0xaaaaaaaaUL);
+    HOST_TEST_EQUAL(Cpu.R[5], 0xbbbbbbbbUL);
+    HOST_TEST_EQUAL(Cpu.R[3], TEST_DATA + 8);
+
+    /* Base in the list: loaded, not written back */
+    HOST_TEST_EQUAL(Cpu.R[0], 0xaaaaaaaaUL);
+    HOST_TEST_EQUAL(Cpu.R[6], 0xbbbbbbbbUL);
+}
+
+/* Conditional branches: 3 cycles taken, 1 not */
+static void test_branch(void)
+{
+    static const uint16_t code[] = {
+        0x2800,             /* CMP   r0, #0        */
+        0xd000,             /* BEQ   .+4           */
+        0x2101,             /* MOVS  r1, #1        */
+    };
+
+
+    test_load(TEST_CODE, code, 3);
+    Cpu.R[0] = 0;
+    HOST_TEST_EQUAL(test_run(), 1 + 3);
+    HOST_TEST_EQUAL(Cpu.R[1], 0);
+
+    test_load(TEST_CODE, code, 3);
+    Cpu.R[0] = 1;
+    HOST_TEST_EQUAL(test_run(), 1 + 1 + 1);
+    HOST_TEST_EQUAL(Cpu.R[1], 1);
+}
+
+/* Calls & returns: BL 4, BX 3, PUSH {lr} 2, POP {pc} 1 + 1 + 3 */
+static void test_call(void)
+{
+    static const uint16_t bx[] = {
+        0xf000, 0xf801,     /* BL    .+6           */
+        OP_NOP,             /* (returns here)      */
+        0x202a,             /* MOVS  r0, #42       */
+        OP_BX_LR,           /* BX    lr            */
+    };
+    static const uint16_t pop[] = {
+        0xf000, 0xf801,     /* BL    .+6           */
+        OP_NOP,             /* (returns here)      */
+        0xb500,             /* PUSH  {lr}          */
+        0xbd00,             /* POP   {pc}          */
+    };
+
+
+    test_load(TEST_CODE, bx, 5);
+    Cpu.Until = TEST_CODE + 4;
+    HOST_TEST_EQUAL(test_run(), 4 + 1 + 3);
+    HOST_TEST_EQUAL(Cpu.R[0], 42);
+    HOST_TEST_EQUAL(Cpu.R[14], (TEST_CODE + 4) | 1);
+
+    test_load(TEST_CODE, pop, 5);
+    Cpu.Until = TEST_CODE + 4;
+    HOST_TEST_EQUAL(test_run(), 4 + 2 + 5);
+    HOST_TEST_EQUAL(Cpu.R[13], TEST_STACK);
+}
+
+/* Special registers & barriers: MRS / MSR / ISB 4 cycles, CPS 1 */
+static void test_special(void)
+{
+    static const uint16_t code[] = {
+        0xb672,             /* CPSID i             */
+        0xf3ef, 0x8010,     /* MRS   r0, PRIMASK   */
+        0xb662,             /* CPSIE i             */
+        0xf3ef, 0x8110,     /* MRS   r1, PRIMASK   */
+        0xf3bf, 0x8f6f,     /* ISB                 */
+        0xf382, 0x8809,     /* MSR   PSP, r2       */
+    };
+
+
+    test_load(TEST_CODE, code, 10);
+    Cpu.R[2] = TEST_DATA | 3;
+    HOST_TEST_EQUAL(test_run(), 1 + 4 + 1 + 4 + 4 + 4);
+    HOST_TEST_EQUAL(Cpu.R[0], 1);
+    HOST_TEST_EQUAL(Cpu.R[1], 0);
+    HOST_TEST_EQUAL(Cpu.OtherSP, TEST_DATA);
+    HOST_TEST_EQUAL(Cpu.Instructions, 6);
+}
+
+/* Flash wait states: once per instruction word fetched & per data read */
+static void test_wait_states(void)
+{
+    static const uint16_t nops[] = {
+        OP_NOP, OP_NOP, OP_NOP, OP_NOP,
+    };
+    static const uint16_t load[] = {
+        0x6801,             /* LDR   r1, [r0]      */
+        0x6813,             /* LDR   r3, [r2]      */
+    };
+
+
+    test_load(TEST_CODE, nops, 4);
+    FLASH->FLASHCFG |= 2;
+    HOST_TEST_EQUAL(test_run(), 4 + 2 * 2);
+    HOST_TEST_EQUAL(Cpu.WaitCycles, 2 * 2);
+
+    /* From RAM, only the read from flash waits */
+    test_load(TEST_RAM_CODE, load, 2);
+    FLASH->FLASHCFG |= 2;
+    Cpu.R[0] = 0;
+    Cpu.R[2] = TEST_DATA;
+    HOST_TEST_EQUAL(test_run(), (2 + 2) + 2);
+    HOST_TEST_EQUAL(Cpu.R[1], TEST_STACK);
+    HOST_TEST_EQUAL(Cpu.WaitCycles, 2);
+}
+
+/* Interrupt entry & return: 16 cycles each, caller saved state restored */
+static void test_exception(void)
+{
+    static const uint16_t code[] = {
+        OP_NOP,
+    };
+    static const uint16_t handler[] = {
+        0x2007,             /* MOVS  r0, #7        */
+        0x2409,             /* MOVS  r4, #9        */
+        OP_BX_LR,           /* BX    lr            */
+    };
+
+
+    test_load(TEST_CODE, code, 1);
+    test_word(&Cpu.Flash[(SIM_EXC_IRQ0 + UART0_IRQn) * 4], TEST_HANDLER | 1);
+    test_place(&Cpu.Flash[TEST_HANDLER], handler, 3);
+    Cpu.R[0] = 0x1234;
+    NVIC_EnableIRQ(UART0_IRQn);
+    NVIC_SetPendingIRQ(UART0_IRQn);
+
+    HOST_TEST_EQUAL(test_run(), SIM_EXC_ENTRY_CYCLES + 1 + 1 + 3 + SIM_EXC_RETURN_CYCLES + 1);
+    HOST_TEST_EQUAL(Cpu.ExceptionCount, 1);
+    HOST_TEST_EQUAL(Cpu.Exception, 0);
+    HOST_TEST_EQUAL(Cpu.R[0], 0x1234);
+    HOST_TEST_EQUAL(Cpu.R[4], 9);
+    HOST_TEST_EQUAL(Cpu.R[13], TEST_STACK);
+    HOST_TEST_EQUAL(NVIC_GetPendingIRQ(UART0_IRQn), 0);
+
+    NVIC_DisableIRQ(UART0_IRQn);
+}
+
+int main(void)
+{
+    HOST_Init();
+    HOST_SetExternalCPU(1);
+
+    test_arith();
+    test_logic();
+    test_shift();
+    test_mul();
+    test_load_store();
+    test_multiple();
+    test_branch();
+    test_call();
+    test_special();
+    test_wait_states();
+    test_exception();
+
+    HOST_SetExternalCPU(0);
+
+    return host_test_done("test_sim_cpu");
+}
@@ -0,0 +1,214 @@
+/******************************************************************************
+ * @file:    test_uart.c
+ * @purpose: Host unit tests for the UART accessors & the SERIAL driver
+ *           against the UART0 model (FIFOs, interrupt IDs, flow control).
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx/uart.h"
+#include "lpc11xx/serial.h"
+#include "host_test.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static uint8_t serial_rx[256];
+static uint8_t serial_tx[256];
+
+
+/* Functions ----------------------------------------------------------------*/
+
+static void test_rx_fifo(void)
+{
+    static const uint8_t data[] = { 'a', 'b', 'c', 'd' };
+    uint8_t c;
+    unsigned int i;
+
+
+    host_test_setup();
+
+    UART_EnableFifos(UART0);
+    UART_SetRxFifoTrigger(UART0, UART_RxFifoTrigger_4);
+    UART_EnableInterrupts(UART0, UART_Interrupt_RxData);
+    HOST_TEST_EQUAL(UART_GetPendingInterruptID(UART0), UART_InterruptID_None);
+
+    /* Below the trigger level: data, but no interrupt until the time-out */
+    HOST_UARTReceive(UART0, data, 3);
+    HOST_TEST_CHECK(UART_GetLineStatus(UART0) & UART_LineStatus_RxData);
+    HOST_TEST_EQUAL(UART_GetPendingInterruptID(UART0), UART_InterruptID_None);
+    HOST_UARTRxIdle(UART0);
+    HOST_TEST_EQUAL(UART_GetPendingInterruptID(UART0), UART_InterruptID_CharacterTimeOut);
+
+    HOST_UARTReceive(UART0, &data[3], 1);
+    HOST_TEST_EQUAL(UART_GetPendingInterruptID(UART0), UART_InterruptID_RxDataAvailable);
+
+    for (i = 0; i < sizeof(data); i++) {
+        c = UART_Recv(UART0);
+        HOST_TEST_EQUAL(c, data[i]);
+    }
+
+    HOST_TEST_CHECK(!(UART_GetLineStatus(UART0) & UART_LineStatus_RxData));
+    HOST_TEST_EQUAL(UART_GetPendingInterruptID(UART0), UART_InterruptID_None);
+}
+
+static void test_rx_overrun(void)
+{
+    uint8_t data[20];
+
+
+    host_test_setup();
+    memset(data, 0x55, sizeof(data));
+
+    UART_EnableFifos(UART0);
+    /* Delivery stops at the first character lost */
+    HOST_TEST_EQUAL(HOST_UARTReceive(UART0, data, sizeof(data)), 16);
+    HOST_TEST_EQUAL(HOST_UARTGetOverruns(UART0), 1);
+
+    /* Overrun is sticky until LSR is read */
+    HOST_TEST_CHECK(UART_GetLineStatus(UART0) & UART_LineStatus_RxOverrun);
+    HOST_TEST_CHECK(!(UART_GetLineStatus(UART0) & UART_LineStatus_RxOverrun));
+
+    UART_FlushRxFifo(UART0);
+    HOST_TEST_CHECK(!(UART_GetLineStatus(UART0) & UART_LineStatus_RxData));
+}
+
+static void test_tx(void)
+{
+    uint8_t out[8];
+
+
+    host_test_setup();
+
+    UART_EnableFifos(UART0);
+    HOST_TEST_CHECK(UART_GetLineStatus(UART0) & UART_LineStatus_TxEmpty);
+
+    /* Held: data waits in the FIFO */
+    HOST_UARTSetTxHold(UART0, 1);
+    UART_Send(UART0, 'x');
+    UART_Send(UART0, 'y');
+    HOST_TEST_CHECK(!(UART_GetLineStatus(UART0) & UART_LineStatus_TxEmpty));
+    HOST_TEST_EQUAL(HOST_UARTTransmitted(UART0, out, sizeof(out)), 0);
+
+    HOST_TEST_EQUAL(HOST_UARTShiftOut(UART0, 1), 1);
+    HOST_TEST_EQUAL(HOST_UARTTransmitted(UART0, out, sizeof(out)), 1);
+    HOST_TEST_EQUAL(out[0], 'x');
+
+    /* Released: the rest goes straight out */
+    HOST_UARTSetTxHold(UART0, 0);
+    HOST_TEST_EQUAL(HOST_UARTTransmitted(UART0, out, sizeof(out)), 1);
+    HOST_TEST_EQUAL(out[0], 'y');
+    HOST_TEST_CHECK(UART_GetLineStatus(UART0) & UART_LineStatus_TxEmpty);
+
+    /* Loopback keeps characters off the wire */
+    UART_EnableLoopback(UART0);
+    UART_Send(UART0, 'z');
+    HOST_TEST_EQUAL(HOST_UARTTransmitted(UART0, out, sizeof(out)), 0);
+    HOST_TEST_EQUAL(UART_Recv(UART0), 'z');
+}
+
+static void test_flow_control(void)
+{
+    static const uint8_t data[8] = { 0 };
+    uint8_t out[8];
+
+
+    host_test_setup();
+
+    UART_EnableFifos(UART0);
+    UART_SetRxFifoTrigger(UART0, UART_RxFifoTrigger_4);
+    UART_SetFlowControl(UART0, UART_FlowControl_RTSCTS);
+    HOST_TEST_EQUAL(UART_GetFlowControl(UART0), UART_FlowControl_RTSCTS);
+
+    /* Auto-CTS: nothing leaves while the peer isn't ready */
+    HOST_UARTSetCTS(UART0, 0);
+    UART_Send(UART0, '1');
+    UART_Send(UART0, '2');
+    HOST_TEST_EQUAL(HOST_UARTTransmitted(UART0, out, sizeof(out)), 0);
+    HOST_UARTSetCTS(UART0, 1);
+    HOST_TEST_EQUAL(HOST_UARTTransmitted(UART0, out, sizeof(out)), 2);
+
+    /* Auto-RTS: dropped at the trigger level, raised once drained */
+    HOST_TEST_CHECK(HOST_UARTGetRTS(UART0));
+    HOST_UARTReceive(UART0, data, 4);
+    HOST_TEST_CHECK(!HOST_UARTGetRTS(UART0));
+    UART_Recv(UART0);
+    HOST_TEST_CHECK(HOST_UARTGetRTS(UART0));
+}
+
+static void test_serial(void)
+{
+    SERIAL_Config_Type config = {
+        .Baud      = 115200,
+        .RxTrigger = UART_RxFifoTrigger_8,
+        .RxBuffer  = serial_rx,
+        .RxSize    = sizeof(serial_rx),
+        .TxBuffer  = serial_tx,
+        .TxSize    = sizeof(serial_tx),
+    };
+    uint8_t in[600];
+    uint8_t got[600];
+    unsigned int sent;
+    unsigned int n;
+    unsigned int k;
+    unsigned int i;
+
+
+    host_test_setup();
+    HOST_SetVector(UART0_IRQn, SERIAL_IRQHandler);
+    memset(&SERIAL_Stats, 0, sizeof(SERIAL_Stats));
+
+    for (i = 0; i < sizeof(in); i++) {
+        in[i] = i * 7;
+    }
+
+    HOST_TEST_EQUAL(SERIAL_Init(&config), 0);
+
+    /* Receive in FIFO-sized bursts, more in total than the ring holds */
+    for (sent = 0, n = 0; sent < sizeof(in); sent += k) {
+        k = (sizeof(in) - sent < 14) ? sizeof(in) - sent : 14;
+        HOST_UARTReceive(UART0, &in[sent], k);
+        n += SERIAL_Read(&got[n], sizeof(got) - n);
+    }
+
+    HOST_UARTRxIdle(UART0);
+    n += SERIAL_Read(&got[n], sizeof(got) - n);
+
+    HOST_TEST_EQUAL(n, sizeof(in));
+    HOST_TEST_CHECK(memcmp(in, got, sizeof(in)) == 0);
+    HOST_TEST_EQUAL(SERIAL_Stats.RxDropped, 0);
+    HOST_TEST_EQUAL(SERIAL_Stats.RxOverruns, 0);
+
+    /* Transmit more than the ring holds through a held transmitter */
+    HOST_UARTSetTxHold(UART0, 1);
+
+    for (sent = 0, n = 0; n < sizeof(in); ) {
+        sent += SERIAL_Write(&in[sent], sizeof(in) - sent);
+        n += HOST_UARTShiftOut(UART0, 16);
+    }
+
+    SERIAL_Flush();
+    HOST_TEST_EQUAL(HOST_UARTTransmitted(UART0, got, sizeof(got)), sizeof(in));
+    HOST_TEST_CHECK(memcmp(in, got, sizeof(in)) == 0);
+    HOST_TEST_EQUAL(SERIAL_Stats.TxBytes, sizeof(in));
+    HOST_TEST_EQUAL(SERIAL_TxFree(), sizeof(serial_tx));
+}
+
+int main(void)
+{
+    test_rx_fifo();
+    test_rx_overrun();
+    test_tx();
+    test_flow_control();
+    test_serial();
+
+    return host_test_done("test_uart");
+}
@@ -0,0 +1,136 @@
+/******************************************************************************
+ * @file:    test_wake.c
+ * @purpose: Host unit tests for WAKE_Sleep(): start logic wake-ups, &
+ *           handing other pending interrupts back to the caller.
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include "lpc11xx.h"
+#include "lpc11xx_host.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx/wake.h"
+#include "host_test.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static unsigned int wake_calls;
+static unsigned int wake_sleeps;
+static unsigned int uart_irqs;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/* First edge: back to sleep; second: run */
+static WAKE_Action_Type wake_handler(unsigned int input)
+{
+    /* SYSCON isn't modelled; do what STARTRSRP0CLR does on the part */
+    SYSCON->STARTSRP0 &= ~(1UL << input);
+
+    return (++wake_calls == 1) ? WAKE_Action_Sleep : WAKE_Action_Run;
+}
+
+/* The "edge" on PIO0_0 comes in while the core sleeps */
+static void wake_idle(void)
+{
+    wake_sleeps++;
+    SYSCON->STARTSRP0 |= SYSCON_WakeupInput_0;
+}
+
+static void uart_handler(void)
+{
+    uart_irqs++;
+    NVIC_ClearPendingIRQ(UART0_IRQn);
+}
+
+static void wake_reset(void)
+{
+    host_test_setup();
+
+    wake_calls = 0;
+    wake_sleeps = 0;
+    uart_irqs = 0;
+    WAKE_Stats = (WAKE_Stats_Type){ 0 };
+
+    HOST_SetIdleHook(wake_idle);
+    WAKE_SetHandler(0, SYSCON_WakeupEdge_Rising, wake_handler);
+}
+
+static void test_wake_edge(void)
+{
+    SYSCON_MainClockSource_Type clock;
+
+
+    wake_reset();
+    clock = SYSCON_GetMainClockSource();
+
+    HOST_TEST_EQUAL(WAKE_Sleep(), SYSCON_WakeupInput_0);
+    HOST_TEST_EQUAL(wake_calls, 2);
+    HOST_TEST_EQUAL(wake_sleeps, 2);
+    HOST_TEST_EQUAL(WAKE_Stats.Wakes, 2);
+    HOST_TEST_EQUAL(WAKE_Stats.Runs, 1);
+    HOST_TEST_EQUAL(WAKE_Stats.Interrupted, 0);
+
+    /* Clocks put back */
+    HOST_TEST_EQUAL(SYSCON_GetMainClockSource(), clock);
+    HOST_TEST_CHECK(!(SCB->SCR & SCB_SCR_SLEEPDEEP_Msk));
+
+    WAKE_SetHandler(0, SYSCON_WakeupEdge_Rising, 0);
+}
+
+/* A pending interrupt keeps WFI from sleeping; it must not be starved */
+static void test_wake_pending_irq(void)
+{
+    SYSCON_MainClockSource_Type clock;
+
+
+    wake_reset();
+    clock = SYSCON_GetMainClockSource();
+
+    HOST_SetVector(UART0_IRQn, uart_handler);
+    NVIC_EnableIRQ(UART0_IRQn);
+
+    __disable_irq();
+    NVIC_SetPendingIRQ(UART0_IRQn);
+
+    HOST_TEST_EQUAL(WAKE_Sleep(), 0);
+    HOST_TEST_EQUAL(wake_calls, 0);
+    HOST_TEST_EQUAL(wake_sleeps, 0);
+    HOST_TEST_EQUAL(uart_irqs, 0);
+    HOST_TEST_EQUAL(WAKE_Stats.Interrupted, 1);
+    HOST_TEST_EQUAL(WAKE_Stats.Runs, 0);
+    HOST_TEST_EQUAL(SYSCON_GetMainClockSource(), clock);
+    HOST_TEST_CHECK(__get_PRIMASK());
+
+    /* Unmasking lets it run; the next call sleeps as usual */
+    __enable_irq();
+    HOST_TEST_EQUAL(uart_irqs, 1);
+
+    HOST_TEST_EQUAL(WAKE_Sleep(), SYSCON_WakeupInput_0);
+    HOST_TEST_EQUAL(wake_calls, 2);
+    HOST_TEST_EQUAL(WAKE_Stats.Runs, 1);
+
+    NVIC_DisableIRQ(UART0_IRQn);
+    HOST_SetVector(UART0_IRQn, 0);
+    WAKE_SetHandler(0, SYSCON_WakeupEdge_Rising, 0);
+}
+
+int main(void)
+{
+    /* A regression here spins forever; don't hang make check */
+    alarm(10);
+
+    test_wake_edge();
+    test_wake_pending_irq();
+
+    HOST_SetIdleHook(0);
+
+    return host_test_done("test_wake");
+}
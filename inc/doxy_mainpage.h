@@ -24,28 +24,52 @@
  * LPC11xx_Device_Lib_v1.2/
  *    Makefile      -- Top-level makefile for building docs or the library
  *
+ *    bench/        -- Cycle / code size / stack benchmarks of driver hot paths,
+ *                      run under lpc11xx-sim against baseline.tsv
+ *
  *    docs/         -- Doxygen-generated documentation of the library
  *
  *    example/      -- Example firmware source for using assorted peripherals /
  *                      library features
  *
+ *    host/         -- Host-native build (liblpc11xx-host.a) with simulated
+ *                      peripherals, for testing / timing code off-target
+ *      Makefile         -- Make file for the host library & lpc11xx-sim
+ *      inc/             -- Host stand-in for core_cm0.h, harness API
+ *      lpc11xx_host*.c  -- Register file, interrupt & peripheral models
+ *      sim/             -- lpc11xx-sim: Cortex-M0 instruction set simulator
+ *                          that runs linked ELF images & reports cycles per
+ *                          function (flash wait states included)
+ *
  *    inc/          -- Top-level include directory
  *      doxy_mainpage.h  -- Source of this documentation file
  *      lpc11xx/         -- Header files for lpc11xx peripherals & functions
  *        adc.h               -- Analog to Digital Converter interface
+ *        clock.h             -- Runtime clock changes, notification, solver
+ *        clock_config.h      -- Compile-time clock settings & checks
  *        crp.h               -- Code Read Protection interface
  *        ct16b.h             -- 16-bit Counter / Timer interface
  *        ct32b.h             -- 32-bit Counter / Timer interface
  *        flash.h             -- Flash Controller interface
+ *        gate.h              -- Reference-counted peripheral clock / power gating
  *        gpio.h              -- General Purpose I/O interface
  *        i2c.h               -- I2C Controller interface
  *        iap.h               -- Flash programming interface
+ *        idle.h              -- Tickless idle (timers, sleep / deep-sleep)
  *        iocon.h             -- IO Configuration interface
+ *        irccal.h            -- IRC oscillator calibration against a reference
  *        isr_vector.h        -- Interrupt Service Routine structure
  *        pmu.h               -- Power Management Unit interface
+ *        power_api.h         -- ROM Power Profile API (LPC11xxL)
+ *        retain.h            -- State retained through deep power-down
+ *        rs485.h             -- RS-485 multidrop node driver (UART0)
+ *        serial.h            -- Interrupt-driven, buffered UART0 driver
  *        ssp.h               -- Synchronous Serial Peripheral (/SPI) interface
+ *        stack.h             -- Stack high-water mark / depth sampling
  *        syscon.h            -- System Configuration Block interface
+ *        sysinit.h           -- Driver initialization registry (boot / lazy)
  *        uart.h              -- UART interface
+ *        wake.h              -- Fast deep-sleep wake-up on start logic inputs
  *        wdt.h               -- Watchdog Timer interface
  *      lpc11xx.h        -- Base header file for using lpc11xx microcontrollers
  *      lpclib_assert.h  -- Header file for "assert" debugging of the library
@@ -60,10 +84,22 @@
  *
  *    src/          -- 'C' source files
  *      Makefile         -- Make file for building the library objects
+ *      lpc11xx_clock.c  -- Runtime core clock changes
+ *      lpc11xx_clocksolve.c -- Clock tree solver (PLL / divider search)
  *      lpc11xx_crp.c    -- Code Read Protection storage
  *      lpc11xx_crt0.c   -- CPU initialization / libc start-up code
+ *      lpc11xx_gate.c   -- Peripheral clock / power gating
  *      lpc11xx_iap.c    -- Flash programming functions
+ *      lpc11xx_idle.c   -- Tickless idle timers & sleep
+ *      lpc11xx_irccal.c -- IRC trim calibration
  *      lpc11xx_pll.c    -- PLL interface functions
+ *      lpc11xx_power_api.c -- ROM Power Profile API calls
+ *      lpc11xx_retain.c -- Deep power-down state retention
+ *      lpc11xx_rs485.c  -- RS-485 multidrop node driver
+ *      lpc11xx_serial.c -- Buffered UART0 driver
+ *      lpc11xx_stack.c  -- Stack usage measurement
+ *      lpc11xx_sysinit.c -- Driver init registry (deferred / forced init)
+ *      lpc11xx_wake.c   -- Deep-sleep wake-up handling
  *      lpclib_assert.c  -- Assert function
  *      system_lpc11xx.c -- CMSIS-required system functions (SystemInit, SystemCoreClockUpdate)
  * </pre>
@@ -129,9 +165,6 @@
  * uart.h
  * - IT naming (IT??? Intr? Irq?)
  *
- * power_profiles.h
- * - Complete
- *
  * wdt.h
  *
  * linker files
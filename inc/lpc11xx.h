@@ -90,6 +90,25 @@ extern "C" {
 
 #define IRC_Val                 (12000000UL)    /*!< Speed of internal RC Oscillator (12 Mhz)    */
 
+/** @brief Place a function in RAM (copied from flash at start-up).
+  *
+  * Code in RAM runs without flash wait states (2 at 48MHz), which helps
+  * busy interrupt handlers, e.g.:
+  *
+  *   LPC11XX_RAMFUNC void UART0_IRQHandler(void) { ... }
+  *
+  * It costs the function's size in RAM as well as flash (see the "%.ram"
+  * rule in lpc11xx.mk).  Only the function itself moves: anything it calls
+  * that doesn't get inlined still runs from flash.  RAM and flash are too
+  * far apart for a plain BL: callers reach the function with a long call,
+  * and calls out of it rely on -mlong-calls (set by lpc11xx.mk).
+  */
+#if defined(__arm__)
+# define LPC11XX_RAMFUNC  __attribute__((section(".ramfunc"), long_call, noinline))
+#else
+# define LPC11XX_RAMFUNC  /* host builds: no separate RAM to run from */
+#endif
+
 
 /** @defgroup LPC11xx_Cortex_M0_Configuration LPC11xx Cortex-M0 MCU Configuration
   * @{
@@ -1128,6 +1147,7 @@ typedef struct {
   */
 
 #define PMU_WAKEUPHYS                  (1 << 10)           /*!< Enable Hysteresis on Wakeup Pin  */
+#define PMU_GPREG4_DATA_Mask           (0xfffff800)        /*!< Bits free for data (31:11)       */
 
 /** @} */
 
@@ -1545,7 +1565,7 @@ typedef struct {
   * @{
   */
 
-#define SYSCON_SYSAHBCLKCTRL_Mask       (0x0003ffffUL)     /*!< AHB Clock Control Mask           */
+#define SYSCON_SYSAHBCLKCTRL_Mask       (0x0007ffffUL)     /*!< AHB Clock Control Mask           */
 #define SYSCON_SYSAHBCLKCTRL_SYS        (1 << 0)           /*!< (RO) Main System Clock Enabled   */
 #define SYSCON_SYSAHBCLKCTRL_ROM        (1 << 1)           /*!< Enable AHB clock to System ROM   */
 #define SYSCON_SYSAHBCLKCTRL_RAM        (1 << 2)           /*!< Enable AHB clock to System RAM   */
@@ -65,6 +65,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_ADC_H
+
 
 /**
   * @defgroup ADC_AbstractionLayer ADC (Analog-to-Digital Converter) Abstraction Layer
@@ -578,6 +582,8 @@ __INLINE static ADC_StartConversion_Type ADC_GetStartConversionTrigger(ADC_Type
   * @}
   */
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
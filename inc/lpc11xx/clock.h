@@ -0,0 +1,332 @@
+/** ***************************************************************************
+ * @file     clock.h
+ * @brief    Runtime core clock control for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * SystemInit() brings the core up at F_CPU.  CLOCK_SetCoreFrequency() moves
+ * it to another operating point at run time, e.g. down to the 12MHz
+ * oscillator between bursts of work and back up to 48MHz for them.  It
+ * reprograms the system PLL (or bypasses & powers it down), keeps the flash
+ * wait states safe for the speed at every step, and updates SystemCoreClock
+ * & SystemAHBClock.
+ *
+ * Anything whose dividers are derived from the clock (UART divisor, SSP
+ * prescaler, timer match values...) registers a CLOCK_Notifier_Type with
+ * CLOCK_RegisterNotifier().  Each is called once before the change (e.g. to
+ * let a UART finish sending) and once after (to recompute its dividers).
+ *
+ * CLOCK_Solve() works out a whole clock tree from target frequencies: PLL
+ * M/P (or no PLL), the AHB divider, the SYSCON UART0 / SSP0 / SSP1 / WDT
+ * dividers, and the UART divisor & SSP prescalers behind them.  It only
+ * does arithmetic (no register access), so it runs equally well on the
+ * host.
+ *
+ * CLOCK_GetFrequency() gives the frequency of any clock in the tree (core,
+ * main, UART0 / SSP0 / SSP1 PCLK, WDT clock, CLKOUT).  The values are
+ * worked out from the SYSCON registers once and cached; the lpc11xx/syscon.h
+ * functions that change a clock mark the cache stale, and the next
+ * CLOCK_GetFrequency() (or SystemCoreClockUpdate()) refreshes it.  Reading
+ * a clock is then a load and a test, with no division.  Registers written
+ * directly (not through the library) need a CLOCK_InvalidateFrequencies().
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_CLOCK_H_
+#define NXP_LPC_CLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+#include "system_lpc11xx.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_Clock LPC11xx Runtime Clock Control
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief Clock change notification events.
+  */
+typedef enum {
+    CLOCK_Event_PreChange = 0,            /*!< About to change (old clock running) */
+    CLOCK_Event_PostChange,               /*!< Changed; SystemCoreClock is updated */
+} CLOCK_Event_Type;
+
+/** @brief A driver's registration for clock change notifications.
+  *
+  * Owned by the driver (usually a static variable); the library links it
+  * into a list, so it must stay valid while registered.
+  */
+typedef struct clock_notifier {
+    void (*Notify)(CLOCK_Event_Type event, uint32_t coreClock);  /*!< Callback (new core clock, Hz) */
+    struct clock_notifier *Next;          /*!< (used by the library)            */
+} CLOCK_Notifier_Type;
+
+
+/** @brief Clocks whose frequencies CLOCK_GetFrequency() reports.
+  */
+typedef enum {
+    CLOCK_Core = 0,                       /*!< CPU / AHB clock (main / AHB div.) */
+    CLOCK_Main,                           /*!< Main clock                       */
+    CLOCK_UART0,                          /*!< UART0 PCLK                       */
+    CLOCK_SSP0,                           /*!< SSP0 PCLK                        */
+    CLOCK_SSP1,                           /*!< SSP1 PCLK                        */
+    CLOCK_WDT,                            /*!< WDT clock (WDCLK)                */
+    CLOCK_CLKOUT,                         /*!< CLKOUT pin                       */
+    CLOCK_NumClocks
+} CLOCK_Clock_Type;
+
+/** @brief Target frequencies for CLOCK_Solve(); 0 for any output not used.
+  */
+typedef struct {
+    uint32_t InputClock;                  /*!< PLL input (IRC or system osc), Hz */
+    uint32_t CoreClock;                   /*!< Core / AHB clock, Hz (required)  */
+    uint32_t UART0Baud;                   /*!< UART0 baud rate                  */
+    uint32_t SSP0Clock;                   /*!< SSP0 SCK, Hz                     */
+    uint32_t SSP1Clock;                   /*!< SSP1 SCK, Hz                     */
+    uint32_t WDTTick;                     /*!< WDT counter rate (WDCLK / 4), Hz */
+} CLOCK_Targets_Type;
+
+/** @brief A clock tree configuration found by CLOCK_Solve().
+  *
+  * Register values are as taken by the matching lpc11xx/syscon.h,
+  * uart.h & ssp.h functions.  Actual* are the resulting frequencies.
+  */
+typedef struct {
+    uint8_t  UsePLL;                      /*!< 1: main clock is PLL out; 0: PLL in */
+    uint8_t  PLLScaler;                   /*!< SYSCON_SetSysPLLClockScaler()    */
+    uint8_t  AHBDivider;                  /*!< SYSCON_SetAHBClockDivider()      */
+    uint8_t  UART0Divider;                /*!< SYSCON_SetUART0ClockDivider()    */
+    uint16_t UART0Divisor;                /*!< UART_SetDivisor()                */
+    uint8_t  UART0DivAddVal;              /*!< UART_SetFractionalDivider() div  */
+    uint8_t  UART0MulVal;                 /*!< UART_SetFractionalDivider() mult */
+    uint8_t  SSP0Divider;                 /*!< SYSCON_SetSSP0ClockDivider()     */
+    uint8_t  SSP0Prescaler;               /*!< SSP_SetClockPrescaler()          */
+    uint16_t SSP0TicksPerBit;             /*!< SSP_SetPrescalerTicksPerBit()    */
+    uint8_t  SSP1Divider;                 /*!< SYSCON_SetSSP1ClockDivider()     */
+    uint8_t  SSP1Prescaler;               /*!< SSP_SetClockPrescaler()          */
+    uint16_t SSP1TicksPerBit;             /*!< SSP_SetPrescalerTicksPerBit()    */
+    uint8_t  WDTClockSource;              /*!< SYSCON_WDTClockSource_Type       */
+    uint8_t  WDTDivider;                  /*!< SYSCON_SetWDTClockDivider()      */
+    uint32_t MainClock;                   /*!< Main clock, Hz                   */
+    uint32_t CCOClock;                    /*!< PLL CCO, Hz (0 if PLL unused)    */
+    uint32_t ActualCoreClock;             /*!< Hz                               */
+    uint32_t ActualUART0Baud;             /*!< baud                             */
+    uint32_t ActualSSP0Clock;             /*!< Hz                               */
+    uint32_t ActualSSP1Clock;             /*!< Hz                               */
+    uint32_t ActualWDTTick;               /*!< Hz                               */
+    uint32_t ErrorPPM;                    /*!< Sum of each target's error, ppm  */
+} CLOCK_Config_Type;
+
+
+/** @brief A UART0 baud rate setting found by CLOCK_SolveUARTBaud().
+  */
+typedef struct {
+    uint8_t  Divider;                     /*!< SYSCON_SetUART0ClockDivider()    */
+    uint8_t  DivAddVal;                   /*!< UART_SetFractionalDivider() div  */
+    uint8_t  MulVal;                      /*!< UART_SetFractionalDivider() mult */
+    uint16_t Divisor;                     /*!< UART_SetDivisor()                */
+    uint32_t ActualBaud;                  /*!< baud                             */
+    uint32_t ErrorPPM;                    /*!< Error from the wanted rate, ppm  */
+} CLOCK_UARTBaud_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Highest core clock the LPC11xx is specified for */
+#define CLOCK_MAX_CORE_CLOCK    50000000UL
+
+/*! @brief System PLL limits (output, & current controlled oscillator range) */
+#define CLOCK_MAX_PLL_CLOCK     100000000UL
+#define CLOCK_MIN_CCO_CLOCK     156000000UL
+#define CLOCK_MAX_CCO_CLOCK     320000000UL
+
+/*! @brief Largest UART baud rate error CLOCK_SolveUARTBaud() accepts, ppm
+ *         (2%; about half the margin of an 8N1 character)
+ */
+#ifndef CLOCK_BAUD_TOLERANCE
+# define CLOCK_BAUD_TOLERANCE   20000UL
+#endif
+
+
+/* Exported Variables -------------------------------------------------------*/
+
+/*! @brief Cached clock frequencies, in Hz (0 for a clock that is off) */
+extern uint32_t CLOCK_Frequencies[CLOCK_NumClocks];
+
+/*! @brief Nonzero while CLOCK_Frequencies matches the SYSCON registers */
+extern volatile uint8_t CLOCK_FrequenciesValid;
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Mark the cached clock frequencies stale.
+  *
+  * Called by the lpc11xx/syscon.h functions that change a clock; only
+  * needed elsewhere if SYSCON clock registers are written directly.
+  */
+__INLINE static void CLOCK_InvalidateFrequencies(void)
+{
+    CLOCK_FrequenciesValid = 0;
+}
+
+/** @brief Get the frequency of a clock.
+  * @param[in]  clock        The clock
+  * @return                  Its frequency in Hz (0 if it is off)
+  *
+  * Reads the cache, refreshing it first (with SystemCoreClockUpdate()) if
+  * a clock has changed since it was last filled in.
+  */
+__INLINE static uint32_t CLOCK_GetFrequency(CLOCK_Clock_Type clock)
+{
+    if (!CLOCK_FrequenciesValid) {
+        SystemCoreClockUpdate();
+    }
+
+    return CLOCK_Frequencies[clock];
+}
+
+
+/** @brief  Calculate the scaler value to load into a PLL's config register
+  * @param  [in]  clk_in  PLL input frequency, in Hz
+  * @param  [in]  clk_out Desired output PLL frequency, in Hz
+  * @param  [out] err     The actual output PLL freq. minus clk_out (may be null)
+  *
+  * @return Value for SYSCON_SetSysPLLClockScaler(), or -1 if out of range
+  */
+extern int16_t PLL_ScalerCalc(uint32_t clk_in, uint32_t clk_out, int32_t *err);
+
+/** @brief Find the clock tree configuration best matching a set of targets.
+  * @param[in]  targets      Wanted frequencies
+  * @param[out] config       The best configuration found
+  * @return                  0 on success, -1 if no legal configuration exists
+  *
+  * Every legal PLL setting (M 1-32, P with the CCO in 156 - 320MHz, output
+  * up to 100MHz) and running without the PLL are tried.  For each, every
+  * output gets the legal divider chain closest to its target.  The result
+  * has the lowest total error; ties go to the lowest PLL / main clock (the
+  * lowest power), then to the largest SYSCON dividers.  The WDT may be run
+  * from the main clock or the IRC.  The core clock is kept to
+  * CLOCK_MAX_CORE_CLOCK or less.
+  *
+  * A UART0 target only counts as met within CLOCK_BAUD_TOLERANCE.
+  *
+  * This is a search over a few thousand combinations (a UART0 target
+  * multiplies that by the fractional divider settings); fine at start-up or
+  * on the host, but not in a time-critical path.
+  */
+extern int CLOCK_Solve(const CLOCK_Targets_Type *targets, CLOCK_Config_Type *config);
+
+/** @brief Find the UART0 setting closest to a baud rate.
+  * @param[in]  mainClock    Main clock, Hz
+  * @param[in]  baud         Wanted baud rate
+  * @param[out] setting      The best setting found
+  * @return                  0 on success, -1 if the rate can't be made
+  *                          within CLOCK_BAUD_TOLERANCE
+  *
+  * Searches the SYSCON divider, the divisor (DLM / DLL) & the fractional
+  * divider (DIVADDVAL / MULVAL) together.  Ties go to no fractional
+  * divider, then the largest SYSCON divider.  For baud rates fixed at build
+  * time, lpc11xx/clock_config.h works the same out as constants.
+  */
+extern int CLOCK_SolveUARTBaud(uint32_t mainClock, uint32_t baud, CLOCK_UARTBaud_Type *setting);
+
+/** @brief Change the core clock.
+  * @param[in]  coreClock    Requested main clock, in Hz (the core clock
+  *                          with the usual AHB divider of 1)
+  * @return                  0 on success, -1 if it can't be generated
+  *
+  * The PLL input (IRC or system oscillator, whichever SystemInit() chose)
+  * is used directly if coreClock equals it; otherwise the PLL output is
+  * used, rounded to the nearest multiple of the input.  SystemCoreClock
+  * and CLOCK_GetFrequency() give the frequencies actually set.
+  *
+  * Notifiers are called with interrupts enabled; the switch itself runs
+  * with interrupts masked (for up to the PLL lock time, ~100us).  Call
+  * from thread mode.
+  */
+extern int CLOCK_SetCoreFrequency(uint32_t coreClock);
+
+/** @brief Get the flash wait states needed at a core clock.
+  * @param[in]  coreClock    Core clock, in Hz
+  * @return                  Wait states (0 - 2)
+  */
+extern unsigned int CLOCK_FlashWaitStates(uint32_t coreClock);
+
+/** @brief Register for clock change notifications.
+  * @param[in]  notifier     The registration (Notify filled in)
+  */
+extern void CLOCK_RegisterNotifier(CLOCK_Notifier_Type *notifier);
+
+/** @brief Stop clock change notifications.
+  * @param[in]  notifier     A registration passed to CLOCK_RegisterNotifier()
+  */
+extern void CLOCK_UnregisterNotifier(CLOCK_Notifier_Type *notifier);
+
+/** @brief Tell registered drivers about a clock change.
+  * @param[in]  event        Before or after the change
+  * @param[in]  coreClock    The new core clock, in Hz
+  *
+  * CLOCK_SetCoreFrequency() does this itself; only code changing the clock
+  * some other way (e.g. PowerAPI_SetPLLFreq()) needs to call it, with
+  * CLOCK_Event_PreChange before & CLOCK_Event_PostChange after.
+  */
+extern void CLOCK_Notify(CLOCK_Event_Type event, uint32_t coreClock);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_CLOCK_H_ */
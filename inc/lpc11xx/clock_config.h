@@ -0,0 +1,359 @@
+/** ***************************************************************************
+ * @file     clock_config.h
+ * @brief    Compile-time clock configuration for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * Works out every clock register value for the build's clock settings as
+ * constants, so SystemInit() only stores them, and checks at compile time
+ * that the settings can actually be generated.  An impossible combination
+ * (e.g. an F_CPU that isn't a whole multiple of the oscillator) stops the
+ * build with a message saying what is wrong.
+ *
+ * Inputs (-D on the command line; lpc11xx.mk sets the first two):
+ *
+ * - F_CPU: main clock, Hz (required)
+ * - HSE_Val: external oscillator, Hz (the 12MHz IRC is used if not set)
+ * - AHBCLKDIV_Val: AHB (core) clock divider, default 1
+ * - UART0_BAUD, UART0CLKDIV_Val: UART0 baud rate & SYSCON divider; gives
+ *   CLOCK_CFG_UART0_DIVIDER, CLOCK_CFG_UART0_DIVISOR,
+ *   CLOCK_CFG_UART0_DIVADDVAL & CLOCK_CFG_UART0_MULVAL (the fractional
+ *   divider, 0 / 1 if unused).  Without UART0CLKDIV_Val the SYSCON divider
+ *   is searched along with the rest: each fraction gets the smallest
+ *   divider that keeps its divisor in range, which is within a few ppm of
+ *   CLOCK_SolveUARTBaud()'s exhaustive search.
+ * - SSP0_SCK / SSP1_SCK, SSP0CLKDIV_Val / SSP1CLKDIV_Val: highest SPI clock
+ *   wanted, Hz, & SYSCON divider (default 1); gives CLOCK_CFG_SSPn_PRESCALER
+ *   and CLOCK_CFG_SSPn_TICKS_PER_BIT (SCK is never above SSPn_SCK)
+ * - CLOCK_BAUD_TOLERANCE: largest baud rate error allowed, in ppm (see
+ *   lpc11xx/clock.h; the same limit applies at run time)
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_CLOCK_CONFIG_H_
+#define NXP_LPC_CLOCK_CONFIG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include "lpc11xx.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx/clock.h"
+
+
+/**
+  * @ingroup LPC11xx_Clock
+  * @{
+  */
+
+/** @defgroup LPC11xx_Clock_Config LPC11xx Compile-Time Clock Configuration
+  * @{
+  */
+
+/* Settings -----------------------------------------------------------------*/
+
+#ifndef F_CPU
+# error "F_CPU (main clock frequency) must be defined"
+#endif
+
+#ifndef AHBCLKDIV_Val
+# define AHBCLKDIV_Val 1
+#endif
+
+#ifndef SSP0CLKDIV_Val
+# define SSP0CLKDIV_Val 1
+#endif
+
+#ifndef SSP1CLKDIV_Val
+# define SSP1CLKDIV_Val 1
+#endif
+
+#if defined(__cplusplus)
+# define CLOCK_CFG_ASSERT(cond, msg)  static_assert(cond, msg)
+#else
+# define CLOCK_CFG_ASSERT(cond, msg)  _Static_assert(cond, msg)
+#endif
+
+
+/* Derived Values -----------------------------------------------------------*/
+
+/*! @brief Flash wait states needed at a core clock */
+#define CLOCK_FLASH_WAITS(hz)       (((hz) < 20000000UL) ? 0 : (((hz) < 40000000UL) ? 1 : 2))
+
+/*! @brief PLL input: the system oscillator if HSE_Val is given, else the IRC */
+#ifdef HSE_Val
+# define CLOCK_CFG_INPUT_CLOCK      (HSE_Val)
+#else
+# define CLOCK_CFG_INPUT_CLOCK      (IRC_Val)
+#endif
+
+/*! @brief 1 if F_CPU comes from the PLL, 0 if it is the input clock itself */
+#define CLOCK_CFG_USE_PLL           ((F_CPU) != CLOCK_CFG_INPUT_CLOCK)
+
+/*! @brief PLL multiplier & post divider (SYSCON_SysPLLPVal_Type) */
+#define CLOCK_CFG_PLL_M             ((F_CPU) / CLOCK_CFG_INPUT_CLOCK)
+#define CLOCK_CFG_PLL_P             (((F_CPU) < 19500000UL) ? SYSCON_SysPLLPVal_8 \
+                                     : ((F_CPU) < 39000000UL) ? SYSCON_SysPLLPVal_4 \
+                                     : SYSCON_SysPLLPVal_2)
+
+/*! @brief Value for SYSCON_SetSysPLLClockScaler() */
+#define CLOCK_CFG_PLL_SCALER        ((CLOCK_CFG_PLL_P << SYSCON_SYSPLLCTRL_PSEL_Shift) \
+                                     | (CLOCK_CFG_PLL_M - 1))
+
+/*! @brief PLL current controlled oscillator frequency */
+#define CLOCK_CFG_CCO_CLOCK         ((unsigned long long)(F_CPU) * (2UL << CLOCK_CFG_PLL_P))
+
+/*! @brief Core / AHB clock & flash wait states */
+#define CLOCK_CFG_AHB_DIVIDER       (AHBCLKDIV_Val)
+#define CLOCK_CFG_AHB_CLOCK         ((F_CPU) / (AHBCLKDIV_Val))
+#define CLOCK_CFG_FLASH_WAITS       CLOCK_FLASH_WAITS(F_CPU)
+
+#ifdef UART0_BAUD
+/* UART0: baud = F_CPU / (16 * divider * divisor * (1 + d / m)).  Each
+ *  fraction d / m (in lowest terms, 0 / 1 first so no fraction wins ties)
+ *  gets a SYSCON divider & its nearest divisor; the best is kept in a
+ *  chain of enum constants, as picking a minimum with nested macros grows
+ *  exponentially.
+ */
+# define _CLOCK_CFG_UART0_IDEAL(d, m) \
+    (((unsigned long long)(F_CPU) * (m)) / (16ULL * (UART0_BAUD) * ((m) + (d))))
+# ifdef UART0CLKDIV_Val
+#  define _CLOCK_CFG_UART0_DIV(d, m)  ((unsigned long long)(UART0CLKDIV_Val))
+# else
+#  define _CLOCK_CFG_UART0_DIV(d, m) \
+    (_CLOCK_CFG_UART0_IDEAL(d, m) > 65535ULL ? (_CLOCK_CFG_UART0_IDEAL(d, m) + 65534ULL) / 65535ULL : 1ULL)
+# endif
+# define _CLOCK_CFG_UART0_DL(d, m) \
+    (((unsigned long long)(F_CPU) * (m) + 8ULL * (UART0_BAUD) * ((m) + (d)) * _CLOCK_CFG_UART0_DIV(d, m)) \
+     / (16ULL * (UART0_BAUD) * ((m) + (d)) * _CLOCK_CFG_UART0_DIV(d, m)))
+# define _CLOCK_CFG_UART0_DL1(d, m) \
+    (_CLOCK_CFG_UART0_DL(d, m) ? _CLOCK_CFG_UART0_DL(d, m) : 1ULL)
+# define _CLOCK_CFG_UART0_WANT(d, m) \
+    (16ULL * (UART0_BAUD) * ((m) + (d)) * _CLOCK_CFG_UART0_DIV(d, m) * _CLOCK_CFG_UART0_DL1(d, m))
+# define _CLOCK_CFG_UART0_ERR(d, m) \
+    (((_CLOCK_CFG_UART0_DL(d, m) < ((d) ? 3ULL : 1ULL)) || (_CLOCK_CFG_UART0_DL(d, m) > 65535ULL) \
+      || (_CLOCK_CFG_UART0_DIV(d, m) > 255ULL)) \
+     ? 0x7fffffff \
+     : (int)(((unsigned long long)(F_CPU) * (m) > _CLOCK_CFG_UART0_WANT(d, m) \
+              ? (unsigned long long)(F_CPU) * (m) - _CLOCK_CFG_UART0_WANT(d, m) \
+              : _CLOCK_CFG_UART0_WANT(d, m) - (unsigned long long)(F_CPU) * (m)) \
+             * 1000000ULL / _CLOCK_CFG_UART0_WANT(d, m)))
+# define _CLOCK_CFG_UART0_TRY(n, p, d, m) \
+    _CLOCK_CFG_UART0_E##n = _CLOCK_CFG_UART0_ERR(d, m), \
+    _CLOCK_CFG_UART0_D##n = (_CLOCK_CFG_UART0_E##n < _CLOCK_CFG_UART0_E##p##B) ? (d) : _CLOCK_CFG_UART0_D##p, \
+    _CLOCK_CFG_UART0_M##n = (_CLOCK_CFG_UART0_E##n < _CLOCK_CFG_UART0_E##p##B) ? (m) : _CLOCK_CFG_UART0_M##p, \
+    _CLOCK_CFG_UART0_V##n = (_CLOCK_CFG_UART0_E##n < _CLOCK_CFG_UART0_E##p##B) \
+                            ? (int)_CLOCK_CFG_UART0_DIV(d, m) : _CLOCK_CFG_UART0_V##p, \
+    _CLOCK_CFG_UART0_E##n##B = (_CLOCK_CFG_UART0_E##n < _CLOCK_CFG_UART0_E##p##B) \
+                               ? _CLOCK_CFG_UART0_E##n : _CLOCK_CFG_UART0_E##p##B
+
+enum {
+    _CLOCK_CFG_UART0_E0B = _CLOCK_CFG_UART0_ERR(0, 1),
+    _CLOCK_CFG_UART0_D0 = 0,
+    _CLOCK_CFG_UART0_M0 = 1,
+    _CLOCK_CFG_UART0_V0 = (int)_CLOCK_CFG_UART0_DIV(0, 1),
+    _CLOCK_CFG_UART0_TRY( 1,  0,  1,  2),
+    _CLOCK_CFG_UART0_TRY( 2,  1,  1,  3),
+    _CLOCK_CFG_UART0_TRY( 3,  2,  2,  3),
+    _CLOCK_CFG_UART0_TRY( 4,  3,  1,  4),
+    _CLOCK_CFG_UART0_TRY( 5,  4,  3,  4),
+    _CLOCK_CFG_UART0_TRY( 6,  5,  1,  5),
+    _CLOCK_CFG_UART0_TRY( 7,  6,  2,  5),
+    _CLOCK_CFG_UART0_TRY( 8,  7,  3,  5),
+    _CLOCK_CFG_UART0_TRY( 9,  8,  4,  5),
+    _CLOCK_CFG_UART0_TRY(10,  9,  1,  6),
+    _CLOCK_CFG_UART0_TRY(11, 10,  5,  6),
+    _CLOCK_CFG_UART0_TRY(12, 11,  1,  7),
+    _CLOCK_CFG_UART0_TRY(13, 12,  2,  7),
+    _CLOCK_CFG_UART0_TRY(14, 13,  3,  7),
+    _CLOCK_CFG_UART0_TRY(15, 14,  4,  7),
+    _CLOCK_CFG_UART0_TRY(16, 15,  5,  7),
+    _CLOCK_CFG_UART0_TRY(17, 16,  6,  7),
+    _CLOCK_CFG_UART0_TRY(18, 17,  1,  8),
+    _CLOCK_CFG_UART0_TRY(19, 18,  3,  8),
+    _CLOCK_CFG_UART0_TRY(20, 19,  5,  8),
+    _CLOCK_CFG_UART0_TRY(21, 20,  7,  8),
+    _CLOCK_CFG_UART0_TRY(22, 21,  1,  9),
+    _CLOCK_CFG_UART0_TRY(23, 22,  2,  9),
+    _CLOCK_CFG_UART0_TRY(24, 23,  4,  9),
+    _CLOCK_CFG_UART0_TRY(25, 24,  5,  9),
+    _CLOCK_CFG_UART0_TRY(26, 25,  7,  9),
+    _CLOCK_CFG_UART0_TRY(27, 26,  8,  9),
+    _CLOCK_CFG_UART0_TRY(28, 27,  1, 10),
+    _CLOCK_CFG_UART0_TRY(29, 28,  3, 10),
+    _CLOCK_CFG_UART0_TRY(30, 29,  7, 10),
+    _CLOCK_CFG_UART0_TRY(31, 30,  9, 10),
+    _CLOCK_CFG_UART0_TRY(32, 31,  1, 11),
+    _CLOCK_CFG_UART0_TRY(33, 32,  2, 11),
+    _CLOCK_CFG_UART0_TRY(34, 33,  3, 11),
+    _CLOCK_CFG_UART0_TRY(35, 34,  4, 11),
+    _CLOCK_CFG_UART0_TRY(36, 35,  5, 11),
+    _CLOCK_CFG_UART0_TRY(37, 36,  6, 11),
+    _CLOCK_CFG_UART0_TRY(38, 37,  7, 11),
+    _CLOCK_CFG_UART0_TRY(39, 38,  8, 11),
+    _CLOCK_CFG_UART0_TRY(40, 39,  9, 11),
+    _CLOCK_CFG_UART0_TRY(41, 40, 10, 11),
+    _CLOCK_CFG_UART0_TRY(42, 41,  1, 12),
+    _CLOCK_CFG_UART0_TRY(43, 42,  5, 12),
+    _CLOCK_CFG_UART0_TRY(44, 43,  7, 12),
+    _CLOCK_CFG_UART0_TRY(45, 44, 11, 12),
+    _CLOCK_CFG_UART0_TRY(46, 45,  1, 13),
+    _CLOCK_CFG_UART0_TRY(47, 46,  2, 13),
+    _CLOCK_CFG_UART0_TRY(48, 47,  3, 13),
+    _CLOCK_CFG_UART0_TRY(49, 48,  4, 13),
+    _CLOCK_CFG_UART0_TRY(50, 49,  5, 13),
+    _CLOCK_CFG_UART0_TRY(51, 50,  6, 13),
+    _CLOCK_CFG_UART0_TRY(52, 51,  7, 13),
+    _CLOCK_CFG_UART0_TRY(53, 52,  8, 13),
+    _CLOCK_CFG_UART0_TRY(54, 53,  9, 13),
+    _CLOCK_CFG_UART0_TRY(55, 54, 10, 13),
+    _CLOCK_CFG_UART0_TRY(56, 55, 11, 13),
+    _CLOCK_CFG_UART0_TRY(57, 56, 12, 13),
+    _CLOCK_CFG_UART0_TRY(58, 57,  1, 14),
+    _CLOCK_CFG_UART0_TRY(59, 58,  3, 14),
+    _CLOCK_CFG_UART0_TRY(60, 59,  5, 14),
+    _CLOCK_CFG_UART0_TRY(61, 60,  9, 14),
+    _CLOCK_CFG_UART0_TRY(62, 61, 11, 14),
+    _CLOCK_CFG_UART0_TRY(63, 62, 13, 14),
+    _CLOCK_CFG_UART0_TRY(64, 63,  1, 15),
+    _CLOCK_CFG_UART0_TRY(65, 64,  2, 15),
+    _CLOCK_CFG_UART0_TRY(66, 65,  4, 15),
+    _CLOCK_CFG_UART0_TRY(67, 66,  7, 15),
+    _CLOCK_CFG_UART0_TRY(68, 67,  8, 15),
+    _CLOCK_CFG_UART0_TRY(69, 68, 11, 15),
+    _CLOCK_CFG_UART0_TRY(70, 69, 13, 15),
+    _CLOCK_CFG_UART0_TRY(71, 70, 14, 15)
+};
+
+/*! @brief UART0: SYSCON divider, UART_SetDivisor() & UART_SetFractionalDivider()
+ *         values, resulting baud rate & its error (ppm)
+ */
+# define CLOCK_CFG_UART0_DIVIDER    _CLOCK_CFG_UART0_V71
+# define CLOCK_CFG_UART0_PCLK       ((F_CPU) / CLOCK_CFG_UART0_DIVIDER)
+# define CLOCK_CFG_UART0_DIVADDVAL  _CLOCK_CFG_UART0_D71
+# define CLOCK_CFG_UART0_MULVAL     _CLOCK_CFG_UART0_M71
+# define CLOCK_CFG_UART0_DIVISOR    _CLOCK_CFG_UART0_DL(CLOCK_CFG_UART0_DIVADDVAL, CLOCK_CFG_UART0_MULVAL)
+# define CLOCK_CFG_UART0_ACTUAL     (((unsigned long long)(F_CPU) * CLOCK_CFG_UART0_MULVAL) \
+                                     / (16ULL * CLOCK_CFG_UART0_DIVIDER \
+                                        * _CLOCK_CFG_UART0_DL1(CLOCK_CFG_UART0_DIVADDVAL, CLOCK_CFG_UART0_MULVAL) \
+                                        * (CLOCK_CFG_UART0_MULVAL + CLOCK_CFG_UART0_DIVADDVAL)))
+# define CLOCK_CFG_UART0_ERROR_PPM  _CLOCK_CFG_UART0_E71B
+#endif
+
+/* SSP: smallest even prescaler leaving ticks per bit <= 256, then the fewest
+ *  ticks per bit that keep SCK at or under the requested rate
+ */
+#define _CLOCK_CFG_SSP_PRESCALER(pclk, sck) \
+    ((((pclk) + 512UL * (sck) - 1) / (512UL * (sck))) * 2)
+#define _CLOCK_CFG_SSP_TICKS(pclk, sck) \
+    (((pclk) + _CLOCK_CFG_SSP_PRESCALER(pclk, sck) * (sck) - 1) \
+     / (_CLOCK_CFG_SSP_PRESCALER(pclk, sck) * (sck)))
+
+#ifdef SSP0_SCK
+/*! @brief SSP0: SYSCON divider, SSP_SetClockPrescaler() & SSP_SetPrescalerTicksPerBit() values */
+# define CLOCK_CFG_SSP0_DIVIDER         (SSP0CLKDIV_Val)
+# define CLOCK_CFG_SSP0_PCLK            ((F_CPU) / (SSP0CLKDIV_Val))
+# define CLOCK_CFG_SSP0_PRESCALER       _CLOCK_CFG_SSP_PRESCALER(CLOCK_CFG_SSP0_PCLK, SSP0_SCK)
+# define CLOCK_CFG_SSP0_TICKS_PER_BIT   _CLOCK_CFG_SSP_TICKS(CLOCK_CFG_SSP0_PCLK, SSP0_SCK)
+#endif
+
+#ifdef SSP1_SCK
+/*! @brief SSP1: SYSCON divider, SSP_SetClockPrescaler() & SSP_SetPrescalerTicksPerBit() values */
+# define CLOCK_CFG_SSP1_DIVIDER         (SSP1CLKDIV_Val)
+# define CLOCK_CFG_SSP1_PCLK            ((F_CPU) / (SSP1CLKDIV_Val))
+# define CLOCK_CFG_SSP1_PRESCALER       _CLOCK_CFG_SSP_PRESCALER(CLOCK_CFG_SSP1_PCLK, SSP1_SCK)
+# define CLOCK_CFG_SSP1_TICKS_PER_BIT   _CLOCK_CFG_SSP_TICKS(CLOCK_CFG_SSP1_PCLK, SSP1_SCK)
+#endif
+
+
+/* Checks -------------------------------------------------------------------*/
+
+CLOCK_CFG_ASSERT(!CLOCK_CFG_USE_PLL || ((F_CPU) % CLOCK_CFG_INPUT_CLOCK) == 0,
+                 "F_CPU must be a whole multiple of HSE_Val (or of the 12MHz IRC if HSE_Val is not set)");
+CLOCK_CFG_ASSERT(!CLOCK_CFG_USE_PLL || ((CLOCK_CFG_INPUT_CLOCK >= 10000000UL) && (CLOCK_CFG_INPUT_CLOCK <= 25000000UL)),
+                 "HSE_Val must be 10 - 25MHz to drive the PLL");
+CLOCK_CFG_ASSERT(!CLOCK_CFG_USE_PLL || ((CLOCK_CFG_PLL_M >= 1) && (CLOCK_CFG_PLL_M <= 32)),
+                 "F_CPU / HSE_Val is more than the PLL's maximum multiplier (32)");
+CLOCK_CFG_ASSERT(!CLOCK_CFG_USE_PLL || ((CLOCK_CFG_CCO_CLOCK >= 156000000ULL) && (CLOCK_CFG_CCO_CLOCK <= 320000000ULL)),
+                 "F_CPU cannot be made by the PLL (CCO out of its 156 - 320MHz range)");
+CLOCK_CFG_ASSERT(((AHBCLKDIV_Val) >= 1) && ((AHBCLKDIV_Val) <= 255),
+                 "AHBCLKDIV_Val must be 1 - 255");
+CLOCK_CFG_ASSERT(CLOCK_CFG_AHB_CLOCK <= 50000000UL,
+                 "Core clock (F_CPU / AHBCLKDIV_Val) is over the LPC11xx 50MHz maximum");
+
+#ifdef UART0_BAUD
+# ifdef UART0CLKDIV_Val
+CLOCK_CFG_ASSERT(((UART0CLKDIV_Val) >= 1) && ((UART0CLKDIV_Val) <= 255),
+                 "UART0CLKDIV_Val must be 1 - 255");
+CLOCK_CFG_ASSERT(CLOCK_CFG_UART0_ERROR_PPM != 0x7fffffff,
+                 "UART0_BAUD is out of range for the UART clock (adjust UART0CLKDIV_Val)");
+# else
+CLOCK_CFG_ASSERT(CLOCK_CFG_UART0_ERROR_PPM != 0x7fffffff,
+                 "UART0_BAUD is out of range for F_CPU");
+# endif
+CLOCK_CFG_ASSERT(CLOCK_CFG_UART0_ERROR_PPM <= (CLOCK_BAUD_TOLERANCE),
+                 "UART0_BAUD cannot be made within CLOCK_BAUD_TOLERANCE from F_CPU");
+#endif
+
+#ifdef SSP0_SCK
+CLOCK_CFG_ASSERT(((SSP0CLKDIV_Val) >= 1) && ((SSP0CLKDIV_Val) <= 255),
+                 "SSP0CLKDIV_Val must be 1 - 255");
+CLOCK_CFG_ASSERT((CLOCK_CFG_SSP0_PRESCALER >= 2) && (CLOCK_CFG_SSP0_PRESCALER <= 254),
+                 "SSP0_SCK is too slow for the SSP0 clock (raise SSP0CLKDIV_Val)");
+#endif
+
+#ifdef SSP1_SCK
+CLOCK_CFG_ASSERT(((SSP1CLKDIV_Val) >= 1) && ((SSP1CLKDIV_Val) <= 255),
+                 "SSP1CLKDIV_Val must be 1 - 255");
+CLOCK_CFG_ASSERT((CLOCK_CFG_SSP1_PRESCALER >= 2) && (CLOCK_CFG_SSP1_PRESCALER <= 254),
+                 "SSP1_SCK is too slow for the SSP1 clock (raise SSP1CLKDIV_Val)");
+#endif
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_CLOCK_CONFIG_H_ */
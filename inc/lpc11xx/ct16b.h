@@ -72,6 +72,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_CT16B_H
+
 
 /**
   * @defgroup CT16B_AbstractionLayer CT16B (16-bit Counter/Timer) Abstraction Layer
@@ -547,7 +551,7 @@ __INLINE static uint32_t CT16B_GetConfigForCaptureChannel(CT16B_Type *timer, uns
 {
     lpclib_assert(channel < CT16B_NUM_CAPTURE_CHANNELS);
 
-    return ((timer->CCR >> (3 * channel)) & CT16B_CaptureConfig_Mask);
+    return ((timer->CCR >> (3 * channel)) & CT16B_CaptureConfigMask_Mask);
 }
 
 /** @brief Get the count value on a capture channel on a CT16B counter/timer.
@@ -570,6 +574,8 @@ __INLINE static uint32_t CT16B_GetCountForCaptureChannel(CT16B_Type *timer, unsi
   * @}
   */
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
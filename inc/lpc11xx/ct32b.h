@@ -52,6 +52,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_CT32B_H
+
 
 /**
   * @defgroup CT32B_AbstractionLayer CT16B (32-bit Counter/Timer) Abstraction Layer
@@ -571,6 +575,8 @@ __INLINE static uint32_t CT32B_GetCaptureValue(CT32B_Type *Timer, unsigned int C
   * @}
   */
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
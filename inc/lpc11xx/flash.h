@@ -63,6 +63,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_FLASH_H
+
 
 /**
   * @defgroup FLASH_AbstractionLayer Flash Control Abstraction Layer
@@ -135,6 +139,8 @@ __INLINE static void FLASH_GenerateSignature(uint32_t start_addr,
   */
 
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,157 @@
+/** ***************************************************************************
+ * @file     gate.h
+ * @brief    Reference-counted peripheral clock & power gating for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * Rather than turning a peripheral's clocks on with SYSCON_EnableAHBClockLines()
+ * & leaving them on, a driver calls GATE_Acquire() when it starts using the
+ * peripheral & GATE_Release() when it's done.  The first user turns the
+ * peripheral on, the last one turns it off again:
+ * - the AHB (register interface) clock line,
+ * - the peripheral clock divider for UART0 / SSP0 / SSP1 (set to 0 while
+ *   released; the divider the driver set is put back on the next acquire),
+ * - the analog power line for the ADC.
+ *
+ * GATE_Init() turns off everything managed that nobody has acquired (the
+ * chip comes out of reset with some of it on).  Code that still uses the
+ * SYSCON functions directly on a managed peripheral will have it turned
+ * off under it by GATE_Init() / GATE_Release().
+ *
+ * With a time source set (GATE_SetTimeSource(), e.g. a function returning
+ * IDLE_GetTicks()), GATE_GetStats() shows how long each peripheral has
+ * been on, to find what's drawing current.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_GATE_H_
+#define NXP_LPC_GATE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_Gate LPC11xx Peripheral Clock & Power Gating
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief Managed peripherals.
+  */
+typedef enum {
+    GATE_UART0 = 0,                       /*!< UART0 (AHB line, UART clock)     */
+    GATE_SSP0,                            /*!< SSP0 (AHB line, SSP clock)       */
+    GATE_SSP1,                            /*!< SSP1 (AHB line, SSP clock)       */
+    GATE_ADC0,                            /*!< ADC (AHB line, analog power)     */
+    GATE_I2C0,                            /*!< I2C0 (AHB line)                  */
+    GATE_CT16B0,                          /*!< 16-bit timer 0 (AHB line)        */
+    GATE_CT16B1,                          /*!< 16-bit timer 1 (AHB line)        */
+    GATE_CT32B0,                          /*!< 32-bit timer 0 (AHB line)        */
+    GATE_CT32B1,                          /*!< 32-bit timer 1 (AHB line)        */
+    GATE_NumLines
+} GATE_Line_Type;
+
+/*! @brief Macro to test whether parameter is a valid gated line */
+#define GATE_IS_LINE(Line)  ((unsigned int)(Line) < GATE_NumLines)
+
+/** @brief Use of one peripheral.
+  */
+typedef struct {
+    uint32_t Enables;                     /*!< Times turned on                  */
+    uint32_t EnabledTime;                 /*!< Time on, in time source units
+                                               (including now, if on)           */
+    uint8_t  Users;                       /*!< Current users                    */
+} GATE_Stats_Type;
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Turn off every managed peripheral that has no users.
+  */
+extern void GATE_Init(void);
+
+/** @brief Start using a peripheral, turning it on if it's the first user.
+  * @param[in]  line         The peripheral
+  */
+extern void GATE_Acquire(GATE_Line_Type line);
+
+/** @brief Stop using a peripheral, turning it off if it's the last user.
+  * @param[in]  line         The peripheral
+  */
+extern void GATE_Release(GATE_Line_Type line);
+
+/** @brief Test whether a peripheral is on (has users).
+  * @param[in]  line         The peripheral
+  * @return                  1 if it's on, 0 otherwise.
+  */
+extern unsigned int GATE_IsEnabled(GATE_Line_Type line);
+
+/** @brief Set the clock used for time-enabled accounting.
+  * @param[in]  now          Function returning a free-running count (0 for
+  *                          no time accounting)
+  */
+extern void GATE_SetTimeSource(uint32_t (*now)(void));
+
+/** @brief Get use of a peripheral.
+  * @param[in]  line         The peripheral
+  * @param[out] stats        Where to put it
+  */
+extern void GATE_GetStats(GATE_Line_Type line, GATE_Stats_Type *stats);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_GATE_H_ */
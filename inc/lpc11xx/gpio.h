@@ -65,6 +65,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_GPIO_H
+
 
 /**
   * @defgroup GPIO_AbstractionLayer GPIO (General Purpose IO) Abstraction Layer
@@ -478,6 +482,8 @@ __INLINE static void GPIO_ClearPendingInterruptsForPin(GPIO_Type *gpio, unsigned
   * @}
   */
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
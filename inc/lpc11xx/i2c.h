@@ -63,6 +63,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_I2C_H
+
 
 /**
   * @defgroup I2C_AbstractionLayer I2C (Inter-Integreated Circuit) Abstraction Layer
@@ -334,6 +338,8 @@ __INLINE static unsigned int I2C_MonitorIsEnabled(I2C_Type *i2c)
   */
 
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
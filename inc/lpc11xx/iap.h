@@ -63,6 +63,10 @@ extern "C" {
 #include "system_lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_IAP_H
+
 
 /**
   * @defgroup IAP_AbstractionLayer IAP (Flash Programming) Abstraction Layer
@@ -348,6 +352,8 @@ static __INLINE void IAP_ReinvokeISP(void)
   */
 
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,235 @@
+/** ***************************************************************************
+ * @file     idle.h
+ * @brief    Tickless idle: timers, sleep & deep-sleep for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * Instead of busy-polling, a main loop calls IDLE_Sleep() whenever it has
+ * nothing to do.  Time is kept by CT32B0, free running at IDLE_TICK_HZ;
+ * work that has to happen later is put on one-shot IDLE_Timer_Type
+ * timers, and the nearest expiry is always loaded into match register 3.
+ * There is no periodic tick: the core only wakes for a timer that is due
+ * or for some other interrupt.
+ *
+ * IDLE_Sleep() picks the mode from the time left to the next expiry:
+ * - Sleep (core clock stopped, peripherals running; wakes in a few clocks)
+ *   when the expiry is close or deep-sleep isn't allowed.
+ * - Deep-sleep when it is at least IDLE_DEEPSLEEP_MIN_TICKS away.  The main
+ *   clock is moved to the watchdog oscillator (everything else analog is
+ *   powered down), so CT32B0 keeps counting; MAT3 on PIO0_11 ends it
+ *   through the start logic IDLE_DEEPSLEEP_WAKE_TICKS before the expiry,
+ *   and the PLL / clocks are back as they were when IDLE_Sleep() returns.
+ *
+ * Deep-sleep is off until IDLE_EnableDeepSleep(), which takes over
+ * PIO0_11.  Only start logic inputs wake the part from deep-sleep, and
+ * peripherals lose their clock in it; a driver in the middle of something
+ * (e.g. a UART receiving) holds it off with IDLE_LockDeepSleep().
+ *
+ * The watchdog oscillator is only good to about +/-40%, so time in
+ * deep-sleep is that accurate unless IDLE_SetWDTOscFrequency() is given
+ * a measured value (e.g. from CLKOUT on a frequency counter).
+ *
+ * CT32B0 is owned by this module; IDLE_CT32B0_IRQHandler must be its
+ * interrupt handler (ISR_SetHandler(CT32B0_IRQn, IDLE_CT32B0_IRQHandler)
+ * or -Wl,--defsym=CT32B0_IRQHandler=IDLE_CT32B0_IRQHandler).  Timer
+ * callbacks run from it.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_IDLE_H_
+#define NXP_LPC_IDLE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_Idle LPC11xx Tickless Idle
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief A one-shot timer.
+  *
+  * Owned by the caller (usually a static variable); linked into a list
+  * while running, so it must stay valid until it fires or is stopped.
+  */
+typedef struct idle_timer {
+    void (*Callback)(struct idle_timer *timer); /*!< Called on expiry (from the IRQ) */
+    uint32_t Expires;                     /*!< (used by the library)            */
+    struct idle_timer *Next;              /*!< (used by the library)            */
+} IDLE_Timer_Type;
+
+/** @brief Where idle time has gone.
+  */
+typedef struct {
+    uint32_t Sleeps;                      /*!< Times slept                      */
+    uint32_t DeepSleeps;                  /*!< Times deep-slept                 */
+    uint32_t SleepTicks;                  /*!< Ticks spent sleeping             */
+    uint32_t DeepSleepTicks;              /*!< Ticks spent deep-sleeping        */
+    uint32_t MaxWakeLateness;             /*!< Worst ticks past a timer expiry on
+                                               coming out of deep-sleep         */
+} IDLE_Stats_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Timebase rate (CT32B0 ticks per second) */
+#ifndef IDLE_TICK_HZ
+# define IDLE_TICK_HZ               1000UL
+#endif
+
+/*! @brief Time from a deep-sleep wake-up to running at full speed again,
+ *         microseconds: IRC start-up & PLL lock.  Add the crystal's start-up
+ *         time if the system oscillator feeds the PLL; check against
+ *         IDLE_Stats.MaxWakeLateness.
+ */
+#ifndef IDLE_DEEPSLEEP_WAKE_US
+# define IDLE_DEEPSLEEP_WAKE_US     500UL
+#endif
+
+/*! @brief Deep-sleep wake-up time in ticks (rounded up) */
+#define IDLE_DEEPSLEEP_WAKE_TICKS   ((IDLE_DEEPSLEEP_WAKE_US * IDLE_TICK_HZ + 999999UL) / 1000000UL)
+
+/*! @brief Shortest idle period worth a deep-sleep; below it the switch
+ *         costs more than it saves.
+ */
+#ifndef IDLE_DEEPSLEEP_MIN_TICKS
+# define IDLE_DEEPSLEEP_MIN_TICKS   (4 * IDLE_DEEPSLEEP_WAKE_TICKS + 2)
+#endif
+
+/*! @brief Watchdog oscillator setting used as the main clock in deep-sleep */
+#define IDLE_WDTOSC_FREQ            SYSCON_WDTOscFreq_0_5_Mhz
+#define IDLE_WDTOSC_DIVIDER         2
+
+
+/* Exported Variables -------------------------------------------------------*/
+
+extern IDLE_Stats_Type IDLE_Stats;        /*!< Idle statistics (clear at will)  */
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Start the timebase.
+  *
+  * Powers & starts CT32B0 at IDLE_TICK_HZ from the core clock (kept right
+  * across CLOCK_SetCoreFrequency()), & enables its interrupt.
+  */
+extern void IDLE_Init(void);
+
+/** @brief Stop the timebase & release CT32B0.
+  *
+  * Gives up the module's GATE_CT32B0 reference.  Running timers are
+  * dropped without their callbacks being called; IDLE_Sleep() must not be
+  * used again until the next IDLE_Init().
+  */
+extern void IDLE_Deinit(void);
+
+/** @brief Get the time.
+  * @return                  Ticks (of IDLE_TICK_HZ) since IDLE_Init(); wraps
+  */
+__INLINE static uint32_t IDLE_GetTicks(void)
+{
+    return CT32B0->TC;
+}
+
+/** @brief Start (or restart) a one-shot timer.
+  * @param[in]  timer        The timer (Callback filled in)
+  * @param[in]  ticks        Ticks from now to expiry (1 - 0x7fffffff)
+  */
+extern void IDLE_StartTimer(IDLE_Timer_Type *timer, uint32_t ticks);
+
+/** @brief Stop a timer; nothing happens if it isn't running.
+  * @param[in]  timer        The timer
+  */
+extern void IDLE_StopTimer(IDLE_Timer_Type *timer);
+
+/** @brief Allow deep-sleep.
+  *
+  * Takes over PIO0_11 (as CT32B0_MAT3) and sets the watchdog oscillator to
+  * IDLE_WDTOSC_FREQ / IDLE_WDTOSC_DIVIDER; a watchdog clocked from it
+  * keeps running at that rate.
+  */
+extern void IDLE_EnableDeepSleep(void);
+
+/** @brief Hold off deep-sleep (nests with IDLE_UnlockDeepSleep()).
+  */
+extern void IDLE_LockDeepSleep(void);
+
+/** @brief Undo one IDLE_LockDeepSleep().
+  */
+extern void IDLE_UnlockDeepSleep(void);
+
+/** @brief Set the watchdog oscillator frequency used for deep-sleep time.
+  * @param[in]  hz           Measured frequency after IDLE_WDTOSC_DIVIDER
+  *                          (the nominal frequency is used until set)
+  */
+extern void IDLE_SetWDTOscFrequency(uint32_t hz);
+
+/** @brief Sleep until an interrupt or the next timer.
+  *
+  * Call from thread mode with nothing else to do (typically at the bottom
+  * of the main loop).  Returns after any interrupt has been handled.
+  */
+extern void IDLE_Sleep(void);
+
+/** @brief CT32B0 interrupt handler: runs expired timers.
+  */
+extern void IDLE_CT32B0_IRQHandler(void);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_IDLE_H_ */
@@ -62,6 +62,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_IOCON_H
+
 
 /**
   * @defgroup IOCON_AbstractionLayer IOCON (IO Configuration Block) Abstraction Layer
@@ -126,8 +130,7 @@ typedef enum {
 } IOCON_Pin_Type;
 
 /*! @brief Macro to test whether parameter is a valid IO Pin */
-#define IOCON_IS_PIN(Pin)  (((Pin) >= IOCON_Pin_2_6) \
-                         && ((Pin) <= IOCON_Pin_3_3) \
+#define IOCON_IS_PIN(Pin)  (((unsigned int)(Pin) <= IOCON_Pin_3_3) \
                          && ((Pin) != 0x01)          \
                          && ((Pin) != 0x06))
 
@@ -492,14 +495,20 @@ __INLINE static IOCON_Function_Type IOCON_GetPinFunction(IOCON_Pin_Type pin)
 __INLINE static void IOCON_SetPinConfig(IOCON_PinConfig_Type config, IOCON_Mode_Type mode)
 {
     uint16_t pin = config & 0xff;
+    uint32_t mask = IOCON_Function_Mask | IOCON_Mode_Mask;
 
 
     lpclib_assert(IOCON_IS_PIN(pin));
-    lpclib_assert(IOCON_IS_FUNCTION(config >> 8));
+    lpclib_assert(IOCON_IS_FUNCTION((config >> 8) & IOCON_Function_Mask));
     lpclib_assert(IOCON_IS_MODE(mode));
 
+    /* AD pin configs carry their analog / digital setting too */
+    if (IOCON_IS_AD_PIN(pin)) {
+        mask |= IOCON_ADMode_Digital;
+    }
+
     ((__IO uint32_t *)IOCON)[pin] =
-        (((__IO uint32_t *)IOCON)[pin] & ~(IOCON_Function_Mask | IOCON_Mode_Mask))
+        (((__IO uint32_t *)IOCON)[pin] & ~mask)
         | (config >> 8) | mode;
 }
 
@@ -719,6 +728,8 @@ __INLINE static IOCON_RI0Location_Type IOCON_GetRI0Location(void)
   * @}
   */
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,153 @@
+/** ***************************************************************************
+ * @file     irccal.h
+ * @brief    IRC oscillator trimming against a reference clock for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * The 12MHz IRC is only factory trimmed to about 1%, which on a board with
+ * no crystal limits how fast the UART can reliably go.  This measures the
+ * IRC against a reference edge on CT32B1_CAP0 (PIO1_0) and walks the
+ * IRCCTRL trim value to the setting closest to nominal.
+ *
+ * The reference can be anything of known frequency: a GPS 1PPS output,
+ * a host-generated square wave, or the system oscillator on CLKOUT
+ * (SYSCON_CLKOUTSource_SysOsc, divided down) wired to PIO1_0.  CT32B1
+ * counts the core clock, which has to come from the IRC (directly or
+ * through the PLL); the longer the measurement (edges / ref_hz), the finer
+ * the result.  Trim steps are coarse next to what even one period of a
+ * 1PPS reference resolves at core clock rates.
+ *
+ * The result can be kept in a flash sector set aside for it with
+ * IRCCAL_Save() and put back at start-up with IRCCAL_Restore().
+ *
+ * CT32B1 and PIO1_0 are taken over while calibrating.  Measuring polls, so
+ * IRCCAL_Calibrate() takes about (IRCCAL_MAX_STEPS + 1) * edges / ref_hz
+ * seconds at worst.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_IRCCAL_H_
+#define NXP_LPC_IRCCAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_IRCCal LPC11xx IRC Oscillator Calibration
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief Outcome of a calibration.
+  */
+typedef struct {
+    uint8_t  Trim;                        /*!< IRCCTRL trim value chosen        */
+    uint8_t  Steps;                       /*!< Trim values tried                */
+    int32_t  ErrorPPM;                    /*!< Measured error at Trim (+ = fast) */
+} IRCCAL_Result_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Most trim values IRCCAL_Calibrate() tries */
+#ifndef IRCCAL_MAX_STEPS
+# define IRCCAL_MAX_STEPS           16
+#endif
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Measure the IRC's error.
+  * @param[in]  ref_hz       Reference frequency on PIO1_0, Hz
+  * @param[in]  edges        Reference periods to measure over
+  * @param[out] ppm          Error, parts per million (+ means running fast)
+  * @return                  0 on success, -1 if the core clock isn't from the
+  *                          IRC, the measurement's too long for the timer, or
+  *                          no reference edges came
+  */
+extern int IRCCAL_Measure(uint32_t ref_hz, unsigned int edges, int32_t *ppm);
+
+/** @brief Trim the IRC as close to nominal as it will go.
+  * @param[in]  ref_hz       Reference frequency on PIO1_0, Hz
+  * @param[in]  edges        Reference periods per measurement
+  * @param[out] result       The trim chosen & its error (may be 0)
+  * @return                  0 on success, -1 if a measurement failed (the
+  *                          trim is left as it was)
+  */
+extern int IRCCAL_Calibrate(uint32_t ref_hz, unsigned int edges, IRCCAL_Result_Type *result);
+
+/** @brief Store the current trim in flash.
+  * @param[in]  addr         Start of a flash sector set aside for it
+  * @return                  0 on success, negative IAP status value on error
+  *
+  * Erases the sector.  Interrupts must not run from flash while it's busy,
+  * and the IAP code uses the top 32 bytes of RAM.
+  *
+  * The page written comes from a 256-byte static buffer (in .noinit), so
+  * linking this in costs 256 bytes of RAM; the stack use is small.
+  */
+extern int IRCCAL_Save(uint32_t addr);
+
+/** @brief Put back a trim stored by IRCCAL_Save().
+  * @param[in]  addr         The sector IRCCAL_Save() used
+  * @return                  0 if one was found & applied, -1 if not
+  */
+extern int IRCCAL_Restore(uint32_t addr);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_IRCCAL_H_ */
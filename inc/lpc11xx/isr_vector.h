@@ -50,6 +50,11 @@ extern "C" {
 #endif
 
 
+/* Includes -----------------------------------------------------------------*/
+
+#include "lpc11xx.h"
+
+
 /**
   * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
   * @{
@@ -120,6 +125,9 @@ typedef struct isr_vector {
     void (* GPIO0_IRQHandler_Vect)(void);           /*!< GPIO0 IRQ Handler            */
 } ISRVector_Type;
 
+/*! @brief Exception / interrupt handler */
+typedef void (*ISR_Handler_Type)(void);
+
 /** @} */
 
 /* System Exception / Interrupt Handlers ------------------------------------*/
@@ -251,6 +259,53 @@ extern void GPIO0_IRQHandler(void);
   * @}
   */
 
+/* Runtime Vector Table -----------------------------------------------------*/
+
+/** @defgroup LPC11xx_RAMVectors LPC11xx Runtime (RAM) Vector Table
+  * @{
+  *
+  * The vectors in flash (BootISRVector) are fixed when the image is linked.
+  * ISR_UseRAMVectors() copies them to the start of RAM & remaps that over
+  * address 0, after which ISR_SetHandler() can point any exception or IRQ
+  * straight at a handler, with no dispatch function in between.
+  *
+  * The RAM table takes the first 192 bytes of RAM (only if these functions
+  * are linked in).  Code that reads address 0 expecting flash, such as a
+  * checksum over the vectors, sees the RAM copy while it is mapped.
+  */
+
+/*! @brief The vectors in flash, as linked */
+extern const ISRVector_Type BootISRVector;
+
+/** @brief Copy the flash vectors to RAM & switch to the RAM copy.
+  *
+  * Any handlers installed with ISR_SetHandler() before a previous
+  * ISR_UseFlashVectors() are replaced by the flash vectors.
+  */
+extern void ISR_UseRAMVectors(void);
+
+/** @brief Switch back to the vectors in flash.
+  */
+extern void ISR_UseFlashVectors(void);
+
+/** @brief Install the handler for an exception or interrupt.
+  * @param[in]  irq          The exception / IRQ number (e.g. UART0_IRQn)
+  * @param[in]  handler      The handler to call
+  * @return                  The handler previously installed
+  *
+  * The RAM vectors must be in use (see ISR_UseRAMVectors()).  The change is
+  * a single word write, so it can be made with the interrupt enabled.
+  */
+extern ISR_Handler_Type ISR_SetHandler(IRQn_Type irq, ISR_Handler_Type handler);
+
+/** @brief Get the handler installed for an exception or interrupt.
+  * @param[in]  irq          The exception / IRQ number (e.g. UART0_IRQn)
+  * @return                  The handler in the vector table in use
+  */
+extern ISR_Handler_Type ISR_GetHandler(IRQn_Type irq);
+
+/** @} */
+
 /**
   * @}
   */
@@ -55,6 +55,11 @@ extern "C" {
 
 #include <stdint.h>
 #include "lpc11xx.h"
+#include "lpclib_assert.h"
+
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_PMU_H
 
 /**
   * @defgroup PMU_AbstractionLayer PMU (Power Management Unit) Abstraction Layer
@@ -107,6 +112,39 @@ __INLINE static unsigned int PMU_IsInDeepPowerDownMode(void)
     return (PMU->PCON & PMU_DPDFLAG) ? 1:0;
 }
 
+/** @brief Clear the flag showing deep power down mode was entered.
+  *
+  * @note
+  * The flag is only cleared by power-on, so after a wake-up from deep power
+  * down it needs clearing to tell later resets apart.
+  */
+__INLINE static void PMU_ClearDeepPowerDownFlag(void)
+{
+    PMU->PCON = (PMU->PCON & ~PMU_SLEEPFLAG) | PMU_DPDFLAG;
+}
+
+/** @brief Set a general purpose register (kept through deep power down).
+  * @param[in]  reg          The register (0-3)
+  * @param[in]  value        The value to store
+  */
+__INLINE static void PMU_SetGPREG(unsigned int reg, uint32_t value)
+{
+    lpclib_assert(reg <= 3);
+
+    (&PMU->GPREG0)[reg] = value;
+}
+
+/** @brief Get a general purpose register (kept through deep power down).
+  * @param[in]  reg          The register (0-3)
+  * @return                  The register's value.
+  */
+__INLINE static uint32_t PMU_GetGPREG(unsigned int reg)
+{
+    lpclib_assert(reg <= 3);
+
+    return (&PMU->GPREG0)[reg];
+}
+
 /** @brief Enable hysteresis on the deep-powerdown wakeup pin.
   */
 __INLINE static void PMU_EnableWakeupHysteresis(void)
@@ -138,6 +176,8 @@ __INLINE static unsigned int PMU_WakeupHysteresisIsEnabled(void)
   */
 
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
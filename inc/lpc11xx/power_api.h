@@ -0,0 +1,182 @@
+/**************************************************************************//**
+ * @file     power_api.h
+ * @brief    Power Profile API Interface Header for LPC11xxL Microcontrollers.
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     1. January 2012
+ ******************************************************************************
+ * @section Overview
+ * This file gives a basic interface to NXP LPC11xxL microcontroller
+ * Power Profile API (ROM based interface to power control on the
+ * chips).  It allows setting of the microcontroller's PLL and performance.
+ *
+ * The ROM picks PLL / AHB divider settings for a requested clock, and
+ * tunes the flash access time & internal regulator for the clock and a
+ * power mode (CPU performance, efficiency or low current).  Only the
+ * L-series parts (LPC111x/1xx, /2xx, /3xx) have it in ROM.
+ *
+ * Both functions change SYSCON / flash registers behind the library's
+ * back; they refresh SystemCoreClock and the CLOCK_GetFrequency() cache
+ * themselves.  lpc11xx-sim emulates the ROM entry points, so code using
+ * the API runs (and can be benchmarked) under the simulator.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_POWER_API_H_
+#define NXP_LPC_POWER_API_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+
+
+/**
+  * @defgroup PowerAPI Power Profile API Interface
+  * @ingroup  LPC_Peripheral_AbstractionLayer
+  * @{
+  */
+
+/* Defines ------------------------------------------------------------------*/
+
+/** @defgroup PowerAPI_Definitions Power Profile API Interface Definitions
+  * @{
+  */
+
+#define POWERAPI_ROM_DRIVER_TABLE (0x1fff1ff8UL)    /*!< Holds the ROM driver table address */
+#define POWERAPI_ROM_DRIVER_INDEX (3)               /*!< Power API's slot in the driver table */
+
+/** @} */
+
+
+/* Types & Type-Related Definitions -----------------------------------------*/
+
+/** @defgroup PowerAPI_Types Power API Interface Types and Type-Related Definitions
+  * @ingroup  PowerAPI
+  * @{
+  */
+
+/*! @brief How closely PowerAPI_SetPLLFreq() must match the requested clock */
+typedef enum {
+    PowerAPI_PLLMode_Equal = 0,                            /*!< Exactly the requested clock      */
+    PowerAPI_PLLMode_LessOrEqual,                          /*!< Closest at or below it           */
+    PowerAPI_PLLMode_GreaterOrEqual,                       /*!< Closest at or above it           */
+    PowerAPI_PLLMode_Approximate                           /*!< Closest either way               */
+} PowerAPI_PLLMode_Type;
+
+/*! @brief Macro to test whether parameter is a valid PLL match mode */
+#define POWERAPI_IS_PLL_MODE(Mode) ((Mode) <= PowerAPI_PLLMode_Approximate)
+
+/*! @brief Power Profile API status codes */
+typedef enum {
+    PowerAPI_Status_Success = 0,                           /*!< Done                             */
+    PowerAPI_Status_InvalidFrequency,                      /*!< Clock out of range               */
+    PowerAPI_Status_InvalidMode,                           /*!< Bad PLL / power mode             */
+    PowerAPI_Status_FreqNotFound,                          /*!< No PLL setting matches           */
+    PowerAPI_Status_PLLNotLocked                           /*!< PLL didn't lock in max_tries     */
+} PowerAPI_Status_Type;
+
+/*! @brief Power modes for PowerAPI_SetPowerMode() */
+typedef enum {
+    PowerAPI_PowerMode_Default = 0,                        /*!< Reset settings                   */
+    PowerAPI_PowerMode_Performance,                        /*!< Fastest CPU                      */
+    PowerAPI_PowerMode_Efficiency,                         /*!< Best work per unit of current    */
+    PowerAPI_PowerMode_LowCurrent                          /*!< Least active current             */
+} PowerAPI_PowerMode_Type;
+
+/*! @brief Macro to test whether parameter is a valid power mode */
+#define POWERAPI_IS_POWER_MODE(Mode) ((Mode) <= PowerAPI_PowerMode_LowCurrent)
+
+/*! @brief The ROM's Power API function table */
+typedef struct {
+    void (*SetPLL)(uint32_t command[], uint32_t result[]);   /*!< set_pll   */
+    void (*SetPower)(uint32_t command[], uint32_t result[]); /*!< set_power */
+} PowerAPI_ROM_Type;
+
+/**
+  * @}
+  */
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @defgroup POWER_Exported_Functions Power Profile Exported Functions
+  * @{
+  */
+
+/** @brief Set the system clock via the Power Profile API's PLL search.
+  * @param[in]  desired_sysclock  The clock at which to run the CPU, in Hz
+  * @param[in]  pll_mode          How closely it must be matched
+  * @param[in]  max_tries         Polls of the PLL lock bit before giving up
+  * @return PowerAPI_Status_Type value giving success or the reason the call failed.
+  *
+  * The PLL input (IRC or system oscillator) is left as SystemInit() set it.
+  * The flash access time is raised beforehand if the clock goes up, but
+  * only to a safe value: follow with PowerAPI_SetPowerMode() to tune it.
+  *
+  * Clock notifiers (CLOCK_RegisterNotifier()) are called as for
+  * CLOCK_SetCoreFrequency(), so SERIAL / RS485 dividers follow the new
+  * clock.  The ROM chooses the clock, so CLOCK_Event_PreChange is given
+  * desired_sysclock & CLOCK_Event_PostChange the clock actually set; the
+  * latter comes even if the call fails.  Call from thread mode.
+  */
+PowerAPI_Status_Type PowerAPI_SetPLLFreq(uint32_t desired_sysclock,
+                                         PowerAPI_PLLMode_Type pll_mode,
+                                         uint32_t max_tries);
+
+/** @brief  Set the system power mode to the desired setting via Power Profile interface
+  * @param  power_mode           The desired power mode (performance, efficiency, etc.)
+  * @return PowerAPI_Status_Type value giving success or the reason the call failed.
+  *
+  * Tunes the flash access time & regulator for the current core clock
+  * (SystemCoreClock, which must be 1 - 50MHz in whole MHz).
+  */
+PowerAPI_Status_Type PowerAPI_SetPowerMode(PowerAPI_PowerMode_Type power_mode);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_POWER_API_H_ */
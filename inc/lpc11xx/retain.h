@@ -0,0 +1,145 @@
+/** ***************************************************************************
+ * @file     retain.h
+ * @brief    State retained through deep power-down for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * Deep power-down turns off everything but the PMU, so RAM is lost and the
+ * wake-up (on the WAKEUP pin, PIO1_4) is a reset.  The PMU's general
+ * purpose registers do keep their contents; RETAIN_Save() packs a small
+ * RETAIN_State_Type into them with a checksum, and RETAIN_Load() gets it
+ * back after the wake-up.
+ *
+ * _start checks for a deep power-down wake-up with valid retained state
+ * first thing (RETAIN_CheckResume()) & sets SystemResumed.  It then skips
+ * painting RAM for stack measurement, and SystemInit stays on the IRC if
+ * the library was built with LPC11XX_DPD_RESUME_IRC=1, so a node that
+ * wakes to take a sample & goes back down doesn't wait for the crystal &
+ * PLL.  Drivers & main() can check SystemResumed to skip their own
+ * set-up that only matters on a cold start.
+ *
+ * The registers are the application's while the chip runs, but belong to
+ * this module once it's used; the hysteresis control in GPREG4 is left as
+ * it is.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_RETAIN_H_
+#define NXP_LPC_RETAIN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_Retain LPC11xx Deep Power-Down State Retention
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief Application state kept through deep power-down.
+  */
+typedef struct {
+    uint32_t Sequence;                    /*!< e.g. samples / wake-ups so far   */
+    uint32_t Timestamp;                   /*!< e.g. time of the last sample     */
+    uint32_t Data[2];                     /*!< Anything else                    */
+    uint8_t  BootReason;                  /*!< Why to wake (0 - RETAIN_BOOTREASON_MAX) */
+} RETAIN_State_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Largest RETAIN_State_Type BootReason (it gets 5 bits of GPREG4) */
+#define RETAIN_BOOTREASON_MAX       31
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Store state in the PMU registers.
+  * @param[in]  state        The state to keep
+  */
+extern void RETAIN_Save(const RETAIN_State_Type *state);
+
+/** @brief Get state back from the PMU registers.
+  * @param[out] state        Where to put it
+  * @return                  0 if it checks out, -1 if there's none (e.g.
+  *                          after power-on) or it's corrupt
+  */
+extern int RETAIN_Load(RETAIN_State_Type *state);
+
+/** @brief Make the retained state invalid.
+  */
+extern void RETAIN_Invalidate(void);
+
+/** @brief Check for a wake-up from deep power-down with state to resume.
+  * @return                  1 if so, 0 for any other reset
+  *
+  * Clears the PMU's deep power-down flag, so only gives the answer once per
+  * boot; _start calls it and leaves the answer in SystemResumed.
+  */
+extern uint8_t RETAIN_CheckResume(void);
+
+/** @brief Save state & enter deep power-down.
+  * @param[in]  state        The state to keep
+  *
+  * Doesn't return; a falling edge on the WAKEUP pin (PIO1_4) resets the
+  * chip.  Interrupts should be disabled and the WAKEUP pin high.
+  */
+extern void RETAIN_EnterDeepPowerDown(const RETAIN_State_Type *state) __attribute__((noreturn));
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_RETAIN_H_ */
@@ -0,0 +1,194 @@
+/** ***************************************************************************
+ * @file     rs485.h
+ * @brief    RS-485 multidrop node driver (UART0) for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * Runs UART0 as a node on an RS-485 multidrop bus, using the 9th (parity)
+ * bit to mark address characters: a frame is an address character (9th
+ * bit set) followed by data characters (9th bit clear), and ends when the
+ * line goes idle for the character time-out (3.5 - 4.5 characters' time).
+ *
+ * The UART does the work:
+ * - Auto address detect: the receiver stays off until an address
+ *   character matching this node's address arrives, and turns itself off
+ *   again at the next address character that doesn't match.  Frames for
+ *   other nodes never reach the FIFO, so they cause no interrupts; on a
+ *   busy bus the CPU sleeps (IDLE_Sleep(), WFI) through them and only
+ *   wakes for its own.  (Deep-sleep stops the UART clock; use sleep.)
+ * - Auto direction control: RTS0 (PIO1_5) drives the transceiver's driver
+ *   enable while characters go out, and is held for DirDelay bit times
+ *   after the last stop bit, so the turnaround needs no timer or
+ *   interrupt.
+ *
+ * Received frames (without the address character) are passed from the
+ * interrupt handler to the Received callback; frames with framing errors
+ * or breaks, or too long for RxBuffer, are dropped & counted.
+ * RS485_Send() sends the address character itself (waiting its one
+ * character time to switch the 9th bit), then the interrupt handler feeds
+ * the data straight from the caller's buffer.
+ *
+ * RS485_IRQHandler must be UART0's interrupt handler (ISR_SetHandler(
+ * UART0_IRQn, RS485_IRQHandler) or
+ * -Wl,--defsym=UART0_IRQHandler=RS485_IRQHandler); it can't be used
+ * alongside the serial driver.  The baud rate is kept across
+ * CLOCK_SetCoreFrequency(); if the new clock can't give it within
+ * CLOCK_BAUD_TOLERANCE, the node stays off the bus (counted in
+ * BaudErrors) until a clock change gives a usable rate.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_RS485_H_
+#define NXP_LPC_RS485_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+#include "lpc11xx/uart.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_RS485 LPC11xx RS-485 Multidrop Node Driver
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief Driver settings.
+  */
+typedef struct {
+    uint32_t Baud;                        /*!< Baud rate                        */
+    uint8_t Address;                      /*!< This node's address              */
+    uint8_t DirDelay;                     /*!< Driver enable hold, bit times    */
+    UART_RS485DirControlPolarity_Type DirPolarity;  /*!< RTS0 level while sending */
+    UART_RxFifoTrigger_Type RxTrigger;    /*!< Receive interrupt level (4+)     */
+    uint8_t *RxBuffer;                    /*!< Frame being received             */
+    uint16_t RxSize;                      /*!< Its size (longest frame)         */
+    void (*Received)(const uint8_t *frame, unsigned int len);  /*!< Called (from the handler) per frame */
+} RS485_Config_Type;
+
+/** @brief Driver statistics.
+  */
+typedef struct {
+    uint32_t Interrupts;                  /*!< Handler calls                    */
+    uint32_t RxFrames;                    /*!< Frames passed to Received        */
+    uint32_t RxDropped;                   /*!< Frames dropped (errors / length) */
+    uint32_t RxOverruns;                  /*!< Receive FIFO overruns (lost data) */
+    uint32_t TxFrames;                    /*!< Frames sent                      */
+    uint32_t BaudErrors;                  /*!< Clock changes with no usable baud */
+} RS485_Stats_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Depth of the UART's FIFOs */
+#define RS485_FIFO_SIZE             16
+
+
+/* Exported Variables -------------------------------------------------------*/
+
+extern RS485_Stats_Type RS485_Stats;      /*!< Driver statistics (clear at will) */
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Set up UART0 as a bus node & start the driver.
+  * @param[in]  config       Settings (RxBuffer must stay valid)
+  *
+  * Takes over PIO1_6 (RXD), PIO1_7 (TXD) & PIO1_5 (RTS, driver enable),
+  * sets 8 data bits + address bit & enables the interrupt.
+  * @return                  0 on success, -1 if the main clock can't give
+  *                          the baud rate within CLOCK_BAUD_TOLERANCE
+  *                          (nothing is set up)
+  */
+extern int RS485_Init(const RS485_Config_Type *config);
+
+/** @brief Stop the driver & release UART0.
+  *
+  * Disables the interrupt & gives up the driver's GATE_UART0 reference.
+  * A frame still going out is cut short (wait for !RS485_TxBusy() first).
+  */
+extern void RS485_Deinit(void);
+
+/** @brief Change this node's address.
+  * @param[in]  address      The new address (0 - 255)
+  *
+  * The receiver waits for the next frame to the new address.
+  */
+extern void RS485_SetAddress(unsigned int address);
+
+/** @brief Start sending a frame.
+  * @param[in]  address      Node to send it to (0 - 255)
+  * @param[in]  data         The data (must stay valid until sent)
+  * @param[in]  len          Its length
+  * @return                  0 if started, -1 if a frame is still going out
+  *                          or the UART is halted
+  *
+  * Waits one character time for the address to go out; the data is sent
+  *  from the interrupt handler.
+  */
+extern int RS485_Send(unsigned int address, const uint8_t *data, unsigned int len);
+
+/** @brief Test whether a frame is still going out.
+  * @return                  1 if so (data in use or line driven), 0 otherwise
+  */
+extern unsigned int RS485_TxBusy(void);
+
+/** @brief UART0 interrupt handler.
+  */
+extern void RS485_IRQHandler(void);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_RS485_H_ */
@@ -0,0 +1,247 @@
+/** ***************************************************************************
+ * @file     serial.h
+ * @brief    Interrupt-driven, buffered UART0 driver for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * Moves data between UART0 and a pair of caller-supplied ring buffers from
+ * the UART interrupt, working the FIFOs a burst at a time:
+ * - Transmit: each TxEmpty interrupt refills the whole 16-byte FIFO, so
+ *   there's one interrupt per 16 characters sent.
+ * - Receive: the interrupt comes at the FIFO trigger level (RxTrigger,
+ *   e.g. 14 characters) and drains everything there; a partial FIFO is
+ *   picked up by the character time-out (3.5 - 4.5 characters' time
+ *   after the last one arrived).
+ *
+ * The rings are single-producer / single-consumer and lock-free: the
+ * interrupt handler is the only writer of the receive ring & the only
+ * reader of the transmit ring, so SERIAL_Read() / SERIAL_Write() only
+ * need to be kept to one thread (or one interrupt level) each.  Ring sizes
+ * must be powers of 2.
+ *
+ * At high rates, the receive trigger level sets how long the handler may
+ * be held off: with a trigger of 14 it must run within 2 characters'
+ * time (about 22us at 921600 baud) or data is overrun.  A lower trigger
+ * trades interrupts for slack.
+ *
+ * SERIAL_Send() queues descriptors pointing at the caller's own buffers
+ * (e.g. a frame's header, payload & CRC) instead of copying into the
+ * transmit ring; the handler loads the FIFO straight from them and calls
+ * each one's Done when its last byte is in the FIFO.  Descriptors & ring
+ * data go out in the order they were queued.
+ *
+ * With auto-RTS (FlowControl UART_FlowControl_RTS or _RTSCTS), nothing is
+ * lost: when the receive ring fills, the handler stops reading the FIFO
+ * & masks the receive interrupt, so the FIFO climbs to the trigger level
+ * & the UART drops RTS to the peer by itself.  SERIAL_Read() turns
+ * receiving back on once the ring is down to RxLowWater (0 means half
+ * full), and the handler being held off is covered the same way.  The
+ * peer may send what's left of the character in progress and any it
+ * already had on the wire, so leave it room above the trigger level (a
+ * trigger of 8 leaves 8 characters).  With auto-CTS, the UART holds off
+ * sending while the peer drops CTS.
+ *
+ * SERIAL_IRQHandler must be UART0's interrupt handler (ISR_SetHandler(
+ * UART0_IRQn, SERIAL_IRQHandler) or
+ * -Wl,--defsym=UART0_IRQHandler=SERIAL_IRQHandler).  The baud rate is
+ * kept across CLOCK_SetCoreFrequency(); if the new clock can't give it
+ * within CLOCK_BAUD_TOLERANCE, the UART stops sending & receiving
+ * (counted in BaudErrors) until a clock change or SERIAL_SetBaud() gives
+ * a usable rate.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_SERIAL_H_
+#define NXP_LPC_SERIAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+#include "lpc11xx/uart.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_Serial LPC11xx Buffered UART Driver
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief Driver settings.
+  */
+typedef struct {
+    uint32_t Baud;                        /*!< Baud rate                        */
+    UART_RxFifoTrigger_Type RxTrigger;    /*!< Receive interrupt level          */
+    uint8_t *RxBuffer;                    /*!< Receive ring                     */
+    uint16_t RxSize;                      /*!< Its size (power of 2)            */
+    uint8_t *TxBuffer;                    /*!< Transmit ring                    */
+    uint16_t TxSize;                      /*!< Its size (power of 2)            */
+    UART_FlowControl_Type FlowControl;    /*!< Hardware flow control            */
+    uint16_t RxLowWater;                  /*!< Throttled: resume at this level  */
+} SERIAL_Config_Type;
+
+/** @brief A piece of data to send in place, for SERIAL_Send().
+  *
+  * Owned by the caller, as is the data it points at; both must stay valid
+  * (& the data unchanged) until Done is called for it.
+  */
+typedef struct serial_txdesc {
+    const uint8_t *Data;                  /*!< Data to send                     */
+    uint16_t Length;                      /*!< Its length                       */
+    void (*Done)(struct serial_txdesc *desc);  /*!< Called (from the handler) once it's all in the FIFO, or 0 */
+    struct serial_txdesc *Next;           /*!< (used by the library)            */
+    uint16_t Mark;                        /*!< (used by the library)            */
+    uint16_t Offset;                      /*!< (used by the library)            */
+} SERIAL_TxDesc_Type;
+
+/** @brief Driver statistics.
+  */
+typedef struct {
+    uint32_t Interrupts;                  /*!< Handler calls                    */
+    uint32_t RxBytes;                     /*!< Characters received              */
+    uint32_t TxBytes;                     /*!< Characters sent to the FIFO      */
+    uint32_t RxOverruns;                  /*!< Receive FIFO overruns (lost data) */
+    uint32_t RxDropped;                   /*!< Characters lost to a full ring   */
+    uint32_t RxErrors;                    /*!< Parity / framing errors & breaks */
+    uint32_t RxThrottles;                 /*!< Times the receive ring filled    */
+    uint32_t BaudErrors;                  /*!< Clock changes with no usable baud */
+} SERIAL_Stats_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Depth of the UART's transmit FIFO */
+#define SERIAL_TX_FIFO_SIZE         16
+
+
+/* Exported Variables -------------------------------------------------------*/
+
+extern SERIAL_Stats_Type SERIAL_Stats;    /*!< Driver statistics (clear at will) */
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Set up UART0 & start the driver.
+  * @param[in]  config       Settings (the buffers must stay valid)
+  *
+  * Takes over PIO1_6 (RXD) & PIO1_7 (TXD), plus PIO1_5 (RTS) & PIO0_7
+  * (CTS) for flow control, sets 8N1 & enables the interrupt.
+  * @return                  0 on success, -1 if the main clock can't give
+  *                          the baud rate within CLOCK_BAUD_TOLERANCE
+  *                          (nothing is set up)
+  */
+extern int SERIAL_Init(const SERIAL_Config_Type *config);
+
+/** @brief Stop the driver & release UART0.
+  *
+  * Disables the interrupt & gives up the driver's GATE_UART0 reference.
+  * Queued data that hasn't gone out is dropped (SERIAL_Flush() first to
+  * send it), & SERIAL_Send() descriptors still queued never see Done.
+  */
+extern void SERIAL_Deinit(void);
+
+/** @brief Change the baud rate.
+  * @param[in]  baud         The new rate
+  * @return                  0 on success, -1 if it can't be made (the old
+  *                          rate is kept)
+  *
+  * Waits for queued data to go out first.
+  */
+extern int SERIAL_SetBaud(uint32_t baud);
+
+/** @brief Queue data to send, without blocking.
+  * @param[in]  data         The data
+  * @param[in]  len          Its length
+  * @return                  Bytes queued (less than len if the ring filled)
+  */
+extern unsigned int SERIAL_Write(const uint8_t *data, unsigned int len);
+
+/** @brief Queue data to send in place, without copying or blocking.
+  * @param[in]  descs        The descriptors (Data, Length & Done filled in)
+  * @param[in]  count        How many
+  *
+  * Sent after anything already queued, in order; each descriptor's Done
+  *  is called from the interrupt handler once it's in the FIFO, after
+  *  which it & its data may be reused.
+  */
+extern void SERIAL_Send(SERIAL_TxDesc_Type *descs, unsigned int count);
+
+/** @brief Take received data, without blocking.
+  * @param[out] data         Where to put it
+  * @param[in]  len          Most to take
+  * @return                  Bytes taken
+  */
+extern unsigned int SERIAL_Read(uint8_t *data, unsigned int len);
+
+/** @brief Get the number of received bytes waiting.
+  * @return                  Bytes in the receive ring
+  */
+extern unsigned int SERIAL_RxCount(void);
+
+/** @brief Get the room left for sending.
+  * @return                  Free bytes in the transmit ring
+  */
+extern unsigned int SERIAL_TxFree(void);
+
+/** @brief Wait for everything queued to be sent.
+  */
+extern void SERIAL_Flush(void);
+
+/** @brief UART0 interrupt handler.
+  */
+extern void SERIAL_IRQHandler(void);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_SERIAL_H_ */
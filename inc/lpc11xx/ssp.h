@@ -66,6 +66,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_SSP_H
+
 
 /**
   * @defgroup SSP_AbstractionLayer SSP (Synchronous Serial Peripheral) Abstraction layer
@@ -118,9 +122,9 @@ typedef enum {
 } SSP_FrameFormat_Type;
 
 /*! @brief Macro to test whether parameter is a valid SSP Frame Format value */
-#define SSP_IS_FRAMEFORMAT(FrameFormat) (((FrameFormat) == SSP_FrameFormatSPI)\
-                                      || ((FrameFormat) == SSP_FrameFormatTI) \
-                                      || ((FrameFormat) == SSP_FrameFormatMW))
+#define SSP_IS_FRAMEFORMAT(FrameFormat) (((FrameFormat) == SSP_FrameFormat_SPI)\
+                                      || ((FrameFormat) == SSP_FrameFormat_TI) \
+                                      || ((FrameFormat) == SSP_FrameFormat_MW))
 
 /** @} */
 
@@ -135,8 +139,8 @@ typedef enum {
 } SSP_ClockPolarity_Type;
 
 /*! @brief Macro to test whether parameter is a valid SSP Clock Polarity value */
-#define SSP_IS_CLOCKPOLARITY(Polarity) (((Polarity) == SSP_ClockPolarityLow) \
-                                     || ((Polarity) == SSP_ClockPolarityHigh))
+#define SSP_IS_CLOCKPOLARITY(Polarity) (((Polarity) == SSP_ClockPolarity_Low) \
+                                     || ((Polarity) == SSP_ClockPolarity_High))
 
 /** @} */
 
@@ -151,8 +155,8 @@ typedef enum {
 } SSP_ClockPhase_Type;
 
 /*! @brief Macro to test whether parameter is a valid SSP Clock Phase value */
-#define SSP_IS_CLOCKPHASE(Phase) (((Phase) == SSP_ClockPhaseA) \
-                               || ((Phase) == SSP_ClockPhaseB))
+#define SSP_IS_CLOCKPHASE(Phase) (((Phase) == SSP_ClockPhase_A) \
+                               || ((Phase) == SSP_ClockPhase_B))
 
 /** @} */
 
@@ -168,9 +172,9 @@ typedef enum {
 } SSP_Mode_Type;
 
 /*! @brief Macro to test whether parameter is a valid SSP Communication Mode value */
-#define SSP_IS_MODE(Mode) (((Mode) == SSP_ModeMaster) \
-                        || ((Mode) == SSP_ModeSlave)  \
-                        || ((Mode) == SSP_ModeSlaveInputOnly))
+#define SSP_IS_MODE(Mode) (((Mode) == SSP_Mode_Master) \
+                        || ((Mode) == SSP_Mode_Slave)  \
+                        || ((Mode) == SSP_Mode_SlaveInputOnly))
 
 /** @} */
 
@@ -201,46 +205,6 @@ typedef uint32_t SSP_ITMask_Type;
   * @{
   */
 
-/** @brief Send a word via an SSP.
-  * @param[in]  ssp          A pointer to the SSP instance
-  * @param[in]  word         A word to send
-  */
-__INLINE static void SSP_Send(SSP_Type *ssp, uint16_t word)
-{
-    ssp->DR = word;
-}
-
-/** @brief Retrieve a word from an SSP's receive FIFO.
-  * @param[in]  ssp          A pointer to the SSP instance
-  * @return                  The word read from the SSP's receive FIFO.
-  */
-__INLINE static uint16_t SSP_Recv(SSP_Type *ssp)
-{
-    return ssp->DR;
-}
-
-/** @brief Send & receive a word via the SSP.
-  * @param[in]  ssp          A pointer to the SSP instance
-  * @param[in]  word_out     A word to send
-  * @return                  The word read from the SSP's incoming FIFO.
-  */
-__INLINE static uint16_t SSP_Xfer(SSP_Type *ssp, uint16_t word_out)
-{
-    ssp->DR = word_out;
-    while (!SSP_RxIsAvailable(ssp));
-    return ssp->DR;
-}
-
-/** @brief Flush an SSP's receive FIFO.
-  * @param[in]  ssp          A pointer to the SSP instance
-  */
-__INLINE static void SSP_FlushRxFifo(SSP_Type *ssp)
-{
-    while (SSP_RxIsAvailable(ssp)) {
-        SSP_Recv(ssp);
-    }
-}
-
 /** @brief Enable loopback mode on an SSP.
   * @param[in]  ssp          A pointer to the SSP instance
   */
@@ -336,6 +300,46 @@ __INLINE static unsigned int SSP_IsBusy(SSP_Type *ssp)
     return (ssp->SR & SSP_BSY) ? 1:0;
 }
 
+/** @brief Send a word via an SSP.
+  * @param[in]  ssp          A pointer to the SSP instance
+  * @param[in]  word         A word to send
+  */
+__INLINE static void SSP_Send(SSP_Type *ssp, uint16_t word)
+{
+    ssp->DR = word;
+}
+
+/** @brief Retrieve a word from an SSP's receive FIFO.
+  * @param[in]  ssp          A pointer to the SSP instance
+  * @return                  The word read from the SSP's receive FIFO.
+  */
+__INLINE static uint16_t SSP_Recv(SSP_Type *ssp)
+{
+    return ssp->DR;
+}
+
+/** @brief Send & receive a word via the SSP.
+  * @param[in]  ssp          A pointer to the SSP instance
+  * @param[in]  word_out     A word to send
+  * @return                  The word read from the SSP's incoming FIFO.
+  */
+__INLINE static uint16_t SSP_Xfer(SSP_Type *ssp, uint16_t word_out)
+{
+    ssp->DR = word_out;
+    while (!SSP_RxIsAvailable(ssp));
+    return ssp->DR;
+}
+
+/** @brief Flush an SSP's receive FIFO.
+  * @param[in]  ssp          A pointer to the SSP instance
+  */
+__INLINE static void SSP_FlushRxFifo(SSP_Type *ssp)
+{
+    while (SSP_RxIsAvailable(ssp)) {
+        SSP_Recv(ssp);
+    }
+}
+
 /** @brief Enable specific interrupts on an SSP.
   * @param[in]  ssp          A pointer to the SSP instance
   * @param[in]  it_mask      A bitmask of SSP interrupts to enable
@@ -477,7 +481,7 @@ __INLINE static SSP_ClockPolarity_Type SSP_GetClockPolarity(SSP_Type *ssp)
   */
 __INLINE static void SSP_SetClockPhase(SSP_Type *ssp, SSP_ClockPhase_Type phase)
 {
-    lpclib_assert(SSP_IS_CLOCKPHASE(polarity));
+    lpclib_assert(SSP_IS_CLOCKPHASE(phase));
 
     ssp->CR0 = (ssp->CR0 & ~SSP_CPHA) | phase;
 }
@@ -486,7 +490,7 @@ __INLINE static void SSP_SetClockPhase(SSP_Type *ssp, SSP_ClockPhase_Type phase)
   * @param[in]  ssp          A pointer to the SSP instance
   * @return                  The clock line phase on which the SSP latches data.
   */
-__INLINE static SSP_ClockPhase_Type SSP_SetClockPhase(SSP_Type *ssp)
+__INLINE static SSP_ClockPhase_Type SSP_GetClockPhase(SSP_Type *ssp)
 {
     return ssp->CR0 & SSP_CPHA;
 }
@@ -548,6 +552,8 @@ __INLINE static unsigned int SSP_GetClockPrescaler(SSP_Type *ssp)
   */
 
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,167 @@
+/** ***************************************************************************
+ * @file     stack.h
+ * @brief    Stack usage measurement for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * _start paints all free RAM between the end of .noinit (_heap_start) and
+ * the stack pointer with STACK_PAINT_PATTERN before anything else runs.
+ * STACK_GetHighWater() scans up from the bottom for the first word that no
+ * longer holds the pattern, giving the deepest the stack has ever reached.
+ * This assumes nothing else (e.g. a heap) writes to that RAM.
+ *
+ * For a breakdown by interrupt nesting, STACK_StartSampling() runs SysTick
+ * at top priority; each tick STACK_SysTick_Handler records the stack depth
+ * of the code it interrupted, against that code's priority level.  Thread
+ * mode is level 0, an interrupt at the lowest priority level 1, and so on
+ * up to STACK_NUM_LEVELS - 1.  Nested interrupts always run at a higher
+ * level than the one they preempt, so the depth seen at level n covers up
+ * to n nested handlers.  Sampling can miss short-lived peaks; the painted
+ * high-water mark can't.
+ *
+ * SysTick can't preempt code at its own priority or above, so priority 0
+ * handlers, NMI & HardFault are never sampled: level STACK_NUM_LEVELS - 1
+ * always reads 0, & the deepest sampled level is STACK_NUM_LEVELS - 2.
+ * Stack used by priority 0 handlers only shows in STACK_GetHighWater().
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_STACK_H_
+#define NXP_LPC_STACK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include "lpc11xx.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_Stack LPC11xx Stack Usage Measurement
+  * @{
+  */
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Value painted over unused stack at boot */
+#define STACK_PAINT_PATTERN     0xa5a5a5a5UL
+
+/*! @brief Sampling levels: thread mode + one per interrupt priority level */
+#define STACK_NUM_LEVELS        (1 + (1 << __NVIC_PRIO_BITS))
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Get the space available to the stack.
+  * @return                  Bytes from _heap_start up to the initial stack pointer
+  */
+extern uint32_t STACK_GetSize(void);
+
+/** @brief Get the stack in use right now.
+  * @return                  Bytes between the current & initial stack pointer
+  */
+extern uint32_t STACK_GetUsed(void);
+
+/** @brief Get the deepest the stack has reached since boot.
+  * @return                  Bytes used at the deepest point
+  *
+  * Scans the painted area, so this takes time proportional to the free
+  * margin; don't call it from a time-critical path.
+  */
+extern uint32_t STACK_GetHighWater(void);
+
+/** @brief Get the stack space never touched since boot.
+  * @return                  STACK_GetSize() - STACK_GetHighWater()
+  */
+extern uint32_t STACK_GetFree(void);
+
+/** @brief Start sampling stack depth from SysTick.
+  * @param[in]  period       Core clocks between samples (1 - 0x1000000)
+  *
+  * Sets SysTick to interrupt at top priority (0), which keeps it from
+  * sampling other priority 0 handlers.  STACK_SysTick_Handler must be
+  * the SysTick handler, e.g. with ISR_SetHandler(SysTick_IRQn,
+  * STACK_SysTick_Handler) or by linking with
+  * -Wl,--defsym=SysTick_Handler=STACK_SysTick_Handler.
+  */
+extern void STACK_StartSampling(uint32_t period);
+
+/** @brief Stop sampling stack depth (turns SysTick off).
+  */
+extern void STACK_StopSampling(void);
+
+/** @brief Get the deepest stack sampled at a level.
+  * @param[in]  level        0 for thread mode, up to STACK_NUM_LEVELS - 1
+  * @return                  Bytes in use when interrupted at that level
+  *                          (always 0 for STACK_NUM_LEVELS - 1, priority 0)
+  */
+extern uint32_t STACK_GetDeepest(unsigned int level);
+
+/** @brief Forget the sampled depths.
+  */
+extern void STACK_ClearDeepest(void);
+
+/** @brief SysTick handler that samples stack depth.
+  *
+  * After sampling, calls STACK_SysTickHook(), so other per-tick work can
+  * share SysTick.
+  */
+extern void STACK_SysTick_Handler(void);
+
+/** @brief Called from STACK_SysTick_Handler() after each sample.
+  *
+  * Does nothing by default; define this to hook the tick.
+  */
+extern void STACK_SysTickHook(void);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_STACK_H_ */
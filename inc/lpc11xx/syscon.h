@@ -62,6 +62,11 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_SYSCON_H
+#include "lpc11xx/clock.h"
+
 
 /**
   * @defgroup SYSCON_AbstractionLayer SYSCON (System Control Block) Abstraction Layer
@@ -530,6 +535,7 @@ __INLINE static void SYSCON_SetWDTOscDivider(unsigned int divider)
 
     SYSCON->WDTOSCCTRL = (SYSCON->WDTOSCCTRL & ~SYSCON_WDTOSCCTRL_DIV_Mask)
                           | ((divider >> 1) - 1);
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get the current divider of the watchdog timer oscillator.
@@ -549,6 +555,7 @@ __INLINE static void SYSCON_SetWDTOscFreq(SYSCON_WDTOscFreq_Type freq)
 
     SYSCON->WDTOSCCTRL = (SYSCON->WDTOSCCTRL & ~SYSCON_WDTOSCCTRL_FREQSEL_Mask)
                          | (freq << SYSCON_WDTOSCCTRL_FREQSEL_Shift);
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get the current frequency setting of the watchdog timer oscillator.
@@ -638,6 +645,7 @@ __INLINE static void SYSCON_EnableSysPLLClockSourceUpdate(void)
     SYSCON->SYSPLLCLKUEN = SYSCON_SYSPLLUEN_ENA;
     SYSCON->SYSPLLCLKUEN = 0;
     SYSCON->SYSPLLCLKUEN = SYSCON_SYSPLLUEN_ENA;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Test whether the system PLL clock source has updated.
@@ -665,6 +673,7 @@ __INLINE static void SYSCON_SetSysPLLClockScaler(unsigned int scaler)
     lpclib_assert((scaler & ~(SYSCON_SYSPLLCTRL_MSEL_Mask | SYSCON_SYSPLLCTRL_PSEL_Mask)) == 0);
 
     SYSCON->SYSPLLCTRL = scaler;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get the current system PLL scaler (M and P) setting.
@@ -687,6 +696,7 @@ __INLINE static void SYSCON_SetSysPLLMVal(unsigned int m)
     lpclib_assert((m & ~(SYSCON_SYSPLLCTRL_MSEL_Mask)) == 0);
 
     SYSCON->SYSPLLCTRL = (SYSCON->SYSPLLCTRL & ~SYSCON_SYSPLLCTRL_MSEL_Mask) | m;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief  Get the current system PLL M (multiplier) value.
@@ -706,6 +716,7 @@ __INLINE static void SYSCON_SetSysPLLPVal(unsigned int p)
 
     SYSCON->SYSPLLCTRL = (SYSCON->SYSPLLCTRL & ~SYSCON_SYSPLLCTRL_PSEL_Mask)
                           | (p << SYSCON_SYSPLLCTRL_PSEL_Shift);
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get the current system PLL P (divider) value.
@@ -750,6 +761,7 @@ __INLINE static void SYSCON_EnableMainClockSourceUpdate(void)
     SYSCON->MAINCLKUEN = SYSCON_MAINCLKUEN_ENA;
     SYSCON->MAINCLKUEN = 0;
     SYSCON->MAINCLKUEN = SYSCON_MAINCLKUEN_ENA;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Test whether the main clock source has updated.
@@ -773,6 +785,7 @@ __INLINE static void SYSCON_SetAHBClockDivider(unsigned int divider)
     lpclib_assert(divider <= 255);
 
     SYSCON->SYSAHBCLKDIV = divider;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get the current AHB clock divider.
@@ -819,6 +832,7 @@ __INLINE static void SYSCON_SetSSP0ClockDivider(unsigned int divider)
     lpclib_assert(divider <= 255);
 
     SYSCON->SSP0CLKDIV = divider;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get SSP0's main clock divider.
@@ -837,6 +851,7 @@ __INLINE static void SYSCON_SetSSP1ClockDivider(unsigned int divider)
     lpclib_assert(divider <= 255);
 
     SYSCON->SSP1CLKDIV = divider;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get SSP1's main clock divider.
@@ -855,6 +870,7 @@ __INLINE static void SYSCON_SetUART0ClockDivider(unsigned int divider)
     lpclib_assert(divider <= 255);
 
     SYSCON->UART0CLKDIV = divider;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get UART0's main clock divider.
@@ -898,6 +914,7 @@ __INLINE static void SYSCON_EnableWDTClockSourceUpdate(void)
     SYSCON->WDTCLKUEN = SYSCON_WDTCLKUEN_ENA;
     SYSCON->WDTCLKUEN = 0;
     SYSCON->WDTCLKUEN = SYSCON_WDTCLKUEN_ENA;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief  Test whether the watchdog timer's clock source has successfully updated.
@@ -919,6 +936,7 @@ __INLINE static void SYSCON_SetWDTClockDivider(unsigned int divider)
     lpclib_assert(divider <= 255);
 
     SYSCON->WDTCLKDIV = divider;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get the current watchdog timer input clock divider.
@@ -962,6 +980,7 @@ __INLINE static void SYSCON_EnableCLKOUTSourceUpdate(void)
     SYSCON->CLKOUTUEN = SYSCON_CLKOUTUEN_ENA;
     SYSCON->CLKOUTUEN = 0;
     SYSCON->CLKOUTUEN = SYSCON_CLKOUTUEN_ENA;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Test whether the CLKOUT clock source has successfully updated.
@@ -983,6 +1002,7 @@ __INLINE static void SYSCON_SetCLKOUTDivider(unsigned int divider)
     lpclib_assert(divider <= 255);
 
     SYSCON->CLKOUTDIV = divider;
+    CLOCK_InvalidateFrequencies();
 }
 
 /** @brief Get the current CLKOUT clock divider.
@@ -1239,6 +1259,8 @@ __INLINE static uint32_t SYSCON_GetDeviceID(void)
   */
 
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
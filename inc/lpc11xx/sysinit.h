@@ -0,0 +1,172 @@
+/** ***************************************************************************
+ * @file     sysinit.h
+ * @brief    Driver initialization registry for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * Drivers register an init routine with SYSINIT_BOOT() or SYSINIT_LAZY().
+ * Registrations are placed in the .init0 - .init7 sections (one per
+ * priority level) and gathered into a single table by the link scripts.
+ *
+ * At boot, after SystemInit() and before static constructors, _start runs
+ * every SYSINIT_BOOT() routine, level 0 first.  SYSINIT_LAZY() routines
+ * are skipped at boot; the driver instead calls SYSINIT_REQUIRE() on entry
+ * to its API, and the routine runs the first time that happens.  A product
+ * that never touches a peripheral never pays for bringing it up.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_SYSINIT_H_
+#define NXP_LPC_SYSINIT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_SysInit LPC11xx Driver Initialization Registry
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief When a registered init routine runs.
+  */
+typedef enum {
+    SYSINIT_When_Boot = 0,                /*!< From _start, before constructors */
+    SYSINIT_When_Lazy,                    /*!< On first SYSINIT_REQUIRE()       */
+} SYSINIT_When_Type;
+
+/** @brief One registered init routine (placed in flash by SYSINIT_BOOT() /
+  *        SYSINIT_LAZY(); don't declare these directly).
+  */
+typedef struct {
+    void (*Init)(void);                   /*!< Routine to call                  */
+    uint8_t *Done;                        /*!< Set non-zero once it has run     */
+    uint8_t When;                         /*!< SYSINIT_When_Type                */
+    uint8_t Level;                        /*!< Priority level (0 runs first)    */
+} SYSINIT_Entry_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Priority levels; a routine may depend on any at a lower level */
+#define SYSINIT_LEVEL_CORE        0       /*!< Clocks, power, memory            */
+#define SYSINIT_LEVEL_PLATFORM    2       /*!< Pin muxing, GPIO                 */
+#define SYSINIT_LEVEL_DRIVER      4       /*!< Peripheral drivers               */
+#define SYSINIT_LEVEL_APP         6       /*!< Application services             */
+#define SYSINIT_LEVEL_LAST        7
+
+/** @brief Register a routine to run at boot.
+  * @param[in]  name         Identifier for the registration
+  * @param[in]  level        Priority level, 0 - 7 (a literal or SYSINIT_LEVEL_*)
+  * @param[in]  fn           void fn(void) to call
+  */
+#define SYSINIT_BOOT(name, level, fn)   _SYSINIT_ENTRY(name, level, fn, SYSINIT_When_Boot)
+
+/** @brief Register a routine to run on first SYSINIT_REQUIRE(name).
+  * @param[in]  name         Identifier for the registration
+  * @param[in]  level        Priority level, 0 - 7; used by SYSINIT_RunLazy()
+  * @param[in]  fn           void fn(void) to call
+  */
+#define SYSINIT_LAZY(name, level, fn)   _SYSINIT_ENTRY(name, level, fn, SYSINIT_When_Lazy)
+
+/** @brief Declare a registration made in another file (for SYSINIT_REQUIRE()).
+  * @param[in]  name         Identifier given to SYSINIT_BOOT() / SYSINIT_LAZY()
+  */
+#define SYSINIT_DECLARE(name) \
+    extern uint8_t name##_sysinit_done; \
+    extern const SYSINIT_Entry_Type name##_sysinit
+
+/** @brief Make sure a registered routine has run, running it now if not.
+  * @param[in]  name         Identifier given to SYSINIT_BOOT() / SYSINIT_LAZY()
+  *
+  * Once the routine has run this is a single byte test.
+  */
+#define SYSINIT_REQUIRE(name) \
+    do { if (!name##_sysinit_done) { SYSINIT_Run(&name##_sysinit); } } while (0)
+
+/** @brief Has a registered routine run?
+  * @param[in]  name         Identifier given to SYSINIT_BOOT() / SYSINIT_LAZY()
+  */
+#define SYSINIT_IS_DONE(name)           (name##_sysinit_done != 0)
+
+/* The level goes into the section name, so it has to expand to a digit */
+#define _SYSINIT_ENTRY(name, level, fn, when)  _SYSINIT_ENTRY_(name, level, fn, when)
+#define _SYSINIT_ENTRY_(name, level, fn, when) \
+    uint8_t name##_sysinit_done; \
+    __attribute__((section(".init" #level), used, aligned(4))) \
+    const SYSINIT_Entry_Type name##_sysinit = { fn, &name##_sysinit_done, when, level }
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Run a registered routine if it hasn't run yet.
+  * @param[in]  entry        The registration
+  *
+  * Normally called through SYSINIT_REQUIRE().  Call from thread mode (not
+  * from an interrupt handler that may preempt the driver being set up).
+  */
+extern void SYSINIT_Run(const SYSINIT_Entry_Type *entry);
+
+/** @brief Run every SYSINIT_LAZY() routine that hasn't run yet, in level order.
+  *
+  * For when deferring isn't wanted after all (e.g. to keep first-use latency
+  * out of a time-critical path).
+  */
+extern void SYSINIT_RunLazy(void);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_SYSINIT_H_ */
@@ -71,6 +71,10 @@ extern "C" {
 #include "lpc11xx.h"
 #include "lpclib_assert.h"
 
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_UART_H
+
 
 /**
   * @defgroup UART_AbstractionLayer UART (Asynchronous Serial) Abstraction Layer
@@ -291,6 +295,26 @@ typedef enum {
 
 /** @} */
 
+/** @defgroup UART_FlowControl UART Hardware Flow Control Modes
+  * @{
+  */
+
+/*! @brief UART hardware flow control modes */
+typedef enum {
+    UART_FlowControl_None   = 0x00,                        /*!< No flow control                  */
+    UART_FlowControl_RTS    = 0x40,                        /*!< RTS drops at the Rx FIFO trigger */
+    UART_FlowControl_CTS    = 0x80,                        /*!< Tx waits for CTS                 */
+    UART_FlowControl_RTSCTS = 0xc0,                        /*!< Both                             */
+} UART_FlowControl_Type;
+
+/*! @brief Macro to test whether parameter is a valid flow control mode */
+#define UART_IS_FLOWCONTROL(FC) (((FC) == UART_FlowControl_None) \
+                              || ((FC) == UART_FlowControl_RTS) \
+                              || ((FC) == UART_FlowControl_CTS) \
+                              || ((FC) == UART_FlowControl_RTSCTS))
+
+/** @} */
+
 /**
   * @}
   */
@@ -531,7 +555,7 @@ __INLINE static void UART_SetDTR(UART_Type *uart, unsigned int state)
     if (state) {
         uart->MCR |= UART_DTR;
     } else {
-        uart->MCR &= UART_DTR;
+        uart->MCR &= ~UART_DTR;
     }
 }
 
@@ -553,7 +577,7 @@ __INLINE static void UART_SetRTS(UART_Type *uart, unsigned int state)
     if (state) {
         uart->MCR |= UART_RTS;
     } else {
-        uart->MCR &= UART_RTS;
+        uart->MCR &= ~UART_RTS;
     }
 }
 
@@ -616,6 +640,32 @@ __INLINE static uint8_t UART_AutoCTSIsEnabled(UART_Type *uart)
     return (uart->MCR & UART_CTSENA) ? 1:0;
 }
 
+/** @brief Set the hardware flow control used by an UART.
+  * @param[in]  uart         A pointer to the UART instance
+  * @param[in]  mode         The flow control mode
+  *
+  * Auto-RTS deasserts RTS when the Rx FIFO reaches its trigger level, &
+  *  reasserts it when the FIFO is read below it; auto-CTS holds off sending
+  *  the next character while CTS is deasserted.
+  *
+  * @note Only UART0 has the RTS0 / CTS0 pins; set them up with IOCON first.
+  */
+__INLINE static void UART_SetFlowControl(UART_Type *uart, UART_FlowControl_Type mode)
+{
+    lpclib_assert(UART_IS_FLOWCONTROL(mode));
+
+    uart->MCR = (uart->MCR & ~(UART_RTSENA | UART_CTSENA)) | mode;
+}
+
+/** @brief Get the hardware flow control used by an UART.
+  * @param[in]  uart         A pointer to the UART instance
+  * @return                  The flow control mode
+  */
+__INLINE static UART_FlowControl_Type UART_GetFlowControl(UART_Type *uart)
+{
+    return uart->MCR & (UART_RTSENA | UART_CTSENA);
+}
+
 /** @brief Set the number of bytes in an UART's Rx FIFO that will trigger an interrupt.
   * @param[in]  uart         A pointer to the UART instance
   * @param[in]  trigger      The new FIFO trigger setting
@@ -1087,6 +1137,8 @@ __INLINE static unsigned int UART_GetRS485DirDelay(UART_Type *uart)
   * @}
   */
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
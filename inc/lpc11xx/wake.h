@@ -0,0 +1,176 @@
+/** ***************************************************************************
+ * @file     wake.h
+ * @brief    Fast wake-up from deep-sleep on start logic inputs for NXP LPC11xx MCUs
+ * @version  V1.0
+ * @author   Tymm Twillman
+ * @date     February 2012
+ ******************************************************************************
+ * @section Overview
+ * For reacting quickly to outside events (a button, a radio's IRQ line)
+ * while drawing deep-sleep current.  Each start logic input (PIO0_0 -
+ * PIO0_11, PIO1_0) can be given a handler & an edge with WAKE_SetHandler();
+ * WAKE_Sleep() then deep-sleeps until one of them fires.
+ *
+ * Getting back to a PLL clock means waiting for it to lock, so before
+ * deep-sleeping the main clock is moved to the IRC, and only the IRC comes
+ * back up on the wake-up.  The handlers are called as soon as the core is
+ * running again, from the IRC and with interrupts still masked; peripherals
+ * clocked from the main clock run slow (or, if powered down, not at all)
+ * while they do.  A handler returns WAKE_Action_Sleep when it has dealt
+ * with the event, and the part goes straight back to deep-sleep without
+ * the PLL ever being started.  WAKE_Action_Run means there's more to do:
+ * the PLL & clocks are put back as they were and WAKE_Sleep() returns.
+ *
+ * Handlers are called from WAKE_Sleep() itself, so the WAKEUPn interrupt
+ * vectors (which the link scripts point at Reset_Handler) are never taken
+ * there.  To have the inputs' handlers run on edges while awake as well,
+ * install WAKE_IRQHandler on the vectors in use (ISR_SetHandler() or
+ * -Wl,--defsym=WAKEUPn_IRQHandler=WAKE_IRQHandler) & enable them with
+ * NVIC_EnableIRQ(WAKEUPn_IRQn); the return value is ignored there.
+ *
+ * The pins need to be set up (IOCON function, pull-ups) by the caller;
+ * the start logic sees the pin whatever its function.  Deep-sleep here is
+ * untimed: the watchdog oscillator isn't kept, so CT32B0 (lpc11xx/idle.h)
+ * stops & loses the time spent asleep.
+ *
+ * WAKE_Stats.LastLatency / MaxLatency are in core (IRC) clocks, from the
+ * core starting again to the first handler being called; the IRC's
+ * start-up after the edge (a few microseconds) comes before that.  They're
+ * measured with SysTick, and only if it isn't already in use.
+ ******************************************************************************
+ * @section License
+ * Licensed under a Simplified BSD License:
+ *
+ * Copyright (c) 2012, Timothy Twillman
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *        this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * TIMOTHY TWILLMAN OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of Timothy Twillman.
+ *****************************************************************************/
+
+#ifndef NXP_LPC_WAKE_H_
+#define NXP_LPC_WAKE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "lpc11xx.h"
+#include "lpc11xx/syscon.h"
+
+
+/**
+  * @ingroup LPC11xx_System LPC11xx Microcontroller System Interface
+  * @{
+  */
+
+/** @defgroup LPC11xx_Wake LPC11xx Fast Deep-Sleep Wake-up
+  * @{
+  */
+
+/* Types --------------------------------------------------------------------*/
+
+/** @brief What to do after a wake-up handler.
+  */
+typedef enum {
+    WAKE_Action_Sleep = 0,                /*!< Handled; deep-sleep again        */
+    WAKE_Action_Run                       /*!< Restore clocks & return          */
+} WAKE_Action_Type;
+
+/** @brief Wake-up handler.
+  * @param[in]  input        The start logic input that fired (0 - 12)
+  * @return                  What to do next
+  */
+typedef WAKE_Action_Type (*WAKE_Handler_Type)(unsigned int input);
+
+/** @brief Wake-up statistics.
+  */
+typedef struct {
+    uint32_t Wakes;                       /*!< Wake-ups from deep-sleep         */
+    uint32_t Runs;                        /*!< Of those, returns to full speed
+                                               for a handler                    */
+    uint32_t Interrupted;                 /*!< Returns (0) for other interrupts */
+    uint32_t LastLatency;                 /*!< Core clocks from wake-up to the
+                                               first handler (last wake-up)     */
+    uint32_t MaxLatency;                  /*!< Worst of those                   */
+} WAKE_Stats_Type;
+
+
+/* Macros -------------------------------------------------------------------*/
+
+/*! @brief Number of start logic inputs */
+#define WAKE_NUM_INPUTS             13
+
+/*! @brief Test for a valid start logic input number */
+#define WAKE_IS_INPUT(Input)        ((unsigned int)(Input) < WAKE_NUM_INPUTS)
+
+
+/* Exported Variables -------------------------------------------------------*/
+
+extern WAKE_Stats_Type WAKE_Stats;        /*!< Wake-up statistics (clear at will) */
+
+
+/* Exported Functions -------------------------------------------------------*/
+
+/** @brief Set (or clear) the handler for a start logic input.
+  * @param[in]  input        The input (0 - 11 for PIO0_n, 12 for PIO1_0)
+  * @param[in]  edge         The edge that triggers it
+  * @param[in]  handler      Called when it fires (0 to stop using the input)
+  */
+extern void WAKE_SetHandler(unsigned int input, SYSCON_WakeupEdge_Type edge,
+                            WAKE_Handler_Type handler);
+
+/** @brief Deep-sleep until a handler returns WAKE_Action_Run.
+  * @return                  Mask of inputs whose handlers asked to run
+  *                          (SYSCON_WakeupInput_*), or 0 if some other
+  *                          enabled interrupt is pending
+  *
+  * Call from thread mode.  Returns with the clocks as they were on entry.
+  * Interrupts stay masked inside, & WFI can't sleep while one is pending,
+  * so on a 0 return unmask them (if they were masked) to let it run, then
+  * call again.
+  */
+extern uint32_t WAKE_Sleep(void);
+
+/** @brief Start logic interrupt handler, for edges while awake.
+  */
+extern void WAKE_IRQHandler(void);
+
+/** @} */
+
+/**
+  * @}
+  */
+
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* #ifndef NXP_LPC_WAKE_H_ */
@@ -60,6 +60,11 @@ extern "C" {
 
 #include <stdint.h>
 #include "lpc11xx.h"
+#include "lpclib_assert.h"
+
+#pragma push_macro("LPCLIB_ASSERT_FILE_ID")
+#undef LPCLIB_ASSERT_FILE_ID
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_WDT_H
 
 
 /**
@@ -169,11 +174,11 @@ __INLINE static void WDT_Feed(void)
     uint32_t primask;
 
 
-    __asm__ __volatile__ ("    mrs    %0, primask":"=r"(primask));
+    primask = __get_PRIMASK();
     __disable_irq();
     WDT->FEED = WDT_Feed_A;
     WDT->FEED = WDT_Feed_B;
-    __asm__ __volatile__ ("    msr    primask, %0"::"r"(primask));
+    __set_PRIMASK(primask);
 }
 
 /** @brief Set the watchdog's timeout constant.
@@ -278,6 +283,8 @@ __INLINE static void WDT_GetWindow(void)
   */
 
 
+#pragma pop_macro("LPCLIB_ASSERT_FILE_ID")
+
 #ifdef __cplusplus
 };
 #endif
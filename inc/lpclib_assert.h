@@ -7,14 +7,32 @@
  ******************************************************************************
  * @section Overview
  * This file gives an interface to an assert function that can be used during
- * library debugging.  When enabled, any use of lpclib_assert() where the
- * passed in parameter evaluates to 0 will cause the program to jump into
- * an infinite loop.  This can be helpful in finding bugs in the library
- * code.  When disabled, lpclib_assert() does nothing.
+ * library debugging.  How much an lpclib_assert() costs, and what a failing
+ * one does, depends on LPCLIB_ASSERT_LEVEL:
  *
- * To enable the assert checking, define the symbol LPCLIB_DEBUG when
- * compiling the library, and when compiling any applications that use
- * the library.
+ * - LPCLIB_ASSERT_OFF (0): lpclib_assert() generates no code at all; the
+ *   condition is only type-checked (inside sizeof, so it is never
+ *   evaluated).  Accessors compile exactly as the raw register writes would.
+ * - LPCLIB_ASSERT_RECORD (1): a failure stores where it happened in a record
+ *   in .noinit RAM (which survives reset) and resets the chip.  Look at the
+ *   record with lpclib_assert_get_record() after start-up.
+ * - LPCLIB_ASSERT_FULL (2): a failure stores the record, then calls
+ *   lpclib_assert_failed(), which by default loops forever so a debugger
+ *   can be attached.
+ *
+ * Set the level with LPCLIB_ASSERT=off|record|full when using lpc11xx.mk, or
+ * define LPCLIB_ASSERT_LEVEL directly.  Use the same level for the library
+ * and the application.  If LPCLIB_ASSERT_LEVEL isn't defined, defining
+ * LPCLIB_DEBUG selects the full level, as in earlier releases.
+ *
+ * Where a check failed is kept as one 32-bit location, the file's ID in the
+ * upper half and the line in the lower, so no file name strings end up in
+ * flash.  A file that uses lpclib_assert() picks its ID by defining
+ * LPCLIB_ASSERT_FILE_ID before any includes; library files use the
+ * LPCLIB_ASSERT_ID_xxx values below, and a header with inline checks sets
+ * its own ID for its body only (push_macro / pop_macro).  Files that don't
+ * define one get LPCLIB_ASSERT_ID_NONE; applications are free to use IDs
+ * from LPCLIB_ASSERT_ID_APP up.
  ******************************************************************************
  * @section License
  * Licensed under a Simplified BSD License:
@@ -51,6 +69,8 @@
 #ifndef LPCLIB_ASSERT_H_
 #define LPCLIB_ASSERT_H_
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -61,21 +81,120 @@ extern "C" {
 
 /* Defines ------------------------------------------------------------------*/
 
-/*! assert()-like function wrapper used when LPC_LIB_DEBUG is set */
-#ifdef LPCLIB_DEBUG
-# define lpclib_assert(x) if ((x) == 0) { lpclib_assert_failed(); }
+/*! Assertion levels (values for LPCLIB_ASSERT_LEVEL) */
+#define LPCLIB_ASSERT_OFF      (0)    /*!< No checks, no code                  */
+#define LPCLIB_ASSERT_RECORD   (1)    /*!< Record the failure in RAM & reset   */
+#define LPCLIB_ASSERT_FULL     (2)    /*!< Record the failure & stop           */
+
+#ifndef LPCLIB_ASSERT_LEVEL
+# ifdef LPCLIB_DEBUG
+#  define LPCLIB_ASSERT_LEVEL  LPCLIB_ASSERT_FULL
+# else
+#  define LPCLIB_ASSERT_LEVEL  LPCLIB_ASSERT_OFF
+# endif
+#endif
+
+/*! Value of lpclib_assert_record.Magic when the record holds a failure */
+#define LPCLIB_ASSERT_MAGIC    (0xa55e7f1dUL)
+
+/*! File IDs (values for LPCLIB_ASSERT_FILE_ID) */
+#define LPCLIB_ASSERT_ID_NONE        (0)    /*!< File didn't set an ID          */
+
+#define LPCLIB_ASSERT_ID_CLOCK       (1)    /*!< src/lpc11xx_clock.c            */
+#define LPCLIB_ASSERT_ID_CLOCKSOLVE  (2)    /*!< src/lpc11xx_clocksolve.c       */
+#define LPCLIB_ASSERT_ID_GATE        (3)    /*!< src/lpc11xx_gate.c             */
+#define LPCLIB_ASSERT_ID_IDLE        (4)    /*!< src/lpc11xx_idle.c             */
+#define LPCLIB_ASSERT_ID_IRCCAL      (5)    /*!< src/lpc11xx_irccal.c           */
+#define LPCLIB_ASSERT_ID_ISR         (6)    /*!< src/lpc11xx_isr.c              */
+#define LPCLIB_ASSERT_ID_POWER_API   (7)    /*!< src/lpc11xx_power_api.c        */
+#define LPCLIB_ASSERT_ID_RETAIN      (8)    /*!< src/lpc11xx_retain.c           */
+#define LPCLIB_ASSERT_ID_RS485       (9)    /*!< src/lpc11xx_rs485.c            */
+#define LPCLIB_ASSERT_ID_SERIAL      (10)   /*!< src/lpc11xx_serial.c           */
+#define LPCLIB_ASSERT_ID_STACK       (11)   /*!< src/lpc11xx_stack.c            */
+#define LPCLIB_ASSERT_ID_SYSINIT     (12)   /*!< src/lpc11xx_sysinit.c          */
+#define LPCLIB_ASSERT_ID_WAKE        (13)   /*!< src/lpc11xx_wake.c             */
+
+#define LPCLIB_ASSERT_ID_ADC_H       (64)   /*!< inc/lpc11xx/adc.h              */
+#define LPCLIB_ASSERT_ID_CT16B_H     (65)   /*!< inc/lpc11xx/ct16b.h            */
+#define LPCLIB_ASSERT_ID_CT32B_H     (66)   /*!< inc/lpc11xx/ct32b.h            */
+#define LPCLIB_ASSERT_ID_FLASH_H     (67)   /*!< inc/lpc11xx/flash.h            */
+#define LPCLIB_ASSERT_ID_GPIO_H      (68)   /*!< inc/lpc11xx/gpio.h             */
+#define LPCLIB_ASSERT_ID_I2C_H       (69)   /*!< inc/lpc11xx/i2c.h              */
+#define LPCLIB_ASSERT_ID_IAP_H       (70)   /*!< inc/lpc11xx/iap.h              */
+#define LPCLIB_ASSERT_ID_IOCON_H     (71)   /*!< inc/lpc11xx/iocon.h            */
+#define LPCLIB_ASSERT_ID_PMU_H       (72)   /*!< inc/lpc11xx/pmu.h              */
+#define LPCLIB_ASSERT_ID_SSP_H       (73)   /*!< inc/lpc11xx/ssp.h              */
+#define LPCLIB_ASSERT_ID_SYSCON_H    (74)   /*!< inc/lpc11xx/syscon.h           */
+#define LPCLIB_ASSERT_ID_UART_H      (75)   /*!< inc/lpc11xx/uart.h             */
+#define LPCLIB_ASSERT_ID_WDT_H       (76)   /*!< inc/lpc11xx/wdt.h              */
+
+#define LPCLIB_ASSERT_ID_APP         (256)  /*!< First ID free for applications */
+
+#ifndef LPCLIB_ASSERT_FILE_ID
+# define LPCLIB_ASSERT_FILE_ID       LPCLIB_ASSERT_ID_NONE
+#endif
+
+/*! Pack a file ID & line into a location / unpack them again */
+#define LPCLIB_ASSERT_LOCATION(id, line) \
+    ((((uint32_t)(id)) << 16) | (((uint32_t)(line)) & 0xffff))
+#define LPCLIB_ASSERT_LOCATION_FILE(location)  (((uint32_t)(location)) >> 16)
+#define LPCLIB_ASSERT_LOCATION_LINE(location)  (((uint32_t)(location)) & 0xffff)
+
+/*! assert()-like function wrapper; see the overview for what each level does */
+#if (LPCLIB_ASSERT_LEVEL == LPCLIB_ASSERT_OFF)
+# define lpclib_assert(x) ((void)sizeof((x) == 0))
+#elif (LPCLIB_ASSERT_LEVEL == LPCLIB_ASSERT_RECORD)
+# define lpclib_assert(x) do { if ((x) == 0) { \
+    lpclib_assert_reset(LPCLIB_ASSERT_LOCATION(LPCLIB_ASSERT_FILE_ID, __LINE__)); } } while (0)
 #else
-# define lpclib_assert(x) do {} while(0)
+# define lpclib_assert(x) do { if ((x) == 0) { \
+    lpclib_assert_stop(LPCLIB_ASSERT_LOCATION(LPCLIB_ASSERT_FILE_ID, __LINE__)); } } while (0)
 #endif
 
 
+/* Types --------------------------------------------------------------------*/
+
+/*! @brief Record of the last assertion failure (kept in .noinit RAM) */
+typedef struct {
+    uint32_t    Magic;          /*!< LPCLIB_ASSERT_MAGIC if a failure is recorded */
+    uint32_t    Location;       /*!< File ID & line of the failing assertion     */
+    uint32_t    Count;          /*!< Failures since the record was last cleared  */
+} LPCLIB_AssertRecord_Type;
+
+
 /* Exported Functions -------------------------------------------------------*/
 
 /** @brief  Infinite loop function to trap assertion failures.
   * @return Does not return (infinite loop).
+  *
+  * Called at the full assertion level, after the failure is recorded.  This
+  * is declared weak so applications can override it.
   */
 extern void lpclib_assert_failed(void);
 
+/** @brief  Record an assertion failure & reset the chip.
+  * @param[in]  location     LPCLIB_ASSERT_LOCATION() of the failing assertion.
+  * @return Does not return.
+  */
+extern void lpclib_assert_reset(uint32_t location) __attribute__((noreturn));
+
+/** @brief  Record an assertion failure & call lpclib_assert_failed().
+  * @param[in]  location     LPCLIB_ASSERT_LOCATION() of the failing assertion.
+  * @return Does not return.
+  */
+extern void lpclib_assert_stop(uint32_t location) __attribute__((noreturn));
+
+/** @brief  Get the record of an assertion failure from before the last reset.
+  * @return The record, or (null) if none is recorded.
+  *
+  * The record is kept until lpclib_assert_clear_record() is called.
+  */
+extern const LPCLIB_AssertRecord_Type *lpclib_assert_get_record(void);
+
+/** @brief  Forget any recorded assertion failure.
+  */
+extern void lpclib_assert_clear_record(void);
+
 /**
   * @}
   */
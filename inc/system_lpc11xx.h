@@ -57,6 +57,27 @@ extern "C" {
   * @{
   */
 
+/* Types ----------------------------------------------------------------------------------------*/
+
+/** @brief Start of each boot phase, in core clocks since _start began.
+  *
+  * Filled in by _start (lpc11xx_crt0.c) before main() is called.  Phases up
+  * to SystemInit run from the 12MHz IRC; later ones at the clock SystemInit
+  * sets up, so e.g. the time spent clearing .bss is
+  * (Data - BSS) / IRC_Val seconds.  Time in the boot ROM before _start
+  * isn't included.
+  */
+typedef struct {
+    uint32_t StackPaint;                                   /*!< Painting free RAM (stack.h)      */
+    uint32_t BSS;                                          /*!< Clearing .bss                    */
+    uint32_t Data;                                         /*!< Copying .data & .ramfunc         */
+    uint32_t SystemInit;                                   /*!< SystemInit() (clock set-up)      */
+    uint32_t Drivers;                                      /*!< SYSINIT_BOOT() routines          */
+    uint32_t Constructors;                                 /*!< Global / static constructors     */
+    uint32_t Main;                                         /*!< Entry to main()                  */
+} SystemBootTimes_Type;
+
+
 /* Exported Variables ---------------------------------------------------------------------------*/
 
 /** @defgroup LPC11xx_System_Variables System-level Core Variables for LPC11xx MCUs
@@ -65,6 +86,9 @@ extern "C" {
 
 extern uint32_t SystemCoreClock;                           /*!< Speed of MCU Core Clock          */
 extern uint32_t SystemAHBClock;                            /*!< Speed of AHB Bus                 */
+extern SystemBootTimes_Type SystemBootTimes;               /*!< Boot phase timestamps            */
+extern uint8_t SystemResumed;                              /*!< 1 if woken from deep power-down
+                                                                with retained state (retain.h) */
 
 /** @} */
 
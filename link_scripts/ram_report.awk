@@ -0,0 +1,79 @@
+# ram_report.awk : report the RAM an image uses & how much each LPC11xx
+#                  model would have left over.
+#
+# Usage: size -A -d image.elf | awk -f ram_report.awk - lpc11xx-rom.ld...
+#
+# Sections counted are those linked into RAM (.data, .ramfunc, .bss,
+# .noinit & the minimum stack reserved by ._checkstack), plus the top of
+# RAM that the link scripts keep free for IAP calls.  Heap use beyond that
+# isn't known until run time.  An image linked for one model uses the same
+# RAM on the others, so this shows which parts it would fit.
+#
+# Author: Tymm Twillman <tymm@gmail.com>
+# Date:   February 2012
+
+BEGIN {
+    ram_base = 268435456        # 0x10000000
+    ram_limit = ram_base + 65536
+    n = 0
+    models = 0
+    total = 0
+}
+
+{
+    sub(/\r$/, "")
+}
+
+# size -A -d: "section  size  addr"
+FILENAME == "-" {
+    if ((NF == 3) && ($2 ~ /^[0-9]+$/) && ($3 >= ram_base) && ($3 < ram_limit) && ($2 > 0)) {
+        section[n] = $1
+        bytes[n++] = $2
+        total += $2
+    }
+    next
+}
+
+# Link scripts: "ram (xrw)  : ORIGIN = 0x10000000, LENGTH = 8K" and
+#  "_stack = ORIGIN(ram) + LENGTH(ram) - 36;"
+/^ *ram *\(/ {
+    length_str = $0
+    sub(/.*LENGTH *= */, "", length_str)
+    ram_bytes = length_str + 0
+    if (length_str ~ /^[0-9]+[Kk]/) {
+        ram_bytes *= 1024
+    }
+
+    model = FILENAME
+    sub(/.*\//, "", model)
+    sub(/-rom\.ld$/, "", model)
+
+    name[models] = model
+    size[models++] = ram_bytes
+    next
+}
+
+/^_stack *=.*LENGTH\(ram\) *- *[0-9]+/ {
+    reserve = $0
+    sub(/.*- */, "", reserve)
+    iap_reserve = reserve + 0
+    next
+}
+
+END {
+    printf "RAM used (bytes):\n\n"
+    for (i = 0; i < n; i++) {
+        printf "  %-16s %6d%s\n", section[i], bytes[i],
+               (section[i] == "._checkstack") ? "  (minimum stack)" : ""
+    }
+    printf "  %-16s %6d\n", "IAP reserve", iap_reserve
+    total += iap_reserve
+    printf "  %-16s %6d\n\n", "total", total
+
+    printf "  %-16s %6s %6s\n", "model", "ram", "free"
+    for (i = 0; i < models; i++) {
+        free_bytes = size[i] - total
+        printf "  %-16s %6d %6d%s\n", name[i], size[i], free_bytes,
+               (free_bytes < 0) ? "  DOES NOT FIT" : ""
+    }
+}
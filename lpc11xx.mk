@@ -22,11 +22,42 @@
 #       run (NOT the external / internal oscillator speed).
 #       e.g. 60000000L for 60 MHz operation.
 #
+#     HOST_CC (defaults to gcc)
+#       Native compiler used for liblpc11xx-host.a, the variant of the
+#       library that runs on the build machine against simulated
+#       peripherals (see host/inc/lpc11xx_host.h), and for the
+#       lpc11xx-sim instruction set simulator.
+#
 #     HSE_Val (no default value; must be explicitly set)
 #       This is the speed of an external crystal / oscillator
 #       from which the CPU's internal (F_CPU) frequency will be derived
 #       (generally 8Mhz, 12Mhz, etc.)
 #
+#       F_CPU & HSE_Val are checked at compile time (and the PLL / flash
+#       settings derived from them) by inc/lpc11xx/clock_config.h, which
+#       also takes optional AHB / UART0 / SSP settings as -D flags.
+#
+#     LPCLIB_ASSERT (defaults to full)
+#       How much parameter checking the library's inline functions do
+#       (see inc/lpclib_assert.h):
+#         off    -- none; no code generated for the checks
+#         record -- a failed check is logged to RAM & the chip is reset
+#         full   -- a failed check is logged, then the CPU loops forever
+#       Build the library and the application with the same setting.
+#
+#     LPC11XX_DATA_LZ (defaults to off)
+#       Set to 1 to store .data's initial values compressed in flash &
+#       have _start unpack them (the default %.elf rule, or use
+#       $(LPC11XX_LINK_LZ) as the recipe of your own link rule).  Saves
+#       flash on small parts at the cost of boot time; each link reports
+#       both.  Needs lpc11xx-pack (LPC11XX_PACK) on the path; set
+#       LPC11XX_SIM to an lpc11xx-sim to have boot cycles measured.
+#
+#     LPC11XX_DPD_RESUME_IRC (defaults to off)
+#       Set to 1 to have SystemInit leave the core on the 12MHz IRC after
+#       a wake-up from deep power-down with retained state (see
+#       inc/lpc11xx/retain.h), skipping crystal & PLL start-up.
+#
 # I'm happy to take suggestions on making this all work better :/
 
 
@@ -52,7 +83,7 @@ CPU             := $(if $(CPU),$(CPU),cortex-m0)
 # If making the library, make sure that the necessary options have been set on
 #  command line.
 
-ifeq ($(filter liblpc11xx.a, $(MAKECMDGOALS)),liblpc11xx.a)
+ifneq ($(filter liblpc11xx.a liblpc11xx-host.a lpc11xx-sim check, $(MAKECMDGOALS)),)
   ifeq ("$(LPC11XX_MODEL)","")
     $(error "LPC11XX_MODEL not defined.  Please set this to the model of chip (e.g. LPC11XX_MODEL=lpc1114)")
   endif
@@ -62,13 +93,25 @@ ifeq ($(filter liblpc11xx.a, $(MAKECMDGOALS)),liblpc11xx.a)
   endif
 endif
 
+LPCLIB_ASSERT   := $(if $(LPCLIB_ASSERT),$(LPCLIB_ASSERT),full)
+
+ifeq ($(filter off record full,$(LPCLIB_ASSERT)),)
+  $(error "LPCLIB_ASSERT must be off, record or full (is $(LPCLIB_ASSERT))")
+endif
+
+LPCLIB_ASSERT_LEVEL := $(if $(filter off,$(LPCLIB_ASSERT)),0,$(if $(filter record,$(LPCLIB_ASSERT)),1,2))
+
 # For the lpc1100 device library's use
-LPC11XXLIB_FLAGS := -D$(LPC11XX_MODEL) -DF_CPU=$(F_CPU) -DLPCLIB_DEBUG
+LPC11XXLIB_FLAGS := -D$(LPC11XX_MODEL) -DF_CPU=$(F_CPU) -DLPCLIB_ASSERT_LEVEL=$(LPCLIB_ASSERT_LEVEL)
 
 ifneq ("$(HSE_Val)","")
   LPC11XXLIB_FLAGS += -DHSE_Val=$(HSE_Val)
 endif
 
+ifeq ($(LPC11XX_DPD_RESUME_IRC),1)
+  LPC11XXLIB_FLAGS += -DLPC11XX_DPD_RESUME_IRC=1
+endif
+
 # CPU machine flags
 override LPC11XX_MACHINE_FLAGS   += -mlittle-endian -mlong-calls -msoft-float \
                                     -mcpu=$(CPU) -mthumb
@@ -87,6 +130,16 @@ LPC11XX_LDFLAGS   += $(LPC11XX_MACHINE_FLAGS) -nostartfiles \
                     -T$(LPC11XXLIB_DIR)/link_scripts/$(LPC11XX_MODEL)-rom.ld
 LPC11XX_ARFLAGS   := -rs
 
+# Host-native build: the host/inc stand-in for the CMSIS core header comes
+#  first so the *_BASE pointers land in the simulated register file.
+
+HOST_CC              ?= gcc
+HOST_AR              ?= ar
+LPC11XX_HOST_INCLUDE += -I$(LPC11XXLIB_DIR)/host/inc -I$(LPC11XXLIB_DIR)/inc
+LPC11XX_HOST_CFLAGS  += $(LPC11XXLIB_FLAGS) $(LPC11XX_HOST_INCLUDE) \
+                        $(LPC11XX_OPTIMIZE) $(LPC11XX_WARN)
+LPC11XX_HOST_LIBS    += -L. -llpc11xx-host
+
 # Set defaults for general compiler / linker flags (can be overriden on command
 #  line without affecting library build)
 
@@ -108,19 +161,70 @@ STRIP             = $(CROSS_COMPILE)strip
 RANLIB            = $(CROSS_COMPILE)ranlib
 OBJDUMP           = $(CROSS_COMPILE)objdump
 OBJCOPY           = $(CROSS_COMPILE)objcopy
-
+SIZE              = $(CROSS_COMPILE)size
+
+
+# Packed .data: linked in two passes against a variant of the model's link
+#  script whose .data has no image in flash.  The first pass gives .data's
+#  contents to pack; the second adds the packed image (.data_lz, after all
+#  other code) & must lay .data out the same, which is checked.  The
+#  unpacker is linked into both passes so code addresses don't move.
+
+LPC11XX_PACK       ?= lpc11xx-pack
+LPC11XX_SIM        ?=
+LPC11XX_LZ_SCRIPT   = $(LPC11XX_MODEL)-rom-lz.ld
+LPC11XX_LZ_LDFLAGS  = $(LPC11XX_MACHINE_FLAGS) -nostartfiles -T$(LPC11XX_LZ_SCRIPT) \
+                      -Wl,-u,_meminit_unpack
+
+$(LPC11XX_LZ_SCRIPT): $(LPC11XXLIB_DIR)/link_scripts/$(LPC11XX_MODEL)-rom.ld
+	sed '/^    \.data : {/,/AT > flash/ s/ AT > flash//' $< > $@
+
+# Flash image (without .dataflash) of $(1), for comparing sizes
+lpc11xx_flash_bin = $(OBJCOPY) -j .text -j .data -j .ramfunc -j .data_lz -O binary $(1) $(1).bin
+
+# Boot cycles of $(1) up to main(), using lpc11xx-sim
+lpc11xx_boot_cycles = `$(LPC11XX_SIM) -t -o $(1).boot -u main $(1) > /dev/null; \
+                       awk -F '\t' '$$1 == "\# cycles" { print $$2 }' $(1).boot`
+
+define LPC11XX_LINK_LZ
+	$(CC) $(LDFLAGS) -o $@.plain $(filter %.o,$^) $(LIBS)
+	$(CC) $(LPC11XX_LZ_LDFLAGS) -o $@.pass1 $(filter %.o,$^) $(LIBS)
+	$(OBJCOPY) -j .data -O binary $@.pass1 $@.data
+	$(LPC11XX_PACK) -o $@.lz.s $@.data
+	$(AS) -o $@.lz.o $@.lz.s
+	$(CC) $(LPC11XX_LZ_LDFLAGS) -o $@ $(filter %.o,$^) $@.lz.o $(LIBS)
+	$(OBJCOPY) -j .data -O binary $@ $@.data.check
+	@cmp -s $@.data $@.data.check || { echo "$@: .data changed between link passes;" \
+	    "link without LPC11XX_DATA_LZ" >&2; rm -f $@; exit 1; }
+	$(OBJCOPY) --set-section-flags .data=alloc $@
+	@$(call lpc11xx_flash_bin,$@.plain); $(call lpc11xx_flash_bin,$@); \
+	  echo "$@: packed .data saves $$((`wc -c < $@.plain.bin` - `wc -c < $@.bin`)) bytes of flash"
+	$(if $(LPC11XX_SIM),@echo "$@: and adds $$(($(call lpc11xx_boot_cycles,$@) - \
+	    $(call lpc11xx_boot_cycles,$@.plain))) cycles to boot")
+endef
 
 # Default for building a binary.  Generally should be overriden.
 %.elf: liblpc11xx.a
+ifeq ($(LPC11XX_DATA_LZ),1)
+%.elf: %.o $(LPC11XX_LZ_SCRIPT)
+	$(LPC11XX_LINK_LZ)
+else
 %.elf: %.o
 	$(CC) $(LDFLAGS) $(LIBS) -o $@ $^
+endif
 
 # Defaults for other object building...
 %.hex: %.elf
-	$(OBJCOPY) -j .text -j .data -j .dataflash -O ihex $< $@
+	$(OBJCOPY) -j .text -j .data -j .ramfunc -j .data_lz -j .dataflash -O ihex $< $@
 
 %.srec: %.elf
-	$(OBJCOPY) -j .text -j .data -j .dataflash -O srec $< $@
+	$(OBJCOPY) -j .text -j .data -j .ramfunc -j .data_lz -j .dataflash -O srec $< $@
 
 %.bin: %.elf
-	$(OBJCOPY) -j .text -j .data -j .dataflash -O binary $< $@
+	$(OBJCOPY) -j .text -j .data -j .ramfunc -j .data_lz -j .dataflash -O binary $< $@
+
+# RAM used by an image, and what that leaves free on each model
+%.ram: %.elf
+	$(SIZE) -A -d $< | awk -f $(LPC11XXLIB_DIR)/link_scripts/ram_report.awk \
+	    - $(sort $(wildcard $(LPC11XXLIB_DIR)/link_scripts/*-rom.ld)) > $@
+	@cat $@
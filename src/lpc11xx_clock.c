@@ -0,0 +1,165 @@
+/******************************************************************************
+ * @file:    lpc11xx_clock.c
+ * @purpose: Runtime core clock changes & clock change notification
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_CLOCK
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "system_lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/clock_config.h"
+#include "lpc11xx/flash.h"
+#include "lpc11xx/syscon.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* Registered clock change notifiers */
+static CLOCK_Notifier_Type *CLOCK_Notifiers;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Get the frequency going into the system PLL.
+  * @return                  IRC or system oscillator frequency, in Hz
+  */
+static uint32_t CLOCK_PLLInputFrequency(void)
+{
+#ifdef HSE_Val
+    if (SYSCON_GetSysPLLClockSource() == SYSCON_SysPLLClockSource_SysOsc) {
+        return HSE_Val;
+    }
+#endif
+    return IRC_Val;
+}
+
+/** @brief Switch the main clock & wait for the switch to take effect.
+  * @param[in]  source       The new main clock source
+  */
+static void CLOCK_SwitchMainClock(SYSCON_MainClockSource_Type source)
+{
+    SYSCON_SetMainClockSource(source);
+    SYSCON_EnableMainClockSourceUpdate();
+    while (!SYSCON_MainClockSourceIsUpdated());
+}
+
+/** @brief Tell registered drivers about a clock change.
+  * @param[in]  event        Before or after the change
+  * @param[in]  coreClock    The new core clock, in Hz
+  */
+void CLOCK_Notify(CLOCK_Event_Type event, uint32_t coreClock)
+{
+    CLOCK_Notifier_Type *notifier;
+
+
+    for (notifier = CLOCK_Notifiers; notifier != 0; notifier = notifier->Next) {
+        notifier->Notify(event, coreClock);
+    }
+}
+
+/** @brief Get the flash wait states needed at a core clock.
+  * @param[in]  coreClock    Core clock, in Hz
+  * @return                  Wait states (0 - 2)
+  */
+unsigned int CLOCK_FlashWaitStates(uint32_t coreClock)
+{
+    return CLOCK_FLASH_WAITS(coreClock);
+}
+
+/** @brief Change the core clock.
+  * @param[in]  coreClock    Requested core clock, in Hz
+  * @return                  0 on success, -1 if it can't be generated
+  */
+int CLOCK_SetCoreFrequency(uint32_t coreClock)
+{
+    uint32_t clk_in = CLOCK_PLLInputFrequency();
+    uint32_t actual;
+    uint32_t primask;
+    int16_t scaler = -1;
+    int32_t err;
+
+
+    if (coreClock == clk_in) {
+        actual = clk_in;
+    } else {
+        scaler = PLL_ScalerCalc(clk_in, coreClock, &err);
+        if (scaler < 0) {
+            return -1;
+        }
+        actual = coreClock + err;
+    }
+
+    if (actual > CLOCK_MAX_CORE_CLOCK) {
+        return -1;
+    }
+
+    CLOCK_Notify(CLOCK_Event_PreChange, actual);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* Slow flash down first if speeding up */
+    if (CLOCK_FlashWaitStates(actual) > FLASH_GetWaitStates()) {
+        FLASH_SetWaitStates(CLOCK_FlashWaitStates(actual));
+    }
+
+    /* Run from the PLL input while the PLL is off / being changed */
+    CLOCK_SwitchMainClock(SYSCON_MainClockSource_SysPLLIn);
+    SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_SysPLL);
+
+    if (scaler >= 0) {
+        SYSCON_SetSysPLLClockScaler(scaler);
+        SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_SysPLL);
+        while (!SYSCON_SysPLLIsLocked());
+
+        CLOCK_SwitchMainClock(SYSCON_MainClockSource_SysPLLOut);
+    }
+
+    FLASH_SetWaitStates(CLOCK_FlashWaitStates(actual));
+
+    SystemCoreClockUpdate();
+
+    if (!primask) {
+        __enable_irq();
+    }
+
+    CLOCK_Notify(CLOCK_Event_PostChange, actual);
+
+    return 0;
+}
+
+/** @brief Register for clock change notifications.
+  * @param[in]  notifier     The registration (Notify filled in)
+  */
+void CLOCK_RegisterNotifier(CLOCK_Notifier_Type *notifier)
+{
+    lpclib_assert((notifier != 0) && (notifier->Notify != 0));
+
+    notifier->Next = CLOCK_Notifiers;
+    CLOCK_Notifiers = notifier;
+}
+
+/** @brief Stop clock change notifications.
+  * @param[in]  notifier     A registration passed to CLOCK_RegisterNotifier()
+  */
+void CLOCK_UnregisterNotifier(CLOCK_Notifier_Type *notifier)
+{
+    CLOCK_Notifier_Type **pp;
+
+
+    for (pp = &CLOCK_Notifiers; *pp != 0; pp = &(*pp)->Next) {
+        if (*pp == notifier) {
+            *pp = notifier->Next;
+            break;
+        }
+    }
+}
@@ -0,0 +1,447 @@
+/******************************************************************************
+ * @file:    lpc11xx_clocksolve.c
+ * @purpose: Clock tree solver (PLL, AHB & peripheral dividers)
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Pure arithmetic; no register access, so it is built into the host
+ * library as well.
+ *****************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_CLOCKSOLVE
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/syscon.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* PLL input range */
+#define CLOCK_MIN_PLL_INPUT     10000000UL
+#define CLOCK_MAX_PLL_INPUT     25000000UL
+
+/* Clocks per UART bit, SSP prescaler step & WDT count */
+#define CLOCK_UART_SCALE        16
+#define CLOCK_SSP_SCALE         2
+#define CLOCK_WDT_SCALE         4
+
+
+/* File-Local Types ---------------------------------------------------------*/
+
+/* Splits a total divider into its parts; returns 0 if it can't be done */
+typedef int (*CLOCK_Split_Type)(uint32_t k, uint16_t *parts);
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief clk / k, rounded to nearest.
+  */
+static uint32_t CLOCK_Div(uint32_t clk, uint32_t k)
+{
+    return (clk + k / 2) / k;
+}
+
+/** @brief clk / k, rounded to nearest (for k over 32 bits).
+  */
+static uint32_t CLOCK_Div64(uint64_t clk, uint64_t k)
+{
+    return (uint32_t)((clk + k / 2) / k);
+}
+
+/** @brief Error of clk / k from target, in ppm.
+  */
+static uint32_t CLOCK_ErrorPPM(uint32_t clk, uint64_t k, uint32_t target)
+{
+    uint64_t want = k * target;
+    uint64_t diff = (clk > want) ? clk - want : want - clk;
+
+
+    return (uint32_t)((diff * 1000000ULL + want / 2) / want);
+}
+
+/** @brief Split a SYSCON divider (1 - 255) alone.
+  */
+static int CLOCK_SplitSimple(uint32_t k, uint16_t *parts)
+{
+    if ((k < 1) || (k > 255)) {
+        return 0;
+    }
+
+    parts[0] = k;
+
+    return 1;
+}
+
+/** @brief Split k into SYSCON divider (1 - 255) * UART divisor (1 - 65535).
+  *
+  * The largest SYSCON divider that works is used (slowest UART clock).
+  */
+static int CLOCK_SplitUART(uint32_t k, uint16_t *parts)
+{
+    uint32_t d;
+
+
+    for (d = 255; d > 0; d--) {
+        if (((k % d) == 0) && ((k / d) <= 65535)) {
+            parts[0] = d;
+            parts[1] = k / d;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/** @brief Split k into SYSCON divider (1 - 255) * UART divisor (3 - 65535),
+  *        for use with the fractional divider.
+  *
+  * The largest SYSCON divider that works is used (slowest UART clock).
+  */
+static int CLOCK_SplitUARTFrac(uint32_t k, uint16_t *parts)
+{
+    uint32_t d;
+
+
+    for (d = (k / 3 < 255) ? k / 3 : 255; d > 0; d--) {
+        if (((k % d) == 0) && ((k / d) <= 65535)) {
+            parts[0] = d;
+            parts[1] = k / d;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/** @brief Greatest common divisor.
+  */
+static uint32_t CLOCK_GCD(uint32_t a, uint32_t b)
+{
+    uint32_t t;
+
+
+    while (b) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+/** @brief Split k into SYSCON divider (1 - 255) * prescaler / 2 (1 - 127)
+  *        * ticks per bit (1 - 256).
+  */
+static int CLOCK_SplitSSP(uint32_t k, uint16_t *parts)
+{
+    uint32_t d;
+    uint32_t c;
+    uint32_t r;
+
+
+    for (d = 255; d > 0; d--) {
+        if ((k % d) != 0) {
+            continue;
+        }
+
+        r = k / d;
+        for (c = (r + 255) / 256; c <= 127; c++) {
+            if ((r % c) == 0) {
+                parts[0] = d;
+                parts[1] = c * 2;
+                parts[2] = r / c;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/** @brief Find the total divider k, with clk / (scale * k) nearest target,
+  *        that can be split into legal parts.
+  * @return                  Error in ppm, or UINT32_MAX if nothing fits
+  */
+static uint32_t CLOCK_Nearest(uint32_t clk, uint32_t scale, uint32_t target,
+                              uint32_t kmin, uint32_t kmax,
+                              CLOCK_Split_Type split, uint16_t *parts)
+{
+    uint16_t lo_parts[3];
+    uint16_t hi_parts[3];
+    uint32_t k0;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t lo_err = UINT32_MAX;
+    uint32_t hi_err = UINT32_MAX;
+    uint32_t i;
+
+
+    k0 = clk / (scale * target);
+
+    /* Nearest legal divider at or below the ideal one (faster clock)... */
+    for (lo = (k0 < kmax) ? k0 : kmax; lo >= kmin && lo > 0; lo--) {
+        if (split(lo, lo_parts)) {
+            lo_err = CLOCK_ErrorPPM(clk, (uint64_t)scale * lo, target);
+            break;
+        }
+    }
+
+    /* ...and above it (slower clock) */
+    for (hi = (k0 + 1 > kmin) ? k0 + 1 : kmin; hi <= kmax; hi++) {
+        if (split(hi, hi_parts)) {
+            hi_err = CLOCK_ErrorPPM(clk, (uint64_t)scale * hi, target);
+            break;
+        }
+    }
+
+    /* Ties go to the slower clock */
+    if (hi_err <= lo_err) {
+        for (i = 0; i < 3; i++) {
+            parts[i] = hi_parts[i];
+        }
+        return hi_err;
+    }
+
+    for (i = 0; i < 3; i++) {
+        parts[i] = lo_parts[i];
+    }
+
+    return lo_err;
+}
+
+/** @brief Find the UART0 divider, divisor & fractional divider closest to
+  *        a baud rate.
+  * @param[in]  mainClock    Main clock, Hz
+  * @param[in]  baud         Wanted baud rate
+  * @param[out] setting      The best setting found
+  * @return                  0 on success, -1 if the rate can't be made
+  *                          within CLOCK_BAUD_TOLERANCE
+  */
+int CLOCK_SolveUARTBaud(uint32_t mainClock, uint32_t baud, CLOCK_UARTBaud_Type *setting)
+{
+    uint16_t parts[3];
+    uint32_t err;
+    uint32_t d;
+    uint32_t m;
+
+
+    lpclib_assert(setting != 0);
+    lpclib_assert(baud != 0);
+
+    setting->ErrorPPM = UINT32_MAX;
+
+    if (baud > mainClock / CLOCK_UART_SCALE) {
+        return -1;
+    }
+
+    /* Baud = main / (16 * divider * divisor * (1 + d / m)); d / m in lowest
+     *  terms, & no fraction (0 / 1) first so it wins ties
+     */
+    for (m = 1; m <= 15; m++) {
+        for (d = (m == 1) ? 0 : 1; d < m; d++) {
+            if ((d != 0) && (CLOCK_GCD(d, m) != 1)) {
+                continue;
+            }
+
+            err = CLOCK_Nearest(mainClock * m, CLOCK_UART_SCALE * (m + d), baud,
+                                d ? 3 : 1, 255UL * 65535UL,
+                                d ? CLOCK_SplitUARTFrac : CLOCK_SplitUART, parts);
+
+            if (err < setting->ErrorPPM) {
+                setting->ErrorPPM = err;
+                setting->Divider = parts[0];
+                setting->Divisor = parts[1];
+                setting->DivAddVal = d;
+                setting->MulVal = m;
+            }
+        }
+    }
+
+    if (setting->ErrorPPM == UINT32_MAX) {
+        return -1;
+    }
+
+    setting->ActualBaud = CLOCK_Div64((uint64_t)mainClock * setting->MulVal,
+                                      (uint64_t)CLOCK_UART_SCALE * setting->Divider
+                                      * setting->Divisor
+                                      * (setting->MulVal + setting->DivAddVal));
+
+    /* The closest is still reported, to show how far off it is */
+    return (setting->ErrorPPM <= CLOCK_BAUD_TOLERANCE) ? 0 : -1;
+}
+
+/** @brief Fill in everything after the main clock for one PLL setting.
+  * @return                  Total error in ppm, or UINT32_MAX if infeasible
+  */
+static uint32_t CLOCK_SolveDividers(const CLOCK_Targets_Type *targets,
+                                    CLOCK_Config_Type *config)
+{
+    uint32_t mainclk = config->MainClock;
+    uint64_t total;
+    uint32_t err;
+    uint32_t irc_err;
+    uint16_t parts[3];
+    uint16_t irc_parts[3];
+    CLOCK_UARTBaud_Type uart;
+
+
+    /* Core: don't go over the maximum core clock */
+    err = CLOCK_Nearest(mainclk, 1, targets->CoreClock,
+                        (mainclk + CLOCK_MAX_CORE_CLOCK - 1) / CLOCK_MAX_CORE_CLOCK, 255,
+                        CLOCK_SplitSimple, parts);
+    if (err == UINT32_MAX) {
+        return UINT32_MAX;
+    }
+    total = err;
+    config->AHBDivider = parts[0];
+    config->ActualCoreClock = CLOCK_Div(mainclk, parts[0]);
+
+    if (targets->UART0Baud) {
+        if (CLOCK_SolveUARTBaud(mainclk, targets->UART0Baud, &uart) < 0) {
+            return UINT32_MAX;
+        }
+        total += uart.ErrorPPM;
+        config->UART0Divider = uart.Divider;
+        config->UART0Divisor = uart.Divisor;
+        config->UART0DivAddVal = uart.DivAddVal;
+        config->UART0MulVal = uart.MulVal;
+        config->ActualUART0Baud = uart.ActualBaud;
+    }
+
+    if (targets->SSP0Clock) {
+        err = CLOCK_Nearest(mainclk, CLOCK_SSP_SCALE, targets->SSP0Clock,
+                            1, 255UL * 127UL * 256UL, CLOCK_SplitSSP, parts);
+        if (err == UINT32_MAX) {
+            return UINT32_MAX;
+        }
+        total += err;
+        config->SSP0Divider = parts[0];
+        config->SSP0Prescaler = parts[1];
+        config->SSP0TicksPerBit = parts[2];
+        config->ActualSSP0Clock = CLOCK_Div(mainclk, parts[0] * parts[1] * parts[2]);
+    }
+
+    if (targets->SSP1Clock) {
+        err = CLOCK_Nearest(mainclk, CLOCK_SSP_SCALE, targets->SSP1Clock,
+                            1, 255UL * 127UL * 256UL, CLOCK_SplitSSP, parts);
+        if (err == UINT32_MAX) {
+            return UINT32_MAX;
+        }
+        total += err;
+        config->SSP1Divider = parts[0];
+        config->SSP1Prescaler = parts[1];
+        config->SSP1TicksPerBit = parts[2];
+        config->ActualSSP1Clock = CLOCK_Div(mainclk, parts[0] * parts[1] * parts[2]);
+    }
+
+    if (targets->WDTTick) {
+        /* From the main clock or the IRC, whichever is closer (the IRC on
+         *  a tie, since it doesn't move with the core clock)
+         */
+        err = CLOCK_Nearest(mainclk, CLOCK_WDT_SCALE, targets->WDTTick,
+                            1, 255, CLOCK_SplitSimple, parts);
+        irc_err = CLOCK_Nearest(IRC_Val, CLOCK_WDT_SCALE, targets->WDTTick,
+                                1, 255, CLOCK_SplitSimple, irc_parts);
+        if (irc_err <= err) {
+            err = irc_err;
+            parts[0] = irc_parts[0];
+            config->WDTClockSource = SYSCON_WDTClockSource_IRC;
+            config->ActualWDTTick = CLOCK_Div(IRC_Val, CLOCK_WDT_SCALE * parts[0]);
+        } else {
+            config->WDTClockSource = SYSCON_WDTClockSource_MainClock;
+            config->ActualWDTTick = CLOCK_Div(mainclk, CLOCK_WDT_SCALE * parts[0]);
+        }
+        if (err == UINT32_MAX) {
+            return UINT32_MAX;
+        }
+        total += err;
+        config->WDTDivider = parts[0];
+    }
+
+    return (total >= UINT32_MAX) ? UINT32_MAX - 1 : (uint32_t)total;
+}
+
+/** @brief Is a candidate better than the best so far?
+  */
+static int CLOCK_IsBetter(const CLOCK_Config_Type *cand, const CLOCK_Config_Type *best)
+{
+    if (cand->ErrorPPM != best->ErrorPPM) {
+        return cand->ErrorPPM < best->ErrorPPM;
+    }
+
+    /* Lowest power: PLL off, then slowest CCO, then slowest main clock */
+    if (cand->CCOClock != best->CCOClock) {
+        return cand->CCOClock < best->CCOClock;
+    }
+
+    return cand->MainClock < best->MainClock;
+}
+
+/** @brief Find the clock tree configuration best matching a set of targets.
+  * @param[in]  targets      Wanted frequencies
+  * @param[out] config       The best configuration found
+  * @return                  0 on success, -1 if no legal configuration exists
+  */
+int CLOCK_Solve(const CLOCK_Targets_Type *targets, CLOCK_Config_Type *config)
+{
+    static const uint8_t pvals[] = {
+        SYSCON_SysPLLPVal_1, SYSCON_SysPLLPVal_2,
+        SYSCON_SysPLLPVal_4, SYSCON_SysPLLPVal_8
+    };
+    CLOCK_Config_Type cand;
+    uint32_t fin = targets->InputClock;
+    uint32_t m;
+    uint32_t p;
+    int found = 0;
+
+
+    lpclib_assert((targets != 0) && (config != 0));
+    lpclib_assert((targets->InputClock != 0) && (targets->CoreClock != 0));
+
+    /* m == 0: run from the PLL input, PLL off */
+    for (m = 0; m <= 32; m++) {
+        for (p = 0; p < sizeof(pvals); p++) {
+            cand = (CLOCK_Config_Type){ 0 };
+
+            if (m == 0) {
+                if (p > 0) {
+                    break;
+                }
+                cand.MainClock = fin;
+            } else {
+                if ((fin < CLOCK_MIN_PLL_INPUT) || (fin > CLOCK_MAX_PLL_INPUT)) {
+                    break;
+                }
+                cand.MainClock = fin * m;
+                cand.CCOClock = cand.MainClock * (2UL << pvals[p]);
+                if ((cand.MainClock > CLOCK_MAX_PLL_CLOCK)
+                    || (cand.CCOClock < CLOCK_MIN_CCO_CLOCK)
+                    || (cand.CCOClock > CLOCK_MAX_CCO_CLOCK))
+                {
+                    continue;
+                }
+                cand.UsePLL = 1;
+                cand.PLLScaler = (pvals[p] << SYSCON_SYSPLLCTRL_PSEL_Shift) | (m - 1);
+            }
+
+            cand.ErrorPPM = CLOCK_SolveDividers(targets, &cand);
+            if (cand.ErrorPPM == UINT32_MAX) {
+                continue;
+            }
+
+            if (!found || CLOCK_IsBetter(&cand, config)) {
+                *config = cand;
+                found = 1;
+            }
+        }
+    }
+
+    return found ? 0 : -1;
+}
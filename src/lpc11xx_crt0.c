@@ -47,6 +47,9 @@
 
 #include "lpc11xx.h"
 #include "lpc11xx/isr_vector.h"
+#include "lpc11xx/retain.h"
+#include "lpc11xx/stack.h"
+#include "lpc11xx/sysinit.h"
 #include "system_lpc11xx.h"
 
 
@@ -58,16 +61,39 @@ int main();
 /* These are provided by the linker */
 extern unsigned long _bss_start, _bss_end;
 extern unsigned long _data_start, _data_src_start, _data_end;
+extern unsigned long _ramfunc_start, _ramfunc_src_start, _ramfunc_end;
+extern unsigned long _data_lz_start, _data_lz_end;
 extern unsigned long _stack;
+extern unsigned long _heap_start;
 extern unsigned long __checksum__;
-extern unsigned long _init_array_start;
-extern unsigned long _init_array_end;
-extern unsigned long _fini_array_start;
-extern unsigned long _fini_array_end;
+extern void (* const _init_array_start[])(void);
+extern void (* const _init_array_end[])(void);
+extern void (* const _fini_array_start[])(void);
+extern void (* const _fini_array_end[])(void);
+extern const SYSINIT_Entry_Type _sysinit_start[];
+extern const SYSINIT_Entry_Type _sysinit_end[];
+
+/* Fast fill / copy for .bss & .data (lpc11xx_meminit.s) */
+extern void _meminit_zero(unsigned long *start, unsigned long *end);
+extern void _meminit_paint(unsigned long *start, unsigned long value);
+extern void _meminit_copy(unsigned long *dst, unsigned long *src, unsigned long *dst_end);
+
+/* Unpacker for a packed .data image; its address heads the image */
+typedef void (*Meminit_Unpack_Type)(unsigned long *dst, unsigned long *src, unsigned long *dst_end);
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Core clocks since _start started SysTick (it counts down) */
+#define BOOT_TIME()  (SysTick_LOAD_RELOAD_Msk - SysTick->VAL)
 
 
 /* System Global Variables --------------------------------------------------*/
 
+/*! @brief Boot phase timestamps; in .noinit so clearing .bss doesn't wipe them */
+__attribute__ ((section(".noinit")))
+SystemBootTimes_Type SystemBootTimes;
+
 /*! @brief System Exception & Interrupt Vectors */
 __attribute__ ((section(".boot_isr_vector")))
 const ISRVector_Type BootISRVector = {
@@ -123,24 +149,47 @@ void UndefinedException_Handler(void)
 }
 
 
+/** @brief Run the SYSINIT_BOOT() routines in the driver init registry
+  * @param None.
+  *
+  * @return None.
+  *
+  * Called on system bring-up, before global / static constructors.  The
+  * table is in priority order; SYSINIT_LAZY() entries are left for
+  * SYSINIT_REQUIRE().
+  */
+static void _sysinit_boot(void) __attribute__((section(".startup") ));
+static void _sysinit_boot()
+{
+    const SYSINIT_Entry_Type *entry;
+
+
+    for (entry = _sysinit_start; entry < _sysinit_end; entry++) {
+        if (entry->When == SYSINIT_When_Boot) {
+            *entry->Done = 1;
+            entry->Init();
+        }
+    }
+}
+
+
 /** @brief Function for iterating through & calling global / static constructors
   * @param None.
   *
   * @return None.
   *
-  * Called on system bring-up.
+  * Called on system bring-up.  .init_array.NNNNN sections (constructor
+  * priorities) are sorted ahead of plain .init_array by the link scripts,
+  * so lower priorities run first.
   */
 void __libc_init_array(void) __attribute__((weak, section(".startup") ));
 void __libc_init_array()
 {
-    unsigned long iptr;
+    void (* const *iptr)(void);
 
 
-    for (iptr = (unsigned long)&_init_array_start;
-         iptr < (unsigned long)&_init_array_end;
-         iptr++)
-    {
-        (*((void (*)())iptr))();
+    for (iptr = _init_array_start; iptr < _init_array_end; iptr++) {
+        (*iptr)();
     }
 }
 
@@ -150,19 +199,16 @@ void __libc_init_array()
   *
   * @return None.
   *
-  * Called on exit from main()
+  * Called on exit from main().  Runs in reverse order of construction.
   */
 void __libc_fini_array(void) __attribute__((weak, section(".startup") ));
 void __libc_fini_array()
 {
-    unsigned long fptr;
+    void (* const *fptr)(void);
 
 
-    for (fptr = (unsigned long)&_fini_array_start;
-         fptr < (unsigned long)&_fini_array_end;
-         fptr++)
-    {
-        (*((void (*)())fptr))();
+    for (fptr = _fini_array_end; fptr > _fini_array_start; ) {
+        (*--fptr)();
     }
 }
 
@@ -171,34 +217,64 @@ void __libc_fini_array()
   *
   * @return None.
   *
-  * Calls _sysinit() to prep hardware (core clocks, etc), then initializes BSS and
-  * DATA segments, calls global / static constructors, then calls main().
-  * If main() returns, calls global / static destructors then goes into an
-  * infinite loop.
+  * Checks for a wake-up from deep power-down with retained state
+  * (lpc11xx/retain.h; sets SystemResumed), paints free RAM for stack
+  * measurement (lpc11xx/stack.h) unless it was one, calls
+  * _sysinit() to prep hardware (core clocks, etc), then initializes BSS and
+  * DATA segments, copies RAM-resident functions into place, runs boot-time
+  * driver init routines (lpc11xx/sysinit.h), calls global / static
+  * constructors, then calls main().  If main() returns, calls global /
+  * static destructors then goes into an infinite loop.
+  *
+  * The start of each phase is recorded in SystemBootTimes, using SysTick as
+  * a core clock counter; SysTick is turned off again before main().
   */
 void _start(void) __attribute__((section (".startup") )) __attribute__((naked));
 void _start()
 {
-    unsigned long *x;
-    unsigned long *y;
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
 
-    /* Clear BSS area */
-    for (x = &_bss_start; x < &_bss_end; x++) {
-        *x = 0;
+    /* A wake-up from deep power-down wants to get to work quickly */
+    SystemResumed = RETAIN_CheckResume();
+
+    /* Paint the free RAM below the stack, for STACK_GetHighWater() */
+    SystemBootTimes.StackPaint = BOOT_TIME();
+    if (!SystemResumed) {
+        _meminit_paint(&_heap_start, STACK_PAINT_PATTERN);
     }
 
-    /* Copy data area from flash */
-    for (x = &_data_start,y = &_data_src_start; x < &_data_end; x++,y++) {
-        *x = *y;
+    /* Clear BSS area */
+    SystemBootTimes.BSS = BOOT_TIME();
+    _meminit_zero(&_bss_start, &_bss_end);
+
+    /* Copy data area & RAM-resident code (LPC11XX_RAMFUNC) from flash */
+    SystemBootTimes.Data = BOOT_TIME();
+    if (&_data_lz_end > &_data_lz_start) {
+        /* Packed image (LPC11XX_DATA_LZ in lpc11xx.mk) */
+        (*(Meminit_Unpack_Type *)&_data_lz_start)(&_data_start, &_data_lz_start + 1, &_data_end);
+    } else {
+        _meminit_copy(&_data_start, &_data_src_start, &_data_end);
     }
+    _meminit_copy(&_ramfunc_start, &_ramfunc_src_start, &_ramfunc_end);
 
+    SystemBootTimes.SystemInit = BOOT_TIME();
     SystemInit();
 
     /* Do after copying data, since SystemInit modifies some variables...
-     * Call global / static constructors
+     * Bring up registered drivers, then call global / static constructors
+     * (which may use them)
      */
+    SystemBootTimes.Drivers = BOOT_TIME();
+    _sysinit_boot();
+
+    SystemBootTimes.Constructors = BOOT_TIME();
     __libc_init_array();
 
+    SystemBootTimes.Main = BOOT_TIME();
+    SysTick->CTRL = 0;
+
     /* Call main() function... */
     main();
 
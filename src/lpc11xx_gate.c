@@ -0,0 +1,296 @@
+/******************************************************************************
+ * @file:    lpc11xx_gate.c
+ * @purpose: Reference-counted peripheral clock & power gating
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_GATE
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "lpc11xx/gate.h"
+#include "lpc11xx/syscon.h"
+
+
+/* Types --------------------------------------------------------------------*/
+
+/* Peripheral clock divider behind a line */
+typedef enum {
+    GATE_Divider_None = 0,
+    GATE_Divider_UART0,
+    GATE_Divider_SSP0,
+    GATE_Divider_SSP1,
+} GATE_Divider_Type;
+
+/* What turning a line on / off switches */
+typedef struct {
+    uint32_t AHBLine;                     /* SYSCON_AHBClockLine_*              */
+    uint8_t  PowerLine;                   /* SYSCON_AnalogPowerLine_* (or 0)    */
+    uint8_t  Divider;                     /* GATE_Divider_Type                  */
+} GATE_Control_Type;
+
+/* State of a line */
+typedef struct {
+    uint32_t Enables;
+    uint32_t EnabledTime;                 /* Up to the last turn-off            */
+    uint32_t EnabledAt;                   /* Time source count at turn-on       */
+    uint8_t  Users;
+    uint8_t  SavedDivider;                /* Divider while released             */
+} GATE_State_Type;
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+static const GATE_Control_Type GATE_Controls[GATE_NumLines] = {
+    [GATE_UART0]  = { SYSCON_AHBClockLine_UART0,  0, GATE_Divider_UART0 },
+    [GATE_SSP0]   = { SYSCON_AHBClockLine_SSP0,   0, GATE_Divider_SSP0 },
+    [GATE_SSP1]   = { SYSCON_AHBClockLine_SSP1,   0, GATE_Divider_SSP1 },
+    [GATE_ADC0]   = { SYSCON_AHBClockLine_ADC0,   SYSCON_AnalogPowerLine_ADC0, GATE_Divider_None },
+    [GATE_I2C0]   = { SYSCON_AHBClockLine_I2C0,   0, GATE_Divider_None },
+    [GATE_CT16B0] = { SYSCON_AHBClockLine_CT16B0, 0, GATE_Divider_None },
+    [GATE_CT16B1] = { SYSCON_AHBClockLine_CT16B1, 0, GATE_Divider_None },
+    [GATE_CT32B0] = { SYSCON_AHBClockLine_CT32B0, 0, GATE_Divider_None },
+    [GATE_CT32B1] = { SYSCON_AHBClockLine_CT32B1, 0, GATE_Divider_None },
+};
+
+static GATE_State_Type GATE_States[GATE_NumLines];
+
+/* Time source for accounting (none if 0) */
+static uint32_t (*GATE_Now)(void);
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Get a line's peripheral clock divider.
+  * @param[in]  divider      Which divider
+  * @return                  Its setting
+  */
+static unsigned int GATE_GetDivider(GATE_Divider_Type divider)
+{
+    switch (divider) {
+    case GATE_Divider_UART0:
+        return SYSCON_GetUART0ClockDivider();
+
+    case GATE_Divider_SSP0:
+        return SYSCON_GetSSP0ClockDivider();
+
+    case GATE_Divider_SSP1:
+        return SYSCON_GetSSP1ClockDivider();
+
+    default:
+        return 0;
+    }
+}
+
+/** @brief Set a line's peripheral clock divider.
+  * @param[in]  divider      Which divider
+  * @param[in]  value        The setting (0 stops the clock)
+  */
+static void GATE_SetDivider(GATE_Divider_Type divider, unsigned int value)
+{
+    switch (divider) {
+    case GATE_Divider_UART0:
+        SYSCON_SetUART0ClockDivider(value);
+        break;
+
+    case GATE_Divider_SSP0:
+        SYSCON_SetSSP0ClockDivider(value);
+        break;
+
+    case GATE_Divider_SSP1:
+        SYSCON_SetSSP1ClockDivider(value);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/** @brief Turn a line off.
+  * @param[in]  line         The line
+  */
+static void GATE_Off(GATE_Line_Type line)
+{
+    const GATE_Control_Type *control = &GATE_Controls[line];
+
+
+    if (control->Divider != GATE_Divider_None) {
+        GATE_States[line].SavedDivider = GATE_GetDivider(control->Divider);
+        GATE_SetDivider(control->Divider, 0);
+    }
+
+    if (control->PowerLine) {
+        SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, control->PowerLine);
+    }
+
+    SYSCON_DisableAHBClockLines(control->AHBLine);
+}
+
+/** @brief Turn off every managed peripheral that has no users.
+  */
+void GATE_Init(void)
+{
+    uint32_t primask;
+    unsigned int line;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (line = 0; line < GATE_NumLines; line++) {
+        if (GATE_States[line].Users == 0) {
+            GATE_Off(line);
+        }
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Start using a peripheral, turning it on if it's the first user.
+  * @param[in]  line         The peripheral
+  */
+void GATE_Acquire(GATE_Line_Type line)
+{
+    const GATE_Control_Type *control;
+    GATE_State_Type *state;
+    uint32_t primask;
+
+
+    lpclib_assert(GATE_IS_LINE(line));
+
+    control = &GATE_Controls[line];
+    state = &GATE_States[line];
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    lpclib_assert(state->Users < 0xff);
+
+    if (state->Users++ == 0) {
+        SYSCON_EnableAHBClockLines(control->AHBLine);
+
+        if (control->PowerLine) {
+            SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, control->PowerLine);
+        }
+
+        if (state->SavedDivider) {
+            GATE_SetDivider(control->Divider, state->SavedDivider);
+        }
+
+        state->Enables++;
+        if (GATE_Now) {
+            state->EnabledAt = GATE_Now();
+        }
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Stop using a peripheral, turning it off if it's the last user.
+  * @param[in]  line         The peripheral
+  */
+void GATE_Release(GATE_Line_Type line)
+{
+    GATE_State_Type *state;
+    uint32_t primask;
+
+
+    lpclib_assert(GATE_IS_LINE(line));
+
+    state = &GATE_States[line];
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    lpclib_assert(state->Users != 0);
+
+    if (--state->Users == 0) {
+        GATE_Off(line);
+
+        if (GATE_Now) {
+            state->EnabledTime += GATE_Now() - state->EnabledAt;
+        }
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Test whether a peripheral is on (has users).
+  * @param[in]  line         The peripheral
+  * @return                  1 if it's on, 0 otherwise.
+  */
+unsigned int GATE_IsEnabled(GATE_Line_Type line)
+{
+    lpclib_assert(GATE_IS_LINE(line));
+
+    return (GATE_States[line].Users != 0) ? 1:0;
+}
+
+/** @brief Set the clock used for time-enabled accounting.
+  * @param[in]  now          Function returning a free-running count (0 for none)
+  */
+void GATE_SetTimeSource(uint32_t (*now)(void))
+{
+    uint32_t primask;
+    unsigned int line;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* Lines already on count from here */
+    for (line = 0; line < GATE_NumLines; line++) {
+        if (GATE_States[line].Users && now) {
+            GATE_States[line].EnabledAt = now();
+        }
+    }
+
+    GATE_Now = now;
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Get use of a peripheral.
+  * @param[in]  line         The peripheral
+  * @param[out] stats        Where to put it
+  */
+void GATE_GetStats(GATE_Line_Type line, GATE_Stats_Type *stats)
+{
+    const GATE_State_Type *state;
+    uint32_t primask;
+
+
+    lpclib_assert(GATE_IS_LINE(line));
+    lpclib_assert(stats != 0);
+
+    state = &GATE_States[line];
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    stats->Enables = state->Enables;
+    stats->EnabledTime = state->EnabledTime;
+    stats->Users = state->Users;
+
+    if (state->Users && GATE_Now) {
+        stats->EnabledTime += GATE_Now() - state->EnabledAt;
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
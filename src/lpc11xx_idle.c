@@ -0,0 +1,480 @@
+/******************************************************************************
+ * @file:    lpc11xx_idle.c
+ * @purpose: Tickless idle: CT32B0 timers, sleep & deep-sleep
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_IDLE
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "system_lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/ct32b.h"
+#include "lpc11xx/gate.h"
+#include "lpc11xx/idle.h"
+#include "lpc11xx/iocon.h"
+#include "lpc11xx/pmu.h"
+#include "lpc11xx/syscon.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Match channel used for timer expiry & the deep-sleep wake-up pin */
+#define IDLE_MATCH_CHANNEL  3
+
+/* Start logic input / interrupt for CT32B0_MAT3 (PIO0_11) */
+#define IDLE_WAKEUP_INPUT   SYSCON_WakeupInput_11
+#define IDLE_WAKEUP_IRQn    WAKEUP11_IRQn
+
+/* "No timer running" for the time to the next expiry */
+#define IDLE_FOREVER        0x7fffffffUL
+
+/* In system_lpc11xx.c */
+extern uint32_t WDTOscValToFreq(SYSCON_WDTOscFreq_Type oscVal);
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+IDLE_Stats_Type IDLE_Stats;
+
+/* Running timers, soonest expiry first */
+static IDLE_Timer_Type *IDLE_Timers;
+
+/* Deep-sleep enabled by IDLE_EnableDeepSleep() & not locked out */
+static uint8_t IDLE_DeepSleepEnabled;
+static uint8_t IDLE_DeepSleepLocks;
+
+/* Watchdog oscillator frequency (after its divider) */
+static uint32_t IDLE_WDTOscHz;
+
+/* Holding a GATE_CT32B0 reference (IDLE_Init() to IDLE_Deinit()) */
+static uint8_t IDLE_Acquired;
+
+static void IDLE_ClockChange(CLOCK_Event_Type event, uint32_t coreClock);
+static CLOCK_Notifier_Type IDLE_ClockNotifier = { IDLE_ClockChange, 0 };
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Run the timebase from a given timer clock.
+  * @param[in]  clock        CT32B0's clock (the core clock), in Hz
+  */
+static void IDLE_SetTimerClock(uint32_t clock)
+{
+    CT32B_SetPrescaler(CT32B0, (clock + IDLE_TICK_HZ / 2) / IDLE_TICK_HZ - 1);
+
+    /* PC may be past the new limit; it'd count all the way around */
+    CT32B_SetPrescalerCount(CT32B0, 0);
+}
+
+/** @brief Keep the tick rate when the core clock changes.
+  * @param[in]  event        Before or after the change
+  * @param[in]  coreClock    The new core clock, in Hz
+  */
+static void IDLE_ClockChange(CLOCK_Event_Type event, uint32_t coreClock)
+{
+    if (event == CLOCK_Event_PostChange) {
+        IDLE_SetTimerClock(coreClock);
+    }
+}
+
+/** @brief Get the time from now to the soonest timer expiry.
+  * @return                  Ticks (<= 0 if already due), IDLE_FOREVER if none
+  *
+  * Called with interrupts masked.
+  */
+static int32_t IDLE_TimeToNext(void)
+{
+    if (IDLE_Timers == 0) {
+        return IDLE_FOREVER;
+    }
+
+    return (int32_t)(IDLE_Timers->Expires - CT32B_GetCount(CT32B0));
+}
+
+/** @brief Set the match register for a time, making sure it isn't missed.
+  * @param[in]  expires      The tick to match at
+  *
+  * Called with interrupts masked.  If the time has already been reached
+  * (or was while it was being set), the interrupt is pended by hand.
+  */
+static void IDLE_SetMatch(uint32_t expires)
+{
+    CT32B_SetChannelMatchValue(CT32B0, IDLE_MATCH_CHANNEL, expires);
+    CT32B_SetChannelMatchControl(CT32B0, IDLE_MATCH_CHANNEL, CT32B_MatchControl_Interrupt);
+
+    if ((int32_t)(expires - CT32B_GetCount(CT32B0)) <= 0) {
+        NVIC_SetPendingIRQ(CT32B0_IRQn);
+    }
+}
+
+/** @brief Aim the match register at the soonest timer.
+  *
+  * Called with interrupts masked.
+  */
+static void IDLE_Reprogram(void)
+{
+    if (IDLE_Timers == 0) {
+        CT32B_SetChannelMatchControl(CT32B0, IDLE_MATCH_CHANNEL, CT32B_MatchControl_None);
+    } else {
+        IDLE_SetMatch(IDLE_Timers->Expires);
+    }
+}
+
+/** @brief Take a timer off the list if it's there.
+  * @param[in]  timer        The timer
+  *
+  * Called with interrupts masked.
+  */
+static void IDLE_Unlink(IDLE_Timer_Type *timer)
+{
+    IDLE_Timer_Type **pp;
+
+
+    for (pp = &IDLE_Timers; *pp != 0; pp = &(*pp)->Next) {
+        if (*pp == timer) {
+            *pp = timer->Next;
+            timer->Next = 0;
+            return;
+        }
+    }
+}
+
+/** @brief Start the timebase.
+  */
+void IDLE_Init(void)
+{
+    /* One reference however many times IDLE_Init() is called */
+    if (!IDLE_Acquired) {
+        GATE_Acquire(GATE_CT32B0);
+        IDLE_Acquired = 1;
+    }
+
+    CT32B_Disable(CT32B0);
+    CT32B_SetMode(CT32B0, CT32B_Mode_Timer);
+    CT32B_SetChannelMatchControl(CT32B0, IDLE_MATCH_CHANNEL, CT32B_MatchControl_None);
+    CT32B_ClearPendingIT(CT32B0, CT32B_IT_MR3);
+    IDLE_SetTimerClock(CLOCK_GetFrequency(CLOCK_Core));
+
+    CT32B_AssertReset(CT32B0);
+    CT32B_DeassertReset(CT32B0);
+
+    IDLE_Timers = 0;
+    CLOCK_UnregisterNotifier(&IDLE_ClockNotifier);
+    CLOCK_RegisterNotifier(&IDLE_ClockNotifier);
+
+    NVIC_ClearPendingIRQ(CT32B0_IRQn);
+    NVIC_EnableIRQ(CT32B0_IRQn);
+
+    CT32B_Enable(CT32B0);
+}
+
+/** @brief Stop the timebase & release CT32B0.
+  */
+void IDLE_Deinit(void)
+{
+    NVIC_DisableIRQ(CT32B0_IRQn);
+    CLOCK_UnregisterNotifier(&IDLE_ClockNotifier);
+
+    if (IDLE_Acquired) {
+        CT32B_Disable(CT32B0);
+        CT32B_SetChannelMatchControl(CT32B0, IDLE_MATCH_CHANNEL, CT32B_MatchControl_None);
+        CT32B_ClearPendingIT(CT32B0, CT32B_IT_MR3);
+        GATE_Release(GATE_CT32B0);
+        IDLE_Acquired = 0;
+    }
+
+    IDLE_Timers = 0;
+
+    NVIC_ClearPendingIRQ(CT32B0_IRQn);
+}
+
+/** @brief Start (or restart) a one-shot timer.
+  * @param[in]  timer        The timer (Callback filled in)
+  * @param[in]  ticks        Ticks from now to expiry (1 - 0x7fffffff)
+  */
+void IDLE_StartTimer(IDLE_Timer_Type *timer, uint32_t ticks)
+{
+    IDLE_Timer_Type **pp;
+    uint32_t primask;
+
+
+    lpclib_assert((timer != 0) && (timer->Callback != 0));
+    lpclib_assert((ticks != 0) && (ticks <= IDLE_FOREVER));
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    IDLE_Unlink(timer);
+
+    timer->Expires = CT32B_GetCount(CT32B0) + ticks;
+
+    /* Timers with the same expiry fire in the order started */
+    for (pp = &IDLE_Timers; *pp != 0; pp = &(*pp)->Next) {
+        if ((int32_t)((*pp)->Expires - timer->Expires) > 0) {
+            break;
+        }
+    }
+
+    timer->Next = *pp;
+    *pp = timer;
+
+    if (IDLE_Timers == timer) {
+        IDLE_Reprogram();
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Stop a timer; nothing happens if it isn't running.
+  * @param[in]  timer        The timer
+  */
+void IDLE_StopTimer(IDLE_Timer_Type *timer)
+{
+    uint32_t primask;
+
+
+    lpclib_assert(timer != 0);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    IDLE_Unlink(timer);
+
+    /* A stale match just makes the handler find nothing to do */
+    IDLE_Reprogram();
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief CT32B0 interrupt handler: runs expired timers.
+  */
+void IDLE_CT32B0_IRQHandler(void)
+{
+    IDLE_Timer_Type *timer;
+
+
+    CT32B_ClearPendingIT(CT32B0, CT32B_IT_MR3);
+
+    __disable_irq();
+
+    while (IDLE_TimeToNext() <= 0) {
+        timer = IDLE_Timers;
+        IDLE_Timers = timer->Next;
+        timer->Next = 0;
+
+        /* Callbacks may start / stop timers, including this one */
+        __enable_irq();
+        timer->Callback(timer);
+        __disable_irq();
+    }
+
+    IDLE_Reprogram();
+
+    __enable_irq();
+}
+
+/** @brief Allow deep-sleep.
+  */
+void IDLE_EnableDeepSleep(void)
+{
+    SYSCON_EnableAHBClockLines(SYSCON_AHBClockLine_IOCON);
+    IOCON_SetPinConfig(IOCON_PinConfig_0_11_CT32B0_MAT3, IOCON_Mode_Normal);
+
+    SYSCON_SetWDTOscFreq(IDLE_WDTOSC_FREQ);
+    SYSCON_SetWDTOscDivider(IDLE_WDTOSC_DIVIDER);
+
+    if (IDLE_WDTOscHz == 0) {
+        IDLE_WDTOscHz = WDTOscValToFreq(IDLE_WDTOSC_FREQ) / IDLE_WDTOSC_DIVIDER;
+    }
+
+    IDLE_DeepSleepEnabled = 1;
+}
+
+/** @brief Hold off deep-sleep (nests with IDLE_UnlockDeepSleep()).
+  */
+void IDLE_LockDeepSleep(void)
+{
+    uint32_t primask;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    lpclib_assert(IDLE_DeepSleepLocks < 0xff);
+    IDLE_DeepSleepLocks++;
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Undo one IDLE_LockDeepSleep().
+  */
+void IDLE_UnlockDeepSleep(void)
+{
+    uint32_t primask;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    lpclib_assert(IDLE_DeepSleepLocks != 0);
+    IDLE_DeepSleepLocks--;
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Set the watchdog oscillator frequency used for deep-sleep time.
+  * @param[in]  hz           Measured frequency after IDLE_WDTOSC_DIVIDER
+  */
+void IDLE_SetWDTOscFrequency(uint32_t hz)
+{
+    lpclib_assert(hz >= IDLE_TICK_HZ);
+
+    IDLE_WDTOscHz = hz;
+}
+
+/** @brief Deep-sleep with the main clock on the watchdog oscillator.
+  * @param[in]  wake         Tick at which to wake (if timed)
+  * @param[in]  timed        Whether a timer is running
+  *
+  * Called with interrupts masked; returns with everything as it was,
+  * except the time.
+  */
+static void IDLE_DeepSleep(uint32_t wake, int timed)
+{
+    SYSCON_MainClockSource_Type mainClock = SYSCON_GetMainClockSource();
+    uint32_t runLines = SYSCON_GetEnabledAnalogPowerLinesForMode(SYSCON_PowerMode_Run)
+                        & SYSCON_PDAWAKECFG_Mask;
+    uint32_t sleepLines = SYSCON_GetEnabledAnalogPowerLinesForMode(SYSCON_PowerMode_Sleep)
+                          & SYSCON_PDSLEEPCFG_Mask;
+
+
+    /* Power up on wake-up exactly what's running now */
+    SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Awake, SYSCON_PDAWAKECFG_Mask);
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Awake, runLines);
+
+    /* Keep the watchdog oscillator (the timebase's clock) through it; it's
+     *  also the main clock on wake-up, when PDAWAKECFG becomes PDRUNCFG
+     */
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Sleep, SYSCON_AnalogPowerLine_WDTOsc);
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Awake, SYSCON_AnalogPowerLine_WDTOsc);
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_WDTOsc);
+
+    SYSCON_SetMainClockSource(SYSCON_MainClockSource_WDTOsc);
+    SYSCON_EnableMainClockSourceUpdate();
+    while (!SYSCON_MainClockSourceIsUpdated());
+    IDLE_SetTimerClock(IDLE_WDTOscHz / SYSCON_GetAHBClockDivider());
+
+    /* MAT3 goes high at the wake-up time; its rising edge starts the chip */
+    if (timed) {
+        CT32B_SetChannelMatchValue(CT32B0, IDLE_MATCH_CHANNEL, wake);
+        CT32B_SetChannelExtMatchBit(CT32B0, IDLE_MATCH_CHANNEL, 0);
+        CT32B_SetChannelExtMatchControl(CT32B0, IDLE_MATCH_CHANNEL, CT32B_ExtMatchControl_Set);
+
+        SYSCON_SetWakeupEdgesForInputs(IDLE_WAKEUP_INPUT, SYSCON_WakeupEdge_Rising);
+        SYSCON_ResetWakeupInputs(IDLE_WAKEUP_INPUT);
+        SYSCON_EnableWakeupInputs(IDLE_WAKEUP_INPUT);
+        NVIC_ClearPendingIRQ(IDLE_WAKEUP_IRQn);
+        NVIC_EnableIRQ(IDLE_WAKEUP_IRQn);
+    }
+
+    /* Only sleep if the wake-up time wasn't passed getting here */
+    if (!timed || ((int32_t)(wake - CT32B_GetCount(CT32B0)) > 0)) {
+        PMU_DisableDeepPowerDown();
+        SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+        __WFI();
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    }
+
+    if (timed) {
+        NVIC_DisableIRQ(IDLE_WAKEUP_IRQn);
+        SYSCON_DisableWakeupInputs(IDLE_WAKEUP_INPUT);
+        SYSCON_ResetWakeupInputs(IDLE_WAKEUP_INPUT);
+        NVIC_ClearPendingIRQ(IDLE_WAKEUP_IRQn);
+
+        CT32B_SetChannelExtMatchControl(CT32B0, IDLE_MATCH_CHANNEL, CT32B_ExtMatchControl_None);
+        CT32B_SetChannelExtMatchBit(CT32B0, IDLE_MATCH_CHANNEL, 0);
+    }
+
+    /* The wake-up match isn't an expiry; IDLE_Reprogram() sorts that out */
+    CT32B_ClearPendingIT(CT32B0, CT32B_IT_MR3);
+    NVIC_ClearPendingIRQ(CT32B0_IRQn);
+
+    if (mainClock == SYSCON_MainClockSource_SysPLLOut) {
+        while (!SYSCON_SysPLLIsLocked());
+    }
+
+    SYSCON_SetMainClockSource(mainClock);
+    SYSCON_EnableMainClockSourceUpdate();
+    while (!SYSCON_MainClockSourceIsUpdated());
+    IDLE_SetTimerClock(CLOCK_GetFrequency(CLOCK_Core));
+
+    if (!(runLines & SYSCON_AnalogPowerLine_WDTOsc)) {
+        SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_WDTOsc);
+    }
+    if (!(sleepLines & SYSCON_AnalogPowerLine_WDTOsc)) {
+        SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Sleep, SYSCON_AnalogPowerLine_WDTOsc);
+    }
+
+    IDLE_Reprogram();
+}
+
+/** @brief Sleep until an interrupt or the next timer.
+  */
+void IDLE_Sleep(void)
+{
+    uint32_t start;
+    uint32_t late;
+    int32_t next;
+    uint32_t primask;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    start = CT32B_GetCount(CT32B0);
+    next = IDLE_TimeToNext();
+
+    if (next <= 0) {
+        /* Already due; the pending interrupt runs it */
+    } else if (!IDLE_DeepSleepEnabled || IDLE_DeepSleepLocks
+               || (SYSCON_GetMainClockSource() == SYSCON_MainClockSource_WDTOsc)
+               || (next < (int32_t)IDLE_DEEPSLEEP_MIN_TICKS)) {
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+        __WFI();
+
+        IDLE_Stats.Sleeps++;
+        IDLE_Stats.SleepTicks += CT32B_GetCount(CT32B0) - start;
+    } else {
+        IDLE_DeepSleep(start + next - IDLE_DEEPSLEEP_WAKE_TICKS, IDLE_Timers != 0);
+
+        IDLE_Stats.DeepSleeps++;
+        IDLE_Stats.DeepSleepTicks += CT32B_GetCount(CT32B0) - start;
+
+        if ((IDLE_Timers != 0) && (IDLE_TimeToNext() < 0)) {
+            late = -IDLE_TimeToNext();
+            if (late > IDLE_Stats.MaxWakeLateness) {
+                IDLE_Stats.MaxWakeLateness = late;
+            }
+        }
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
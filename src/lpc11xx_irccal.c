@@ -0,0 +1,277 @@
+/******************************************************************************
+ * @file:    lpc11xx_irccal.c
+ * @purpose: IRC oscillator trimming against a reference on CT32B1_CAP0
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_IRCCAL
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "system_lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/ct32b.h"
+#include "lpc11xx/gate.h"
+#include "lpc11xx/iap.h"
+#include "lpc11xx/iocon.h"
+#include "lpc11xx/irccal.h"
+#include "lpc11xx/syscon.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Marks a trim record in flash ("IRCT") */
+#define IRCCAL_MAGIC        0x54435249UL
+
+
+/* Types --------------------------------------------------------------------*/
+
+/* Trim record as stored by IRCCAL_Save() */
+typedef struct {
+    uint32_t Magic;
+    uint32_t Trim;
+    uint32_t Check;                       /* ~(Magic ^ Trim)                    */
+} IRCCAL_Record_Type;
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* Page written by IRCCAL_Save(); too big for the stack on 2K parts.
+ *  IAP_CopyRamToFlash() wants the source on a 256 byte boundary.
+ */
+__attribute__ ((section(".noinit"), aligned(256)))
+static uint32_t IRCCAL_Page[IAP_ByteCount_256 / sizeof(uint32_t)];
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Test whether the core clock comes from the IRC.
+  * @return                  1 if so, 0 otherwise
+  */
+static int IRCCAL_CoreFromIRC(void)
+{
+    switch (SYSCON_GetMainClockSource()) {
+    case SYSCON_MainClockSource_IRC:
+        return 1;
+
+    case SYSCON_MainClockSource_SysPLLIn:
+    case SYSCON_MainClockSource_SysPLLOut:
+        return SYSCON_GetSysPLLClockSource() == SYSCON_SysPLLClockSource_IRC;
+
+    default:
+        return 0;
+    }
+}
+
+/** @brief Wait for the next reference edge.
+  * @param[in]  start        Timer count the measurement started at
+  * @param[in]  limit        Counts from start to give up at
+  * @param[out] count        Timer count at the edge
+  * @return                  0 on success, -1 on time-out
+  */
+static int IRCCAL_WaitEdge(uint32_t start, uint32_t limit, uint32_t *count)
+{
+    while (!(CT32B_GetPendingIT(CT32B1) & CT32B_IT_CR0)) {
+        if (CT32B_GetCount(CT32B1) - start > limit) {
+            return -1;
+        }
+    }
+
+    *count = CT32B_GetCaptureValue(CT32B1, 0);
+    CT32B_ClearPendingIT(CT32B1, CT32B_IT_CR0);
+
+    return 0;
+}
+
+/** @brief Measure the IRC's error.
+  * @param[in]  ref_hz       Reference frequency on PIO1_0, Hz
+  * @param[in]  edges        Reference periods to measure over
+  * @param[out] ppm          Error, parts per million (+ means running fast)
+  * @return                  0 on success, -1 on failure
+  */
+int IRCCAL_Measure(uint32_t ref_hz, unsigned int edges, int32_t *ppm)
+{
+    uint64_t expected;
+    uint32_t start, first, last, limit;
+    unsigned int i;
+    int ret = -1;
+
+
+    lpclib_assert(ref_hz != 0);
+    lpclib_assert(edges != 0);
+    lpclib_assert(ppm != 0);
+
+    if (!IRCCAL_CoreFromIRC()) {
+        return -1;
+    }
+
+    /* Timer counts for the measurement if the IRC were exactly IRC_Val */
+    expected = ((uint64_t)CLOCK_GetFrequency(CLOCK_Core) * edges + ref_hz / 2) / ref_hz;
+
+    /* Give up at twice the time for the first edge & the rest */
+    if ((expected == 0) || (expected * (edges + 1) / edges * 2 > 0xffffffffULL)) {
+        return -1;
+    }
+    limit = expected * (edges + 1) / edges * 2;
+
+    GATE_Acquire(GATE_CT32B1);
+    IOCON_SetPinConfig(IOCON_PinConfig_1_0_CT32B1_CAP0, IOCON_Mode_Normal);
+
+    CT32B_Disable(CT32B1);
+    CT32B_SetMode(CT32B1, CT32B_Mode_Timer);
+    CT32B_SetPrescaler(CT32B1, 0);
+    CT32B_AssertReset(CT32B1);
+    CT32B_DeassertReset(CT32B1);
+    CT32B_SetCaptureControl(CT32B1, 0, CT32B_CaptureControl_RisingEdges);
+    CT32B_ClearPendingIT(CT32B1, CT32B_IT_CR0);
+    CT32B_Enable(CT32B1);
+
+    start = CT32B_GetCount(CT32B1);
+    if (IRCCAL_WaitEdge(start, limit, &first) == 0) {
+        last = first;
+        for (i = 0; i < edges; i++) {
+            if (IRCCAL_WaitEdge(start, limit, &last) < 0) {
+                break;
+            }
+        }
+
+        if (i == edges) {
+            *ppm = (int32_t)(((int64_t)(last - first) - (int64_t)expected) * 1000000
+                             / (int64_t)expected);
+            ret = 0;
+        }
+    }
+
+    CT32B_Disable(CT32B1);
+    CT32B_SetCaptureControl(CT32B1, 0, CT32B_CaptureControl_None);
+    GATE_Release(GATE_CT32B1);
+
+    return ret;
+}
+
+/** @brief Trim the IRC as close to nominal as it will go.
+  * @param[in]  ref_hz       Reference frequency on PIO1_0, Hz
+  * @param[in]  edges        Reference periods per measurement
+  * @param[out] result       The trim chosen & its error (may be 0)
+  * @return                  0 on success, -1 if a measurement failed
+  */
+int IRCCAL_Calibrate(uint32_t ref_hz, unsigned int edges, IRCCAL_Result_Type *result)
+{
+    unsigned int start = SYSCON_GetIRCTrim();
+    unsigned int best = start;
+    unsigned int steps = 0;
+    int reversed = 0;
+    int32_t best_ppm, ppm;
+    int dir;
+    int trim;
+
+
+    if (IRCCAL_Measure(ref_hz, edges, &best_ppm) < 0) {
+        return -1;
+    }
+
+    /* A higher trim value runs the IRC faster */
+    dir = (best_ppm > 0) ? -1 : 1;
+
+    while ((best_ppm != 0) && (steps < IRCCAL_MAX_STEPS)) {
+        trim = (int)best + dir;
+        if ((trim < 0) || (trim > 255)) {
+            break;
+        }
+
+        SYSCON_SetIRCTrim(trim);
+        steps++;
+
+        if (IRCCAL_Measure(ref_hz, edges, &ppm) < 0) {
+            SYSCON_SetIRCTrim(start);
+            return -1;
+        }
+
+        if ((ppm < 0 ? -ppm : ppm) < (best_ppm < 0 ? -best_ppm : best_ppm)) {
+            /* Closer; stop once it's gone past nominal */
+            best = trim;
+            if ((ppm < 0) != (best_ppm < 0)) {
+                best_ppm = ppm;
+                break;
+            }
+            best_ppm = ppm;
+        } else if (!reversed && (best == start)) {
+            /* This part's trim runs the other way */
+            dir = -dir;
+            reversed = 1;
+        } else {
+            break;
+        }
+    }
+
+    SYSCON_SetIRCTrim(best);
+
+    if (result) {
+        result->Trim = best;
+        result->Steps = steps;
+        result->ErrorPPM = best_ppm;
+    }
+
+    return 0;
+}
+
+/** @brief Store the current trim in flash.
+  * @param[in]  addr         Start of a flash sector set aside for it
+  * @return                  0 on success, negative IAP status value on error
+  */
+int IRCCAL_Save(uint32_t addr)
+{
+    uint32_t *page = IRCCAL_Page;
+    IRCCAL_Record_Type *record = (IRCCAL_Record_Type *)page;
+    unsigned int i;
+    int ret;
+
+
+    lpclib_assert((addr & (IAP_SECTOR_SIZE - 1)) == 0);
+
+    for (i = 0; i < sizeof(IRCCAL_Page) / sizeof(IRCCAL_Page[0]); i++) {
+        page[i] = 0xffffffffUL;
+    }
+
+    record->Magic = IRCCAL_MAGIC;
+    record->Trim = SYSCON_GetIRCTrim();
+    record->Check = (uint32_t)~(IRCCAL_MAGIC ^ record->Trim);
+
+    ret = IAP_PrepareSectors(addr, 1);
+    if (ret == 0) {
+        ret = IAP_EraseSectors(addr, 1);
+    }
+    if (ret == 0) {
+        ret = IAP_PrepareSectors(addr, 1);
+    }
+    if (ret == 0) {
+        ret = IAP_CopyRamToFlash(addr, (uintptr_t)page, IAP_ByteCount_256);
+    }
+
+    return ret;
+}
+
+/** @brief Put back a trim stored by IRCCAL_Save().
+  * @param[in]  addr         The sector IRCCAL_Save() used
+  * @return                  0 if one was found & applied, -1 if not
+  */
+int IRCCAL_Restore(uint32_t addr)
+{
+    const IRCCAL_Record_Type *record = (const IRCCAL_Record_Type *)(uintptr_t)addr;
+
+
+    if ((record->Magic != IRCCAL_MAGIC) || (record->Trim > 255)
+     || (record->Check != (uint32_t)~(IRCCAL_MAGIC ^ record->Trim))) {
+        return -1;
+    }
+
+    SYSCON_SetIRCTrim(record->Trim);
+
+    return 0;
+}
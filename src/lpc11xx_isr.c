@@ -0,0 +1,98 @@
+/******************************************************************************
+ * @file:    lpc11xx_isr.c
+ * @purpose: Runtime (RAM) exception / interrupt vector table
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_ISR
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "lpc11xx/isr_vector.h"
+#include "lpc11xx/syscon.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Vector table entries (exception number is IRQn + 16) */
+#define ISR_NUM_VECTORS     (sizeof(ISRVector_Type) / sizeof(ISR_Handler_Type))
+#define ISR_VECTOR(irq)     ((int)(irq) + 16)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* Linked at the start of RAM (not loaded; filled in by ISR_UseRAMVectors) */
+__attribute__((section(".ram_isr_vector")))
+static ISRVector_Type RAMISRVector;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Copy the flash vectors to RAM & switch to the RAM copy.
+  */
+void ISR_UseRAMVectors(void)
+{
+    const uint32_t *src = (const uint32_t *)&BootISRVector;
+    uint32_t *dst = (uint32_t *)&RAMISRVector;
+    unsigned int i;
+
+
+    for (i = 0; i < ISR_NUM_VECTORS; i++) {
+        dst[i] = src[i];
+    }
+
+    SYSCON_SetMemRemap(SYSCON_RemapMem_RAM);
+}
+
+/** @brief Switch back to the vectors in flash.
+  */
+void ISR_UseFlashVectors(void)
+{
+    SYSCON_SetMemRemap(SYSCON_RemapMem_FLASH);
+}
+
+/** @brief Install the handler for an exception or interrupt.
+  * @param[in]  irq          The exception / IRQ number (e.g. UART0_IRQn)
+  * @param[in]  handler      The handler to call
+  * @return                  The handler previously installed
+  */
+ISR_Handler_Type ISR_SetHandler(IRQn_Type irq, ISR_Handler_Type handler)
+{
+    ISR_Handler_Type *vectors = (ISR_Handler_Type *)&RAMISRVector;
+    ISR_Handler_Type old;
+
+
+    lpclib_assert((ISR_VECTOR(irq) > 0) && (ISR_VECTOR(irq) < (int)ISR_NUM_VECTORS));
+    lpclib_assert(SYSCON_GetMemRemap() == SYSCON_RemapMem_RAM);
+
+    old = vectors[ISR_VECTOR(irq)];
+    vectors[ISR_VECTOR(irq)] = handler;
+
+    return old;
+}
+
+/** @brief Get the handler installed for an exception or interrupt.
+  * @param[in]  irq          The exception / IRQ number (e.g. UART0_IRQn)
+  * @return                  The handler in the vector table in use
+  */
+ISR_Handler_Type ISR_GetHandler(IRQn_Type irq)
+{
+    const ISR_Handler_Type *vectors;
+
+
+    lpclib_assert((ISR_VECTOR(irq) > 0) && (ISR_VECTOR(irq) < (int)ISR_NUM_VECTORS));
+
+    if (SYSCON_GetMemRemap() == SYSCON_RemapMem_RAM) {
+        vectors = (const ISR_Handler_Type *)&RAMISRVector;
+    } else {
+        vectors = (const ISR_Handler_Type *)&BootISRVector;
+    }
+
+    return vectors[ISR_VECTOR(irq)];
+}
@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include "lpc11xx.h"
+#include "lpc11xx/clock.h"
 #include "lpc11xx/syscon.h"
 
 
@@ -53,13 +54,15 @@ int16_t PLL_ScalerCalc(uint32_t clk_in, uint32_t clk_out, int32_t *err)
      */
     actual = m * clk_in;
 
-	/* Decide which PLL P divisor to select based on output clock frequency */
+	/* Decide which PLL P divisor to select based on output clock frequency;
+	 *  the CCO (2 * P * output) has to run at 156 - 320MHz
+	 */
     if (actual < 19500000UL) {
-        p = SYSCON_SYSPLLCTRL_PSEL_DIV8;
+        p = SYSCON_SysPLLPVal_8;
     } else if (actual < 39000000UL) {
-        p = SYSCON_SYSPLLCTRL_PSEL_DIV4;
+        p = SYSCON_SysPLLPVal_4;
     } else if (actual < 78000000UL) {
-        p = SYSCON_SYSPLLCTRL_PSEL_DIV2;
+        p = SYSCON_SysPLLPVal_2;
     } else {
         return -1;
     }
@@ -70,5 +73,5 @@ int16_t PLL_ScalerCalc(uint32_t clk_in, uint32_t clk_out, int32_t *err)
     }
 
 	/* Munge the p/m values into the register setting value */
-    return ((p << 5) | (m - 1));
+    return ((p << SYSCON_SYSPLLCTRL_PSEL_Shift) | (m - 1));
 }
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * @file:    lpc11xx_power_api.c
+ * @purpose: Calls into the LPC11xxL boot ROM Power Profile API
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_POWER_API
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "system_lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/flash.h"
+#include "lpc11xx/power_api.h"
+#include "lpc11xx/syscon.h"
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Find the ROM's Power API function table.
+  * @return                  The table (in ROM)
+  */
+static const PowerAPI_ROM_Type *PowerAPI_ROM(void)
+{
+    const PowerAPI_ROM_Type * const *drivers;
+
+
+    drivers = *(const PowerAPI_ROM_Type * const **)POWERAPI_ROM_DRIVER_TABLE;
+
+    return drivers[POWERAPI_ROM_DRIVER_INDEX];
+}
+
+/** @brief Set the system clock via the Power Profile API's PLL search.
+  * @param[in]  desired_sysclock  The clock at which to run the CPU, in Hz
+  * @param[in]  pll_mode          How closely it must be matched
+  * @param[in]  max_tries         Polls of the PLL lock bit before giving up
+  * @return PowerAPI_Status_Type value giving success or the reason the call failed.
+  */
+PowerAPI_Status_Type PowerAPI_SetPLLFreq(uint32_t desired_sysclock,
+                                         PowerAPI_PLLMode_Type pll_mode,
+                                         uint32_t max_tries)
+{
+    uint32_t command[4];
+    uint32_t result[2];
+    uint32_t clk_in = IRC_Val;
+
+
+    lpclib_assert(POWERAPI_IS_PLL_MODE(pll_mode));
+
+#ifdef HSE_Val
+    if (SYSCON_GetSysPLLClockSource() == SYSCON_SysPLLClockSource_SysOsc) {
+        clk_in = HSE_Val;
+    }
+#endif
+
+    /* Let drivers finish with the old clock (the ROM picks the new one) */
+    CLOCK_Notify(CLOCK_Event_PreChange, desired_sysclock);
+
+    /* The ROM leaves flash timing alone; keep it safe for the new clock */
+    if (CLOCK_FlashWaitStates(desired_sysclock) > FLASH_GetWaitStates()) {
+        FLASH_SetWaitStates(CLOCK_FlashWaitStates(desired_sysclock));
+    }
+
+    command[0] = clk_in / 1000;
+    command[1] = desired_sysclock / 1000;
+    command[2] = pll_mode;
+    command[3] = max_tries;
+
+    PowerAPI_ROM()->SetPLL(command, result);
+
+    /* The ROM wrote the PLL, main clock & AHB divider registers directly */
+    CLOCK_InvalidateFrequencies();
+    SystemCoreClockUpdate();
+
+    /* Even a failed call may have moved the main clock (e.g. PLL not locked) */
+    CLOCK_Notify(CLOCK_Event_PostChange, SystemCoreClock);
+
+    return result[0];
+}
+
+/** @brief  Set the system power mode to the desired setting via Power Profile interface
+  * @param  power_mode           The desired power mode (performance, efficiency, etc.)
+  * @return PowerAPI_Status_Type value giving success or the reason the call failed.
+  */
+PowerAPI_Status_Type PowerAPI_SetPowerMode(PowerAPI_PowerMode_Type power_mode)
+{
+    uint32_t command[3];
+    uint32_t result[1];
+    uint32_t mhz = CLOCK_GetFrequency(CLOCK_Core) / 1000000;
+
+
+    lpclib_assert(POWERAPI_IS_POWER_MODE(power_mode));
+
+    command[0] = mhz;
+    command[1] = power_mode;
+    command[2] = mhz;
+
+    PowerAPI_ROM()->SetPower(command, result);
+
+    return result[0];
+}
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * @file:    lpc11xx_retain.c
+ * @purpose: State retained through deep power-down in the PMU registers
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_RETAIN
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "lpc11xx/pmu.h"
+#include "lpc11xx/retain.h"
+#include "lpc11xx/syscon.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* GPREG4 layout (bit 10 is the WAKEUP pin hysteresis, 9:0 reserved) */
+#define RETAIN_REASON_Shift     11
+#define RETAIN_REASON_Mask      (0x1fUL << RETAIN_REASON_Shift)
+#define RETAIN_CHECK_Shift      16
+#define RETAIN_CHECK_Mask       (0xffffUL << RETAIN_CHECK_Shift)
+
+/* Mixed into the checksum, so all-zero registers (power-on) don't pass */
+#define RETAIN_CHECK_SEED       0x5aa5
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Fletcher-16 checksum of the retained words.
+  * @param[in]  words        GPREG0-3, then GPREG4's data bits
+  * @return                  The checksum
+  */
+static uint16_t RETAIN_Checksum(const uint32_t words[5])
+{
+    uint32_t sum1 = RETAIN_CHECK_SEED & 0xff;
+    uint32_t sum2 = RETAIN_CHECK_SEED >> 8;
+    unsigned int i, j;
+
+
+    for (i = 0; i < 5; i++) {
+        for (j = 0; j < 32; j += 8) {
+            sum1 = (sum1 + ((words[i] >> j) & 0xff)) % 255;
+            sum2 = (sum2 + sum1) % 255;
+        }
+    }
+
+    return (sum2 << 8) | sum1;
+}
+
+/** @brief Store state in the PMU registers.
+  * @param[in]  state        The state to keep
+  */
+void RETAIN_Save(const RETAIN_State_Type *state)
+{
+    uint32_t words[5];
+    unsigned int i;
+
+
+    lpclib_assert(state != 0);
+    lpclib_assert(state->BootReason <= RETAIN_BOOTREASON_MAX);
+
+    words[0] = state->Sequence;
+    words[1] = state->Timestamp;
+    words[2] = state->Data[0];
+    words[3] = state->Data[1];
+    words[4] = (uint32_t)state->BootReason << RETAIN_REASON_Shift;
+
+    for (i = 0; i < 4; i++) {
+        PMU_SetGPREG(i, words[i]);
+    }
+
+    PMU->GPREG4 = (PMU->GPREG4 & ~PMU_GPREG4_DATA_Mask) | words[4]
+                  | ((uint32_t)RETAIN_Checksum(words) << RETAIN_CHECK_Shift);
+}
+
+/** @brief Get state back from the PMU registers.
+  * @param[out] state        Where to put it
+  * @return                  0 if it checks out, -1 if there's none or it's corrupt
+  */
+int RETAIN_Load(RETAIN_State_Type *state)
+{
+    uint32_t words[5];
+    uint32_t gpreg4 = PMU->GPREG4;
+    unsigned int i;
+
+
+    lpclib_assert(state != 0);
+
+    for (i = 0; i < 4; i++) {
+        words[i] = PMU_GetGPREG(i);
+    }
+    words[4] = gpreg4 & RETAIN_REASON_Mask;
+
+    if (RETAIN_Checksum(words) != ((gpreg4 & RETAIN_CHECK_Mask) >> RETAIN_CHECK_Shift)) {
+        return -1;
+    }
+
+    state->Sequence = words[0];
+    state->Timestamp = words[1];
+    state->Data[0] = words[2];
+    state->Data[1] = words[3];
+    state->BootReason = words[4] >> RETAIN_REASON_Shift;
+
+    return 0;
+}
+
+/** @brief Make the retained state invalid.
+  */
+void RETAIN_Invalidate(void)
+{
+    /* Zero data with a zero checksum never checks out (see the seed) */
+    PMU->GPREG4 &= ~PMU_GPREG4_DATA_Mask;
+    PMU_SetGPREG(0, 0);
+    PMU_SetGPREG(1, 0);
+    PMU_SetGPREG(2, 0);
+    PMU_SetGPREG(3, 0);
+}
+
+/** @brief Check for a wake-up from deep power-down with state to resume.
+  * @return                  1 if so, 0 for any other reset
+  */
+uint8_t RETAIN_CheckResume(void)
+{
+    RETAIN_State_Type state;
+
+
+    if (!PMU_IsInDeepPowerDownMode()) {
+        return 0;
+    }
+
+    PMU_ClearDeepPowerDownFlag();
+
+    return (RETAIN_Load(&state) == 0) ? 1:0;
+}
+
+/** @brief Save state & enter deep power-down.
+  * @param[in]  state        The state to keep
+  */
+void RETAIN_EnterDeepPowerDown(const RETAIN_State_Type *state)
+{
+    RETAIN_Save(state);
+
+    /* The IRC has to be running when deep power-down is entered */
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run,
+                                         SYSCON_AnalogPowerLine_IRCOut
+                                         | SYSCON_AnalogPowerLine_IRC);
+
+    PMU_EnableDeepPowerDown();
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+
+    for (;;) {
+        __WFI();
+    }
+}
@@ -0,0 +1,490 @@
+/******************************************************************************
+ * @file:    lpc11xx_rs485.c
+ * @purpose: RS-485 multidrop node driver (UART0)
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_RS485
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "system_lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/gate.h"
+#include "lpc11xx/iocon.h"
+#include "lpc11xx/rs485.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx/uart.h"
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Line status bits that describe received data (cleared by reading LSR) */
+#define RS485_LSR_RX_FLAGS  (UART_LineStatus_RxOverrun | UART_LineStatus_ParityError \
+                           | UART_LineStatus_FramingError | UART_LineStatus_Break)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+RS485_Stats_Type RS485_Stats;
+
+static uint32_t RS485_Baud;
+
+/* Receive flags from LSR reads outside the receive path, not yet seen there */
+static uint32_t RS485_PendingLSR;
+
+/* Frame being received */
+static uint8_t *RS485_RxBuffer;
+static uint16_t RS485_RxSize;
+static uint16_t RS485_RxLen;
+static uint8_t RS485_InFrame;
+static uint8_t RS485_RxBad;
+static void (*RS485_Received)(const uint8_t *frame, unsigned int len);
+
+/* Characters to take per receive interrupt (one less than the trigger) */
+static uint8_t RS485_RxBurst;
+
+/* Frame data still to go into the FIFO */
+static const uint8_t *RS485_TxData;
+static volatile uint16_t RS485_TxLeft;
+
+/* No usable baud rate from the current clock; UART stopped */
+static volatile uint8_t RS485_Halted;
+
+/* Holding a GATE_UART0 reference (RS485_Init() to RS485_Deinit()) */
+static uint8_t RS485_Acquired;
+
+static void RS485_ClockChange(CLOCK_Event_Type event, uint32_t coreClock);
+static CLOCK_Notifier_Type RS485_ClockNotifier = { RS485_ClockChange, 0 };
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Read the line status, keeping receive flags for the receive path.
+  * @return                  Line status, with receive flags not yet taken
+  */
+static uint32_t RS485_LineStatus(void)
+{
+    uint32_t lsr;
+    uint32_t primask;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    lsr = UART_GetLineStatus(UART0) | RS485_PendingLSR;
+    RS485_PendingLSR = lsr & RS485_LSR_RX_FLAGS;
+
+    if (!primask) {
+        __enable_irq();
+    }
+
+    return lsr;
+}
+
+/** @brief Read the line status in the receive path, taking the receive flags.
+  * @return                  Line status
+  */
+static uint32_t RS485_TakeLineStatus(void)
+{
+    uint32_t lsr = UART_GetLineStatus(UART0) | RS485_PendingLSR;
+
+
+    RS485_PendingLSR = 0;
+
+    return lsr;
+}
+
+/** @brief Work out the UART clock & divisors for a baud rate.
+  * @param[in]  baud         The rate
+  * @param[out] setting      The UART clock & divisors
+  * @return                  0 on success, -1 if the main clock can't give
+  *                          it within CLOCK_BAUD_TOLERANCE
+  */
+static int RS485_SolveBaud(uint32_t baud, CLOCK_UARTBaud_Type *setting)
+{
+    return CLOCK_SolveUARTBaud(CLOCK_GetFrequency(CLOCK_Main), baud, setting);
+}
+
+/** @brief Set the UART clock & divisors.
+  * @param[in]  setting      From RS485_SolveBaud()
+  */
+static void RS485_SetDivisor(const CLOCK_UARTBaud_Type *setting)
+{
+    SYSCON_SetUART0ClockDivider(setting->Divider);
+    UART_SetDivisor(UART0, setting->Divisor);
+    UART_SetFractionalDivider(UART0, setting->DivAddVal, setting->MulVal);
+}
+
+/** @brief Keep the baud rate when the core clock changes.
+  * @param[in]  event        Before or after the change
+  * @param[in]  coreClock    The new core clock, in Hz
+  */
+static void RS485_ClockChange(CLOCK_Event_Type event, uint32_t coreClock)
+{
+    CLOCK_UARTBaud_Type setting;
+    uint32_t primask;
+
+
+    (void)coreClock;
+
+    if (event == CLOCK_Event_PreChange) {
+        while (RS485_TxBusy());
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (RS485_SolveBaud(RS485_Baud, &setting) < 0) {
+        /* Off the bus rather than on it at the wrong rate; a later clock
+         *  may do
+         */
+        RS485_Stats.BaudErrors++;
+        RS485_Halted = 1;
+        RS485_TxLeft = 0;
+        UART_DisableTx(UART0);
+        UART_DisableInterrupts(UART0, UART_Interrupt_Mask);
+    } else {
+        RS485_SetDivisor(&setting);
+
+        if (RS485_Halted) {
+            /* Anything heard meanwhile was at the wrong rate */
+            RS485_Halted = 0;
+            RS485_InFrame = 0;
+            UART_FlushFifos(UART0);
+            UART_DisableRS485Rx(UART0);
+            UART_GetLineStatus(UART0);
+            RS485_PendingLSR = 0;
+
+            UART_EnableTx(UART0);
+            UART_EnableInterrupts(UART0, UART_Interrupt_RxData | UART_Interrupt_RxLineStatus);
+        }
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Set up UART0 as a bus node & start the driver.
+  * @param[in]  config       Settings (RxBuffer must stay valid)
+  * @return                  0 on success, -1 if the baud rate can't be made
+  */
+int RS485_Init(const RS485_Config_Type *config)
+{
+    CLOCK_UARTBaud_Type setting;
+
+
+    lpclib_assert(config != 0);
+    lpclib_assert(config->Baud != 0);
+    lpclib_assert(UART_IS_RS485DIRCONTROLPOLARITY(config->DirPolarity));
+    lpclib_assert(UART_IS_RXFIFOTRIGGER(config->RxTrigger));
+    lpclib_assert(config->RxTrigger != UART_RxFifoTrigger_1);
+    lpclib_assert((config->RxBuffer != 0) && (config->RxSize != 0));
+    lpclib_assert(config->Received != 0);
+
+    if (RS485_SolveBaud(config->Baud, &setting) < 0) {
+        return -1;
+    }
+
+    NVIC_DisableIRQ(UART0_IRQn);
+
+    RS485_Baud = config->Baud;
+    RS485_RxBuffer = config->RxBuffer;
+    RS485_RxSize = config->RxSize;
+    RS485_Received = config->Received;
+    RS485_InFrame = 0;
+    RS485_TxLeft = 0;
+    RS485_Halted = 0;
+    RS485_PendingLSR = 0;
+
+    switch (config->RxTrigger) {
+    case UART_RxFifoTrigger_4:
+        RS485_RxBurst = 3;
+        break;
+
+    case UART_RxFifoTrigger_8:
+        RS485_RxBurst = 7;
+        break;
+
+    default:
+        RS485_RxBurst = 13;
+        break;
+    }
+
+    SYSCON_EnableAHBClockLines(SYSCON_AHBClockLine_IOCON);
+    IOCON_SetPinConfig(IOCON_PinConfig_1_6_RXD0, IOCON_Mode_Normal);
+    IOCON_SetPinConfig(IOCON_PinConfig_1_7_TXD0, IOCON_Mode_Normal);
+    IOCON_SetPinConfig(IOCON_PinConfig_1_5_RTS0, IOCON_Mode_Normal);
+
+    /* One reference however many times RS485_Init() is called */
+    if (!RS485_Acquired) {
+        GATE_Acquire(GATE_UART0);
+        RS485_Acquired = 1;
+    }
+
+    UART_DisableInterrupts(UART0, UART_Interrupt_Mask);
+
+    /* Data characters carry a 0 9th bit; address characters set it */
+    RS485_SetDivisor(&setting);
+    UART_SetWordLength(UART0, UART_WordLength_8b);
+    UART_SetStopBits(UART0, UART_StopBits_1);
+    UART_SetParity(UART0, UART_Parity_Zero);
+
+    UART_EnableFifos(UART0);
+    UART_FlushFifos(UART0);
+    UART_SetRxFifoTrigger(UART0, config->RxTrigger);
+
+    /* Receiver off until an address character matches */
+    UART_SetRS485Address(UART0, config->Address);
+    UART_EnableRS485NormalMultidropMode(UART0);
+    UART_EnableRS485AutoAddressDetect(UART0);
+    UART_DisableRS485Rx(UART0);
+
+    UART_SetRS485DirControlPin(UART0, UART_RS485DirControlPin_RTS);
+    UART_SetRS485DirControlPolarity(UART0, config->DirPolarity);
+    UART_SetRS485DirDelay(UART0, config->DirDelay);
+    UART_EnableRS485AutoDirControl(UART0);
+
+    UART_EnableTx(UART0);
+
+    CLOCK_UnregisterNotifier(&RS485_ClockNotifier);
+    CLOCK_RegisterNotifier(&RS485_ClockNotifier);
+
+    /* Clear anything left over */
+    UART_GetLineStatus(UART0);
+    UART_GetPendingInterruptID(UART0);
+
+    UART_EnableInterrupts(UART0, UART_Interrupt_RxData | UART_Interrupt_RxLineStatus);
+
+    NVIC_ClearPendingIRQ(UART0_IRQn);
+    NVIC_EnableIRQ(UART0_IRQn);
+
+    return 0;
+}
+
+/** @brief Stop the driver & release UART0.
+  */
+void RS485_Deinit(void)
+{
+    NVIC_DisableIRQ(UART0_IRQn);
+    CLOCK_UnregisterNotifier(&RS485_ClockNotifier);
+
+    if (RS485_Acquired) {
+        UART_DisableInterrupts(UART0, UART_Interrupt_Mask);
+        UART_DisableRS485AutoDirControl(UART0);
+        GATE_Release(GATE_UART0);
+        RS485_Acquired = 0;
+    }
+
+    RS485_TxLeft = 0;
+    RS485_InFrame = 0;
+
+    NVIC_ClearPendingIRQ(UART0_IRQn);
+}
+
+/** @brief Change this node's address.
+  * @param[in]  address      The new address (0 - 255)
+  */
+void RS485_SetAddress(unsigned int address)
+{
+    uint32_t primask;
+
+
+    lpclib_assert(address <= 255);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    UART_DisableRS485Rx(UART0);
+    UART_SetRS485Address(UART0, address);
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Test whether a frame is still going out.
+  * @return                  1 if so (data in use or line driven), 0 otherwise
+  */
+unsigned int RS485_TxBusy(void)
+{
+    /* Nothing goes out while halted */
+    if (RS485_Halted) {
+        return 0;
+    }
+
+    if (RS485_TxLeft) {
+        return 1;
+    }
+
+    return (RS485_LineStatus() & UART_LineStatus_TxEmpty) ? 0:1;
+}
+
+/** @brief Start sending a frame.
+  * @param[in]  address      Node to send it to (0 - 255)
+  * @param[in]  data         The data (must stay valid until sent)
+  * @param[in]  len          Its length
+  * @return                  0 if started, -1 if a frame is still going out
+  *                          or the UART is halted
+  */
+int RS485_Send(unsigned int address, const uint8_t *data, unsigned int len)
+{
+    lpclib_assert(address <= 255);
+    lpclib_assert((data != 0) || (len == 0));
+    lpclib_assert(len <= 0xffff);
+
+    if (RS485_Halted || RS485_TxBusy()) {
+        return -1;
+    }
+
+    /* The 9th bit can only change with the transmitter empty; the driver
+     *  enable holds over the gap for DirDelay bit times.
+     */
+    UART_SetParity(UART0, UART_Parity_One);
+    UART_Send(UART0, address);
+    while (!(RS485_LineStatus() & UART_LineStatus_TxEmpty));
+    UART_SetParity(UART0, UART_Parity_Zero);
+
+    RS485_Stats.TxFrames++;
+
+    if (len) {
+        RS485_TxData = data;
+        RS485_TxLeft = len;
+
+        /* Fires at once; the FIFO is empty */
+        UART_EnableInterrupts(UART0, UART_Interrupt_TxData);
+    }
+
+    return 0;
+}
+
+/** @brief Finish the frame being received, passing it on if it's good.
+  */
+static void RS485_EndFrame(void)
+{
+    if (!RS485_InFrame) {
+        return;
+    }
+
+    RS485_InFrame = 0;
+
+    if (RS485_RxBad) {
+        RS485_Stats.RxDropped++;
+    } else {
+        RS485_Stats.RxFrames++;
+        RS485_Received(RS485_RxBuffer, RS485_RxLen);
+    }
+}
+
+/** @brief Take characters from the receive FIFO into the frame.
+  * @param[in]  limit        Most to take
+  */
+static void RS485_RxDrain(unsigned int limit)
+{
+    uint32_t lsr;
+    uint8_t c;
+
+
+    while (limit--) {
+        lsr = RS485_TakeLineStatus();
+
+        if (lsr & UART_LineStatus_RxOverrun) {
+            RS485_Stats.RxOverruns++;
+            RS485_RxBad = 1;
+        }
+
+        if (!(lsr & UART_LineStatus_RxData)) {
+            break;
+        }
+
+        c = UART_Recv(UART0);
+
+        /* A 9th bit of 1 (a "parity error") marks our address */
+        if (lsr & UART_LineStatus_ParityError) {
+            RS485_EndFrame();
+
+            RS485_InFrame = 1;
+            RS485_RxBad = 0;
+            RS485_RxLen = 0;
+            continue;
+        }
+
+        if (!RS485_InFrame) {
+            continue;
+        }
+
+        if (lsr & (UART_LineStatus_FramingError | UART_LineStatus_Break)) {
+            RS485_RxBad = 1;
+        }
+
+        if (RS485_RxLen < RS485_RxSize) {
+            RS485_RxBuffer[RS485_RxLen++] = c;
+        } else {
+            RS485_RxBad = 1;
+        }
+    }
+}
+
+/** @brief Refill the (empty) transmit FIFO from the frame being sent.
+  */
+static void RS485_TxFill(void)
+{
+    unsigned int count = RS485_FIFO_SIZE;
+
+
+    while (RS485_TxLeft && count) {
+        UART_Send(UART0, *RS485_TxData++);
+        RS485_TxLeft--;
+        count--;
+    }
+
+    if (!RS485_TxLeft) {
+        UART_DisableInterrupts(UART0, UART_Interrupt_TxData);
+    }
+}
+
+/** @brief UART0 interrupt handler.
+  */
+LPC11XX_RAMFUNC void RS485_IRQHandler(void)
+{
+    UART_InterruptID_Type id;
+
+
+    RS485_Stats.Interrupts++;
+
+    while ((id = UART_GetPendingInterruptID(UART0)) != UART_InterruptID_None) {
+        switch (id) {
+        case UART_InterruptID_RxLineStatus:
+            /* Reading LSR clears it; the character is taken with the rest */
+            RS485_PendingLSR |= UART_GetLineStatus(UART0) & RS485_LSR_RX_FLAGS;
+            break;
+
+        case UART_InterruptID_RxDataAvailable:
+            /* Leave one behind, so the time-out always ends the frame */
+            RS485_RxDrain(RS485_RxBurst);
+            break;
+
+        case UART_InterruptID_CharacterTimeOut:
+            RS485_RxDrain(RS485_FIFO_SIZE);
+            RS485_EndFrame();
+            break;
+
+        case UART_InterruptID_TxEmpty:
+            RS485_TxFill();
+            break;
+
+        default:
+            /* Reading MSR clears a modem status interrupt */
+            UART_GetModemStatus(UART0);
+            break;
+        }
+    }
+}
@@ -0,0 +1,588 @@
+/******************************************************************************
+ * @file:    lpc11xx_serial.c
+ * @purpose: Interrupt-driven, buffered UART0 driver
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_SERIAL
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "system_lpc11xx.h"
+#include "lpc11xx/clock.h"
+#include "lpc11xx/gate.h"
+#include "lpc11xx/iocon.h"
+#include "lpc11xx/serial.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx/uart.h"
+
+
+/* Types --------------------------------------------------------------------*/
+
+/* Single-producer / single-consumer ring; indexes run free & are masked */
+typedef struct {
+    uint8_t *Buffer;
+    uint16_t Mask;                        /* Size - 1                           */
+    volatile uint16_t Head;               /* Written only by the producer       */
+    volatile uint16_t Tail;               /* Written only by the consumer       */
+} SERIAL_Ring_Type;
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Test for a usable ring size */
+#define SERIAL_IS_RING_SIZE(Size)   (((Size) != 0) && ((Size) <= 0x8000) \
+                                  && (((Size) & ((Size) - 1)) == 0))
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+SERIAL_Stats_Type SERIAL_Stats;
+
+static SERIAL_Ring_Type SERIAL_Rx;
+static SERIAL_Ring_Type SERIAL_Tx;
+
+/* Descriptors queued by SERIAL_Send() */
+static SERIAL_TxDesc_Type *volatile SERIAL_TxFirst;
+static SERIAL_TxDesc_Type *SERIAL_TxLast;
+
+static uint32_t SERIAL_Baud;
+
+/* Receive ring level to resume at; set if auto-RTS can hold off the peer */
+static uint16_t SERIAL_RxLowWater;
+static uint8_t SERIAL_Throttling;
+
+/* Receive interrupt masked for a full ring */
+static volatile uint8_t SERIAL_Throttled;
+
+/* No usable baud rate from the current clock; UART stopped */
+static volatile uint8_t SERIAL_Halted;
+
+/* Holding a GATE_UART0 reference (SERIAL_Init() to SERIAL_Deinit()) */
+static uint8_t SERIAL_Acquired;
+
+static void SERIAL_ClockChange(CLOCK_Event_Type event, uint32_t coreClock);
+static CLOCK_Notifier_Type SERIAL_ClockNotifier = { SERIAL_ClockChange, 0 };
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Work out the UART clock & divisors for a baud rate.
+  * @param[in]  baud         The rate
+  * @param[out] setting      The UART clock & divisors
+  * @return                  0 on success, -1 if the main clock can't give
+  *                          it within CLOCK_BAUD_TOLERANCE
+  */
+static int SERIAL_SolveBaud(uint32_t baud, CLOCK_UARTBaud_Type *setting)
+{
+    return CLOCK_SolveUARTBaud(CLOCK_GetFrequency(CLOCK_Main), baud, setting);
+}
+
+/** @brief Set the UART clock & divisors.
+  * @param[in]  setting      From SERIAL_SolveBaud()
+  */
+static void SERIAL_SetDivisor(const CLOCK_UARTBaud_Type *setting)
+{
+    SYSCON_SetUART0ClockDivider(setting->Divider);
+    UART_SetDivisor(UART0, setting->Divisor);
+    UART_SetFractionalDivider(UART0, setting->DivAddVal, setting->MulVal);
+}
+
+/** @brief Stop sending & receiving, for a clock with no usable baud rate.
+  */
+static void SERIAL_Halt(void)
+{
+    uint32_t primask;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    SERIAL_Halted = 1;
+    UART_DisableTx(UART0);
+    UART_DisableInterrupts(UART0, UART_Interrupt_Mask);
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Start sending & receiving again after SERIAL_Halt().
+  */
+static void SERIAL_Resume(void)
+{
+    uint32_t primask;
+
+
+    if (!SERIAL_Halted) {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    SERIAL_Halted = 0;
+    UART_EnableTx(UART0);
+
+    /* TxData turns itself off if there's nothing to send */
+    UART_EnableInterrupts(UART0, UART_Interrupt_RxLineStatus | UART_Interrupt_TxData
+                                 | (SERIAL_Throttled ? 0 : UART_Interrupt_RxData));
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Keep the baud rate when the core clock changes.
+  * @param[in]  event        Before or after the change
+  * @param[in]  coreClock    The new core clock, in Hz
+  */
+static void SERIAL_ClockChange(CLOCK_Event_Type event, uint32_t coreClock)
+{
+    CLOCK_UARTBaud_Type setting;
+
+
+    (void)coreClock;
+
+    if (event == CLOCK_Event_PreChange) {
+        SERIAL_Flush();
+    } else if (SERIAL_SolveBaud(SERIAL_Baud, &setting) < 0) {
+        /* Better silent than sending garbage; a later clock may do */
+        SERIAL_Stats.BaudErrors++;
+        SERIAL_Halt();
+    } else {
+        SERIAL_SetDivisor(&setting);
+        SERIAL_Resume();
+    }
+}
+
+/** @brief Set up a ring.
+  * @param[out] ring         The ring
+  * @param[in]  buffer       Its storage
+  * @param[in]  size         Its size
+  */
+static void SERIAL_InitRing(SERIAL_Ring_Type *ring, uint8_t *buffer, uint16_t size)
+{
+    lpclib_assert(buffer != 0);
+    lpclib_assert(SERIAL_IS_RING_SIZE(size));
+
+    ring->Buffer = buffer;
+    ring->Mask = size - 1;
+    ring->Head = 0;
+    ring->Tail = 0;
+}
+
+/** @brief Set up UART0 & start the driver.
+  * @param[in]  config       Settings (the buffers must stay valid)
+  * @return                  0 on success, -1 if the baud rate can't be made
+  */
+int SERIAL_Init(const SERIAL_Config_Type *config)
+{
+    CLOCK_UARTBaud_Type setting;
+
+
+    lpclib_assert(config != 0);
+    lpclib_assert(config->Baud != 0);
+    lpclib_assert(UART_IS_RXFIFOTRIGGER(config->RxTrigger));
+    lpclib_assert(UART_IS_FLOWCONTROL(config->FlowControl));
+    lpclib_assert(config->RxLowWater < config->RxSize);
+
+    if (SERIAL_SolveBaud(config->Baud, &setting) < 0) {
+        return -1;
+    }
+
+    NVIC_DisableIRQ(UART0_IRQn);
+
+    SERIAL_InitRing(&SERIAL_Rx, config->RxBuffer, config->RxSize);
+    SERIAL_InitRing(&SERIAL_Tx, config->TxBuffer, config->TxSize);
+    SERIAL_TxFirst = 0;
+    SERIAL_TxLast = 0;
+    SERIAL_Baud = config->Baud;
+
+    SERIAL_Throttling = (config->FlowControl & UART_FlowControl_RTS) ? 1:0;
+    SERIAL_Throttled = 0;
+    SERIAL_Halted = 0;
+    SERIAL_RxLowWater = config->RxLowWater ? config->RxLowWater : config->RxSize / 2;
+
+    SYSCON_EnableAHBClockLines(SYSCON_AHBClockLine_IOCON);
+    IOCON_SetPinConfig(IOCON_PinConfig_1_6_RXD0, IOCON_Mode_Normal);
+    IOCON_SetPinConfig(IOCON_PinConfig_1_7_TXD0, IOCON_Mode_Normal);
+
+    if (config->FlowControl & UART_FlowControl_RTS) {
+        IOCON_SetPinConfig(IOCON_PinConfig_1_5_RTS0, IOCON_Mode_Normal);
+    }
+    if (config->FlowControl & UART_FlowControl_CTS) {
+        IOCON_SetPinConfig(IOCON_PinConfig_0_7_CTS0, IOCON_Mode_Normal);
+    }
+
+    /* One reference however many times SERIAL_Init() is called */
+    if (!SERIAL_Acquired) {
+        GATE_Acquire(GATE_UART0);
+        SERIAL_Acquired = 1;
+    }
+
+    UART_DisableInterrupts(UART0, UART_Interrupt_Mask);
+
+    SERIAL_SetDivisor(&setting);
+    UART_SetWordLength(UART0, UART_WordLength_8b);
+    UART_SetStopBits(UART0, UART_StopBits_1);
+    UART_SetParity(UART0, UART_Parity_None);
+
+    UART_EnableFifos(UART0);
+    UART_FlushFifos(UART0);
+    UART_SetRxFifoTrigger(UART0, config->RxTrigger);
+    UART_SetFlowControl(UART0, config->FlowControl);
+    UART_EnableTx(UART0);
+
+    CLOCK_UnregisterNotifier(&SERIAL_ClockNotifier);
+    CLOCK_RegisterNotifier(&SERIAL_ClockNotifier);
+
+    /* Clear anything left over */
+    UART_GetLineStatus(UART0);
+    UART_GetPendingInterruptID(UART0);
+
+    UART_EnableInterrupts(UART0, UART_Interrupt_RxData | UART_Interrupt_RxLineStatus);
+
+    NVIC_ClearPendingIRQ(UART0_IRQn);
+    NVIC_EnableIRQ(UART0_IRQn);
+
+    return 0;
+}
+
+/** @brief Stop the driver & release UART0.
+  */
+void SERIAL_Deinit(void)
+{
+    NVIC_DisableIRQ(UART0_IRQn);
+    CLOCK_UnregisterNotifier(&SERIAL_ClockNotifier);
+
+    if (SERIAL_Acquired) {
+        UART_DisableInterrupts(UART0, UART_Interrupt_Mask);
+        GATE_Release(GATE_UART0);
+        SERIAL_Acquired = 0;
+    }
+
+    SERIAL_TxFirst = 0;
+    SERIAL_TxLast = 0;
+    SERIAL_Tx.Tail = SERIAL_Tx.Head;
+
+    NVIC_ClearPendingIRQ(UART0_IRQn);
+}
+
+/** @brief Change the baud rate.
+  * @param[in]  baud         The new rate
+  * @return                  0 on success, -1 if it can't be made (the old
+  *                          rate is kept)
+  */
+int SERIAL_SetBaud(uint32_t baud)
+{
+    CLOCK_UARTBaud_Type setting;
+
+
+    lpclib_assert(baud != 0);
+
+    if (SERIAL_SolveBaud(baud, &setting) < 0) {
+        return -1;
+    }
+
+    SERIAL_Flush();
+
+    SERIAL_Baud = baud;
+    SERIAL_SetDivisor(&setting);
+    SERIAL_Resume();
+
+    return 0;
+}
+
+/** @brief Queue data to send, without blocking.
+  * @param[in]  data         The data
+  * @param[in]  len          Its length
+  * @return                  Bytes queued (less than len if the ring filled)
+  */
+unsigned int SERIAL_Write(const uint8_t *data, unsigned int len)
+{
+    SERIAL_Ring_Type *ring = &SERIAL_Tx;
+    uint16_t head = ring->Head;
+    unsigned int room;
+    unsigned int i;
+    uint32_t primask;
+
+
+    lpclib_assert((data != 0) || (len == 0));
+
+    room = ring->Mask + 1 - (uint16_t)(head - ring->Tail);
+    if (len > room) {
+        len = room;
+    }
+
+    for (i = 0; i < len; i++) {
+        ring->Buffer[head & ring->Mask] = data[i];
+        head++;
+    }
+
+    /* Data must be in place before the handler can see it */
+    __DMB();
+    ring->Head = head;
+
+    /* The handler turns this off when it runs out, & writes IER itself */
+    if (len) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        UART_EnableInterrupts(UART0, UART_Interrupt_TxData);
+
+        if (!primask) {
+            __enable_irq();
+        }
+    }
+
+    return len;
+}
+
+/** @brief Queue data to send in place, without copying or blocking.
+  * @param[in]  descs        The descriptors (Data, Length & Done filled in)
+  * @param[in]  count        How many
+  */
+void SERIAL_Send(SERIAL_TxDesc_Type *descs, unsigned int count)
+{
+    unsigned int i;
+    uint32_t primask;
+
+
+    lpclib_assert((descs != 0) || (count == 0));
+
+    if (count == 0) {
+        return;
+    }
+
+    /* They go out once the ring has sent everything written before them */
+    for (i = 0; i < count; i++) {
+        lpclib_assert((descs[i].Data != 0) || (descs[i].Length == 0));
+
+        descs[i].Next = (i + 1 < count) ? &descs[i + 1] : 0;
+        descs[i].Mark = SERIAL_Tx.Head;
+        descs[i].Offset = 0;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (SERIAL_TxFirst) {
+        SERIAL_TxLast->Next = descs;
+    } else {
+        SERIAL_TxFirst = descs;
+    }
+    SERIAL_TxLast = &descs[count - 1];
+
+    UART_EnableInterrupts(UART0, UART_Interrupt_TxData);
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Take received data, without blocking.
+  * @param[out] data         Where to put it
+  * @param[in]  len          Most to take
+  * @return                  Bytes taken
+  */
+unsigned int SERIAL_Read(uint8_t *data, unsigned int len)
+{
+    SERIAL_Ring_Type *ring = &SERIAL_Rx;
+    uint16_t tail = ring->Tail;
+    unsigned int count;
+    unsigned int i;
+    uint32_t primask;
+
+
+    lpclib_assert((data != 0) || (len == 0));
+
+    count = (uint16_t)(ring->Head - tail);
+    if (len > count) {
+        len = count;
+    }
+
+    for (i = 0; i < len; i++) {
+        data[i] = ring->Buffer[tail & ring->Mask];
+        tail++;
+    }
+
+    __DMB();
+    ring->Tail = tail;
+
+    /* Let the FIFO drain again; RTS comes back as it empties */
+    if (SERIAL_Throttled && ((uint16_t)(ring->Head - tail) <= SERIAL_RxLowWater)) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        SERIAL_Throttled = 0;
+        if (!SERIAL_Halted) {
+            UART_EnableInterrupts(UART0, UART_Interrupt_RxData);
+        }
+
+        if (!primask) {
+            __enable_irq();
+        }
+    }
+
+    return len;
+}
+
+/** @brief Get the number of received bytes waiting.
+  * @return                  Bytes in the receive ring
+  */
+unsigned int SERIAL_RxCount(void)
+{
+    return (uint16_t)(SERIAL_Rx.Head - SERIAL_Rx.Tail);
+}
+
+/** @brief Get the room left for sending.
+  * @return                  Free bytes in the transmit ring
+  */
+unsigned int SERIAL_TxFree(void)
+{
+    return SERIAL_Tx.Mask + 1 - (uint16_t)(SERIAL_Tx.Head - SERIAL_Tx.Tail);
+}
+
+/** @brief Wait for everything queued to be sent.
+  */
+void SERIAL_Flush(void)
+{
+    /* Nothing goes out while halted */
+    while (!SERIAL_Halted && ((SERIAL_Tx.Head != SERIAL_Tx.Tail) || SERIAL_TxFirst));
+    while (!SERIAL_Halted && !(UART_GetLineStatus(UART0) & UART_LineStatus_TxEmpty));
+}
+
+/** @brief Empty the receive FIFO into the receive ring.
+  */
+static void SERIAL_RxDrain(void)
+{
+    SERIAL_Ring_Type *ring = &SERIAL_Rx;
+    uint16_t head = ring->Head;
+    uint16_t tail = ring->Tail;
+    uint32_t lsr;
+    uint8_t c;
+
+
+    for (;;) {
+        /* Reading LSR clears its error flags */
+        lsr = UART_GetLineStatus(UART0);
+
+        if (lsr & UART_LineStatus_RxOverrun) {
+            SERIAL_Stats.RxOverruns++;
+        }
+        if (lsr & (UART_LineStatus_ParityError | UART_LineStatus_FramingError
+                   | UART_LineStatus_Break)) {
+            SERIAL_Stats.RxErrors++;
+        }
+
+        if (!(lsr & UART_LineStatus_RxData)) {
+            break;
+        }
+
+        if (((uint16_t)(head - tail) > ring->Mask) && SERIAL_Throttling) {
+            /* Leave the rest in the FIFO; auto-RTS holds off the peer */
+            if (!SERIAL_Throttled) {
+                SERIAL_Throttled = 1;
+                SERIAL_Stats.RxThrottles++;
+                UART_DisableInterrupts(UART0, UART_Interrupt_RxData);
+            }
+            break;
+        }
+
+        c = UART_Recv(UART0);
+        SERIAL_Stats.RxBytes++;
+
+        if ((uint16_t)(head - tail) > ring->Mask) {
+            SERIAL_Stats.RxDropped++;
+        } else {
+            ring->Buffer[head & ring->Mask] = c;
+            head++;
+        }
+    }
+
+    __DMB();
+    ring->Head = head;
+}
+
+/** @brief Refill the (empty) transmit FIFO from the transmit ring & queued
+  *        descriptors, in the order they were queued.
+  */
+static void SERIAL_TxFill(void)
+{
+    SERIAL_Ring_Type *ring = &SERIAL_Tx;
+    SERIAL_TxDesc_Type *desc = SERIAL_TxFirst;
+    uint16_t head = ring->Head;
+    uint16_t tail = ring->Tail;
+    unsigned int count = SERIAL_TX_FIFO_SIZE;
+
+
+    while (count) {
+        if (desc && (tail == desc->Mark)) {
+            while ((desc->Offset < desc->Length) && count) {
+                UART_Send(UART0, desc->Data[desc->Offset++]);
+                count--;
+            }
+
+            if (desc->Offset < desc->Length) {
+                break;
+            }
+
+            /* Done may queue more; pick up the new list */
+            SERIAL_TxFirst = desc->Next;
+            if (desc->Done) {
+                desc->Done(desc);
+            }
+            desc = SERIAL_TxFirst;
+            head = ring->Head;
+        } else if (tail != head) {
+            UART_Send(UART0, ring->Buffer[tail & ring->Mask]);
+            tail++;
+            count--;
+        } else {
+            break;
+        }
+    }
+
+    SERIAL_Stats.TxBytes += SERIAL_TX_FIFO_SIZE - count;
+    ring->Tail = tail;
+
+    if ((tail == head) && !SERIAL_TxFirst) {
+        UART_DisableInterrupts(UART0, UART_Interrupt_TxData);
+    }
+}
+
+/** @brief UART0 interrupt handler.
+  */
+LPC11XX_RAMFUNC void SERIAL_IRQHandler(void)
+{
+    UART_InterruptID_Type id;
+
+
+    SERIAL_Stats.Interrupts++;
+
+    while ((id = UART_GetPendingInterruptID(UART0)) != UART_InterruptID_None) {
+        switch (id) {
+        case UART_InterruptID_RxLineStatus:
+        case UART_InterruptID_RxDataAvailable:
+        case UART_InterruptID_CharacterTimeOut:
+            SERIAL_RxDrain();
+            break;
+
+        case UART_InterruptID_TxEmpty:
+            SERIAL_TxFill();
+            break;
+
+        default:
+            /* Reading MSR clears a modem status interrupt */
+            UART_GetModemStatus(UART0);
+            break;
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/******************************************************************************
+ * @file:    lpc11xx_stack.c
+ * @purpose: Stack high-water mark & per-level depth sampling
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_STACK
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "lpc11xx/stack.h"
+
+
+/* External Declarations ----------------------------------------------------*/
+
+/* These are provided by the linker */
+extern uint32_t _heap_start;
+extern uint32_t _stack;
+
+/* Sampler called by STACK_SysTick_Handler */
+void _stack_sample(const uint32_t *frame);
+
+
+/* File-Local Defines -------------------------------------------------------*/
+
+/* Stacked xPSR: exception number, & flag for a padding word added to
+ *  8-byte align the frame
+ */
+#define STACK_XPSR_EXC_Msk      0x3fUL
+#define STACK_XPSR_ALIGN_Msk    (1UL << 9)
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+/* Deepest sampled stack use, by level */
+static uint32_t STACK_Deepest[STACK_NUM_LEVELS];
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Get the space available to the stack.
+  * @return                  Bytes from _heap_start up to the initial stack pointer
+  */
+uint32_t STACK_GetSize(void)
+{
+    return (uint32_t)&_stack - (uint32_t)&_heap_start;
+}
+
+/** @brief Get the stack in use right now.
+  * @return                  Bytes between the current & initial stack pointer
+  */
+uint32_t STACK_GetUsed(void)
+{
+    return (uint32_t)&_stack - __get_MSP();
+}
+
+/** @brief Get the deepest the stack has reached since boot.
+  * @return                  Bytes used at the deepest point
+  */
+uint32_t STACK_GetHighWater(void)
+{
+    const uint32_t *p = &_heap_start;
+
+
+    while ((p < &_stack) && (*p == STACK_PAINT_PATTERN)) {
+        p++;
+    }
+
+    return (uint32_t)&_stack - (uint32_t)p;
+}
+
+/** @brief Get the stack space never touched since boot.
+  * @return                  STACK_GetSize() - STACK_GetHighWater()
+  */
+uint32_t STACK_GetFree(void)
+{
+    return STACK_GetSize() - STACK_GetHighWater();
+}
+
+/** @brief Start sampling stack depth from SysTick.
+  * @param[in]  period       Core clocks between samples (1 - 0x1000000)
+  */
+void STACK_StartSampling(uint32_t period)
+{
+    lpclib_assert((period > 0) && (period <= SysTick_LOAD_RELOAD_Msk + 1));
+
+    NVIC_SetPriority(SysTick_IRQn, 0);
+
+    SysTick->LOAD = period - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk
+                    | SysTick_CTRL_ENABLE_Msk;
+}
+
+/** @brief Stop sampling stack depth (turns SysTick off).
+  */
+void STACK_StopSampling(void)
+{
+    SysTick->CTRL = 0;
+}
+
+/** @brief Get the deepest stack sampled at a level.
+  * @param[in]  level        0 for thread mode, up to STACK_NUM_LEVELS - 1
+  * @return                  Bytes in use when interrupted at that level
+  */
+uint32_t STACK_GetDeepest(unsigned int level)
+{
+    lpclib_assert(level < STACK_NUM_LEVELS);
+
+    return STACK_Deepest[level];
+}
+
+/** @brief Forget the sampled depths.
+  */
+void STACK_ClearDeepest(void)
+{
+    unsigned int i;
+
+
+    for (i = 0; i < STACK_NUM_LEVELS; i++) {
+        STACK_Deepest[i] = 0;
+    }
+}
+
+/** @brief Default (empty) per-tick hook.
+  */
+void STACK_SysTickHook(void) __attribute__((weak));
+void STACK_SysTickHook(void)
+{
+}
+
+/** @brief Record the depth of the code SysTick interrupted.
+  * @param[in]  frame        Exception frame pushed on SysTick entry
+  *
+  * The library only runs on the main stack, so the frame is always on MSP.
+  */
+void _stack_sample(const uint32_t *frame)
+{
+    uint32_t xpsr = frame[7];
+    uint32_t exc = xpsr & STACK_XPSR_EXC_Msk;
+    uint32_t sp;
+    uint32_t used;
+    unsigned int level;
+
+
+    /* Stack pointer before the frame was pushed */
+    sp = (uint32_t)(frame + 8) + ((xpsr & STACK_XPSR_ALIGN_Msk) ? 4 : 0);
+    used = (uint32_t)&_stack - sp;
+
+    if (exc == 0) {
+        level = 0;
+    } else if (exc < (uint32_t)(16 + SVC_IRQn)) {
+        /* NMI / HardFault: above SysTick, so can't actually be seen here */
+        level = STACK_NUM_LEVELS - 1;
+    } else {
+        /* Priority 0 (level STACK_NUM_LEVELS - 1) can't be seen either;
+         *  SysTick runs at 0 & can't preempt its own priority
+         */
+        level = (STACK_NUM_LEVELS - 1) - NVIC_GetPriority((IRQn_Type)((int)exc - 16));
+    }
+
+    if (used > STACK_Deepest[level]) {
+        STACK_Deepest[level] = used;
+    }
+
+    STACK_SysTickHook();
+}
+
+/** @brief SysTick handler that samples stack depth.
+  *
+  * Hands the exception frame (MSP on entry, before anything else is pushed)
+  * to _stack_sample(), which returns from the exception.
+  */
+void STACK_SysTick_Handler(void) __attribute__((naked));
+void STACK_SysTick_Handler(void)
+{
+    __asm volatile (
+        "    mrs     r0, msp          \n"
+        "    ldr     r1, 1f           \n"
+        "    bx      r1               \n"
+        "    .align  2                \n"
+        "1:  .word   _stack_sample    \n"
+    );
+}
@@ -0,0 +1,56 @@
+/******************************************************************************
+ * @file:    lpc11xx_sysinit.c
+ * @purpose: Driver initialization registry (deferred / forced init)
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_SYSINIT
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "lpc11xx/sysinit.h"
+
+
+/* External Declarations ----------------------------------------------------*/
+
+/* Registry table (.init0 - .init7), provided by the linker */
+extern const SYSINIT_Entry_Type _sysinit_start[];
+extern const SYSINIT_Entry_Type _sysinit_end[];
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Run a registered routine if it hasn't run yet.
+  * @param[in]  entry        The registration
+  */
+void SYSINIT_Run(const SYSINIT_Entry_Type *entry)
+{
+    lpclib_assert(entry != 0);
+
+    if (*entry->Done == 0) {
+        /* Mark first, so a routine that (indirectly) requires itself
+         *  doesn't recurse
+         */
+        *entry->Done = 1;
+        entry->Init();
+    }
+}
+
+/** @brief Run every SYSINIT_LAZY() routine that hasn't run yet, in level order.
+  */
+void SYSINIT_RunLazy(void)
+{
+    const SYSINIT_Entry_Type *entry;
+
+
+    /* The table is already in level order (one section per level) */
+    for (entry = _sysinit_start; entry < _sysinit_end; entry++) {
+        SYSINIT_Run(entry);
+    }
+}
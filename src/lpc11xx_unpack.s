@@ -0,0 +1,74 @@
+/******************************************************************************
+ * @file:    lpc11xx_unpack.s
+ * @purpose: Unpacker for a compressed .data load image (see lpc11xx-pack)
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ *
+ * Only linked in when an image has a .data_lz section; the packed image
+ * starts with this function's address, which is what pulls it in & what
+ * _start calls.
+ *
+ * Format: a sequence of
+ *   0x00-0x7f  literal run: (n + 1) bytes follow, copied as-is
+ *   0x80-0xff  match: (n - 0x80 + 4) bytes copied from (offset) bytes back
+ *              in the output; offset follows as 16 bits, little endian
+ * until the output is full.  Matches may overlap their own output (runs).
+ *****************************************************************************/
+
+    .syntax unified
+    .cpu    cortex-m0
+    .thumb
+
+    .section .startup, "ax", %progbits
+
+
+/** @brief Unpack a compressed image.
+  * @param[in]  r0           Destination start address
+  * @param[in]  r1           Packed data
+  * @param[in]  r2           Destination end address
+  */
+    .global _meminit_unpack
+    .type   _meminit_unpack, %function
+    .thumb_func
+_meminit_unpack:
+    push    {r4, r5}
+1:
+    cmp     r0, r2
+    bhs     9f
+    ldrb    r3, [r1]
+    adds    r1, #1
+    cmp     r3, #0x80
+    bhs     3f
+
+    adds    r3, #1                  /* literal run */
+2:
+    ldrb    r4, [r1]
+    adds    r1, #1
+    strb    r4, [r0]
+    adds    r0, #1
+    subs    r3, #1
+    bne     2b
+    b       1b
+
+3:
+    subs    r3, #(0x80 - 4)         /* match: r3 = length */
+    ldrb    r4, [r1]
+    ldrb    r5, [r1, #1]
+    adds    r1, #2
+    lsls    r5, r5, #8
+    orrs    r4, r5
+    subs    r4, r0, r4              /* r4 = earlier output */
+4:
+    ldrb    r5, [r4]
+    adds    r4, #1
+    strb    r5, [r0]
+    adds    r0, #1
+    subs    r3, #1
+    bne     4b
+    b       1b
+
+9:
+    pop     {r4, r5}
+    bx      lr
+    .size   _meminit_unpack, . - _meminit_unpack
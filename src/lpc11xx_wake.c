@@ -0,0 +1,228 @@
+/******************************************************************************
+ * @file:    lpc11xx_wake.c
+ * @purpose: Fast deep-sleep wake-up on start logic inputs
+ * @version: V1.0
+ * @author:  Tymm Twillman
+ * @date:    February 2012
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+
+#define LPCLIB_ASSERT_FILE_ID  LPCLIB_ASSERT_ID_WAKE
+
+#include <stdint.h>
+
+#include "lpc11xx.h"
+#include "lpclib_assert.h"
+#include "lpc11xx/pmu.h"
+#include "lpc11xx/syscon.h"
+#include "lpc11xx/wake.h"
+
+
+/* Static Variables ---------------------------------------------------------*/
+
+WAKE_Stats_Type WAKE_Stats;
+
+static WAKE_Handler_Type WAKE_Handlers[WAKE_NUM_INPUTS];
+
+/* Inputs with handlers (SYSCON_WakeupInput_*) */
+static uint32_t WAKE_Inputs;
+
+
+/* Functions ----------------------------------------------------------------*/
+
+/** @brief Set (or clear) the handler for a start logic input.
+  * @param[in]  input        The input (0 - 11 for PIO0_n, 12 for PIO1_0)
+  * @param[in]  edge         The edge that triggers it
+  * @param[in]  handler      Called when it fires (0 to stop using the input)
+  */
+void WAKE_SetHandler(unsigned int input, SYSCON_WakeupEdge_Type edge,
+                     WAKE_Handler_Type handler)
+{
+    uint32_t bit;
+    uint32_t primask;
+
+
+    lpclib_assert(WAKE_IS_INPUT(input));
+    lpclib_assert(SYSCON_IS_WAKEUPEDGE(edge));
+
+    bit = 1UL << input;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    SYSCON_DisableWakeupInputs(bit);
+    WAKE_Handlers[input] = handler;
+
+    if (handler) {
+        SYSCON_SetWakeupEdgesForInputs(bit, edge);
+        SYSCON_ResetWakeupInputs(bit);
+        SYSCON_EnableWakeupInputs(bit);
+        WAKE_Inputs |= bit;
+    } else {
+        WAKE_Inputs &= ~bit;
+    }
+
+    NVIC_ClearPendingIRQ((IRQn_Type)input);
+
+    if (!primask) {
+        __enable_irq();
+    }
+}
+
+/** @brief Call the handlers for inputs that have fired.
+  * @param[in]  triggered    The inputs (SYSCON_WakeupInput_*)
+  * @return                  Those whose handlers returned WAKE_Action_Run
+  */
+static uint32_t WAKE_Dispatch(uint32_t triggered)
+{
+    uint32_t run = 0;
+    uint32_t bit;
+    unsigned int input;
+
+
+    for (input = 0; input < WAKE_NUM_INPUTS; input++) {
+        bit = 1UL << input;
+        if (!(triggered & bit)) {
+            continue;
+        }
+
+        /* Re-arm first, so an edge during the handler isn't lost */
+        SYSCON_ResetWakeupInputs(bit);
+        NVIC_ClearPendingIRQ((IRQn_Type)input);
+
+        if (WAKE_Handlers[input] && (WAKE_Handlers[input](input) == WAKE_Action_Run)) {
+            run |= bit;
+        }
+    }
+
+    return run;
+}
+
+/** @brief Deep-sleep until a handler returns WAKE_Action_Run.
+  * @return                  Mask of inputs whose handlers asked to run, or 0
+  *                          if another interrupt is waiting
+  */
+uint32_t WAKE_Sleep(void)
+{
+    SYSCON_MainClockSource_Type mainClock;
+    uint32_t runLines, awakeLines;
+    uint32_t irqsEnabled;
+    uint32_t triggered;
+    uint32_t run = 0;
+    uint32_t latency;
+    uint32_t primask;
+    int timing;
+
+
+    lpclib_assert(WAKE_Inputs != 0);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    mainClock = SYSCON_GetMainClockSource();
+    runLines = SYSCON_GetEnabledAnalogPowerLinesForMode(SYSCON_PowerMode_Run)
+               & SYSCON_PDAWAKECFG_Mask;
+    awakeLines = SYSCON_GetEnabledAnalogPowerLinesForMode(SYSCON_PowerMode_Awake)
+                 & SYSCON_PDAWAKECFG_Mask;
+
+    /* Come back up on the IRC alone; the PLL only if a handler needs it */
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_IRC);
+    SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Awake, SYSCON_PDAWAKECFG_Mask);
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Awake,
+                                         (runLines | SYSCON_AnalogPowerLine_IRC)
+                                         & ~(SYSCON_AnalogPowerLine_SysPLL
+                                             | SYSCON_AnalogPowerLine_SysOsc));
+
+    if (mainClock != SYSCON_MainClockSource_IRC) {
+        SYSCON_SetMainClockSource(SYSCON_MainClockSource_IRC);
+        SYSCON_EnableMainClockSourceUpdate();
+        while (!SYSCON_MainClockSourceIsUpdated());
+    }
+
+    /* WFI needs the inputs' interrupts enabled; they're never taken here */
+    irqsEnabled = NVIC->ISER[0] & WAKE_Inputs;
+    NVIC->ISER[0] = WAKE_Inputs;
+
+    /* SysTick stops in deep-sleep; it counts the clocks after it */
+    timing = !(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk);
+
+    while (run == 0) {
+        triggered = SYSCON_GetTriggeredStartLogicInputs() & WAKE_Inputs;
+
+        if (triggered == 0) {
+            if (timing) {
+                SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+                SysTick->VAL = 0;
+                SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+            }
+
+            PMU_DisableDeepPowerDown();
+            SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+            __WFI();
+            SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+            if (timing) {
+                latency = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+                SysTick->CTRL = 0;
+
+                WAKE_Stats.LastLatency = latency;
+                if (latency > WAKE_Stats.MaxLatency) {
+                    WAKE_Stats.MaxLatency = latency;
+                }
+            }
+
+            WAKE_Stats.Wakes++;
+            triggered = SYSCON_GetTriggeredStartLogicInputs() & WAKE_Inputs;
+
+            /* Some other interrupt is pending; WFI won't wait again until
+             *  it's been taken, so hand it back to the caller
+             */
+            if (triggered == 0) {
+                WAKE_Stats.Interrupted++;
+                break;
+            }
+        }
+
+        run = WAKE_Dispatch(triggered);
+    }
+
+    if (run) {
+        WAKE_Stats.Runs++;
+    }
+
+    NVIC->ICER[0] = WAKE_Inputs & ~irqsEnabled;
+    NVIC->ICPR[0] = WAKE_Inputs & ~irqsEnabled;
+
+    /* Deep-sleep wake-up copied PDAWAKECFG to PDRUNCFG; put both back */
+    SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Awake, SYSCON_PDAWAKECFG_Mask);
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Awake, awakeLines);
+    SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, runLines);
+
+    if (mainClock != SYSCON_MainClockSource_IRC) {
+        if (mainClock == SYSCON_MainClockSource_SysPLLOut) {
+            while (!SYSCON_SysPLLIsLocked());
+        }
+
+        SYSCON_SetMainClockSource(mainClock);
+        SYSCON_EnableMainClockSourceUpdate();
+        while (!SYSCON_MainClockSourceIsUpdated());
+    }
+
+    if (!(runLines & SYSCON_AnalogPowerLine_IRC)) {
+        SYSCON_DisableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_IRC);
+    }
+
+    if (!primask) {
+        __enable_irq();
+    }
+
+    return run;
+}
+
+/** @brief Start logic interrupt handler, for edges while awake.
+  */
+void WAKE_IRQHandler(void)
+{
+    WAKE_Dispatch(SYSCON_GetTriggeredStartLogicInputs() & WAKE_Inputs);
+}
@@ -14,6 +14,30 @@
 #include "lpc11xx/wdt.h"
 
 
+/* Static Variables ---------------------------------------------------------*/
+
+/* Last failure; in .noinit so it survives the reset that follows it */
+__attribute__((section(".noinit")))
+static LPCLIB_AssertRecord_Type lpclib_assert_record;
+
+
+/* Local Functions ----------------------------------------------------------*/
+
+static void lpclib_assert_save(uint32_t location)
+{
+    __disable_irq();
+
+    /* Count is garbage after power-up; only trust it with a valid magic */
+    if (lpclib_assert_record.Magic != LPCLIB_ASSERT_MAGIC) {
+        lpclib_assert_record.Count = 0;
+    }
+
+    lpclib_assert_record.Location = location;
+    lpclib_assert_record.Count++;
+    lpclib_assert_record.Magic = LPCLIB_ASSERT_MAGIC;
+}
+
+
 /* Functions ----------------------------------------------------------------*/
 
 /** @brief  Infinite loop function for library debugging
@@ -34,3 +58,46 @@ void lpclib_assert_failed(void)
 #endif
     }
 }
+
+/** @brief  Record an assertion failure & reset the chip.
+  * @param[in]  location     LPCLIB_ASSERT_LOCATION() of the failing assertion.
+  * @return Does not return.
+  */
+void lpclib_assert_reset(uint32_t location)
+{
+    lpclib_assert_save(location);
+
+    NVIC_SystemReset();
+
+    while (1);
+}
+
+/** @brief  Record an assertion failure & call lpclib_assert_failed().
+  * @param[in]  location     LPCLIB_ASSERT_LOCATION() of the failing assertion.
+  * @return Does not return.
+  */
+void lpclib_assert_stop(uint32_t location)
+{
+    lpclib_assert_save(location);
+
+    lpclib_assert_failed();
+
+    /* In case an override of lpclib_assert_failed() returns */
+    while (1);
+}
+
+/** @brief  Get the record of an assertion failure from before the last reset.
+  * @return The record, or (null) if none is recorded.
+  */
+const LPCLIB_AssertRecord_Type *lpclib_assert_get_record(void)
+{
+    return (lpclib_assert_record.Magic == LPCLIB_ASSERT_MAGIC) ? &lpclib_assert_record : 0;
+}
+
+/** @brief  Forget any recorded assertion failure.
+  */
+void lpclib_assert_clear_record(void)
+{
+    lpclib_assert_record.Magic = 0;
+    lpclib_assert_record.Count = 0;
+}
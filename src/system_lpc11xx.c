@@ -44,31 +44,22 @@
 #include "lpc11xx.h"
 #include "system_lpc11xx.h"
 
+#include "lpc11xx/clock.h"
+#include "lpc11xx/clock_config.h"
 #include "lpc11xx/flash.h"
 #include "lpc11xx/syscon.h"
 
 
 /* File-Local Defines -------------------------------------------------------*/
 
-/* By default the AHB divider is set to 1 (bus runs at system clock speed) */
-#ifndef AHBCLKDIV_Val
-# define AHBCLKDIV_Val 1
-#endif
-
 /* By default the Main clock divider is set to 1 (CPU at system clock speed) */
 #ifndef MAINCLKDIV_Val
 # define MAINCLKDIV_Val 1
 #endif
 
-/* If an HSE_Val (High Speed External Oscillator frequency) has been supplied,
- *   use that as the system oscillator input frequency.  Otherwise fall back
- *   to using the internal RC oscillator speed.
+/* PLL, AHB & flash settings come from lpc11xx/clock_config.h, which
+ *   works them out (and checks them) at compile time from F_CPU & HSE_Val.
  */
-#ifdef HSE_Val
-# define MCUOSC_Val HSE_Val
-#else
-# define MCUOSC_Val IRC_Val
-#endif
 
 
 /* Static Variables ---------------------------------------------------------*/
@@ -90,20 +81,31 @@ uint32_t SystemCoreClock = IRC_Val;
 /*! @brief System High-Speed Bus Frequency */
 uint32_t SystemAHBClock = IRC_Val;
 
+/*! @brief Set by _start on a wake-up from deep power-down with retained
+ *         state (lpc11xx/retain.h); in .noinit as it's set before .bss is
+ *         cleared.
+ */
+__attribute__ ((section(".noinit")))
+uint8_t SystemResumed;
+
+/*! @brief Clock frequency cache behind CLOCK_GetFrequency() */
+uint32_t CLOCK_Frequencies[CLOCK_NumClocks];
+volatile uint8_t CLOCK_FrequenciesValid;
+
 
 /* Functions ----------------------------------------------------------------*/
 
 /* System PLL Initialization is only compiled in if the expected CPU speed
  * differs from the input clock rate.  You can always use the SYSCON
- * PLL interface to change later.
+ * PLL interface (or CLOCK_SetCoreFrequency()) to change later.
  */
 
-#if MCUOSC_Val != F_CPU
+#if CLOCK_CFG_USE_PLL
 /** @brief Initialize system PLL
   *
   * @return None.
   *
-  * Sets up the main MCU PLL.
+  * Sets up the main MCU PLL.  All values are compile-time constants.
   */
 static inline void SysPLLInit(void)
 {
@@ -116,17 +118,7 @@ static inline void SysPLLInit(void)
     SYSCON_EnableSysPLLClockSourceUpdate();
     while (!SYSCON_SysPLLClockSourceIsUpdated());
 
-    SYSCON_SetSysPLLMVal((F_CPU / MCUOSC_Val) - 1);
-
-#if (F_CPU < 19500000)
-    SYSCON_SetSysPLLPVal(SYSCON_SysPLLPVal_8);
-#elif (F_CPU < 39000000)
-    SYSCON_SetSysPLLPVal(SYSCON_SysPLLPVal_4);
-#elif (F_CPU < 78000000)
-    SYSCON_SetSysPLLPVal(SYSCON_SysPLLPVal_2);
-#else
-    SYSCON_SetSysPLLPVal(SYSCON_SysPLLPVal_1);
-#endif
+    SYSCON_SetSysPLLClockScaler(CLOCK_CFG_PLL_SCALER);
 
     /* Make sure the PLL is powered */
     SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_SysPLL);
@@ -154,54 +146,132 @@ uint32_t WDTOscValToFreq(SYSCON_WDTOscFreq_Type oscVal)
 }
 
 
+/** @brief Get the current watchdog oscillator output frequency.
+  * @return                  The frequency, in Hz
+  */
+static uint32_t WDTOscFrequency(void)
+{
+    return WDTOscValToFreq(SYSCON_GetWDTOscFreq()) / SYSCON_GetWDTOscDivider();
+}
+
+/** @brief Get the current system oscillator frequency.
+  * @return                  The frequency, in Hz (0 if there's no crystal)
+  */
+static uint32_t SysOscFrequency(void)
+{
+#ifdef HSE_Val
+    return HSE_Val;
+#else
+    return 0;
+#endif
+}
+
+/** @brief Divide a clock by a SYSCON divider (0 means the clock is off).
+  * @param[in]  clock        The clock being divided, in Hz
+  * @param[in]  divider      The SYSCON divider register value
+  * @return                  The divided clock, in Hz
+  */
+static uint32_t DivideClock(uint32_t clock, unsigned int divider)
+{
+    return (divider == 0) ? 0 : clock / divider;
+}
+
 /** @brief Set the system & AHB clock variables based on current clock configs
   *
   * @return None.
   *
-  * Sets SystemCoreClock, SystemAHBClock based on values in clock
-  * configuration registers.
+  * Sets SystemCoreClock, SystemAHBClock and the CLOCK_GetFrequency() cache
+  * from the values in the clock configuration registers.
   *
   * REQUIRED for CMSIS compliance.
   */
 void SystemCoreClockUpdate(void)
 {
-    uint8_t tmp;
-    uint32_t clockSpeed;
+    uint32_t primask;
+    uint32_t pllIn;
+    uint32_t mainClock;
+    uint32_t clock;
 
 
-    tmp = SYSCON_GetMainClockSource();
+    /* Keep interrupt handlers from seeing a half-updated cache */
+    primask = __get_PRIMASK();
+    __disable_irq();
 
-    if (tmp == SYSCON_MainClockSource_IRC) {
-        clockSpeed = IRC_Val;
-    } else if (tmp == SYSCON_MainClockSource_SysPLLIn) {
-        clockSpeed = IRC_Val;
-#ifdef HSE_Val
-        tmp = SYSCON_GetSysPLLClockSource();
-        if (tmp == SYSCON_SysPLLClockSource_SysOsc) {
-            clockSpeed = HSE_Val;
-        }
-#endif
-    } else if (tmp == SYSCON_MainClockSource_WDTOsc) {
-        tmp = SYSCON_GetWDTOscFreq();
-        clockSpeed = WDTOscValToFreq(tmp);
-        clockSpeed /= (SYSCON_GetWDTOscDivider() + 1) * 2;
-    } else { /* SYSCON_MainClockSource_SysPLLOut */
-        tmp = SYSCON_GetSysPLLClockSource();
-        if (tmp == SYSCON_SysPLLClockSource_IRC) {
-            clockSpeed = IRC_Val * SYSCON_GetSysPLLMVal();
-#ifdef HSE_Val
-        } else { /* SYSCON_SysPLLClockSource_SysOsc*/
-            clockSpeed = HSE_Val * SYSCON_GetSysPLLMVal();
-#endif
-        }
+    if (SYSCON_GetSysPLLClockSource() == SYSCON_SysPLLClockSource_SysOsc) {
+        pllIn = SysOscFrequency();
+    } else {
+        pllIn = IRC_Val;
     }
 
-    SystemCoreClock = clockSpeed / SYSCON_GetAHBClockDivider();
+    switch (SYSCON_GetMainClockSource()) {
+    case SYSCON_MainClockSource_IRC:
+        mainClock = IRC_Val;
+        break;
 
-    if (SYSCON_GetAHBClockDivider() == 0) {
-        SystemAHBClock= 0;
-    } else {
-        SystemAHBClock = SystemCoreClock / SYSCON_GetAHBClockDivider();
+    case SYSCON_MainClockSource_SysPLLIn:
+        mainClock = pllIn;
+        break;
+
+    case SYSCON_MainClockSource_WDTOsc:
+        mainClock = WDTOscFrequency();
+        break;
+
+    default: /* SYSCON_MainClockSource_SysPLLOut */
+        /* Fout = M * Fin; P only sets the CCO frequency, not the output */
+        mainClock = pllIn * (SYSCON_GetSysPLLMVal() + 1);
+        break;
+    }
+
+    CLOCK_Frequencies[CLOCK_Main] = mainClock;
+    CLOCK_Frequencies[CLOCK_Core] = DivideClock(mainClock, SYSCON_GetAHBClockDivider());
+    CLOCK_Frequencies[CLOCK_UART0] = DivideClock(mainClock, SYSCON_GetUART0ClockDivider());
+    CLOCK_Frequencies[CLOCK_SSP0] = DivideClock(mainClock, SYSCON_GetSSP0ClockDivider());
+    CLOCK_Frequencies[CLOCK_SSP1] = DivideClock(mainClock, SYSCON_GetSSP1ClockDivider());
+
+    switch (SYSCON_GetWDTClockSource()) {
+    case SYSCON_WDTClockSource_IRC:
+        clock = IRC_Val;
+        break;
+
+    case SYSCON_WDTClockSource_MainClock:
+        clock = mainClock;
+        break;
+
+    default: /* SYSCON_WDTClockSource_WDTOsc */
+        clock = WDTOscFrequency();
+        break;
+    }
+
+    CLOCK_Frequencies[CLOCK_WDT] = DivideClock(clock, SYSCON_GetWDTClockDivider());
+
+    switch (SYSCON_GetCLKOUTSource()) {
+    case SYSCON_CLKOUTSource_IRC:
+        clock = IRC_Val;
+        break;
+
+    case SYSCON_CLKOUTSource_SYSOsc:
+        clock = SysOscFrequency();
+        break;
+
+    case SYSCON_CLKOUTSource_WDTOsc:
+        clock = WDTOscFrequency();
+        break;
+
+    default: /* SYSCON_CLKOUTSource_MainClock */
+        clock = mainClock;
+        break;
+    }
+
+    CLOCK_Frequencies[CLOCK_CLKOUT] = DivideClock(clock, SYSCON_GetCLKOUTDivider());
+
+    /* The CPU runs from the AHB clock; they are one and the same */
+    SystemCoreClock = CLOCK_Frequencies[CLOCK_Core];
+    SystemAHBClock = CLOCK_Frequencies[CLOCK_Core];
+
+    CLOCK_FrequenciesValid = 1;
+
+    if (!primask) {
+        __enable_irq();
     }
 }
 
@@ -217,16 +287,30 @@ void SystemCoreClockUpdate(void)
 void SystemInit(void) __attribute__((weak));
 void SystemInit(void)
 {
-    int i;
-
-
     /* Initialize analog power configuration modes (Set to sane values) */
     SYSCON_InitAnalogPowerLines();
 
+#if LPC11XX_DPD_RESUME_IRC
+    /* Back from deep power-down just to do a little work: stay on the IRC
+     *  rather than wait for the crystal & PLL (CLOCK_SetCoreFrequency()
+     *  can bring them up later)
+     */
+    if (SystemResumed) {
+        FLASH_SetWaitStates(CLOCK_FLASH_WAITS(IRC_Val));
+        SYSCON_SetAHBClockDivider(1);
+
+        SystemCoreClock = IRC_Val;
+        SystemAHBClock = IRC_Val;
+
+        SYSCON_EnableAHBClockLines(SYSCON_AHBClockLine_IOCON);
+        return;
+    }
+#endif
+
 #if defined(__DEBUG_RAM)
-    SYSMEMREMAP_Map(SYSMEMREMAP_Remap_RAM);
+    SYSCON_SetMemRemap(SYSCON_RemapMem_RAM);
 #elif defined(__DEBUG_FLASH)
-    SYSMEMREMAP_Map(SYSMEMREMAP_Remap_FLASH);
+    SYSCON_SetMemRemap(SYSCON_RemapMem_FLASH);
 #endif
 
     /* If using an external crystal / oscillator, enable the system
@@ -241,35 +325,35 @@ void SystemInit(void)
     SYSCON_SetSysOscFreqRange(SYSCON_SysOscFreqRange_15_25);
 # endif
     SYSCON_EnableAnalogPowerLinesForMode(SYSCON_PowerMode_Run, SYSCON_AnalogPowerLine_SysOsc);
-#endif
 
-    /* Brief delay to let the system stabilize a little */
-    for (i = 0; i < 1000; i++) {
-        __asm__ __volatile__(" nop\r\n");
+    /* Brief delay to let the oscillator stabilize a little (the IRC is
+     *  already running, so this is only needed for an external one)
+     */
+    {
+        int i;
+
+        for (i = 0; i < 1000; i++) {
+            __asm__ __volatile__(" nop\r\n");
+        }
     }
+#endif
 
     /* Make sure we don't exceed flash specs when changing clock speed */
     FLASH_SetWaitStates(2);
 
-#if MCUOSC_Val != F_CPU
+#if CLOCK_CFG_USE_PLL
     /* Configure & connect the system PLL, if desired */
     SysPLLInit();
 #endif
 
-    /* Update system frequency variables */
-    SystemCoreClock = F_CPU;
-
-    /* Set flash latency to maximum for running */
-    if (SystemCoreClock < 20000000UL) {
-        FLASH_SetWaitStates(0);
-    } else if (SystemCoreClock < 40000000UL) {
-        FLASH_SetWaitStates(1);
-    }
+    /* Set flash latency to the minimum for the running speed */
+    FLASH_SetWaitStates(CLOCK_CFG_FLASH_WAITS);
 
-    SYSCON_SetAHBClockDivider(AHBCLKDIV_Val);
+    SYSCON_SetAHBClockDivider(CLOCK_CFG_AHB_DIVIDER);
 
-    /* Update AHB frequency variable */
-    SystemAHBClock = F_CPU / AHBCLKDIV_Val;
+    /* Update system frequency variables (the CPU runs at the AHB clock) */
+    SystemCoreClock = CLOCK_CFG_AHB_CLOCK;
+    SystemAHBClock = CLOCK_CFG_AHB_CLOCK;
 
     /* Enable IOCON system clock */
     SYSCON_EnableAHBClockLines(SYSCON_AHBClockLine_IOCON);